@@ -175,6 +175,10 @@ QString QValue3DAxisFormatter::stringForValue(qreal value, const QString &format
  * Reimplement this method if the position cannot be resolved by linear
  * interpolation between the parent axis minimum and maximum values.
  *
+ * \note When resolving positions for large data sets, the renderer may call
+ * this method concurrently from several threads. Reimplementations must not
+ * modify the formatter.
+ *
  * \sa recalculate(), valueAt()
  */
 float QValue3DAxisFormatter::positionAt(float value) const
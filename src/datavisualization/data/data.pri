@@ -17,6 +17,9 @@ HEADERS += \
     $$PWD/qscatterdataproxy_p.h \
     $$PWD/qitemmodelscatterdataproxy.h \
     $$PWD/qitemmodelscatterdataproxy_p.h \
+    $$PWD/qexternalscatterdataproxy.h \
+    $$PWD/qexternalscatterdataproxy_p.h \
+    $$PWD/scatterdataview_p.h \
     $$PWD/abstractitemmodelhandler_p.h \
     $$PWD/baritemmodelhandler_p.h \
     $$PWD/scatteritemmodelhandler_p.h \
@@ -57,6 +60,7 @@ SOURCES += \
     $$PWD/qscatterdataitem.cpp \
     $$PWD/qscatterdataproxy.cpp \
     $$PWD/qitemmodelscatterdataproxy.cpp \
+    $$PWD/qexternalscatterdataproxy.cpp \
     $$PWD/abstractitemmodelhandler.cpp \
     $$PWD/baritemmodelhandler.cpp \
     $$PWD/scatteritemmodelhandler.cpp \
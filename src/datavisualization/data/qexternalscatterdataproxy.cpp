@@ -0,0 +1,279 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qexternalscatterdataproxy_p.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+/*!
+ * \class QExternalScatterDataProxy
+ * \inmodule QtDataVisualization
+ * \brief The QExternalScatterDataProxy class is a data proxy for 3D scatter graphs that
+ * reads the item data directly from a buffer owned by the application.
+ * \since QtDataVisualization 1.4
+ *
+ * QExternalScatterDataProxy wraps existing float buffers of item positions, and optionally
+ * item rotations, without copying them into a QtDataVisualization::QScatterDataArray.
+ * The graph reads the positions directly from the buffer whenever it updates its data,
+ * which avoids keeping a second copy of large data sets that are already in memory,
+ * for example in shared memory written by another process.
+ *
+ * Each item position is read as three consecutive floats for the x, y, and z values.
+ * Each item rotation is read as four consecutive floats for the scalar, x, y, and z values
+ * of a quaternion. The distance between consecutive items in bytes is given by the stride,
+ * which allows reading the values from interleaved buffers. Item values that color the items
+ * through the series gradient can be read from a separate buffer set with setValueBuffer().
+ *
+ * The proxy does not take ownership of the buffers. They must stay valid until another buffer
+ * is set or the proxy is destroyed. When the application changes the values in a buffer, it
+ * must call notifyItemsChanged() for the changed items, or call setBuffer() again for larger
+ * changes, so that the graph updates them. The buffers must not be modified from other
+ * threads while the graph is rendering.
+ *
+ * The functions inherited from QScatterDataProxy that modify the data array or the item
+ * values, such as addItems(), resetArray(), setCapacity(), and setItemValue(), cannot be used
+ * with this proxy. They print a warning and leave the data unchanged. array() always returns
+ * an empty array.
+ *
+ * itemAt() reads the item from the buffers into storage that is shared by all calls, so the
+ * returned pointer is valid only until the next call to itemAt(), and itemAt() must not be
+ * called from several threads at the same time.
+ *
+ * \sa {Qt Data Visualization Data Handling}
+ */
+
+/*!
+ * Constructs QExternalScatterDataProxy with the given \a parent.
+ */
+QExternalScatterDataProxy::QExternalScatterDataProxy(QObject *parent)
+    : QScatterDataProxy(new QExternalScatterDataProxyPrivate(this), parent)
+{
+}
+
+/*!
+ * Constructs QExternalScatterDataProxy with the given \a parent, reading \a count tightly
+ * packed item positions from \a positions.
+ */
+QExternalScatterDataProxy::QExternalScatterDataProxy(const float *positions, int count,
+                                                     QObject *parent)
+    : QScatterDataProxy(new QExternalScatterDataProxyPrivate(this), parent)
+{
+    dptr()->setBuffer(positions, count, 0, 0, 0);
+}
+
+/*!
+ * Deletes the external scatter data proxy. The buffers are not deleted.
+ */
+QExternalScatterDataProxy::~QExternalScatterDataProxy()
+{
+}
+
+/*!
+ * Sets the proxy to read \a count items from the buffer \a positions, with
+ * \a positionStride bytes between the positions of consecutive items. If the optional
+ * \a rotations buffer is given, item rotations are read from it with \a rotationStride
+ * bytes between consecutive items. A stride of \c 0 means that the values are tightly
+ * packed.
+ *
+ * Passing a null \a positions buffer or a non-positive \a count clears the data.
+ * Emits arrayReset().
+ */
+void QExternalScatterDataProxy::setBuffer(const float *positions, int count, int positionStride,
+                                          const float *rotations, int rotationStride)
+{
+    if (positionStride < 0 || rotationStride < 0) {
+        qWarning("Invalid stride. Stride cannot be negative.");
+        return;
+    }
+
+    dptr()->setBuffer(positions, count, positionStride, rotations, rotationStride);
+    emit arrayReset();
+    emit itemCountChanged(itemCount());
+}
+
+/*!
+ * Returns the buffer the item positions are read from.
+ */
+const float *QExternalScatterDataProxy::positions() const
+{
+    return dptrc()->m_positions;
+}
+
+/*!
+ * Returns the number of bytes between the positions of consecutive items.
+ */
+int QExternalScatterDataProxy::positionStride() const
+{
+    return dptrc()->m_positionStride;
+}
+
+/*!
+ * Returns the buffer the item rotations are read from, or null if the items
+ * are not rotated.
+ */
+const float *QExternalScatterDataProxy::rotations() const
+{
+    return dptrc()->m_rotations;
+}
+
+/*!
+ * Returns the number of bytes between the rotations of consecutive items.
+ */
+int QExternalScatterDataProxy::rotationStride() const
+{
+    return dptrc()->m_rotationStride;
+}
+
+/*!
+ * Sets the proxy to read the item values from the buffer \a values, with \a valueStride
+ * bytes between the values of consecutive items. A stride of \c 0 means that the values
+ * are tightly packed. The buffer must contain a value for each item of the current buffer
+ * and any buffer set later with setBuffer(). Passing a null buffer clears the item values.
+ * Emits arrayReset().
+ *
+ * \sa QScatterDataProxy::setItemValue()
+ */
+void QExternalScatterDataProxy::setValueBuffer(const float *values, int valueStride)
+{
+    if (valueStride < 0) {
+        qWarning("Invalid stride. Stride cannot be negative.");
+        return;
+    }
+
+    dptr()->m_values = values;
+    dptr()->m_valueStride = valueStride ? valueStride : int(sizeof(float));
+    emit arrayReset();
+}
+
+/*!
+ * Returns the buffer the item values are read from, or null if the items have no values.
+ */
+const float *QExternalScatterDataProxy::values() const
+{
+    return dptrc()->m_values;
+}
+
+/*!
+ * Returns the number of bytes between the values of consecutive items.
+ */
+int QExternalScatterDataProxy::valueStride() const
+{
+    return dptrc()->m_valueStride;
+}
+
+/*!
+ * Notifies the graph that the number of items specified by \a count starting at the
+ * position \a startIndex have changed in the buffers. Only the changed items are read
+ * again from the buffers. Emits itemsChanged().
+ */
+void QExternalScatterDataProxy::notifyItemsChanged(int startIndex, int count)
+{
+    const int itemCount = dptrc()->m_count;
+    if (startIndex < 0 || count < 0 || startIndex + count > itemCount) {
+        qWarning("Invalid range. The changed items must be within the buffer.");
+        return;
+    }
+
+    if (count)
+        emit itemsChanged(startIndex, count);
+}
+
+/*!
+ * \internal
+ */
+QExternalScatterDataProxyPrivate *QExternalScatterDataProxy::dptr()
+{
+    return static_cast<QExternalScatterDataProxyPrivate *>(d_ptr.data());
+}
+
+/*!
+ * \internal
+ */
+const QExternalScatterDataProxyPrivate *QExternalScatterDataProxy::dptrc() const
+{
+    return static_cast<const QExternalScatterDataProxyPrivate *>(d_ptr.data());
+}
+
+// QExternalScatterDataProxyPrivate
+
+QExternalScatterDataProxyPrivate::QExternalScatterDataProxyPrivate(QExternalScatterDataProxy *q)
+    : QScatterDataProxyPrivate(q),
+      m_positions(0),
+      m_positionStride(0),
+      m_rotations(0),
+      m_rotationStride(0),
+      m_values(0),
+      m_valueStride(int(sizeof(float))),
+      m_count(0)
+{
+}
+
+QExternalScatterDataProxyPrivate::~QExternalScatterDataProxyPrivate()
+{
+}
+
+void QExternalScatterDataProxyPrivate::setBuffer(const float *positions, int count,
+                                                 int positionStride, const float *rotations,
+                                                 int rotationStride)
+{
+    if (!positions || count <= 0) {
+        positions = 0;
+        rotations = 0;
+        count = 0;
+    }
+
+    m_positions = positions;
+    m_positionStride = positionStride ? positionStride : int(3 * sizeof(float));
+    m_rotations = rotations;
+    m_rotationStride = rotationStride ? rotationStride : int(4 * sizeof(float));
+    m_count = count;
+}
+
+ScatterDataView QExternalScatterDataProxyPrivate::dataView() const
+{
+    return ScatterDataView(m_positions, m_positionStride, m_rotations, m_rotationStride,
+                           m_count ? m_values : 0, m_valueStride, m_count);
+}
+
+const QScatterDataItem *QExternalScatterDataProxyPrivate::itemAt(int index) const
+{
+    const ScatterDataView data = dataView();
+    m_itemCache.setPosition(data.position(index));
+    m_itemCache.setRotation(data.rotation(index));
+    return &m_itemCache;
+}
+
+bool QExternalScatterDataProxyPrivate::isArrayModifiable() const
+{
+    qWarning("Invalid operation. The items of an external proxy can only be changed through "
+             "its buffers.");
+    return false;
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,72 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QEXTERNALSCATTERDATAPROXY_H
+#define QEXTERNALSCATTERDATAPROXY_H
+
+#include <QtDataVisualization/qscatterdataproxy.h>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+class QExternalScatterDataProxyPrivate;
+
+class QT_DATAVISUALIZATION_EXPORT QExternalScatterDataProxy : public QScatterDataProxy
+{
+    Q_OBJECT
+
+public:
+    explicit QExternalScatterDataProxy(QObject *parent = Q_NULLPTR);
+    explicit QExternalScatterDataProxy(const float *positions, int count,
+                                       QObject *parent = Q_NULLPTR);
+    virtual ~QExternalScatterDataProxy();
+
+    void setBuffer(const float *positions, int count, int positionStride = 0,
+                   const float *rotations = Q_NULLPTR, int rotationStride = 0);
+    const float *positions() const;
+    int positionStride() const;
+    const float *rotations() const;
+    int rotationStride() const;
+
+    void setValueBuffer(const float *values, int valueStride = 0);
+    const float *values() const;
+    int valueStride() const;
+
+    void notifyItemsChanged(int startIndex, int count);
+
+protected:
+    QExternalScatterDataProxyPrivate *dptr();
+    const QExternalScatterDataProxyPrivate *dptrc() const;
+
+private:
+    Q_DISABLE_COPY(QExternalScatterDataProxy)
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef QEXTERNALSCATTERDATAPROXY_P_H
+#define QEXTERNALSCATTERDATAPROXY_P_H
+
+#include "qexternalscatterdataproxy.h"
+#include "qscatterdataproxy_p.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+class QExternalScatterDataProxyPrivate : public QScatterDataProxyPrivate
+{
+    Q_OBJECT
+public:
+    QExternalScatterDataProxyPrivate(QExternalScatterDataProxy *q);
+    virtual ~QExternalScatterDataProxyPrivate();
+
+    void setBuffer(const float *positions, int count, int positionStride,
+                   const float *rotations, int rotationStride);
+
+    virtual ScatterDataView dataView() const;
+    virtual const QScatterDataItem *itemAt(int index) const;
+    virtual bool isArrayModifiable() const;
+
+private:
+    const float *m_positions; // Not owned
+    int m_positionStride;
+    const float *m_rotations; // Not owned
+    int m_rotationStride;
+    const float *m_values; // Not owned
+    int m_valueStride;
+    int m_count;
+    // Backs the pointer returned by itemAt(), which is valid only until the next itemAt() call
+    mutable QScatterDataItem m_itemCache;
+
+    friend class QExternalScatterDataProxy;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
@@ -28,6 +28,11 @@
 ****************************************************************************/
 
 #include "qheightmapsurfacedataproxy_p.h"
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QtEndian>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -35,6 +40,91 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 const float defaultMinValue = 0.0f;
 const float defaultMaxValue = 10.0f;
 
+// Height maps with fewer pixels than this are resolved in the GUI thread, as handing them to
+// a worker thread would only delay the data.
+const int backgroundResolveThreshold = 512 * 512;
+const int minRowsPerResolveBand = 32;
+// Number of progress updates emitted during a background resolve
+const int resolveProgressSteps = 100;
+
+// Resolves a band of height map rows in a thread pool thread.
+class HeightMapRowBandResolver : public QRunnable
+{
+public:
+    HeightMapRowBandResolver(QHeightMapSurfaceDataProxyPrivate *proxy, HeightMapResolveJob *job,
+                             QSurfaceDataRow **rows, int startRow, int endRow, QSemaphore *done)
+        : m_proxy(proxy),
+          m_job(job),
+          m_rows(rows),
+          m_startRow(startRow),
+          m_endRow(endRow),
+          m_done(done)
+    {
+    }
+
+    void run()
+    {
+        m_proxy->resolveRows(m_job, m_rows, m_startRow, m_endRow);
+        m_done->release();
+    }
+
+private:
+    QHeightMapSurfaceDataProxyPrivate *m_proxy;
+    HeightMapResolveJob *m_job;
+    QSurfaceDataRow **m_rows;
+    int m_startRow;
+    int m_endRow;
+    QSemaphore *m_done;
+};
+
+// Resolves a whole height map in a thread pool thread.
+class HeightMapResolver : public QRunnable
+{
+public:
+    HeightMapResolver(QHeightMapSurfaceDataProxyPrivate *proxy, const HeightMapResolveJob &job)
+        : m_proxy(proxy),
+          m_job(job)
+    {
+    }
+
+    void run()
+    {
+        m_proxy->resolveInBackground(&m_job);
+    }
+
+private:
+    QHeightMapSurfaceDataProxyPrivate *m_proxy;
+    HeightMapResolveJob m_job;
+};
+
+static void deleteArray(QSurfaceDataArray *dataArray)
+{
+    qDeleteAll(*dataArray);
+    delete dataArray;
+}
+
+static void prepareImageSource(HeightMapResolveJob *job)
+{
+    // Images in a directly readable format are read in place. Other images are converted to
+    // RGB32 to be sure we're reading the right bytes.
+    const QImage::Format format = job->heightMap.format();
+    if (format == QImage::Format_Grayscale8 || format == QImage::Format_RGB32
+            || format == QImage::Format_ARGB32) {
+        job->image = job->heightMap;
+    } else {
+        job->image = job->heightMap.convertToFormat(QImage::Format_RGB32);
+    }
+
+    if (format == QImage::Format_Grayscale8)
+        job->format = HeightMapResolveJob::SourceGray8;
+    else if (job->image.isGrayscale())
+        job->format = HeightMapResolveJob::SourceGrayRgb32;
+    else
+        job->format = HeightMapResolveJob::SourceRgb32;
+    job->data = job->image.constBits();
+    job->bytesPerLine = job->image.bytesPerLine();
+}
+
 /*!
  * \class QHeightMapSurfaceDataProxy
  * \inmodule QtDataVisualization
@@ -49,6 +139,14 @@ const float defaultMaxValue = 10.0f;
  * to image horizontal direction and Z-value to the vertical. Setting any of these
  * properties triggers asynchronous re-resolving of any existing height map.
  *
+ * Height maps with a higher precision than the 8-bit channels of images can be given as raw
+ * files of 16-bit integer or 32-bit floating point heights with setRawHeightMapFile(). Raw
+ * files are memory-mapped and read directly, without decoding or converting them first.
+ *
+ * Large height maps are resolved in a worker thread, so that the application stays
+ * responsive while the data is built. The data is replaced only when the whole height map has
+ * been resolved, and the progress of the resolve is reported by the resolveProgress property.
+ *
  * \sa QSurfaceDataProxy, {Qt Data Visualization Data Handling}
  */
 
@@ -126,6 +224,15 @@ const float defaultMaxValue = 10.0f;
  * to ensure that the range remains valid.
  */
 
+/*!
+ * \qmlproperty real HeightMapSurfaceDataProxy::resolveProgress
+ * \since QtDataVisualization 1.4
+ *
+ * The progress of resolving the current height map, from \c{0.0} to \c{1.0}.
+ * Large height maps are resolved in a worker thread, and the value grows as rows of the
+ * height map are resolved. The value is \c{1.0} when no resolve is in progress.
+ */
+
 /*!
  * Constructs QHeightMapSurfaceDataProxy with the given \a parent.
  */
@@ -193,19 +300,22 @@ QHeightMapSurfaceDataProxy::~QHeightMapSurfaceDataProxy()
  * The height of the \a image is read from the red component of the pixels if the \a image is in
  * grayscale, otherwise it is an average calculated from red, green, and blue components of the
  * pixels. Using grayscale images may improve data conversion speed for large images.
+ * Images in QImage::Format_Grayscale8, QImage::Format_RGB32, or QImage::Format_ARGB32 are read
+ * in place, without converting them first.
  *
  * Not recommended formats: all mono formats (for example QImage::Format_Mono).
  *
  * The height map is resolved asynchronously. QSurfaceDataProxy::arrayReset() is emitted when the
- * data has been resolved.
+ * data has been resolved. Large height maps are resolved in a worker thread, and setting
+ * a new height map while the previous one is being resolved cancels the previous resolve.
+ *
+ * \sa resolveProgress
  */
 void QHeightMapSurfaceDataProxy::setHeightMap(const QImage &image)
 {
+    dptr()->clearRawHeightMap();
     dptr()->m_heightMap = image;
-
-    // We do resolving asynchronously to make qml onArrayReset handlers actually get the initial reset
-    if (!dptr()->m_resolveTimer.isActive())
-        dptr()->m_resolveTimer.start(0);
+    dptr()->scheduleResolve();
 }
 
 QImage QHeightMapSurfaceDataProxy::heightMap() const
@@ -237,6 +347,49 @@ QString QHeightMapSurfaceDataProxy::heightMapFile() const
     return dptrc()->m_heightMapFile;
 }
 
+/*!
+ * \enum QHeightMapSurfaceDataProxy::RawDataType
+ * \since QtDataVisualization 1.4
+ *
+ * Type of the heights in a raw height map file.
+ *
+ * \value RawDataUInt16
+ *        Unsigned 16-bit integers.
+ * \value RawDataFloat32
+ *        32-bit floating point numbers.
+ *
+ * \sa setRawHeightMapFile()
+ */
+
+/*!
+ * \since QtDataVisualization 1.4
+ *
+ * Replaces current data with the heights in the raw height map file specified by
+ * \a filename. The file must contain a grid of \a columns times \a rows heights of
+ * \a dataType in little-endian byte order, without a header. Like the pixels of a height map
+ * image, the heights are stored row by row, starting from the row with the largest Z-values.
+ * Extra data after the grid is ignored.
+ *
+ * The file is memory-mapped, and the heights are read from it directly when the data is
+ * resolved, so the file must not be modified or removed while it is in use. The heights
+ * are used as they are, so for example the heights of RawDataUInt16 data range from \c{0}
+ * to \c{65535}.
+ *
+ * Returns \c true if the file was successfully mapped. Otherwise, returns \c false and leaves
+ * the current data unchanged.
+ *
+ * \sa heightMapFile, setHeightMap()
+ */
+bool QHeightMapSurfaceDataProxy::setRawHeightMapFile(const QString &filename, int columns,
+                                                     int rows, RawDataType dataType)
+{
+    if (!dptr()->setRawHeightMapFile(filename, columns, rows, dataType))
+        return false;
+
+    emit heightMapFileChanged(filename);
+    return true;
+}
+
 /*!
  * A convenience function for setting all minimum (\a minX and \a minZ) and maximum
  * (\a maxX and \a maxZ) values at the same time. The minimum values must be smaller than the
@@ -327,6 +480,26 @@ float QHeightMapSurfaceDataProxy::maxZValue() const
     return dptrc()->m_maxZValue;
 }
 
+/*!
+ * \property QHeightMapSurfaceDataProxy::resolveProgress
+ * \since QtDataVisualization 1.4
+ *
+ * \brief The progress of resolving the current height map.
+ *
+ * Height maps with a large number of pixels are resolved in a worker thread, where the rows
+ * of the height map are divided between the available processor cores. The value starts
+ * from \c{0.0} when a background resolve starts, and grows as the rows are resolved. When
+ * the resolved data has replaced the data of the proxy, the value is \c{1.0}.
+ *
+ * Smaller height maps are resolved at once, and the value stays at \c{1.0}.
+ *
+ * \sa heightMap
+ */
+float QHeightMapSurfaceDataProxy::resolveProgress() const
+{
+    return dptrc()->m_resolveProgress;
+}
+
 /*!
  * \internal
  */
@@ -347,6 +520,14 @@ const QHeightMapSurfaceDataProxyPrivate *QHeightMapSurfaceDataProxy::dptrc() con
 
 QHeightMapSurfaceDataProxyPrivate::QHeightMapSurfaceDataProxyPrivate(QHeightMapSurfaceDataProxy *q)
     : QSurfaceDataProxyPrivate(q),
+      m_rawData(0),
+      m_rawColumns(0),
+      m_rawRows(0),
+      m_rawDataType(QHeightMapSurfaceDataProxy::RawDataUInt16),
+      m_resolveProgress(1.0f),
+      m_backgroundResolveCount(0),
+      m_resolvedArray(0),
+      m_resolvedGeneration(0),
       m_minXValue(defaultMinValue),
       m_maxXValue(defaultMaxValue),
       m_minZValue(defaultMinValue),
@@ -355,10 +536,23 @@ QHeightMapSurfaceDataProxyPrivate::QHeightMapSurfaceDataProxyPrivate(QHeightMapS
     m_resolveTimer.setSingleShot(true);
     QObject::connect(&m_resolveTimer, &QTimer::timeout,
                      this, &QHeightMapSurfaceDataProxyPrivate::handlePendingResolve);
+    QObject::connect(this, &QHeightMapSurfaceDataProxyPrivate::resolveProgressed,
+                     this, &QHeightMapSurfaceDataProxyPrivate::handleResolveProgressed,
+                     Qt::QueuedConnection);
+    QObject::connect(this, &QHeightMapSurfaceDataProxyPrivate::resolveFinished,
+                     this, &QHeightMapSurfaceDataProxyPrivate::handleResolveFinished,
+                     Qt::QueuedConnection);
 }
 
 QHeightMapSurfaceDataProxyPrivate::~QHeightMapSurfaceDataProxyPrivate()
 {
+    // Background resolves refer to this object, so they must be finished before it goes away
+    m_resolveGeneration.ref();
+    QMutexLocker locker(&m_resolveMutex);
+    while (m_backgroundResolveCount)
+        m_resolveDone.wait(&m_resolveMutex);
+    if (m_resolvedArray)
+        deleteArray(m_resolvedArray);
 }
 
 QHeightMapSurfaceDataProxy *QHeightMapSurfaceDataProxyPrivate::qptr()
@@ -413,8 +607,8 @@ void QHeightMapSurfaceDataProxyPrivate::setValueRanges(float minX, float maxX,
     if (maxZChanged)
         emit qptr()->maxZValueChanged(m_maxZValue);
 
-    if ((minXChanged || minZChanged || maxXChanged || maxZChanged) && !m_resolveTimer.isActive())
-        m_resolveTimer.start(0);
+    if (minXChanged || minZChanged || maxXChanged || maxZChanged)
+        scheduleResolve();
 }
 
 void QHeightMapSurfaceDataProxyPrivate::setMinXValue(float min)
@@ -434,8 +628,7 @@ void QHeightMapSurfaceDataProxyPrivate::setMinXValue(float min)
         if (maxChanged)
             emit qptr()->maxXValueChanged(m_maxXValue);
 
-        if (!m_resolveTimer.isActive())
-            m_resolveTimer.start(0);
+        scheduleResolve();
     }
 }
 
@@ -456,8 +649,7 @@ void QHeightMapSurfaceDataProxyPrivate::setMaxXValue(float max)
         if (minChanged)
             emit qptr()->minXValueChanged(m_minXValue);
 
-        if (!m_resolveTimer.isActive())
-            m_resolveTimer.start(0);
+        scheduleResolve();
     }
 }
 
@@ -478,8 +670,7 @@ void QHeightMapSurfaceDataProxyPrivate::setMinZValue(float min)
         if (maxChanged)
             emit qptr()->maxZValueChanged(m_maxZValue);
 
-        if (!m_resolveTimer.isActive())
-            m_resolveTimer.start(0);
+        scheduleResolve();
     }
 }
 
@@ -500,40 +691,215 @@ void QHeightMapSurfaceDataProxyPrivate::setMaxZValue(float max)
         if (minChanged)
             emit qptr()->minZValueChanged(m_minZValue);
 
-        if (!m_resolveTimer.isActive())
-            m_resolveTimer.start(0);
+        scheduleResolve();
     }
 }
 
+bool QHeightMapSurfaceDataProxyPrivate::setRawHeightMapFile(
+        const QString &filename, int columns, int rows,
+        QHeightMapSurfaceDataProxy::RawDataType dataType)
+{
+    if (columns < 1 || rows < 1) {
+        qWarning("Invalid raw height map dimensions.");
+        return false;
+    }
+
+    qint64 itemSize = (dataType == QHeightMapSurfaceDataProxy::RawDataUInt16)
+            ? sizeof(quint16) : sizeof(float);
+    qint64 dataSize = qint64(columns) * qint64(rows) * itemSize;
+
+    QSharedPointer<QFile> file(new QFile(filename));
+    if (!file->open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open raw height map file" << filename;
+        return false;
+    }
+    if (file->size() < dataSize) {
+        qWarning() << "Raw height map file" << filename << "is too small for"
+                   << columns << "x" << rows << "heights";
+        return false;
+    }
+    // The mapping stays valid after the file is closed, until the QFile is destroyed
+    const uchar *data = file->map(0, dataSize);
+    file->close();
+    if (!data) {
+        qWarning() << "Could not map raw height map file" << filename;
+        return false;
+    }
+
+    m_heightMap = QImage();
+    m_heightMapFile = filename;
+    m_rawFile = file;
+    m_rawData = data;
+    m_rawColumns = columns;
+    m_rawRows = rows;
+    m_rawDataType = dataType;
+    scheduleResolve();
+    return true;
+}
+
+void QHeightMapSurfaceDataProxyPrivate::clearRawHeightMap()
+{
+    // A resolve that still reads the mapped file keeps it alive
+    m_rawFile.clear();
+    m_rawData = 0;
+    m_rawColumns = 0;
+    m_rawRows = 0;
+}
+
+void QHeightMapSurfaceDataProxyPrivate::scheduleResolve()
+{
+    // A resolve that is still running would publish outdated data, so it is cancelled
+    m_resolveGeneration.ref();
+
+    // We do resolving asynchronously to make qml onArrayReset handlers actually get the initial reset
+    if (!m_resolveTimer.isActive())
+        m_resolveTimer.start(0);
+}
+
 void QHeightMapSurfaceDataProxyPrivate::handlePendingResolve()
 {
-    QImage heightImage = m_heightMap;
+    HeightMapResolveJob job;
+    job.heightMap = m_heightMap;
+    job.rawFile = m_rawFile;
+    job.data = 0;
+    job.bytesPerLine = 0;
+    job.format = HeightMapResolveJob::SourceRgb32;
+    job.minXValue = m_minXValue;
+    job.maxXValue = m_maxXValue;
+    job.minZValue = m_minZValue;
+    job.maxZValue = m_maxZValue;
+    job.generation = m_resolveGeneration.load();
+
+    if (m_rawFile) {
+        // Raw height maps are read directly from the mapped file
+        job.data = m_rawData;
+        job.columns = m_rawColumns;
+        job.rows = m_rawRows;
+        if (m_rawDataType == QHeightMapSurfaceDataProxy::RawDataUInt16) {
+            job.format = HeightMapResolveJob::SourceRawUInt16;
+            job.bytesPerLine = m_rawColumns * int(sizeof(quint16));
+        } else {
+            job.format = HeightMapResolveJob::SourceRawFloat32;
+            job.bytesPerLine = m_rawColumns * int(sizeof(float));
+        }
+    } else {
+        job.columns = m_heightMap.width();
+        job.rows = m_heightMap.height();
+    }
+    job.background = qint64(job.columns) * job.rows >= backgroundResolveThreshold;
 
-    // Convert to RGB32 to be sure we're reading the right bytes
-    if (heightImage.format() != QImage::Format_RGB32)
-        heightImage = heightImage.convertToFormat(QImage::Format_RGB32);
+    if (job.background) {
+        QMutexLocker locker(&m_resolveMutex);
+        m_backgroundResolveCount++;
+        locker.unlock();
+
+        setResolveProgress(0.0f);
+        QThreadPool::globalInstance()->start(new HeightMapResolver(this, job));
+        return;
+    }
 
-    uchar *bits = heightImage.bits();
+    if (!job.data)
+        prepareImageSource(&job);
 
-    int imageHeight = heightImage.height();
-    int imageWidth = heightImage.width();
-    int bitCount = imageWidth * 4 * (imageHeight - 1);
-    int widthBits = imageWidth * 4;
-    float height = 0;
+    int imageHeight = job.rows;
+    int imageWidth = job.columns;
 
     // Do not recreate array if dimensions have not changed
     QSurfaceDataArray *dataArray = m_dataArray;
-    if (imageWidth != qptr()->columnCount() || imageHeight != dataArray->size()) {
+    QVector<QSurfaceDataRow *> rows(imageHeight);
+    if (imageWidth == qptr()->columnCount() && imageHeight == dataArray->size()) {
+        for (int i = 0; i < imageHeight; i++)
+            rows[i] = dataArray->at(i);
+    } else {
+        dataArray = 0;
+    }
+
+    resolveRows(&job, rows.data(), 0, imageHeight);
+
+    if (!dataArray) {
         dataArray = new QSurfaceDataArray;
         dataArray->reserve(imageHeight);
-        for (int i = 0; i < imageHeight; i++) {
-            QSurfaceDataRow *newProxyRow = new QSurfaceDataRow(imageWidth);
-            dataArray->append(newProxyRow);
+        foreach (QSurfaceDataRow *row, rows)
+            dataArray->append(row);
+    }
+
+    publishResolvedArray(dataArray, m_heightMap);
+}
+
+void QHeightMapSurfaceDataProxyPrivate::resolveInBackground(HeightMapResolveJob *job)
+{
+    QVector<QSurfaceDataRow *> rows;
+    int imageHeight = 0;
+
+    // The job may have been cancelled while it waited for a free thread
+    if (!isResolveCancelled(job)) {
+        if (!job->data)
+            prepareImageSource(job);
+
+        imageHeight = job->rows;
+        rows.resize(imageHeight);
+
+        int bandCount = qMin(QThread::idealThreadCount(), imageHeight / minRowsPerResolveBand);
+        if (bandCount <= 1) {
+            resolveRows(job, rows.data(), 0, imageHeight);
+        } else {
+            // Each band allocates and fills rows of its own. The first band is handled in this
+            // thread, as are the bands for which the pool has no free thread.
+            QThreadPool *pool = QThreadPool::globalInstance();
+            QSemaphore done;
+            int startedCount = 0;
+            const int bandSize = (imageHeight + bandCount - 1) / bandCount;
+            for (int startRow = bandSize; startRow < imageHeight; startRow += bandSize) {
+                const int endRow = qMin(startRow + bandSize, imageHeight);
+                HeightMapRowBandResolver *resolver = new HeightMapRowBandResolver(
+                            this, job, rows.data(), startRow, endRow, &done);
+                if (pool->tryStart(resolver)) {
+                    startedCount++;
+                } else {
+                    delete resolver;
+                    resolveRows(job, rows.data(), startRow, endRow);
+                }
+            }
+            resolveRows(job, rows.data(), 0, qMin(bandSize, imageHeight));
+            done.acquire(startedCount);
         }
     }
 
-    float xMul = (m_maxXValue - m_minXValue) / float(imageWidth - 1);
-    float zMul = (m_maxZValue - m_minZValue) / float(imageHeight - 1);
+    // Bands stop early when the job is cancelled, so the rows are complete only if the job was
+    // not cancelled after all the bands had finished.
+    QSurfaceDataArray *dataArray = 0;
+    if (isResolveCancelled(job)) {
+        qDeleteAll(rows);
+    } else {
+        dataArray = new QSurfaceDataArray;
+        dataArray->reserve(imageHeight);
+        foreach (QSurfaceDataRow *row, rows)
+            dataArray->append(row);
+    }
+
+    QMutexLocker locker(&m_resolveMutex);
+    if (dataArray) {
+        // The array replaces any earlier array that has not been published yet
+        if (m_resolvedArray)
+            deleteArray(m_resolvedArray);
+        m_resolvedArray = dataArray;
+        m_resolvedHeightMap = job->heightMap;
+        m_resolvedGeneration = job->generation;
+        emit resolveFinished();
+    }
+    m_backgroundResolveCount--;
+    m_resolveDone.wakeAll();
+}
+
+void QHeightMapSurfaceDataProxyPrivate::resolveRows(HeightMapResolveJob *job,
+                                                    QSurfaceDataRow **rows,
+                                                    int startRow, int endRow)
+{
+    int imageHeight = job->rows;
+    int imageWidth = job->columns;
+
+    float xMul = (job->maxXValue - job->minXValue) / float(imageWidth - 1);
+    float zMul = (job->maxZValue - job->minZValue) / float(imageHeight - 1);
 
     // Last row and column are explicitly set to max values, as relying
     // on multiplier can cause rounding errors, resulting in the value being
@@ -542,56 +908,113 @@ void QHeightMapSurfaceDataProxyPrivate::handlePendingResolve()
     int lastRow = imageHeight - 1;
     int lastCol = imageWidth - 1;
 
-    if (heightImage.isGrayscale()) {
-        // Grayscale, it's enough to read Red byte
-        for (int i = 0; i < imageHeight; i++, bitCount -= widthBits) {
-            QSurfaceDataRow &newRow = *dataArray->at(i);
-            float zVal;
-            if (i == lastRow)
-                zVal = m_maxZValue;
-            else
-                zVal = (float(i) * zMul) + m_minZValue;
-            int j = 0;
-            for (; j < lastCol; j++)
-                newRow[j].setPosition(QVector3D((float(j) * xMul) + m_minXValue,
-                                                float(bits[bitCount + (j * 4)]),
-                                      zVal));
-            newRow[j].setPosition(QVector3D(m_maxXValue,
-                                            float(bits[bitCount + (j * 4)]),
-                                  zVal));
+    const int progressStep = qMax(1, imageHeight / resolveProgressSteps);
+
+    for (int i = startRow; i < endRow; i++) {
+        if (job->background && isResolveCancelled(job))
+            return;
+
+        if (!rows[i])
+            rows[i] = new QSurfaceDataRow(imageWidth);
+        QSurfaceDataRow &newRow = *rows[i];
+
+        float zVal;
+        if (i == lastRow)
+            zVal = job->maxZValue;
+        else
+            zVal = (float(i) * zMul) + job->minZValue;
+        int j = 0;
+        for (; j < lastCol; j++)
+            newRow[j].setPosition(QVector3D((float(j) * xMul) + job->minXValue, 0.0f, zVal));
+        newRow[j].setPosition(QVector3D(job->maxXValue, 0.0f, zVal));
+
+        // Height data is stored from top to bottom, but the data rows go from bottom to top
+        const uchar *bits = job->data + qptrdiff(lastRow - i) * job->bytesPerLine;
+        switch (job->format) {
+        case HeightMapResolveJob::SourceRgb32: {
+            // Not grayscale, we'll need to calculate height from RGB
+            for (j = 0; j < imageWidth; j++) {
+                const uchar *pixel = bits + j * 4;
+                float height = float(pixel[0]) + float(pixel[1]) + float(pixel[2]);
+                newRow[j].setY(height / 3.0f);
+            }
+            break;
         }
-    } else {
-        // Not grayscale, we'll need to calculate height from RGB
-        for (int i = 0; i < imageHeight; i++, bitCount -= widthBits) {
-            QSurfaceDataRow &newRow = *dataArray->at(i);
-            float zVal;
-            if (i == lastRow)
-                zVal = m_maxZValue;
-            else
-                zVal = (float(i) * zMul) + m_minZValue;
-            int j = 0;
-            int nextpixel = 0;
-            for (; j < lastCol; j++) {
-                nextpixel = j * 4;
-                height = (float(bits[bitCount + nextpixel])
-                        + float(bits[1 + bitCount + nextpixel])
-                        + float(bits[2 + bitCount + nextpixel]));
-                newRow[j].setPosition(QVector3D((float(j) * xMul) + m_minXValue,
-                                                height / 3.0f,
-                                                zVal));
+        case HeightMapResolveJob::SourceGrayRgb32:
+            // Grayscale, it's enough to read Red byte
+            for (j = 0; j < imageWidth; j++)
+                newRow[j].setY(float(bits[j * 4]));
+            break;
+        case HeightMapResolveJob::SourceGray8:
+            for (j = 0; j < imageWidth; j++)
+                newRow[j].setY(float(bits[j]));
+            break;
+        case HeightMapResolveJob::SourceRawUInt16:
+            for (j = 0; j < imageWidth; j++)
+                newRow[j].setY(float(qFromLittleEndian<quint16>(bits + j * 2)));
+            break;
+        case HeightMapResolveJob::SourceRawFloat32:
+            for (j = 0; j < imageWidth; j++) {
+                quint32 value = qFromLittleEndian<quint32>(bits + j * 4);
+                float height;
+                memcpy(&height, &value, sizeof(height));
+                newRow[j].setY(height);
             }
-            nextpixel = j * 4;
-            height = (float(bits[bitCount + nextpixel])
-                    + float(bits[1 + bitCount + nextpixel])
-                    + float(bits[2 + bitCount + nextpixel]));
-            newRow[j].setPosition(QVector3D(m_maxXValue,
-                                            height / 3.0f,
-                                            zVal));
+            break;
         }
+
+        if (job->background) {
+            const int resolvedRows = job->resolvedRows.fetchAndAddRelaxed(1) + 1;
+            if (resolvedRows % progressStep == 0 && resolvedRows < imageHeight)
+                emit resolveProgressed(job->generation, float(resolvedRows) / float(imageHeight));
+        }
+    }
+}
+
+void QHeightMapSurfaceDataProxyPrivate::handleResolveProgressed(int generation, float progress)
+{
+    // Progress of cancelled resolves may still be in the event queue, and the bands may report
+    // their progress out of order
+    if (generation == m_resolveGeneration.load() && progress > m_resolveProgress)
+        setResolveProgress(progress);
+}
+
+void QHeightMapSurfaceDataProxyPrivate::handleResolveFinished()
+{
+    QMutexLocker locker(&m_resolveMutex);
+    QSurfaceDataArray *dataArray = m_resolvedArray;
+    QImage heightMap = m_resolvedHeightMap;
+    int generation = m_resolvedGeneration;
+    m_resolvedArray = 0;
+    m_resolvedHeightMap = QImage();
+    locker.unlock();
+
+    if (!dataArray)
+        return;
+
+    // The height map or the ranges may have changed after the resolve finished
+    if (generation != m_resolveGeneration.load()) {
+        deleteArray(dataArray);
+        return;
     }
 
+    publishResolvedArray(dataArray, heightMap);
+}
+
+void QHeightMapSurfaceDataProxyPrivate::publishResolvedArray(QSurfaceDataArray *dataArray,
+                                                             const QImage &heightMap)
+{
     qptr()->resetArray(dataArray);
-    emit qptr()->heightMapChanged(m_heightMap);
+    setResolveProgress(1.0f);
+    emit qptr()->heightMapChanged(heightMap);
+}
+
+void QHeightMapSurfaceDataProxyPrivate::setResolveProgress(float progress)
+{
+    if (m_resolveProgress != progress) {
+        m_resolveProgress = progress;
+        emit qptr()->resolveProgressChanged(progress);
+    }
 }
 
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -41,6 +41,7 @@ class QHeightMapSurfaceDataProxyPrivate;
 class QT_DATAVISUALIZATION_EXPORT QHeightMapSurfaceDataProxy : public QSurfaceDataProxy
 {
     Q_OBJECT
+    Q_ENUMS(RawDataType)
 
     Q_PROPERTY(QImage heightMap READ heightMap WRITE setHeightMap NOTIFY heightMapChanged)
     Q_PROPERTY(QString heightMapFile READ heightMapFile WRITE setHeightMapFile NOTIFY heightMapFileChanged)
@@ -48,8 +49,14 @@ class QT_DATAVISUALIZATION_EXPORT QHeightMapSurfaceDataProxy : public QSurfaceDa
     Q_PROPERTY(float maxXValue READ maxXValue WRITE setMaxXValue NOTIFY maxXValueChanged)
     Q_PROPERTY(float minZValue READ minZValue WRITE setMinZValue NOTIFY minZValueChanged)
     Q_PROPERTY(float maxZValue READ maxZValue WRITE setMaxZValue NOTIFY maxZValueChanged)
+    Q_PROPERTY(float resolveProgress READ resolveProgress NOTIFY resolveProgressChanged REVISION 1)
 
 public:
+    enum RawDataType {
+        RawDataUInt16 = 0,
+        RawDataFloat32
+    };
+
     explicit QHeightMapSurfaceDataProxy(QObject *parent = Q_NULLPTR);
     explicit QHeightMapSurfaceDataProxy(const QImage &image, QObject *parent = Q_NULLPTR);
     explicit QHeightMapSurfaceDataProxy(const QString &filename, QObject *parent = Q_NULLPTR);
@@ -59,6 +66,8 @@ public:
     QImage heightMap() const;
     void setHeightMapFile(const QString &filename);
     QString heightMapFile() const;
+    bool setRawHeightMapFile(const QString &filename, int columns, int rows,
+                             RawDataType dataType);
 
     void setValueRanges(float minX, float maxX, float minZ, float maxZ);
     void setMinXValue(float min);
@@ -70,6 +79,8 @@ public:
     void setMaxZValue(float max);
     float maxZValue() const;
 
+    float resolveProgress() const;
+
 Q_SIGNALS:
     void heightMapChanged(const QImage &image);
     void heightMapFileChanged(const QString &filename);
@@ -77,6 +88,7 @@ Q_SIGNALS:
     void maxXValueChanged(float value);
     void minZValueChanged(float value);
     void maxZValueChanged(float value);
+    Q_REVISION(1) void resolveProgressChanged(float progress);
 
 protected:
     explicit QHeightMapSurfaceDataProxy(QHeightMapSurfaceDataProxyPrivate *d, QObject *parent = Q_NULLPTR);
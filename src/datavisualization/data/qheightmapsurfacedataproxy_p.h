@@ -43,9 +43,44 @@
 #include "qheightmapsurfacedataproxy.h"
 #include "qsurfacedataproxy_p.h"
 #include <QtCore/QTimer>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QWaitCondition>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+// Height map and value ranges that a resolve reads. A resolve is cancelled when the height map
+// or the ranges change while it runs, which is detected from the generation.
+struct HeightMapResolveJob
+{
+    // Layout of the height data that the rows are resolved from
+    enum SourceFormat {
+        SourceRgb32,
+        SourceGrayRgb32, // Grayscale pixels in a 32-bit format, read from a single channel
+        SourceGray8,
+        SourceRawUInt16,
+        SourceRawFloat32
+    };
+
+    QImage heightMap;
+    QImage image; // heightMap in a directly readable format
+    QSharedPointer<QFile> rawFile; // Keeps a mapped raw height map alive while it is read
+    const uchar *data; // Top row of the height data, which is the last row of the surface
+    int bytesPerLine;
+    int columns;
+    int rows;
+    SourceFormat format;
+    float minXValue;
+    float maxXValue;
+    float minZValue;
+    float maxZValue;
+    int generation;
+    bool background;
+    QAtomicInt resolvedRows;
+};
+
 class QHeightMapSurfaceDataProxyPrivate : public QSurfaceDataProxyPrivate
 {
     Q_OBJECT
@@ -59,13 +94,49 @@ public:
     void setMaxXValue(float max);
     void setMinZValue(float min);
     void setMaxZValue(float max);
+    bool setRawHeightMapFile(const QString &filename, int columns, int rows,
+                             QHeightMapSurfaceDataProxy::RawDataType dataType);
+    void clearRawHeightMap();
+
+    void resolveInBackground(HeightMapResolveJob *job);
+    void resolveRows(HeightMapResolveJob *job, QSurfaceDataRow **rows, int startRow, int endRow);
+
+Q_SIGNALS:
+    // Emitted from the threads of a background resolve
+    void resolveProgressed(int generation, float progress);
+    void resolveFinished();
+
 private:
     QHeightMapSurfaceDataProxy *qptr();
+    void scheduleResolve();
+    inline bool isResolveCancelled(const HeightMapResolveJob *job) const
+    {
+        return m_resolveGeneration.load() != job->generation;
+    }
     void handlePendingResolve();
+    void handleResolveProgressed(int generation, float progress);
+    void handleResolveFinished();
+    void publishResolvedArray(QSurfaceDataArray *dataArray, const QImage &heightMap);
+    void setResolveProgress(float progress);
 
     QImage m_heightMap;
     QString m_heightMapFile;
+    QSharedPointer<QFile> m_rawFile;
+    const uchar *m_rawData;
+    int m_rawColumns;
+    int m_rawRows;
+    QHeightMapSurfaceDataProxy::RawDataType m_rawDataType;
     QTimer m_resolveTimer;
+    QAtomicInt m_resolveGeneration;
+    float m_resolveProgress;
+
+    // Guarded by m_resolveMutex, as background resolves hand them over from other threads
+    QMutex m_resolveMutex;
+    QWaitCondition m_resolveDone;
+    int m_backgroundResolveCount;
+    QSurfaceDataArray *m_resolvedArray;
+    QImage m_resolvedHeightMap;
+    int m_resolvedGeneration;
 
     float m_minXValue;
     float m_maxXValue;
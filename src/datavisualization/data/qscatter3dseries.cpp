@@ -124,6 +124,21 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * The preset default is \c 0.0.
  */
 
+/*!
+ * \qmlproperty bool Scatter3DSeries::levelOfDetailEnabled
+ * \since QtDataVisualization 1.4
+ *
+ * Defines whether the series is drawn using a decimated subset of its items when the
+ * items would overlap on screen. The subset is chosen based on the viewport size and
+ * the camera zoom level, and all items are drawn again when the graph is zoomed in
+ * far enough. Selection is only possible for the items that are drawn.
+ * The preset default is \c false.
+ *
+ * \note Level of detail does not affect series that use a mesh other than
+ * \c Abstract3DSeries.MeshPoint when the graph's optimizationHints property
+ * is set to \c AbstractGraph3D.OptimizationStatic.
+ */
+
 /*!
  * \qmlproperty int Scatter3DSeries::invalidSelectionIndex
  * A constant property providing an invalid index for selection. This index is
@@ -249,6 +264,38 @@ float QScatter3DSeries::itemSize() const
     return dptrc()->m_itemSize;
 }
 
+/*!
+ * \property QScatter3DSeries::levelOfDetailEnabled
+ * \since QtDataVisualization 1.4
+ *
+ * \brief Whether the series is drawn at a reduced level of detail when its
+ * items would overlap on screen.
+ *
+ * When enabled, the series precomputes a hierarchy of progressively denser subsets of its
+ * items, where each subset covers the data area with roughly evenly spaced items. The
+ * subset to draw is chosen on each frame based on the viewport size and the camera zoom
+ * level, and all items are drawn again when the graph is zoomed in far enough.
+ * Selection is only possible for the items that are drawn.
+ *
+ * The preset default is \c false.
+ *
+ * \note Level of detail does not affect series that use a mesh other than
+ * QAbstract3DSeries::MeshPoint when the graph's optimization hints are set to
+ * QAbstract3DGraph::OptimizationStatic.
+ */
+void QScatter3DSeries::setLevelOfDetailEnabled(bool enabled)
+{
+    if (enabled != dptr()->m_levelOfDetailEnabled) {
+        dptr()->setLevelOfDetailEnabled(enabled);
+        emit levelOfDetailEnabledChanged(enabled);
+    }
+}
+
+bool QScatter3DSeries::isLevelOfDetailEnabled() const
+{
+    return dptrc()->m_levelOfDetailEnabled;
+}
+
 /*!
  * Returns an invalid index for selection. This index is set to the selectedItem
  * property to clear the selection from this series.
@@ -281,7 +328,8 @@ const QScatter3DSeriesPrivate *QScatter3DSeries::dptrc() const
 QScatter3DSeriesPrivate::QScatter3DSeriesPrivate(QScatter3DSeries *q)
     : QAbstract3DSeriesPrivate(q, QAbstract3DSeries::SeriesTypeScatter),
       m_selectedItem(Scatter3DController::invalidSelectionIndex()),
-      m_itemSize(0.0f)
+      m_itemSize(0.0f),
+      m_levelOfDetailEnabled(false)
 {
     m_itemLabelFormat = QStringLiteral("@xLabel, @yLabel, @zLabel");
     m_mesh = QAbstract3DSeries::MeshSphere;
@@ -392,4 +440,11 @@ void QScatter3DSeriesPrivate::setItemSize(float size)
         m_controller->markSeriesVisualsDirty();
 }
 
+void QScatter3DSeriesPrivate::setLevelOfDetailEnabled(bool enabled)
+{
+    m_levelOfDetailEnabled = enabled;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -43,6 +43,7 @@ class QT_DATAVISUALIZATION_EXPORT QScatter3DSeries : public QAbstract3DSeries
     Q_PROPERTY(QScatterDataProxy *dataProxy READ dataProxy WRITE setDataProxy NOTIFY dataProxyChanged)
     Q_PROPERTY(int selectedItem READ selectedItem WRITE setSelectedItem NOTIFY selectedItemChanged)
     Q_PROPERTY(float itemSize READ itemSize WRITE setItemSize NOTIFY itemSizeChanged)
+    Q_PROPERTY(bool levelOfDetailEnabled READ isLevelOfDetailEnabled WRITE setLevelOfDetailEnabled NOTIFY levelOfDetailEnabledChanged REVISION 1)
 
 public:
     explicit QScatter3DSeries(QObject *parent = Q_NULLPTR);
@@ -59,10 +60,14 @@ public:
     void setItemSize(float size);
     float itemSize() const;
 
+    void setLevelOfDetailEnabled(bool enabled);
+    bool isLevelOfDetailEnabled() const;
+
 Q_SIGNALS:
     void dataProxyChanged(QScatterDataProxy *proxy);
     void selectedItemChanged(int index);
     void itemSizeChanged(float size);
+    Q_REVISION(1) void levelOfDetailEnabledChanged(bool enabled);
 
 protected:
     explicit QScatter3DSeries(QScatter3DSeriesPrivate *d, QObject *parent = Q_NULLPTR);
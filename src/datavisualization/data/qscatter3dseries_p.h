@@ -58,11 +58,13 @@ public:
 
     void setSelectedItem(int index);
     void setItemSize(float size);
+    void setLevelOfDetailEnabled(bool enabled);
 
 private:
     QScatter3DSeries *qptr();
     int m_selectedItem;
     float m_itemSize;
+    bool m_levelOfDetailEnabled;
 
 private:
     friend class QScatter3DSeries;
@@ -31,6 +31,8 @@
 #include "qscatter3dseries_p.h"
 #include "qabstract3daxis_p.h"
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
 /*!
@@ -46,6 +48,11 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * QtDataVisualization::QScatterDataArray and QScatterDataItem objects passed to
  * it.
  *
+ * The number of items can be bounded by setting the \l capacity property, which turns
+ * the data array into a ring buffer for streamed data. Once the array is full, added items
+ * overwrite the oldest items in place instead of growing the array, so that only the
+ * overwritten items need to be updated on the graph.
+ *
  * \sa {Qt Data Visualization Data Handling}
  */
 
@@ -83,6 +90,19 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * The series this proxy is attached to.
  */
 
+/*!
+ * \qmlproperty int ScatterDataProxy::capacity
+ * \since QtDataVisualization 1.4
+ *
+ * The maximum number of items in the array. When the array is full, added items
+ * overwrite the oldest items in place instead of being appended.
+ * If the capacity is set smaller than the current number of items, the oldest items
+ * are removed. The value \c 0 means that the number of items is not limited.
+ * Defaults to \c 0.
+ *
+ * For details, see QScatterDataProxy::capacity.
+ */
+
 /*!
  * Constructs QScatterDataProxy with the given \a parent.
  */
@@ -117,16 +137,59 @@ QScatter3DSeries *QScatterDataProxy::series() const
 }
 
 /*!
- * Takes ownership of the array \a newArray. Clears the existing array if the
- * new array differs from it. If the arrays are the same, this function
- * just triggers the arrayReset() signal.
+ * Takes ownership of the array \a newArray. Clears the existing array and
+ * the item values if the new array differs from it. If the arrays are the same,
+ * this function just triggers the arrayReset() signal.
  *
  * Passing a null array deletes the old array and creates a new empty array.
+ *
+ * If \l capacity is set and the new array has more items than it allows, the
+ * items at the start of the new array are removed.
  */
 void QScatterDataProxy::resetArray(QScatterDataArray *newArray)
 {
+    if (!dptr()->isArrayModifiable()) {
+        // The array is owned by the proxy even if it is not used
+        if (dptr()->m_dataArray != newArray)
+            delete newArray;
+        return;
+    }
+
+    if (dptr()->m_dataArray != newArray)
+        dptr()->resetArray(newArray);
+
+    emit arrayReset();
+    emit itemCountChanged(itemCount());
+}
+
+/*!
+ * \overload
+ * \since QtDataVisualization 1.4
+ *
+ * Takes ownership of the array \a newArray and sets \a values as the item values of
+ * the new items. The number of values must match the number of items in the new array.
+ * Passing an empty \a values clears the item values.
+ *
+ * \sa setItemValues()
+ */
+void QScatterDataProxy::resetArray(QScatterDataArray *newArray, const QVector<float> &values)
+{
+    if (!dptr()->isArrayModifiable()) {
+        // The array is owned by the proxy even if it is not used
+        if (dptr()->m_dataArray != newArray)
+            delete newArray;
+        return;
+    }
+
+    const int newItemCount = newArray ? newArray->size() : 0;
+    if (!values.isEmpty() && values.size() != newItemCount) {
+        qWarning("Invalid values. The number of values must match the number of items.");
+        return;
+    }
+
     if (dptr()->m_dataArray != newArray)
         dptr()->resetArray(newArray);
+    dptr()->resetValues(values);
 
     emit arrayReset();
     emit itemCountChanged(itemCount());
@@ -137,6 +200,9 @@ void QScatterDataProxy::resetArray(QScatterDataArray *newArray)
  */
 void QScatterDataProxy::setItem(int index, const QScatterDataItem &item)
 {
+    if (!dptr()->isArrayModifiable())
+        return;
+
     dptr()->setItem(index, item);
     emit itemsChanged(index, 1);
 }
@@ -147,17 +213,37 @@ void QScatterDataProxy::setItem(int index, const QScatterDataItem &item)
  */
 void QScatterDataProxy::setItems(int index, const QScatterDataArray &items)
 {
+    if (!dptr()->isArrayModifiable())
+        return;
+
     dptr()->setItems(index, items);
     emit itemsChanged(index, items.size());
 }
 
 /*!
- * Adds the item \a item to the end of the array.
+ * Adds the item \a item to the end of the array. If \l capacity is set and
+ * the array is full, the item overwrites the oldest item instead.
  *
  * Returns the index of the added item.
  */
 int QScatterDataProxy::addItem(const QScatterDataItem &item)
 {
+    if (!dptr()->isArrayModifiable())
+        return -1;
+
+    if (dptr()->m_capacity > 0) {
+        const int oldCount = itemCount();
+        QVarLengthArray<QPair<int, int>, 2> changedSpans;
+        int addIndex = dptr()->addItemsToRingBuffer(&item, 1, changedSpans);
+        if (itemCount() != oldCount)
+            emit itemsAdded(oldCount, itemCount() - oldCount);
+        for (int i = 0; i < changedSpans.size(); i++)
+            emit itemsChanged(changedSpans.at(i).first, changedSpans.at(i).second);
+        if (itemCount() != oldCount)
+            emit itemCountChanged(itemCount());
+        return addIndex;
+    }
+
     int addIndex = dptr()->addItem(item);
     emit itemsAdded(addIndex, 1);
     emit itemCountChanged(itemCount());
@@ -165,12 +251,29 @@ int QScatterDataProxy::addItem(const QScatterDataItem &item)
 }
 
 /*!
- * Adds the items specified by \a items to the end of the array.
+ * Adds the items specified by \a items to the end of the array. If \l capacity
+ * is set, the items that do not fit in the array overwrite the oldest items instead.
  *
  * Returns the index of the first added item.
  */
 int QScatterDataProxy::addItems(const QScatterDataArray &items)
 {
+    if (!dptr()->isArrayModifiable())
+        return -1;
+
+    if (dptr()->m_capacity > 0) {
+        const int oldCount = itemCount();
+        QVarLengthArray<QPair<int, int>, 2> changedSpans;
+        int addIndex = dptr()->addItemsToRingBuffer(items.constData(), items.size(), changedSpans);
+        if (itemCount() != oldCount)
+            emit itemsAdded(oldCount, itemCount() - oldCount);
+        for (int i = 0; i < changedSpans.size(); i++)
+            emit itemsChanged(changedSpans.at(i).first, changedSpans.at(i).second);
+        if (itemCount() != oldCount)
+            emit itemCountChanged(itemCount());
+        return addIndex;
+    }
+
     int addIndex = dptr()->addItems(items);
     emit itemsAdded(addIndex, items.size());
     emit itemCountChanged(itemCount());
@@ -180,22 +283,40 @@ int QScatterDataProxy::addItems(const QScatterDataArray &items)
 /*!
  * Inserts the item \a item to the position \a index. If the index is equal to
  * the data array size, the item is added to the array.
+ *
+ * If \l capacity is set, the array is considered to be in chronological order after
+ * the insertion, and the items at the start of the array are removed if it is over capacity.
  */
 void QScatterDataProxy::insertItem(int index, const QScatterDataItem &item)
 {
+    if (!dptr()->isArrayModifiable())
+        return;
+
     dptr()->insertItem(index, item);
     emit itemsInserted(index, 1);
+    int trimCount = dptr()->trimToCapacity();
+    if (trimCount)
+        emit itemsRemoved(0, trimCount);
     emit itemCountChanged(itemCount());
 }
 
 /*!
  * Inserts the items specified by \a items to the position \a index. If the
  * index is equal to data array size, the items are added to the array.
+ *
+ * If \l capacity is set, the array is considered to be in chronological order after
+ * the insertion, and the items at the start of the array are removed if it is over capacity.
  */
 void QScatterDataProxy::insertItems(int index, const QScatterDataArray &items)
 {
+    if (!dptr()->isArrayModifiable())
+        return;
+
     dptr()->insertItems(index, items);
     emit itemsInserted(index, items.size());
+    int trimCount = dptr()->trimToCapacity();
+    if (trimCount)
+        emit itemsRemoved(0, trimCount);
     emit itemCountChanged(itemCount());
 }
 
@@ -203,9 +324,15 @@ void QScatterDataProxy::insertItems(int index, const QScatterDataArray &items)
  * Removes the number of items specified by \a removeCount starting at the
  * position \a index. Attempting to remove items past the end of
  * the array does nothing.
+ *
+ * If \l capacity is set, the array is considered to be in chronological order after
+ * the removal.
  */
 void QScatterDataProxy::removeItems(int index, int removeCount)
 {
+    if (!dptr()->isArrayModifiable())
+        return;
+
     if (index >= dptr()->m_dataArray->size())
         return;
 
@@ -214,6 +341,120 @@ void QScatterDataProxy::removeItems(int index, int removeCount)
     emit itemCountChanged(itemCount());
 }
 
+/*!
+ * \property QScatterDataProxy::capacity
+ * \since QtDataVisualization 1.4
+ *
+ * \brief The maximum number of items in the array.
+ *
+ * When the capacity is set, the array works as a ring buffer. Items added with addItem() or
+ * addItems() are appended until the array is full, after which they overwrite the oldest
+ * items in place and itemsChanged() is emitted for the overwritten items instead of
+ * itemsAdded(). The graph then only needs to update the overwritten items, so the cost of
+ * adding items does not depend on the size of the array. The index order of the items no
+ * longer matches the order they were added in once the oldest items have been overwritten.
+ *
+ * If the capacity is set smaller than the current number of items, the oldest items are
+ * removed. The value \c 0 means that the number of items is not limited.
+ *
+ * Defaults to \c 0.
+ *
+ * \note Axes that adjust their ranges automatically scan all the items whenever items
+ * change. Use fixed axis ranges to keep the cost of streamed data proportional to the
+ * number of added items.
+ */
+void QScatterDataProxy::setCapacity(int capacity)
+{
+    if (!dptr()->isArrayModifiable())
+        return;
+
+    if (capacity < 0) {
+        qWarning("Invalid capacity. Capacity cannot be negative.");
+    } else if (capacity != dptr()->m_capacity) {
+        const int oldOldestIndex = dptr()->m_oldestIndex;
+        const int oldItemCount = itemCount();
+        dptr()->setCapacity(capacity);
+        emit capacityChanged(capacity);
+        if (oldOldestIndex || oldItemCount != itemCount()) {
+            emit arrayReset();
+            emit itemCountChanged(itemCount());
+        }
+    }
+}
+
+int QScatterDataProxy::capacity() const
+{
+    return dptrc()->m_capacity;
+}
+
+/*!
+ * \since QtDataVisualization 1.4
+ *
+ * Sets the value of the item at the position \a index to \a value.
+ *
+ * Item values color the items of a series individually. When the color style of the series
+ * is Q3DTheme::ColorStyleRangeGradient, each item is colored by the position of its value in
+ * the base gradient of the series, instead of by its Y-coordinate. The value \c 0 maps to
+ * the start and \c 1 to the end of the gradient, and values outside this range are clamped.
+ * This allows coloring a large classified data set with a single series.
+ *
+ * The proxy has no item values until the first value is set, after which all items have a
+ * value. Added and inserted items get the value \c 0, and replacing items with setItem() or
+ * setItems() does not change their values. resetArray() with a different array clears the
+ * item values.
+ *
+ * \sa setItemValues(), hasItemValues(), QAbstract3DSeries::baseGradient
+ */
+void QScatterDataProxy::setItemValue(int index, float value)
+{
+    if (!dptr()->isArrayModifiable())
+        return;
+
+    dptr()->setItemValues(index, &value, 1);
+    emit itemsChanged(index, 1);
+}
+
+/*!
+ * \since QtDataVisualization 1.4
+ *
+ * Sets the values of the items starting from the position \a index to \a values.
+ *
+ * \sa setItemValue()
+ */
+void QScatterDataProxy::setItemValues(int index, const QVector<float> &values)
+{
+    if (!dptr()->isArrayModifiable())
+        return;
+
+    dptr()->setItemValues(index, values.constData(), values.size());
+    emit itemsChanged(index, values.size());
+}
+
+/*!
+ * \since QtDataVisualization 1.4
+ *
+ * Returns the value of the item at the position \a index, or \c 0 if the proxy has no
+ * item values.
+ *
+ * \sa setItemValue()
+ */
+float QScatterDataProxy::itemValue(int index) const
+{
+    return dptrc()->dataView().value(index);
+}
+
+/*!
+ * \since QtDataVisualization 1.4
+ *
+ * Returns \c true if the items have values.
+ *
+ * \sa setItemValue()
+ */
+bool QScatterDataProxy::hasItemValues() const
+{
+    return dptrc()->dataView().hasValues();
+}
+
 /*!
  * \property QScatterDataProxy::itemCount
  *
@@ -221,7 +462,7 @@ void QScatterDataProxy::removeItems(int index, int removeCount)
  */
 int QScatterDataProxy::itemCount() const
 {
-    return dptrc()->m_dataArray->size();
+    return dptrc()->dataView().size();
 }
 
 /*!
@@ -235,10 +476,13 @@ const QScatterDataArray *QScatterDataProxy::array() const
 /*!
  * Returns the pointer to the item at the index \a index. It is guaranteed to be
  * valid only until the next call that modifies data.
+ *
+ * \note With QExternalScatterDataProxy, the item is read from the buffers into storage
+ * shared by all calls, so the pointer is valid only until the next call to this function.
  */
 const QScatterDataItem *QScatterDataProxy::itemAt(int index) const
 {
-    return &dptrc()->m_dataArray->at(index);
+    return dptrc()->itemAt(index);
 }
 
 /*!
@@ -306,7 +550,9 @@ const QScatterDataProxyPrivate *QScatterDataProxy::dptrc() const
 
 QScatterDataProxyPrivate::QScatterDataProxyPrivate(QScatterDataProxy *q)
     : QAbstractDataProxyPrivate(q, QAbstractDataProxy::DataTypeScatter),
-      m_dataArray(new QScatterDataArray)
+      m_dataArray(new QScatterDataArray),
+      m_capacity(0),
+      m_oldestIndex(0)
 {
 }
 
@@ -325,9 +571,31 @@ void QScatterDataProxyPrivate::resetArray(QScatterDataArray *newArray)
         m_dataArray->clear();
         delete m_dataArray;
         m_dataArray = newArray;
+        m_valueArray.clear();
+        m_oldestIndex = 0;
+        trimToCapacity();
     }
 }
 
+void QScatterDataProxyPrivate::resetValues(const QVector<float> &values)
+{
+    // Values of the items trimmed to capacity are dropped along with the items
+    const int trimCount = values.size() - m_dataArray->size();
+    if (trimCount > 0)
+        m_valueArray = values.mid(trimCount);
+    else
+        m_valueArray = values;
+}
+
+void QScatterDataProxyPrivate::setItemValues(int index, const float *values, int count)
+{
+    Q_ASSERT(index >= 0 && (index + count) <= m_dataArray->size());
+    if (m_valueArray.isEmpty())
+        m_valueArray.fill(0.0f, m_dataArray->size());
+    for (int i = 0; i < count; i++)
+        m_valueArray[index++] = values[i];
+}
+
 void QScatterDataProxyPrivate::setItem(int index, const QScatterDataItem &item)
 {
     Q_ASSERT(index >= 0 && index < m_dataArray->size());
@@ -345,6 +613,8 @@ int QScatterDataProxyPrivate::addItem(const QScatterDataItem &item)
 {
     int currentSize = m_dataArray->size();
     m_dataArray->append(item);
+    if (!m_valueArray.isEmpty())
+        m_valueArray.append(0.0f);
     return currentSize;
 }
 
@@ -352,6 +622,8 @@ int QScatterDataProxyPrivate::addItems(const QScatterDataArray &items)
 {
     int currentSize = m_dataArray->size();
     (*m_dataArray) += items;
+    if (!m_valueArray.isEmpty())
+        m_valueArray.resize(m_dataArray->size());
     return currentSize;
 }
 
@@ -359,13 +631,19 @@ void QScatterDataProxyPrivate::insertItem(int index, const QScatterDataItem &ite
 {
     Q_ASSERT(index >= 0 && index <= m_dataArray->size());
     m_dataArray->insert(index, item);
+    if (!m_valueArray.isEmpty())
+        m_valueArray.insert(index, 0.0f);
+    m_oldestIndex = 0;
 }
 
 void QScatterDataProxyPrivate::insertItems(int index, const QScatterDataArray &items)
 {
     Q_ASSERT(index >= 0 && index <= m_dataArray->size());
+    if (!m_valueArray.isEmpty())
+        m_valueArray.insert(index, items.size(), 0.0f);
     for (int i = 0; i < items.size(); i++)
         m_dataArray->insert(index++, items.at(i));
+    m_oldestIndex = 0;
 }
 
 void QScatterDataProxyPrivate::removeItems(int index, int removeCount)
@@ -374,16 +652,102 @@ void QScatterDataProxyPrivate::removeItems(int index, int removeCount)
     int maxRemoveCount = m_dataArray->size() - index;
     removeCount = qMin(removeCount, maxRemoveCount);
     m_dataArray->remove(index, removeCount);
+    if (!m_valueArray.isEmpty())
+        m_valueArray.remove(index, removeCount);
+    m_oldestIndex = 0;
+}
+
+void QScatterDataProxyPrivate::setCapacity(int capacity)
+{
+    // Put the items back to chronological order before dropping the oldest ones
+    if (m_oldestIndex) {
+        std::rotate(m_dataArray->begin(), m_dataArray->begin() + m_oldestIndex,
+                    m_dataArray->end());
+        if (!m_valueArray.isEmpty()) {
+            std::rotate(m_valueArray.begin(), m_valueArray.begin() + m_oldestIndex,
+                        m_valueArray.end());
+        }
+        m_oldestIndex = 0;
+    }
+    m_capacity = capacity;
+    trimToCapacity();
+}
+
+// Adds items to a capacity bounded array, overwriting the oldest items once the array is full.
+// The start indices and counts of the overwritten spans are appended to changedSpans, and the
+// appended items follow the old end of the array. Returns the index of the first added item.
+int QScatterDataProxyPrivate::addItemsToRingBuffer(const QScatterDataItem *items, int count,
+                                                   QVarLengthArray<QPair<int, int>, 2> &changedSpans)
+{
+    Q_ASSERT(m_capacity > 0);
+
+    const int oldSize = m_dataArray->size();
+    int firstIndex = -1;
+
+    // Only the newest items fit if more items than capacity are added at once
+    if (count > m_capacity) {
+        items += count - m_capacity;
+        count = m_capacity;
+    }
+
+    const int appendCount = qMin(count, m_capacity - oldSize);
+    if (appendCount > 0) {
+        // The whole capacity is reserved at once, so that filling the array never reallocates it
+        if (m_dataArray->capacity() < m_capacity)
+            m_dataArray->reserve(m_capacity);
+        if (!m_valueArray.isEmpty() && m_valueArray.capacity() < m_capacity)
+            m_valueArray.reserve(m_capacity);
+        for (int i = 0; i < appendCount; i++)
+            m_dataArray->append(items[i]);
+        if (!m_valueArray.isEmpty())
+            m_valueArray.resize(m_dataArray->size());
+        firstIndex = oldSize;
+        items += appendCount;
+        count -= appendCount;
+    }
+
+    while (count > 0) {
+        const int startIndex = m_oldestIndex;
+        const int spanCount = qMin(count, m_capacity - startIndex);
+        QScatterDataItem *data = m_dataArray->data() + startIndex;
+        for (int i = 0; i < spanCount; i++)
+            data[i] = items[i];
+        if (!m_valueArray.isEmpty())
+            std::fill_n(m_valueArray.begin() + startIndex, spanCount, 0.0f);
+        if (firstIndex < 0)
+            firstIndex = startIndex;
+        m_oldestIndex = (startIndex + spanCount) % m_capacity;
+        items += spanCount;
+        count -= spanCount;
+        changedSpans.append(qMakePair(startIndex, spanCount));
+    }
+
+    return firstIndex < 0 ? oldSize : firstIndex;
+}
+
+// Removes the oldest items that do not fit in the capacity. The items are expected to be
+// in chronological order. Returns the number of removed items.
+int QScatterDataProxyPrivate::trimToCapacity()
+{
+    const int trimCount = m_capacity > 0 ? m_dataArray->size() - m_capacity : 0;
+    if (trimCount <= 0)
+        return 0;
+
+    m_dataArray->remove(0, trimCount);
+    if (!m_valueArray.isEmpty())
+        m_valueArray.remove(0, trimCount);
+    return trimCount;
 }
 
 void QScatterDataProxyPrivate::limitValues(QVector3D &minValues, QVector3D &maxValues,
                                            QAbstract3DAxis *axisX, QAbstract3DAxis *axisY,
                                            QAbstract3DAxis *axisZ) const
 {
-    if (m_dataArray->isEmpty())
+    const ScatterDataView data = dataView();
+    if (!data.size())
         return;
 
-    const QVector3D &firstPos = m_dataArray->at(0).position();
+    const QVector3D firstPos = data.position(0);
 
     float minX = firstPos.x();
     float maxX = minX;
@@ -392,9 +756,9 @@ void QScatterDataProxyPrivate::limitValues(QVector3D &minValues, QVector3D &maxV
     float minZ = firstPos.z();
     float maxZ = minZ;
 
-    if (m_dataArray->size() > 1) {
-        for (int i = 1; i < m_dataArray->size(); i++) {
-            const QVector3D &pos = m_dataArray->at(i).position();
+    if (data.size() > 1) {
+        for (int i = 1; i < data.size(); i++) {
+            const QVector3D pos = data.position(i);
 
             float value = pos.x();
             if (qIsNaN(value) || qIsInf(value))
@@ -439,6 +803,23 @@ bool QScatterDataProxyPrivate::isValidValue(float axisValue, float value,
                                   || (value < 0.0f && axis->d_ptr->allowNegatives())));
 }
 
+ScatterDataView QScatterDataProxyPrivate::dataView() const
+{
+    return ScatterDataView(m_dataArray,
+                           m_valueArray.isEmpty() ? 0 : m_valueArray.constData());
+}
+
+const QScatterDataItem *QScatterDataProxyPrivate::itemAt(int index) const
+{
+    return &m_dataArray->at(index);
+}
+
+// Proxies that do not own their data override this to reject the array mutators
+bool QScatterDataProxyPrivate::isArrayModifiable() const
+{
+    return true;
+}
+
 void QScatterDataProxyPrivate::setSeries(QAbstract3DSeries *series)
 {
     QAbstractDataProxyPrivate::setSeries(series);
@@ -49,6 +49,7 @@ class QT_DATAVISUALIZATION_EXPORT QScatterDataProxy : public QAbstractDataProxy
 
     Q_PROPERTY(int itemCount READ itemCount NOTIFY itemCountChanged)
     Q_PROPERTY(QScatter3DSeries *series READ series NOTIFY seriesChanged)
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged REVISION 1)
 
 public:
     explicit QScatterDataProxy(QObject *parent = Q_NULLPTR);
@@ -60,6 +61,7 @@ public:
     const QScatterDataItem *itemAt(int index) const;
 
     void resetArray(QScatterDataArray *newArray);
+    void resetArray(QScatterDataArray *newArray, const QVector<float> &values);
 
     void setItem(int index, const QScatterDataItem &item);
     void setItems(int index, const QScatterDataArray &items);
@@ -72,6 +74,14 @@ public:
 
     void removeItems(int index, int removeCount);
 
+    void setCapacity(int capacity);
+    int capacity() const;
+
+    void setItemValue(int index, float value);
+    void setItemValues(int index, const QVector<float> &values);
+    float itemValue(int index) const;
+    bool hasItemValues() const;
+
 Q_SIGNALS:
     void arrayReset();
     void itemsAdded(int startIndex, int count);
@@ -81,6 +91,7 @@ Q_SIGNALS:
 
     void itemCountChanged(int count);
     void seriesChanged(QScatter3DSeries *series);
+    Q_REVISION(1) void capacityChanged(int capacity);
 
 protected:
     explicit QScatterDataProxy(QScatterDataProxyPrivate *d, QObject *parent = Q_NULLPTR);
@@ -91,6 +102,7 @@ private:
     Q_DISABLE_COPY(QScatterDataProxy)
 
     friend class Scatter3DController;
+    friend class Scatter3DRenderer;
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -43,6 +43,10 @@
 #include "qscatterdataproxy.h"
 #include "qabstractdataproxy_p.h"
 #include "qscatterdataitem.h"
+#include "scatterdataview_p.h"
+
+#include <QtCore/QPair>
+#include <QtCore/QVarLengthArray>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -56,6 +60,8 @@ public:
     virtual ~QScatterDataProxyPrivate();
 
     void resetArray(QScatterDataArray *newArray);
+    void resetValues(const QVector<float> &values);
+    void setItemValues(int index, const float *values, int count);
     void setItem(int index, const QScatterDataItem &item);
     void setItems(int index, const QScatterDataArray &items);
     int addItem(const QScatterDataItem &item);
@@ -63,14 +69,25 @@ public:
     void insertItem(int index, const QScatterDataItem &item);
     void insertItems(int index, const QScatterDataArray &items);
     void removeItems(int index, int removeCount);
+    void setCapacity(int capacity);
+    int addItemsToRingBuffer(const QScatterDataItem *items, int count,
+                             QVarLengthArray<QPair<int, int>, 2> &changedSpans);
+    int trimToCapacity();
     void limitValues(QVector3D &minValues, QVector3D &maxValues, QAbstract3DAxis *axisX,
                      QAbstract3DAxis *axisY, QAbstract3DAxis *axisZ) const;
     bool isValidValue(float axisValue, float value, QAbstract3DAxis *axis) const;
 
+    virtual ScatterDataView dataView() const;
+    virtual const QScatterDataItem *itemAt(int index) const;
+    virtual bool isArrayModifiable() const;
+
     virtual void setSeries(QAbstract3DSeries *series);
 private:
     QScatterDataProxy *qptr();
     QScatterDataArray *m_dataArray;
+    int m_capacity;
+    int m_oldestIndex; // Index of the item overwritten next when the array is at capacity
+    QVector<float> m_valueArray; // Empty or the same size as m_dataArray
 
     friend class QScatterDataProxy;
 };
@@ -165,6 +165,34 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * file name is set.
  */
 
+/*!
+ * \qmlproperty bool Surface3DSeries::heightFieldEnabled
+ * \since QtDataVisualization 1.4
+ *
+ * Defines whether a smooth shaded surface whose data forms a regular grid is drawn from
+ * a texture of heights. The vertex positions and normals are then calculated on the GPU,
+ * which reduces the GPU memory needed for the surface and makes data updates cheaper.
+ * The preset default is \c false.
+ *
+ * The data forms a regular grid when all rows have the same X values and all items in
+ * a row have the same Z value, and the X and Z values are evenly spaced.
+ * The surface is drawn normally if the data is not a regular grid, if flat shading is
+ * enabled, if the graph is polar, or if the system does not support height fields.
+ * Height fields require OpenGL 3.0 or later and are not supported on OpenGL ES.
+ */
+
+/*!
+ * \qmlproperty bool Surface3DSeries::levelOfDetailEnabled
+ * \since QtDataVisualization 1.4
+ *
+ * Defines whether large surfaces are drawn at a reduced level of detail where the
+ * difference to the full detail surface would not be visible. The surface is divided into
+ * tiles, and the detail of each tile is chosen on each frame based on its distance
+ * from the camera. Tiles outside the view are not drawn.
+ * The preset default is \c false.
+ *
+ * \note Level of detail does not affect flat shaded surfaces.
+ */
 
 /*!
  * \enum QSurface3DSeries::DrawFlag
@@ -398,6 +426,66 @@ QString QSurface3DSeries::textureFile() const
     return dptrc()->m_textureFile;
 }
 
+/*!
+ * \property QSurface3DSeries::heightFieldEnabled
+ * \since QtDataVisualization 1.4
+ *
+ * \brief Whether a surface on a regular grid is drawn from a texture of heights.
+ *
+ * When enabled, the vertex positions and normals of a smooth shaded surface are
+ * calculated on the GPU from a texture holding the Y values of the data. This
+ * reduces the GPU memory needed for the surface and makes data updates cheaper.
+ * Defaults to \c false.
+ *
+ * The data forms a regular grid when all rows have the same X values and all items in
+ * a row have the same Z value, and the X and Z values are evenly spaced.
+ * The surface is drawn normally if the data is not a regular grid, if flat shading is
+ * enabled, if the graph is polar, or if the system does not support height fields.
+ * Height fields require OpenGL 3.0 or later and are not supported on OpenGL ES.
+ */
+void QSurface3DSeries::setHeightFieldEnabled(bool enabled)
+{
+    if (dptr()->m_heightFieldEnabled != enabled) {
+        dptr()->setHeightFieldEnabled(enabled);
+        emit heightFieldEnabledChanged(enabled);
+    }
+}
+
+bool QSurface3DSeries::isHeightFieldEnabled() const
+{
+    return dptrc()->m_heightFieldEnabled;
+}
+
+/*!
+ * \property QSurface3DSeries::levelOfDetailEnabled
+ * \since QtDataVisualization 1.4
+ *
+ * \brief Whether the surface is drawn at a reduced level of detail where the
+ * difference would not be visible.
+ *
+ * When enabled, the surface is divided into a hierarchy of tiles that skip more and more
+ * of the data rows and columns. The tiles to draw are chosen on each frame so that the
+ * drawn surface differs from the full detail surface by at most a couple of pixels on
+ * screen, and tiles outside the view are not drawn. This keeps the cost of drawing very
+ * large surfaces bounded when the graph is zoomed out.
+ *
+ * The preset default is \c false.
+ *
+ * \note Level of detail does not affect flat shaded surfaces.
+ */
+void QSurface3DSeries::setLevelOfDetailEnabled(bool enabled)
+{
+    if (dptr()->m_levelOfDetailEnabled != enabled) {
+        dptr()->setLevelOfDetailEnabled(enabled);
+        emit levelOfDetailEnabledChanged(enabled);
+    }
+}
+
+bool QSurface3DSeries::isLevelOfDetailEnabled() const
+{
+    return dptrc()->m_levelOfDetailEnabled;
+}
+
 /*!
  * \internal
  */
@@ -420,7 +508,9 @@ QSurface3DSeriesPrivate::QSurface3DSeriesPrivate(QSurface3DSeries *q)
     : QAbstract3DSeriesPrivate(q, QAbstract3DSeries::SeriesTypeSurface),
       m_selectedPoint(Surface3DController::invalidSelectionPosition()),
       m_flatShadingEnabled(true),
-      m_drawMode(QSurface3DSeries::DrawSurfaceAndWireframe)
+      m_drawMode(QSurface3DSeries::DrawSurfaceAndWireframe),
+      m_heightFieldEnabled(false),
+      m_levelOfDetailEnabled(false)
 {
     m_itemLabelFormat = QStringLiteral("@xLabel, @yLabel, @zLabel");
     m_mesh = QAbstract3DSeries::MeshSphere;
@@ -469,6 +559,8 @@ void QSurface3DSeriesPrivate::connectControllerAndProxy(Abstract3DController *ne
                          &Surface3DController::handleRowsInserted);
         QObject::connect(surfaceDataProxy, &QSurfaceDataProxy::itemChanged, controller,
                          &Surface3DController::handleItemChanged);
+        QObject::connect(surfaceDataProxy, &QSurfaceDataProxy::rowsScrolled, controller,
+                         &Surface3DController::handleRowsScrolled);
         QObject::connect(qptr(), &QSurface3DSeries::dataProxyChanged, controller,
                          &Surface3DController::handleArrayReset);
     }
@@ -534,6 +626,20 @@ void QSurface3DSeriesPrivate::setFlatShadingEnabled(bool enabled)
         m_controller->markSeriesVisualsDirty();
 }
 
+void QSurface3DSeriesPrivate::setHeightFieldEnabled(bool enabled)
+{
+    m_heightFieldEnabled = enabled;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
+void QSurface3DSeriesPrivate::setLevelOfDetailEnabled(bool enabled)
+{
+    m_levelOfDetailEnabled = enabled;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
 void QSurface3DSeriesPrivate::setDrawMode(QSurface3DSeries::DrawFlags mode)
 {
     if (mode.testFlag(QSurface3DSeries::DrawWireframe)
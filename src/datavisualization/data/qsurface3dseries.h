@@ -48,6 +48,8 @@ class QT_DATAVISUALIZATION_EXPORT QSurface3DSeries : public QAbstract3DSeries
     Q_PROPERTY(DrawFlags drawMode READ drawMode WRITE setDrawMode NOTIFY drawModeChanged)
     Q_PROPERTY(QImage texture READ texture WRITE setTexture NOTIFY textureChanged)
     Q_PROPERTY(QString textureFile READ textureFile WRITE setTextureFile NOTIFY textureFileChanged)
+    Q_PROPERTY(bool heightFieldEnabled READ isHeightFieldEnabled WRITE setHeightFieldEnabled NOTIFY heightFieldEnabledChanged REVISION 1)
+    Q_PROPERTY(bool levelOfDetailEnabled READ isLevelOfDetailEnabled WRITE setLevelOfDetailEnabled NOTIFY levelOfDetailEnabledChanged REVISION 1)
 
 public:
     enum DrawFlag {
@@ -81,6 +83,12 @@ public:
     void setTextureFile(const QString &filename);
     QString textureFile() const;
 
+    void setHeightFieldEnabled(bool enabled);
+    bool isHeightFieldEnabled() const;
+
+    void setLevelOfDetailEnabled(bool enabled);
+    bool isLevelOfDetailEnabled() const;
+
 Q_SIGNALS:
     void dataProxyChanged(QSurfaceDataProxy *proxy);
     void selectedPointChanged(const QPoint &position);
@@ -89,6 +97,8 @@ Q_SIGNALS:
     void drawModeChanged(QSurface3DSeries::DrawFlags mode);
     void textureChanged(const QImage &image);
     void textureFileChanged(const QString &filename);
+    Q_REVISION(1) void heightFieldEnabledChanged(bool enabled);
+    Q_REVISION(1) void levelOfDetailEnabledChanged(bool enabled);
 
 protected:
     explicit QSurface3DSeries(QSurface3DSeriesPrivate *d, QObject *parent = Q_NULLPTR);
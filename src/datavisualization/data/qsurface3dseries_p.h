@@ -60,6 +60,8 @@ public:
     void setFlatShadingEnabled(bool enabled);
     void setDrawMode(QSurface3DSeries::DrawFlags mode);
     void setTexture(const QImage &texture);
+    void setHeightFieldEnabled(bool enabled);
+    void setLevelOfDetailEnabled(bool enabled);
 
 private:
     QSurface3DSeries *qptr();
@@ -69,6 +71,8 @@ private:
     QSurface3DSeries::DrawFlags m_drawMode;
     QImage m_texture;
     QString m_textureFile;
+    bool m_heightFieldEnabled;
+    bool m_levelOfDetailEnabled;
 
 private:
     friend class QSurface3DSeries;
@@ -65,6 +65,11 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * whole surface does not completely fit within the visible x-axis or z-axis
  * ranges.
  *
+ * The number of rows can be bounded by setting the \l capacity property, which turns the
+ * proxy into a scrolling window for streamed data, such as the rows of a spectrogram or
+ * a waterfall plot. Once the array is full, added rows push the oldest rows out of the array,
+ * and the graph only needs to update the added rows.
+ *
  * \note Surfaces with less than two rows or columns are not considered valid surfaces and will
  * not be rendered.
  *
@@ -124,6 +129,19 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
  * The series this proxy is attached to.
  */
 
+/*!
+ * \qmlproperty int SurfaceDataProxy::capacity
+ * \since QtDataVisualization 1.4
+ *
+ * The maximum number of rows in the array. When the array is full, added rows
+ * push the oldest rows out of the array instead of growing it.
+ * If the capacity is set smaller than the current number of rows, the oldest rows
+ * are removed. The value \c 0 means that the number of rows is not limited.
+ * Defaults to \c 0.
+ *
+ * For details, see QSurfaceDataProxy::capacity.
+ */
+
 /*!
  * Constructs QSurfaceDataProxy with the given \a parent.
  */
@@ -164,6 +182,9 @@ QSurface3DSeries *QSurfaceDataProxy::series() const
  *
  * Passing a null array deletes the old array and creates a new empty array.
  * All rows in \a newArray must be of same length.
+ *
+ * If \l capacity is set and the new array has more rows than it allows, the
+ * rows at the start of the new array are removed.
  */
 void QSurfaceDataProxy::resetArray(QSurfaceDataArray *newArray)
 {
@@ -223,11 +244,16 @@ void QSurfaceDataProxy::setItem(const QPoint &position, const QSurfaceDataItem &
 /*!
  * Adds the new row \a row to the end of an array. The new row must have
  * the same number of columns as the rows in the initial array.
+ * If \l capacity is set and the array is full, the oldest row is removed
+ * from the start of the array to make room for the new row.
  *
  * Returns the index of the added row.
  */
 int QSurfaceDataProxy::addRow(QSurfaceDataRow *row)
 {
+    if (dptr()->m_capacity > 0)
+        return dptr()->addRowsToRingBuffer(QSurfaceDataArray() << row);
+
     int addIndex = dptr()->addRow(row);
     emit rowsAdded(addIndex, 1);
     emit rowCountChanged(rowCount());
@@ -237,11 +263,16 @@ int QSurfaceDataProxy::addRow(QSurfaceDataRow *row)
 /*!
  * Adds new \a rows to the end of an array. The new rows must have the same
  * number of columns as the rows in the initial array.
+ * If \l capacity is set, the oldest rows are removed from the start of the
+ * array to make room for the rows that do not fit in it.
  *
  * Returns the index of the first added row.
  */
 int QSurfaceDataProxy::addRows(const QSurfaceDataArray &rows)
 {
+    if (dptr()->m_capacity > 0)
+        return dptr()->addRowsToRingBuffer(rows);
+
     int addIndex = dptr()->addRows(rows);
     emit rowsAdded(addIndex, rows.size());
     emit rowCountChanged(rowCount());
@@ -253,11 +284,17 @@ int QSurfaceDataProxy::addRows(const QSurfaceDataArray &rows)
  * If \a rowIndex is equal to the array size, the rows are added to the end of
  * the array. The new row must have the same number of columns as the rows in
  * the initial array.
+ *
+ * If \l capacity is set, the rows at the start of the array are removed if
+ * the array is over capacity after the insertion.
  */
 void QSurfaceDataProxy::insertRow(int rowIndex, QSurfaceDataRow *row)
 {
     dptr()->insertRow(rowIndex, row);
     emit rowsInserted(rowIndex, 1);
+    int trimCount = dptr()->trimToCapacity();
+    if (trimCount)
+        emit rowsRemoved(0, trimCount);
     emit rowCountChanged(rowCount());
 }
 
@@ -266,11 +303,17 @@ void QSurfaceDataProxy::insertRow(int rowIndex, QSurfaceDataRow *row)
  * If \a rowIndex is equal to the array size, the rows are added to the end of
  * the array. The new \a rows must have the same number of columns as the rows
  * in the initial array.
+ *
+ * If \l capacity is set, the rows at the start of the array are removed if
+ * the array is over capacity after the insertion.
  */
 void QSurfaceDataProxy::insertRows(int rowIndex, const QSurfaceDataArray &rows)
 {
     dptr()->insertRows(rowIndex, rows);
     emit rowsInserted(rowIndex, rows.size());
+    int trimCount = dptr()->trimToCapacity();
+    if (trimCount)
+        emit rowsRemoved(0, trimCount);
     emit rowCountChanged(rowCount());
 }
 
@@ -288,6 +331,56 @@ void QSurfaceDataProxy::removeRows(int rowIndex, int removeCount)
     }
 }
 
+/*!
+ * \property QSurfaceDataProxy::capacity
+ * \since QtDataVisualization 1.4
+ *
+ * \brief The maximum number of rows in the array.
+ *
+ * When the capacity is set, the proxy works as a scrolling window over streamed rows.
+ * Rows added with addRow() or addRows() are appended until the array is full, after which
+ * each added row pushes the oldest row out of the start of the array, and rowsScrolled() is
+ * emitted instead of rowsRemoved() and rowsAdded(). The rows keep their chronological
+ * order, so the row indices of the remaining rows decrease by the number of scrolled rows.
+ *
+ * The graph keeps the rows that are still shown and only updates the added rows, so the
+ * cost of adding rows does not depend on the size of the array. With the height field
+ * rendering mode of QSurface3DSeries, only the added rows are uploaded to the graphics
+ * hardware.
+ *
+ * If the capacity is set smaller than the current number of rows, the oldest rows are
+ * removed. The value \c 0 means that the number of rows is not limited.
+ *
+ * Defaults to \c 0.
+ *
+ * \note Axes that adjust their ranges automatically scan all the rows whenever rows
+ * are added, and a changed x-axis or y-axis range updates the whole surface. A z-axis range
+ * changed in the same update as the scrolled rows keeps the scrolling window, so use fixed
+ * x-axis and y-axis ranges, and move the z-axis range along with the rows, to keep the cost
+ * of streamed rows proportional to the number of added rows.
+ *
+ * \sa QSurface3DSeries::heightFieldEnabled
+ */
+void QSurfaceDataProxy::setCapacity(int capacity)
+{
+    if (capacity < 0) {
+        qWarning("Invalid capacity. Capacity cannot be negative.");
+    } else if (capacity != dptr()->m_capacity) {
+        dptr()->m_capacity = capacity;
+        emit capacityChanged(capacity);
+        int trimCount = dptr()->trimToCapacity();
+        if (trimCount) {
+            emit rowsRemoved(0, trimCount);
+            emit rowCountChanged(rowCount());
+        }
+    }
+}
+
+int QSurfaceDataProxy::capacity() const
+{
+    return dptrc()->m_capacity;
+}
+
 /*!
  * Returns the pointer to the data array.
  */
@@ -406,6 +499,15 @@ const QSurfaceDataProxyPrivate *QSurfaceDataProxy::dptrc() const
  * insertRows(), this signal needs to be emitted to update the graph.
  */
 
+/*!
+ * \fn void QSurfaceDataProxy::rowsScrolled(int count)
+ * \since QtDataVisualization 1.4
+ *
+ * This signal is emitted when the number of rows specified by \a count is
+ * removed from the start of the array and the same number of rows is added
+ * to the end of the array, because the array is at \l capacity.
+ */
+
 /*!
  * \fn void QSurfaceDataProxy::itemChanged(int rowIndex, int columnIndex)
  *
@@ -419,7 +521,8 @@ const QSurfaceDataProxyPrivate *QSurfaceDataProxy::dptrc() const
 
 QSurfaceDataProxyPrivate::QSurfaceDataProxyPrivate(QSurfaceDataProxy *q)
     : QAbstractDataProxyPrivate(q, QAbstractDataProxy::DataTypeSurface),
-      m_dataArray(new QSurfaceDataArray)
+      m_dataArray(new QSurfaceDataArray),
+      m_capacity(0)
 {
 }
 
@@ -437,6 +540,7 @@ void QSurfaceDataProxyPrivate::resetArray(QSurfaceDataArray *newArray)
         clearArray();
         m_dataArray = newArray;
     }
+    trimToCapacity();
 }
 
 void QSurfaceDataProxyPrivate::setRow(int rowIndex, QSurfaceDataRow *row)
@@ -519,6 +623,60 @@ void QSurfaceDataProxyPrivate::removeRows(int rowIndex, int removeCount)
     }
 }
 
+// Adds rows to a capacity bounded array, removing the oldest rows once the array is full.
+// Returns the index of the first added row.
+int QSurfaceDataProxyPrivate::addRowsToRingBuffer(const QSurfaceDataArray &rows)
+{
+    Q_ASSERT(m_capacity > 0);
+
+    const int oldSize = m_dataArray->size();
+    int first = 0;
+    int count = rows.size();
+
+    // Only the newest rows fit if more rows than capacity are added at once
+    if (count > m_capacity) {
+        first = count - m_capacity;
+        for (int i = 0; i < first; i++)
+            delete rows.at(i);
+        count = m_capacity;
+    }
+
+    const int appendCount = qMax(0, qMin(count, m_capacity - oldSize));
+    for (int i = 0; i < appendCount; i++) {
+        Q_ASSERT(m_dataArray->isEmpty() || m_dataArray->at(0)->size() == rows.at(first)->size());
+        m_dataArray->append(rows.at(first++));
+    }
+    if (appendCount > 0)
+        emit qptr()->rowsAdded(oldSize, appendCount);
+
+    // The rest of the rows push the oldest rows out of the full array
+    const int scrollCount = count - appendCount;
+    for (int i = 0; i < scrollCount; i++) {
+        Q_ASSERT(m_dataArray->at(0)->size() == rows.at(first)->size());
+        clearRow(0);
+        m_dataArray->removeFirst();
+        m_dataArray->append(rows.at(first++));
+    }
+    if (scrollCount > 0)
+        emit qptr()->rowsScrolled(scrollCount);
+
+    if (appendCount > 0)
+        emit qptr()->rowCountChanged(m_dataArray->size());
+
+    return m_dataArray->size() - count;
+}
+
+// Removes the oldest rows that do not fit in the capacity. Returns the number of removed rows.
+int QSurfaceDataProxyPrivate::trimToCapacity()
+{
+    const int trimCount = m_capacity > 0 ? m_dataArray->size() - m_capacity : 0;
+    if (trimCount <= 0)
+        return 0;
+
+    removeRows(0, trimCount);
+    return trimCount;
+}
+
 QSurfaceDataProxy *QSurfaceDataProxyPrivate::qptr()
 {
     return static_cast<QSurfaceDataProxy *>(q_ptr);
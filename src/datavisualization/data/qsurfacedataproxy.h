@@ -51,6 +51,7 @@ class QT_DATAVISUALIZATION_EXPORT QSurfaceDataProxy : public QAbstractDataProxy
     Q_PROPERTY(int rowCount READ rowCount NOTIFY rowCountChanged)
     Q_PROPERTY(int columnCount READ columnCount NOTIFY columnCountChanged)
     Q_PROPERTY(QSurface3DSeries *series READ series NOTIFY seriesChanged)
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged REVISION 1)
 
 public:
     explicit QSurfaceDataProxy(QObject *parent = Q_NULLPTR);
@@ -79,6 +80,9 @@ public:
 
     void removeRows(int rowIndex, int removeCount);
 
+    void setCapacity(int capacity);
+    int capacity() const;
+
 Q_SIGNALS:
     void arrayReset();
     void rowsAdded(int startIndex, int count);
@@ -86,10 +90,12 @@ Q_SIGNALS:
     void rowsRemoved(int startIndex, int count);
     void rowsInserted(int startIndex, int count);
     void itemChanged(int rowIndex, int columnIndex);
+    Q_REVISION(1) void rowsScrolled(int count);
 
     void rowCountChanged(int count);
     void columnCountChanged(int count);
     void seriesChanged(QSurface3DSeries *series);
+    Q_REVISION(1) void capacityChanged(int capacity);
 
 protected:
     explicit QSurfaceDataProxy(QSurfaceDataProxyPrivate *d, QObject *parent = Q_NULLPTR);
@@ -63,6 +63,8 @@ public:
     void insertRow(int rowIndex, QSurfaceDataRow *row);
     void insertRows(int rowIndex, const QSurfaceDataArray &rows);
     void removeRows(int rowIndex, int removeCount);
+    int addRowsToRingBuffer(const QSurfaceDataArray &rows);
+    int trimToCapacity();
     void limitValues(QVector3D &minValues, QVector3D &maxValues, QAbstract3DAxis *axisX,
                      QAbstract3DAxis *axisY, QAbstract3DAxis *axisZ) const;
     bool isValidValue(float value, QAbstract3DAxis *axis) const;
@@ -77,6 +79,8 @@ private:
     void clearRow(int rowIndex);
     void clearArray();
 
+    int m_capacity;
+
     friend class QSurfaceDataProxy;
 };
 
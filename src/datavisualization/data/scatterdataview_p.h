@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERDATAVIEW_P_H
+#define SCATTERDATAVIEW_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "qscatterdataproxy.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Read-only view to the item positions, rotations, and values of a scatter data proxy. The items
+// are read either from a data array or directly from strided float buffers owned by the user.
+class ScatterDataView
+{
+public:
+    inline ScatterDataView()
+        : m_array(0),
+          m_positions(0),
+          m_positionStride(0),
+          m_rotations(0),
+          m_rotationStride(0),
+          m_values(0),
+          m_valueStride(0),
+          m_count(0)
+    {
+    }
+
+    inline explicit ScatterDataView(const QScatterDataArray *array, const float *values = 0)
+        : m_array(array),
+          m_positions(0),
+          m_positionStride(0),
+          m_rotations(0),
+          m_rotationStride(0),
+          m_values(reinterpret_cast<const char *>(values)),
+          m_valueStride(sizeof(float)),
+          m_count(array->size())
+    {
+    }
+
+    inline ScatterDataView(const float *positions, int positionStride,
+                           const float *rotations, int rotationStride,
+                           const float *values, int valueStride, int count)
+        : m_array(0),
+          m_positions(reinterpret_cast<const char *>(positions)),
+          m_positionStride(positionStride),
+          m_rotations(reinterpret_cast<const char *>(rotations)),
+          m_rotationStride(rotationStride),
+          m_values(reinterpret_cast<const char *>(values)),
+          m_valueStride(valueStride),
+          m_count(count)
+    {
+    }
+
+    inline int size() const { return m_count; }
+
+    inline QVector3D position(int index) const
+    {
+        if (m_array)
+            return m_array->at(index).position();
+        const float *pos = reinterpret_cast<const float *>(m_positions
+                                                           + qptrdiff(index) * m_positionStride);
+        return QVector3D(pos[0], pos[1], pos[2]);
+    }
+
+    // Rotations are read as scalar, x, y, z quadruplets
+    inline QQuaternion rotation(int index) const
+    {
+        if (m_array)
+            return m_array->at(index).rotation();
+        if (!m_rotations)
+            return QQuaternion();
+        const float *rot = reinterpret_cast<const float *>(m_rotations
+                                                           + qptrdiff(index) * m_rotationStride);
+        return QQuaternion(rot[0], rot[1], rot[2], rot[3]);
+    }
+
+    inline bool hasRotations() const { return m_array || m_rotations; }
+
+    inline float value(int index) const
+    {
+        if (!m_values)
+            return 0.0f;
+        return *reinterpret_cast<const float *>(m_values + qptrdiff(index) * m_valueStride);
+    }
+
+    inline bool hasValues() const { return m_values; }
+
+private:
+    const QScatterDataArray *m_array;
+    const char *m_positions;
+    int m_positionStride;
+    const char *m_rotations;
+    int m_rotationStride;
+    const char *m_values;
+    int m_valueStride;
+    int m_count;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
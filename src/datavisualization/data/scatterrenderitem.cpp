@@ -28,6 +28,7 @@
 ****************************************************************************/
 
 #include "scatterrenderitem_p.h"
+#include "scatterdataview_p.h"
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
@@ -48,4 +49,93 @@ ScatterRenderItem::~ScatterRenderItem()
 {
 }
 
+ScatterRenderItemArray::ScatterRenderItemArray()
+{
+}
+
+ScatterRenderItemArray::~ScatterRenderItemArray()
+{
+}
+
+void ScatterRenderItemArray::resize(int size)
+{
+    const int oldSize = m_positions.size();
+    const int oldBlockEnd = m_visibility.size() * visibilityBlockSize;
+
+    m_positions.resize(size);
+    m_translations.resize(size);
+    if (!m_rotations.isEmpty())
+        m_rotations.resize(size);
+    if (!m_values.isEmpty())
+        m_values.resize(size);
+    m_visibility.resize((size + visibilityBlockSize - 1) / visibilityBlockSize);
+
+    // New items are invisible. Added blocks are already zeroed, so only the remainder of the
+    // previous last block needs clearing.
+    const int clearEnd = qMin(size, oldBlockEnd);
+    for (int i = oldSize; i < clearEnd; i++)
+        setVisible(i, false);
+}
+
+void ScatterRenderItemArray::clear()
+{
+    m_positions.clear();
+    m_translations.clear();
+    m_rotations.clear();
+    m_values.clear();
+    m_visibility.clear();
+}
+
+void ScatterRenderItemArray::setRotation(int index, const QQuaternion &rotation)
+{
+    const bool identity = rotation.isNull() || rotation.isIdentity();
+    if (m_rotations.isEmpty()) {
+        if (identity)
+            return;
+        setRotationsEnabled(true);
+    }
+    m_rotations[index] = identity ? identityQuaternion : rotation;
+}
+
+void ScatterRenderItemArray::setRotationsEnabled(bool enabled)
+{
+    if (!enabled)
+        m_rotations.clear();
+    else if (m_rotations.isEmpty())
+        m_rotations.fill(identityQuaternion, size());
+}
+
+void ScatterRenderItemArray::setValuesEnabled(bool enabled)
+{
+    if (!enabled)
+        m_values.clear();
+    else if (m_values.isEmpty())
+        m_values.fill(0.0f, size());
+}
+
+// Enables or disables the values to match the data view. Values that are enabled here are read
+// for all the items, as the values of unchanged items are not updated otherwise. Returns true if
+// the values were enabled or disabled.
+bool ScatterRenderItemArray::updateValues(const ScatterDataView &dataView)
+{
+    if (dataView.hasValues() == hasValues())
+        return false;
+
+    setValuesEnabled(dataView.hasValues());
+    const int count = qMin(size(), dataView.size());
+    for (int i = 0; hasValues() && i < count; i++)
+        m_values[i] = qBound(0.0f, dataView.value(i), 1.0f);
+    return true;
+}
+
+ScatterRenderItem ScatterRenderItemArray::item(int index) const
+{
+    ScatterRenderItem renderItem;
+    renderItem.setPosition(m_positions.at(index));
+    renderItem.setTranslation(m_translations.at(index));
+    renderItem.setRotation(rotation(index));
+    renderItem.setVisible(isVisible(index));
+    return renderItem;
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
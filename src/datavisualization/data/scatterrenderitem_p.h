@@ -44,6 +44,8 @@
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+class ScatterDataView;
+
 class ScatterRenderItem : public AbstractRenderItem
 {
 public:
@@ -65,7 +67,80 @@ protected:
     QVector3D m_position;
     bool m_visible;
 };
-typedef QVector<ScatterRenderItem> ScatterRenderItemArray;
+
+// Render items of a scatter series. Each item field is stored in a separate array, so that the
+// loops processing the items only stream through the fields they use. Rotations are stored only
+// when the series has rotated items, values only when the data proxy has item values, and
+// visibility is stored as a bitset.
+class QT_DATAVISUALIZATION_EXPORT ScatterRenderItemArray
+{
+public:
+    ScatterRenderItemArray();
+    ~ScatterRenderItemArray();
+
+    inline int size() const { return m_positions.size(); }
+    void resize(int size);
+    void clear();
+
+    inline const QVector3D &position(int index) const { return m_positions.at(index); }
+    inline void setPosition(int index, const QVector3D &pos) { m_positions[index] = pos; }
+
+    inline const QVector3D &translation(int index) const { return m_translations.at(index); }
+    inline void setTranslation(int index, const QVector3D &translation)
+    {
+        m_translations[index] = translation;
+    }
+    inline const QVector<QVector3D> &translations() const { return m_translations; }
+
+    inline const QQuaternion &rotation(int index) const
+    {
+        return m_rotations.isEmpty() ? identityQuaternion : m_rotations.at(index);
+    }
+    void setRotation(int index, const QQuaternion &rotation);
+    inline bool hasRotations() const { return !m_rotations.isEmpty(); }
+    void setRotationsEnabled(bool enabled);
+
+    inline void setValue(int index, float value) { m_values[index] = value; }
+    inline bool hasValues() const { return !m_values.isEmpty(); }
+    void setValuesEnabled(bool enabled);
+    bool updateValues(const ScatterDataView &dataView);
+
+    // Position of the item in the range gradient, from 0 to 1. The item value is used if there
+    // is one, otherwise the position is based on the Y-coordinate of the item.
+    inline float gradientPosition(int index, float scaleY) const
+    {
+        if (!m_values.isEmpty())
+            return m_values.at(index);
+        return ((m_translations.at(index).y() + scaleY) * 0.5f) / scaleY;
+    }
+
+    inline bool isVisible(int index) const
+    {
+        return m_visibility.at(index / visibilityBlockSize)
+                & (1u << (index % visibilityBlockSize));
+    }
+    inline void setVisible(int index, bool visible)
+    {
+        quint32 &block = m_visibility[index / visibilityBlockSize];
+        if (visible)
+            block |= (1u << (index % visibilityBlockSize));
+        else
+            block &= ~(1u << (index % visibilityBlockSize));
+    }
+
+    ScatterRenderItem item(int index) const;
+
+    // Visibility of this many consecutive items shares storage, so items of separate blocks can
+    // be written from separate threads.
+    static const int visibilityBlockSize = 32;
+
+private:
+    QVector<QVector3D> m_positions;
+    QVector<QVector3D> m_translations;
+    QVector<QQuaternion> m_rotations;
+    QVector<float> m_values;
+    QVector<quint32> m_visibility;
+};
 
 QT_END_NAMESPACE_DATAVISUALIZATION
 
@@ -1,7 +1,9 @@
 TARGET = QtDataVisualization
 
 QT += core gui
+QT_PRIVATE += core-private
 osx: QT +=  gui-private
+CONFIG += simd
 
 QMAKE_DOCS = $$PWD/doc/qtdatavis3d.qdocconf
 
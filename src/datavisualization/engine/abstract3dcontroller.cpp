@@ -75,7 +75,8 @@ Abstract3DController::Abstract3DController(QRect initialViewport, Q3DScene *scen
     m_clickedType(QAbstract3DGraph::ElementNone),
     m_selectedLabelIndex(-1),
     m_selectedCustomItemIndex(-1),
-    m_margin(-1.0)
+    m_margin(-1.0),
+    m_rayCastPicking(false)
 {
     if (!m_scene)
         m_scene = new Q3DScene;
@@ -506,6 +507,11 @@ void Abstract3DController::synchDataToRenderer()
         m_changeTracker.marginChanged = false;
     }
 
+    if (m_changeTracker.rayCastPickingChanged) {
+        m_renderer->updateRayCastPicking(m_rayCastPicking);
+        m_changeTracker.rayCastPickingChanged = false;
+    }
+
     if (m_changedSeriesList.size()) {
         m_renderer->modifiedSeriesList(m_changedSeriesList);
         m_changedSeriesList.clear();
@@ -1743,5 +1749,20 @@ qreal Abstract3DController::margin() const
     return m_margin;
 }
 
+void Abstract3DController::setRayCastPicking(bool enable)
+{
+    if (m_rayCastPicking != enable) {
+        m_rayCastPicking = enable;
+        m_changeTracker.rayCastPickingChanged = true;
+        emit rayCastPickingChanged(enable);
+        emitNeedRender();
+    }
+}
+
+bool Abstract3DController::isRayCastPicking() const
+{
+    return m_rayCastPicking;
+}
+
 
 QT_END_NAMESPACE_DATAVISUALIZATION
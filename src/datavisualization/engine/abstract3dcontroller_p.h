@@ -109,6 +109,7 @@ struct Abstract3DChangeBitField {
     bool reflectionChanged             : 1;
     bool reflectivityChanged           : 1;
     bool marginChanged                 : 1;
+    bool rayCastPickingChanged         : 1;
 
     Abstract3DChangeBitField() :
         themeChanged(true),
@@ -158,7 +159,8 @@ struct Abstract3DChangeBitField {
         radialLabelOffsetChanged(true),
         reflectionChanged(true),
         reflectivityChanged(true),
-        marginChanged(true)
+        marginChanged(true),
+        rayCastPickingChanged(true)
     {
     }
 };
@@ -223,6 +225,7 @@ protected:
     int m_selectedLabelIndex;
     int m_selectedCustomItemIndex;
     qreal m_margin;
+    bool m_rayCastPicking;
 
     QMutex m_renderMutex;
 
@@ -329,6 +332,9 @@ public:
     void setMargin(qreal margin);
     qreal margin() const;
 
+    void setRayCastPicking(bool enable);
+    bool isRayCastPicking() const;
+
     void emitNeedRender();
 
     virtual void clearSelection() = 0;
@@ -419,6 +425,7 @@ Q_SIGNALS:
     void localeChanged(const QLocale &locale);
     void queriedGraphPositionChanged(const QVector3D &data);
     void marginChanged(qreal margin);
+    void rayCastPickingChanged(bool enabled);
 
 protected:
     virtual QAbstract3DAxis *createDefaultAxis(QAbstract3DAxis::AxisOrientation orientation);
@@ -33,6 +33,7 @@
 #include "q3dtheme_p.h"
 #include "qvalue3daxisformatter_p.h"
 #include "shaderhelper_p.h"
+#include "itemtransform_p.h"
 #include "qcustom3ditem_p.h"
 #include "qcustom3dlabel_p.h"
 #include "qcustom3dvolume_p.h"
@@ -118,6 +119,7 @@ Abstract3DRenderer::Abstract3DRenderer(Abstract3DController *controller)
       m_oldCameraTarget(QVector3D(2000.0f, 2000.0f, 2000.0f)), // Just random invalid target
       m_reflectionEnabled(false),
       m_reflectivity(0.5),
+      m_rayCastPicking(false),
 #if !defined(QT_OPENGL_ES_2)
       m_funcs_2_1(0),
 #endif
@@ -549,6 +551,11 @@ void Abstract3DRenderer::updateMargin(float margin)
     m_requestedMargin = margin;
 }
 
+void Abstract3DRenderer::updateRayCastPicking(bool enable)
+{
+    m_rayCastPicking = enable;
+}
+
 void Abstract3DRenderer::updateOptimizationHint(QAbstract3DGraph::OptimizationHints hint)
 {
     m_cachedOptimizationHint = hint;
@@ -1465,7 +1472,6 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
             }
 
             QMatrix4x4 modelMatrix;
-            QMatrix4x4 itModelMatrix;
             QMatrix4x4 MVPMatrix;
 
             QQuaternion rotation = item->rotation();
@@ -1488,27 +1494,17 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
                 }
                 QVector3D trans = item->translation();
                 trans.setY(reflection * trans.y());
-                modelMatrix.translate(trans);
                 if (reflection < 0.0f) {
-                    QQuaternion mirror = QQuaternion(rotation.scalar(),
-                                                     -rotation.x(), rotation.y(), -rotation.z());
-                    modelMatrix.rotate(mirror);
-                    itModelMatrix.rotate(mirror);
-                } else {
-                    modelMatrix.rotate(rotation);
-                    itModelMatrix.rotate(rotation);
+                    rotation = QQuaternion(rotation.scalar(),
+                                           -rotation.x(), rotation.y(), -rotation.z());
                 }
                 QVector3D scale = item->scaling();
                 scale.setY(reflection * scale.y());
-                modelMatrix.scale(scale);
+                modelMatrix = ItemTransform::modelMatrix(trans, rotation, scale);
             } else {
-                modelMatrix.translate(item->translation());
-                modelMatrix.rotate(rotation);
-                modelMatrix.scale(item->scaling());
-                itModelMatrix.rotate(rotation);
+                modelMatrix = ItemTransform::modelMatrix(item->translation(), rotation,
+                                                         item->scaling());
             }
-            if (!item->isFacingCamera())
-                itModelMatrix.scale(item->scaling());
             MVPMatrix = projectionViewMatrix * modelMatrix;
 
             if (RenderingNormal == state) {
@@ -1534,7 +1530,12 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
                     shader->bind();
                 shader->setUniformValue(shader->model(), modelMatrix);
                 shader->setUniformValue(shader->MVP(), MVPMatrix);
-                shader->setUniformValue(shader->nModel(), itModelMatrix.inverted().transposed());
+                // Normals of reflections are not flipped, and items facing the camera are lit
+                // as if they were not scaled
+                shader->setUniformValue(shader->nModel(),
+                                        ItemTransform::normalMatrix(
+                                            rotation, item->isFacingCamera()
+                                            ? QVector3D(1.0f, 1.0f, 1.0f) : item->scaling()));
 
                 if (item->isBlendNeeded()) {
                     glEnable(GL_BLEND);
@@ -1750,6 +1751,23 @@ void Abstract3DRenderer::drawVolumeSliceFrame(const CustomRenderItem *item, Qt::
 
 }
 
+// Calculates the ray through the center of the clicked pixel, from the near plane towards the far
+// plane of the view frustum. Returns the position of the pixel in normalized device coordinates.
+QPointF Abstract3DRenderer::calculateClickRay(const QMatrix4x4 &projectionViewMatrix,
+                                              QVector3D &rayOrigin, QVector3D &rayDirection) const
+{
+    const float clickX = 2.0f * (float(m_inputPosition.x()) + 0.5f)
+            / float(m_primarySubViewport.width()) - 1.0f;
+    const float clickY = 2.0f * (float(m_viewport.height() - m_inputPosition.y()) + 0.5f)
+            / float(m_primarySubViewport.height()) - 1.0f;
+
+    const QMatrix4x4 inverseProjectionViewMatrix = projectionViewMatrix.inverted();
+    rayOrigin = inverseProjectionViewMatrix * QVector3D(clickX, clickY, -1.0f);
+    rayDirection =
+            (inverseProjectionViewMatrix * QVector3D(clickX, clickY, 1.0f) - rayOrigin).normalized();
+    return QPointF(clickX, clickY);
+}
+
 void Abstract3DRenderer::queriedGraphPosition(const QMatrix4x4 &projectionViewMatrix,
                                               const QVector3D &scaling,
                                               GLuint defaultFboHandle)
@@ -154,6 +154,7 @@ public:
     virtual void updatePolar(bool enable);
     virtual void updateRadialLabelOffset(float offset);
     virtual void updateMargin(float margin);
+    virtual void updateRayCastPicking(bool enable);
 
     virtual QVector3D convertPositionToTranslation(const QVector3D &position,
                                                    bool isAbsolute) = 0;
@@ -241,6 +242,8 @@ protected:
                               const QMatrix4x4 &projectionViewMatrix);
     void queriedGraphPosition(const QMatrix4x4 &projectionViewMatrix, const QVector3D &scaling,
                               GLuint defaultFboHandle);
+    QPointF calculateClickRay(const QMatrix4x4 &projectionViewMatrix, QVector3D &rayOrigin,
+                              QVector3D &rayDirection) const;
 
     void fixContextBeforeDelete();
     void restoreContextAfterDelete();
@@ -333,6 +336,8 @@ protected:
     bool m_reflectionEnabled;
     qreal m_reflectivity;
 
+    bool m_rayCastPicking;
+
     QLocale m_locale;
 #if !defined(QT_OPENGL_ES_2)
     QOpenGLFunctions_2_1 *m_funcs_2_1;  // Not owned
@@ -33,6 +33,7 @@
 #include "texturehelper_p.h"
 #include "utils_p.h"
 #include "barseriesrendercache_p.h"
+#include "itemtransform_p.h"
 
 #include <QtCore/qmath.h>
 
@@ -58,6 +59,12 @@ Bars3DRenderer::Bars3DRenderer(Bars3DController *controller)
       m_depthShader(0),
       m_selectionShader(0),
       m_backgroundShader(0),
+      m_instancedBarShader(0),
+      m_instancedBarGradientShader(0),
+      m_instancedDepthShader(0),
+      m_instancedSelectionShader(0),
+      m_instancingSupported(false),
+      m_barInstancesDirty(true),
       m_bgrTexture(0),
       m_selectionTexture(0),
       m_depthFrameBuffer(0),
@@ -115,12 +122,18 @@ Bars3DRenderer::~Bars3DRenderer()
     delete m_depthShader;
     delete m_selectionShader;
     delete m_backgroundShader;
+    delete m_instancedBarShader;
+    delete m_instancedBarGradientShader;
+    delete m_instancedDepthShader;
+    delete m_instancedSelectionShader;
 }
 
 void Bars3DRenderer::initializeOpenGL()
 {
     Abstract3DRenderer::initializeOpenGL();
 
+    m_instancingSupported = Utils::isInstancingSupported();
+
     // Initialize shaders
 
     // Init depth shader (for shadows). Init in any case, easier to handle shadow activation if done via api.
@@ -194,6 +207,8 @@ void Bars3DRenderer::updateData()
     int dataRowCount = 0;
     int maxDataRowCount = 0;
 
+    m_barInstancesDirty = true;
+
     m_seriesScaleX = 1.0f / float(m_visibleSeriesCount);
     m_seriesStep = 1.0f / float(m_visibleSeriesCount);
     m_seriesStart = -((float(m_visibleSeriesCount) - 1.0f) / 2.0f) * m_seriesStep;
@@ -317,6 +332,8 @@ void Bars3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesList)
 {
     Abstract3DRenderer::updateSeries(seriesList);
 
+    m_barInstancesDirty = true;
+
     bool noSelection = true;
     int seriesCount = seriesList.size();
     int visualIndex = 0;
@@ -362,6 +379,9 @@ void Bars3DRenderer::updateRows(const QVector<Bars3DController::ChangeRow> &rows
     BarSeriesRenderCache *cache = 0;
     const QBar3DSeries *prevSeries = 0;
     const QBarDataArray *dataArray = 0;
+    // Static instances are updated only where the data changed
+    const bool updateInstances = m_instancingSupported
+            && m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
 
     foreach (Bars3DController::ChangeRow item, rows) {
         const int row = item.row;
@@ -379,6 +399,11 @@ void Bars3DRenderer::updateRows(const QVector<Bars3DController::ChangeRow> &rows
         }
         if (cache->isVisible()) {
             updateRenderRow(dataArray->at(row), cache->renderArray()[row - minRow]);
+            if (updateInstances) {
+                const int rowIndex = (row - minRow) * m_cachedColumnCount;
+                for (int i = 0; i < m_cachedColumnCount; i++)
+                    cache->updateIndices().append(rowIndex + i);
+            }
             if (m_cachedIsSlicingActivated
                     && cache == m_selectedSeriesCache
                     && m_selectedBarPos.x() == row) {
@@ -397,6 +422,9 @@ void Bars3DRenderer::updateItems(const QVector<Bars3DController::ChangeItem> &it
     BarSeriesRenderCache *cache = 0;
     const QBar3DSeries *prevSeries = 0;
     const QBarDataArray *dataArray = 0;
+    // Static instances are updated only where the data changed
+    const bool updateInstances = m_instancingSupported
+            && m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
 
     foreach (Bars3DController::ChangeItem item, items) {
         const int row = item.point.x();
@@ -416,6 +444,10 @@ void Bars3DRenderer::updateItems(const QVector<Bars3DController::ChangeItem> &it
         if (cache->isVisible()) {
             updateRenderItem(dataArray->at(row)->at(col),
                              cache->renderArray()[row - minRow][col - minCol]);
+            if (updateInstances) {
+                cache->updateIndices().append((row - minRow) * m_cachedColumnCount
+                                              + col - minCol);
+            }
             if (m_cachedIsSlicingActivated
                     && cache == m_selectedSeriesCache
                     && m_selectedBarPos == QPoint(row, col)) {
@@ -753,19 +785,14 @@ void Bars3DRenderer::drawSlicedScene()
                     barRotation *= m_yRightAngleRotation;
                 }
 
-                modelMatrix.translate(barPosX, barPosY, 0.0f);
                 modelMatrixScaler.setY(item.height());
 
                 if (!seriesRotation.isIdentity())
                     barRotation *= seriesRotation;
 
-                if (!barRotation.isIdentity()) {
-                    modelMatrix.rotate(barRotation);
-                    itModelMatrix.rotate(barRotation);
-                }
-
-                modelMatrix.scale(modelMatrixScaler);
-                itModelMatrix.scale(modelMatrixScaler);
+                ItemTransform::modelAndNormalMatrix(QVector3D(barPosX, barPosY, 0.0f),
+                                                    barRotation, modelMatrixScaler,
+                                                    modelMatrix, itModelMatrix);
 
                 MVPMatrix = projectionViewMatrix * modelMatrix;
 
@@ -788,8 +815,7 @@ void Bars3DRenderer::drawSlicedScene()
                 if (item.height() != 0) {
                     // Set shader bindings
                     barShader->setUniformValue(barShader->model(), modelMatrix);
-                    barShader->setUniformValue(barShader->nModel(),
-                                               itModelMatrix.inverted().transposed());
+                    barShader->setUniformValue(barShader->nModel(), itModelMatrix);
                     barShader->setUniformValue(barShader->MVP(), MVPMatrix);
                     if (colorStyleIsUniform) {
                         barShader->setUniformValue(barShader->color(), barColor);
@@ -1044,6 +1070,24 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
 
     BarRenderItem *selectedBar(0);
 
+    // All passes below draw the bars of a series from the same instances. With static
+    // optimization the instances persist and are reloaded only when the bars have moved.
+    if (m_instancingSupported) {
+        bool staticInstances =
+                m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
+        foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+            if (baseCache->isVisible()) {
+                BarSeriesRenderCache *cache = static_cast<BarSeriesRenderCache *>(baseCache);
+                if (!staticInstances || m_barInstancesDirty || !cache->bufferInstances())
+                    loadBarInstances(cache, staticInstances);
+                else if (cache->updateIndices().size())
+                    updateBarInstances(cache);
+                cache->updateIndices().clear();
+            }
+        }
+        m_barInstancesDirty = false;
+    }
+
     if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone && !m_isOpenGLES) {
         // Render scene into a depth texture for using with shadow mapping
         // Enable drawing to depth framebuffer
@@ -1075,6 +1119,26 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
         foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
             if (baseCache->isVisible()) {
                 BarSeriesRenderCache *cache = static_cast<BarSeriesRenderCache *>(baseCache);
+                if (m_instancingSupported) {
+                    bool skipWrongSide = m_cachedTheme->isBackgroundEnabled()
+                            && m_reflectionEnabled;
+                    QVector4D barScale(shadowScaler.x(), 1.0f, shadowScaler.z(), 0.0f);
+                    m_instancedDepthShader->bind();
+                    m_instancedDepthShader->setUniformValue(m_instancedDepthShader->MVP(),
+                                                            depthProjectionViewMatrix);
+                    if (!skipWrongSide || !m_yFlipped) {
+                        barScale.setW(m_yFlipped ? 0.015f : 0.0f);
+                        drawBarInstances(m_instancedDepthShader, cache,
+                                         BarInstanceBufferHelper::PositiveBars, barScale);
+                    }
+                    if (!skipWrongSide || m_yFlipped) {
+                        barScale.setW(m_yFlipped ? 0.0f : -0.015f);
+                        drawBarInstances(m_instancedDepthShader, cache,
+                                         BarInstanceBufferHelper::NegativeBars, barScale);
+                    }
+                    m_depthShader->bind();
+                    continue;
+                }
                 float seriesPos = m_seriesStart + m_seriesStep * cache->visualIndex() + 0.5f;
                 ObjectHelper *barObj = cache->object();
                 QQuaternion seriesRotation(cache->meshRotation());
@@ -1112,14 +1176,13 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
 
                         // Draw shadows for bars "on the other side" a bit off ground to avoid
                         // seeing shadows through the ground
-                        modelMatrix.translate((colPos - m_rowWidth) / m_scaleFactor,
-                                              item.height() + shadowOffset,
-                                              (m_columnDepth - rowPos) / m_scaleFactor);
                         // Scale the bars down in X and Z to reduce self-shadowing issues
                         shadowScaler.setY(item.height());
-                        if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
-                            modelMatrix.rotate(seriesRotation * item.rotation());
-                        modelMatrix.scale(shadowScaler);
+                        modelMatrix = ItemTransform::modelMatrix(
+                                    QVector3D((colPos - m_rowWidth) / m_scaleFactor,
+                                              item.height() + shadowOffset,
+                                              (m_columnDepth - rowPos) / m_scaleFactor),
+                                    seriesRotation * item.rotation(), shadowScaler);
 
                         MVPMatrix = depthProjectionViewMatrix * modelMatrix;
 
@@ -1197,6 +1260,24 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
         foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
             if (baseCache->isVisible()) {
                 BarSeriesRenderCache *cache = static_cast<BarSeriesRenderCache *>(baseCache);
+                if (m_instancingSupported) {
+                    // Row and column of each bar come from the instance
+                    QVector4D seriesColor(0.0f, 0.0f,
+                                          GLfloat(cache->visualIndex()) / 255.0f, itemAlpha);
+                    QVector4D barScale(m_scaleX * m_seriesScaleX, 1.0f,
+                                       m_scaleZ * m_seriesScaleZ, 0.0f);
+                    m_instancedSelectionShader->bind();
+                    m_instancedSelectionShader->setUniformValue(
+                                m_instancedSelectionShader->MVP(), projectionViewMatrix);
+                    m_instancedSelectionShader->setUniformValue(
+                                m_instancedSelectionShader->color(), seriesColor);
+                    drawBarInstances(m_instancedSelectionShader, cache,
+                                     BarInstanceBufferHelper::PositiveBars, barScale);
+                    drawBarInstances(m_instancedSelectionShader, cache,
+                                     BarInstanceBufferHelper::NegativeBars, barScale);
+                    m_selectionShader->bind();
+                    continue;
+                }
                 float seriesPos = m_seriesStart + m_seriesStep * cache->visualIndex() + 0.5f;
                 ObjectHelper *barObj = cache->object();
                 QQuaternion seriesRotation(cache->meshRotation());
@@ -1219,14 +1300,13 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
                         colPos = (bar + seriesPos) * (m_cachedBarSpacing.width());
                         rowPos = (row + 0.5f) * (m_cachedBarSpacing.height());
 
-                        modelMatrix.translate((colPos - m_rowWidth) / m_scaleFactor,
+                        modelMatrix = ItemTransform::modelMatrix(
+                                    QVector3D((colPos - m_rowWidth) / m_scaleFactor,
                                               item.height(),
-                                              (m_columnDepth - rowPos) / m_scaleFactor);
-                        if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
-                            modelMatrix.rotate(seriesRotation * item.rotation());
-                        modelMatrix.scale(QVector3D(m_scaleX * m_seriesScaleX,
-                                                    item.height(),
-                                                    m_scaleZ * m_seriesScaleZ));
+                                              (m_columnDepth - rowPos) / m_scaleFactor),
+                                    seriesRotation * item.rotation(),
+                                    QVector3D(m_scaleX * m_seriesScaleX, item.height(),
+                                              m_scaleZ * m_seriesScaleZ));
 
                         MVPMatrix = projectionViewMatrix * modelMatrix;
 
@@ -1491,10 +1571,93 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
             }
 
             previousColorStyle = colorStyle;
+
+            // Bars with the base color of the series are drawn as instances, and only the
+            // highlighted ones are left for the loop below
+            bool drawInstances = m_instancingSupported;
+            if (drawInstances) {
+                BarInstanceBufferHelper *instances = cache->bufferInstances();
+                ShaderHelper *instancedShader = colorStyleIsUniform
+                        ? m_instancedBarShader : m_instancedBarGradientShader;
+                GLuint baseGradientTexture = 0;
+                instancedShader->bind();
+                instancedShader->setUniformValue(instancedShader->lightP(), lightPos);
+                instancedShader->setUniformValue(instancedShader->view(), viewMatrix);
+                instancedShader->setUniformValue(instancedShader->ambientS(),
+                                                 m_cachedTheme->ambientLightStrength());
+                instancedShader->setUniformValue(instancedShader->lightColor(), lightColor);
+#ifdef SHOW_DEPTH_TEXTURE_SCENE
+                instancedShader->setUniformValue(instancedShader->MVP(),
+                                                 depthProjectionViewMatrix);
+#else
+                instancedShader->setUniformValue(instancedShader->MVP(), projectionViewMatrix);
+#endif
+                if (colorStyleIsUniform) {
+                    instancedShader->setUniformValue(instancedShader->color(), baseColor);
+                } else {
+                    // Gradient height of each bar is applied in the vertex shader
+                    instancedShader->setUniformValue(instancedShader->gradientMin(), 0.0f);
+                    instancedShader->setUniformValue(instancedShader->gradientHeight(), 1.0f);
+                    baseGradientTexture = cache->baseGradientTexture();
+                }
+
+                GLuint depthTexture = 0;
+                if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone
+                        && !m_isOpenGLES) {
+                    instancedShader->setUniformValue(instancedShader->shadowQ(),
+                                                     m_shadowQualityToShader);
+                    instancedShader->setUniformValue(instancedShader->depth(),
+                                                     depthProjectionViewMatrix);
+                    instancedShader->setUniformValue(instancedShader->lightS(),
+                                                     adjustedLightStrength);
+                    depthTexture = m_depthTexture;
+                } else if (m_reflectionEnabled && reflection != 1.0f
+                           && m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+                    instancedShader->setUniformValue(instancedShader->lightS(),
+                                                     adjustedLightStrength);
+                } else {
+                    instancedShader->setUniformValue(instancedShader->lightS(),
+                                                     m_cachedTheme->lightStrength());
+                }
+
+                // Skip reflections of bars on the "wrong side"
+                QVector4D barScale(m_scaleX * m_seriesScaleX, reflection,
+                                   m_scaleZ * m_seriesScaleZ, 0.0f);
+                bool skipWrongSide = m_reflectionEnabled && reflection != 1.0f;
+                if (!skipWrongSide || !m_yFlipped) {
+                    drawBarInstances(instancedShader, cache,
+                                     BarInstanceBufferHelper::PositiveBaseBars, barScale,
+                                     baseGradientTexture, depthTexture);
+                }
+                if (!skipWrongSide || m_yFlipped) {
+                    drawBarInstances(instancedShader, cache,
+                                     BarInstanceBufferHelper::NegativeBaseBars, barScale,
+                                     baseGradientTexture, depthTexture);
+                }
+                barShader->bind();
+
+                // Nothing is highlighted in this series
+                if (instances->rangeCount(BarInstanceBufferHelper::PositiveBars)
+                        == instances->rangeCount(BarInstanceBufferHelper::PositiveBaseBars)
+                        && instances->rangeCount(BarInstanceBufferHelper::NegativeBars)
+                        == instances->rangeCount(BarInstanceBufferHelper::NegativeBaseBars)) {
+                    continue;
+                }
+            }
+
             for (int row = startRow; row != stopRow; row += stepRow) {
                 BarRenderItemRow &renderRow = renderArray[row];
                 for (int bar = startBar; bar != stopBar; bar += stepBar) {
                     BarRenderItem &item = renderRow[bar];
+                    Bars3DController::SelectionType selectionType =
+                            Bars3DController::SelectionNone;
+                    if (m_cachedSelectionMode > QAbstract3DGraph::SelectionNone
+                            && somethingSelected) {
+                        selectionType = isSelected(row, bar, cache);
+                    }
+                    if (drawInstances && selectionType == Bars3DController::SelectionNone)
+                        continue;
+
                     float adjustedHeight = reflection * item.height();
                     if (adjustedHeight < 0)
                         glCullFace(GL_FRONT);
@@ -1508,17 +1671,12 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
                     GLfloat colPos = (bar + seriesPos) * (m_cachedBarSpacing.width());
                     GLfloat rowPos = (row + 0.5f) * (m_cachedBarSpacing.height());
 
-                    modelMatrix.translate((colPos - m_rowWidth) / m_scaleFactor,
-                                          adjustedHeight,
-                                          (m_columnDepth - rowPos) / m_scaleFactor);
                     modelScaler.setY(adjustedHeight);
-                    if (!seriesRotation.isIdentity() || !item.rotation().isIdentity()) {
-                        QQuaternion totalRotation = seriesRotation * item.rotation();
-                        modelMatrix.rotate(totalRotation);
-                        itModelMatrix.rotate(totalRotation);
-                    }
-                    modelMatrix.scale(modelScaler);
-                    itModelMatrix.scale(modelScaler);
+                    ItemTransform::modelAndNormalMatrix(
+                                QVector3D((colPos - m_rowWidth) / m_scaleFactor, adjustedHeight,
+                                          (m_columnDepth - rowPos) / m_scaleFactor),
+                                seriesRotation * item.rotation(), modelScaler,
+                                modelMatrix, itModelMatrix);
 #ifdef SHOW_DEPTH_TEXTURE_SCENE
                     MVPMatrix = depthProjectionViewMatrix * modelMatrix;
 #else
@@ -1528,11 +1686,6 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
                     GLfloat shadowLightStrength = adjustedLightStrength;
 
                     if (m_cachedSelectionMode > QAbstract3DGraph::SelectionNone) {
-                        Bars3DController::SelectionType selectionType =
-                                Bars3DController::SelectionNone;
-                        if (somethingSelected)
-                            selectionType = isSelected(row, bar, cache);
-
                         switch (selectionType) {
                         case Bars3DController::SelectionItem: {
                             if (colorStyleIsUniform)
@@ -1638,8 +1791,7 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
                         // Skip drawing of 0-height bars and reflections of bars on the "wrong side"
                         // Set shader bindings
                         barShader->setUniformValue(barShader->model(), modelMatrix);
-                        barShader->setUniformValue(barShader->nModel(),
-                                                   itModelMatrix.transposed().inverted());
+                        barShader->setUniformValue(barShader->nModel(), itModelMatrix);
                         barShader->setUniformValue(barShader->MVP(), MVPMatrix);
                         if (colorStyleIsUniform) {
                             barShader->setUniformValue(barShader->color(), barColor);
@@ -1689,6 +1841,113 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
     return barSelectionFound;
 }
 
+void Bars3DRenderer::loadBarInstances(BarSeriesRenderCache *cache, bool staticData)
+{
+    BarInstanceBufferHelper *instances = cache->bufferInstances();
+    if (!instances) {
+        instances = new BarInstanceBufferHelper;
+        cache->setBufferInstances(instances);
+    }
+
+    float seriesPos = m_seriesStart + m_seriesStep * cache->visualIndex() + 0.5f;
+    QQuaternion seriesRotation(cache->meshRotation());
+    Q3DTheme::ColorStyle colorStyle = cache->colorStyle();
+    const BarRenderItemArray &renderArray = cache->renderArray();
+    bool somethingSelected =
+            (m_visualSelectedBarPos != Bars3DController::invalidSelectionPosition())
+            && m_cachedSelectionMode > QAbstract3DGraph::SelectionNone;
+
+    instances->beginLoad(m_cachedRowCount, m_cachedColumnCount);
+    for (int row = 0; row < m_cachedRowCount; row++) {
+        const BarRenderItemRow &renderRow = renderArray.at(row);
+        for (int bar = 0; bar < m_cachedColumnCount; bar++) {
+            const BarRenderItem &item = renderRow.at(bar);
+            if (item.height() == 0)
+                continue;
+
+            bool highlighted = somethingSelected
+                    && isSelected(row, bar, cache) != Bars3DController::SelectionNone;
+            instances->addInstance(barInstanceTranslation(row, bar, seriesPos, item),
+                                   seriesRotation * item.rotation(),
+                                   barInstanceGradientHeight(colorStyle, item),
+                                   row, bar, highlighted);
+        }
+    }
+    instances->endLoad(staticData);
+}
+
+void Bars3DRenderer::updateBarInstances(BarSeriesRenderCache *cache)
+{
+    BarInstanceBufferHelper *instances = cache->bufferInstances();
+    float seriesPos = m_seriesStart + m_seriesStep * cache->visualIndex() + 0.5f;
+    QQuaternion seriesRotation(cache->meshRotation());
+    Q3DTheme::ColorStyle colorStyle = cache->colorStyle();
+    const BarRenderItemArray &renderArray = cache->renderArray();
+    bool somethingSelected =
+            (m_visualSelectedBarPos != Bars3DController::invalidSelectionPosition())
+            && m_cachedSelectionMode > QAbstract3DGraph::SelectionNone;
+
+    foreach (int index, cache->updateIndices()) {
+        const int row = index / m_cachedColumnCount;
+        const int bar = index % m_cachedColumnCount;
+        const BarRenderItem &item = renderArray.at(row).at(bar);
+        bool highlighted = somethingSelected
+                && isSelected(row, bar, cache) != Bars3DController::SelectionNone;
+        if (!instances->updateInstance(barInstanceTranslation(row, bar, seriesPos, item),
+                                       seriesRotation * item.rotation(),
+                                       barInstanceGradientHeight(colorStyle, item),
+                                       row, bar, highlighted)) {
+            // Bar appeared, disappeared or changed sign, so the ranges need to be rebuilt
+            loadBarInstances(cache, true);
+            return;
+        }
+    }
+    instances->uploadUpdates();
+}
+
+QVector3D Bars3DRenderer::barInstanceTranslation(int row, int bar, float seriesPos,
+                                                 const BarRenderItem &item) const
+{
+    GLfloat colPos = (bar + seriesPos) * (m_cachedBarSpacing.width());
+    GLfloat rowPos = (row + 0.5f) * (m_cachedBarSpacing.height());
+    return QVector3D((colPos - m_rowWidth) / m_scaleFactor, item.height(),
+                     (m_columnDepth - rowPos) / m_scaleFactor);
+}
+
+float Bars3DRenderer::barInstanceGradientHeight(Q3DTheme::ColorStyle colorStyle,
+                                                const BarRenderItem &item) const
+{
+    if (colorStyle == Q3DTheme::ColorStyleRangeGradient)
+        return qAbs(item.height()) / m_gradientFraction;
+    else if (colorStyle == Q3DTheme::ColorStyleObjectGradient)
+        return 0.5f;
+    return 0.0f;
+}
+
+void Bars3DRenderer::drawBarInstances(ShaderHelper *shader, BarSeriesRenderCache *cache,
+                                      BarInstanceBufferHelper::InstanceRange range,
+                                      const QVector4D &barScale, GLuint textureId,
+                                      GLuint depthTextureId)
+{
+    BarInstanceBufferHelper *instances = cache->bufferInstances();
+    int instanceCount = instances->rangeCount(range);
+    if (!instanceCount)
+        return;
+
+    // Set front face culling for bars that extend below their base, i.e. negative bars and the
+    // reflections of positive bars
+    bool negative = (range == BarInstanceBufferHelper::NegativeBars
+                     || range == BarInstanceBufferHelper::NegativeBaseBars);
+    if (negative != (barScale.y() < 0.0f))
+        glCullFace(GL_FRONT);
+    else
+        glCullFace(GL_BACK);
+
+    shader->setUniformValue(shader->barScale(), barScale);
+    m_drawer->drawBarInstances(shader, cache->object(), instances, instances->rangeStart(range),
+                               instanceCount, textureId, depthTextureId);
+}
+
 void Bars3DRenderer::drawBackground(GLfloat backgroundRotation,
                                     const QMatrix4x4 &depthProjectionViewMatrix,
                                     const QMatrix4x4 &projectionViewMatrix,
@@ -2474,6 +2733,13 @@ void Bars3DRenderer::updateAxisReversed(QAbstract3DAxis::AxisOrientation orienta
         calculateHeightAdjustment();
 }
 
+void Bars3DRenderer::updateSelectionMode(QAbstract3DGraph::SelectionFlags mode)
+{
+    Abstract3DRenderer::updateSelectionMode(mode);
+
+    // The mode decides which bars around the selected bar are highlighted
+    m_barInstancesDirty = true;
+}
 
 void Bars3DRenderer::updateSelectedBar(const QPoint &position, QBar3DSeries *series)
 {
@@ -2481,6 +2747,7 @@ void Bars3DRenderer::updateSelectedBar(const QPoint &position, QBar3DSeries *ser
     m_selectedSeriesCache = static_cast<BarSeriesRenderCache *>(m_renderCacheList.value(series, 0));
     m_selectionDirty = true;
     m_selectionLabelDirty = true;
+    m_barInstancesDirty = true; // Highlighted bars have changed
 
     if (!m_selectedSeriesCache
             || !m_selectedSeriesCache->isVisible()
@@ -2544,6 +2811,7 @@ void Bars3DRenderer::updateShadowQuality(QAbstract3DGraph::ShadowQuality quality
     }
 
     handleShadowQualityChange();
+    initInstancedShaders();
 
     // Re-init depth buffer
     updateDepthBuffer();
@@ -2579,6 +2847,8 @@ void Bars3DRenderer::fixMeshFileName(QString &fileName, QAbstract3DSeries::Mesh
 
 void Bars3DRenderer::calculateSceneScalingFactors()
 {
+    m_barInstancesDirty = true;
+
     // Calculate scene scaling and translation factors
     m_rowWidth = (m_cachedColumnCount * m_cachedBarSpacing.width()) / 2.0f;
     m_columnDepth = (m_cachedRowCount * m_cachedBarSpacing.height()) / 2.0f;
@@ -2612,6 +2882,8 @@ void Bars3DRenderer::calculateSceneScalingFactors()
 
 void Bars3DRenderer::calculateHeightAdjustment()
 {
+    m_barInstancesDirty = true;
+
     float min = m_axisCacheY.min();
     float max = m_axisCacheY.max();
     GLfloat newAdjustment = 1.0f;
@@ -2804,6 +3076,58 @@ void Bars3DRenderer::initDepthShader()
     }
 }
 
+void Bars3DRenderer::initInstancedShaders()
+{
+    delete m_instancedBarShader;
+    delete m_instancedBarGradientShader;
+    delete m_instancedDepthShader;
+    delete m_instancedSelectionShader;
+    m_instancedBarShader = 0;
+    m_instancedBarGradientShader = 0;
+    m_instancedDepthShader = 0;
+    m_instancedSelectionShader = 0;
+
+    if (!m_instancingSupported)
+        return;
+
+    // Gradient shaders read the gradient position from coords_mdl, which the instanced vertex
+    // shaders scale by the gradient height of each bar
+    if (!m_isOpenGLES) {
+        if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+            m_instancedBarShader =
+                    new ShaderHelper(this, QStringLiteral(":/shaders/vertexBarShadowInstanced"),
+                                     QStringLiteral(":/shaders/fragmentShadowNoTex"));
+            m_instancedBarGradientShader =
+                    new ShaderHelper(this, QStringLiteral(":/shaders/vertexBarShadowInstanced"),
+                                     QStringLiteral(":/shaders/fragmentShadowNoTexColorOnY"));
+        } else {
+            m_instancedBarShader =
+                    new ShaderHelper(this, QStringLiteral(":/shaders/vertexBarInstanced"),
+                                     QStringLiteral(":/shaders/fragment"));
+            m_instancedBarGradientShader =
+                    new ShaderHelper(this, QStringLiteral(":/shaders/vertexBarInstanced"),
+                                     QStringLiteral(":/shaders/fragmentColorOnY"));
+        }
+        m_instancedDepthShader =
+                new ShaderHelper(this, QStringLiteral(":/shaders/vertexBarDepthInstanced"),
+                                 QStringLiteral(":/shaders/fragmentDepth"));
+        m_instancedDepthShader->initialize();
+    } else {
+        m_instancedBarShader =
+                new ShaderHelper(this, QStringLiteral(":/shaders/vertexBarInstanced"),
+                                 QStringLiteral(":/shaders/fragmentES2"));
+        m_instancedBarGradientShader =
+                new ShaderHelper(this, QStringLiteral(":/shaders/vertexBarInstanced"),
+                                 QStringLiteral(":/shaders/fragmentColorOnYES2"));
+    }
+    m_instancedSelectionShader =
+            new ShaderHelper(this, QStringLiteral(":/shaders/vertexBarSelectionInstanced"),
+                             QStringLiteral(":/shaders/fragmentVaryingColor"));
+    m_instancedBarShader->initialize();
+    m_instancedBarGradientShader->initialize();
+    m_instancedSelectionShader->initialize();
+}
+
 void Bars3DRenderer::updateDepthBuffer()
 {
     if (!m_isOpenGLES) {
@@ -44,6 +44,7 @@
 #include "bars3dcontroller_p.h"
 #include "abstract3drenderer_p.h"
 #include "barrenderitem_p.h"
+#include "barinstancebufferhelper_p.h"
 
 QT_BEGIN_NAMESPACE
 class QPoint;
@@ -79,6 +80,12 @@ private:
     ShaderHelper *m_depthShader;
     ShaderHelper *m_selectionShader;
     ShaderHelper *m_backgroundShader;
+    ShaderHelper *m_instancedBarShader;
+    ShaderHelper *m_instancedBarGradientShader;
+    ShaderHelper *m_instancedDepthShader;
+    ShaderHelper *m_instancedSelectionShader;
+    bool m_instancingSupported;
+    bool m_barInstancesDirty;
     GLuint m_bgrTexture;
     GLuint m_selectionTexture;
     GLuint m_depthFrameBuffer;
@@ -153,6 +160,7 @@ public Q_SLOTS:
                                  float max);
     virtual void updateAxisReversed(QAbstract3DAxis::AxisOrientation orientation,
                                     bool enable);
+    virtual void updateSelectionMode(QAbstract3DGraph::SelectionFlags mode);
 
 private:
     virtual void initShaders(const QString &vertexShader, const QString &fragmentShader);
@@ -170,6 +178,16 @@ private:
                   const QMatrix4x4 &projectionViewMatrix, const QMatrix4x4 &viewMatrix,
                   GLint startRow, GLint stopRow, GLint stepRow,
                   GLint startBar, GLint stopBar, GLint stepBar, GLfloat reflection = 1.0f);
+    void loadBarInstances(BarSeriesRenderCache *cache, bool staticData);
+    void updateBarInstances(BarSeriesRenderCache *cache);
+    inline QVector3D barInstanceTranslation(int row, int bar, float seriesPos,
+                                            const BarRenderItem &item) const;
+    inline float barInstanceGradientHeight(Q3DTheme::ColorStyle colorStyle,
+                                           const BarRenderItem &item) const;
+    void drawBarInstances(ShaderHelper *shader, BarSeriesRenderCache *cache,
+                          BarInstanceBufferHelper::InstanceRange range,
+                          const QVector4D &barScale, GLuint textureId = 0,
+                          GLuint depthTextureId = 0);
     void drawBackground(GLfloat backgroundRotation, const QMatrix4x4 &depthProjectionViewMatrix,
                         const QMatrix4x4 &projectionViewMatrix, const QMatrix4x4 &viewMatrix,
                         bool reflectingDraw = false, bool drawingSelectionBuffer = false);
@@ -182,6 +200,7 @@ private:
     void initBackgroundShaders(const QString &vertexShader, const QString &fragmentShader);
     void initSelectionBuffer();
     void initDepthShader();
+    void initInstancedShaders();
     void updateDepthBuffer();
     void calculateSceneScalingFactors();
     void calculateHeightAdjustment();
@@ -28,18 +28,21 @@
 ****************************************************************************/
 
 #include "barseriesrendercache_p.h"
+#include "barinstancebufferhelper_p.h"
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
 BarSeriesRenderCache::BarSeriesRenderCache(QAbstract3DSeries *series,
                                            Abstract3DRenderer *renderer)
     : SeriesRenderCache(series, renderer),
-      m_visualIndex(-1)
+      m_visualIndex(-1),
+      m_barBufferInstances(0)
 {
 }
 
 BarSeriesRenderCache::~BarSeriesRenderCache()
 {
+    delete m_barBufferInstances;
 }
 
 void BarSeriesRenderCache::cleanup(TextureHelper *texHelper)
@@ -47,6 +47,8 @@
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+class BarInstanceBufferHelper;
+
 class BarSeriesRenderCache : public SeriesRenderCache
 {
 public:
@@ -60,11 +62,16 @@ public:
     inline QVector<BarRenderSliceItem> &sliceArray() { return m_sliceArray; }
     inline void setVisualIndex(int index) { m_visualIndex = index; }
     inline int visualIndex() {return m_visualIndex; }
+    inline void setBufferInstances(BarInstanceBufferHelper *object) { m_barBufferInstances = object; }
+    inline BarInstanceBufferHelper *bufferInstances() const { return m_barBufferInstances; }
+    inline QVector<int> &updateIndices() { return m_updateIndices; }
 
 protected:
     BarRenderItemArray m_renderArray;
     QVector<BarRenderSliceItem> m_sliceArray;
     int m_visualIndex; // order of the series is relevant
+    BarInstanceBufferHelper *m_barBufferInstances;
+    QVector<int> m_updateIndices; // Bars changed since the instances were last updated
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
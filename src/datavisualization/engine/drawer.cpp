@@ -34,8 +34,11 @@
 #include "texturehelper_p.h"
 #include "abstract3drenderer_p.h"
 #include "scatterpointbufferhelper_p.h"
+#include "scatterinstancebufferhelper_p.h"
+#include "barinstancebufferhelper_p.h"
 
 #include <QtGui/QMatrix4x4>
+#include <QtGui/QOpenGLExtraFunctions>
 #include <QtCore/qmath.h>
 
 // Resources need to be explicitly initialized when building as static library
@@ -153,7 +156,7 @@ void Drawer::drawObject(ShaderHelper *shader, AbstractObjectHelper *object, GLui
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
 
     // Draw the triangles
-    glDrawElements(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT, (void*)0);
+    drawElements(object);
 
     // Free buffers
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -188,12 +191,216 @@ void Drawer::drawSelectionObject(ShaderHelper *shader, AbstractObjectHelper *obj
     glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
     glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void *)0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
-    glDrawElements(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT, (void *)0);
+    drawElements(object);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glDisableVertexAttribArray(shader->posAtt());
 }
 
+void Drawer::drawInstancedObject(ShaderHelper *shader, AbstractObjectHelper *object,
+                                 ScatterInstanceBufferHelper *instances, GLuint textureId,
+                                 GLuint depthTextureId)
+{
+    // Instanced drawing requires OpenGL 3.3 or OpenGL ES 3.0, see Utils::isInstancingSupported()
+    QOpenGLExtraFunctions *extraFuncs = QOpenGLContext::currentContext()->extraFunctions();
+
+    if (textureId) {
+        // Activate texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        shader->setUniformValue(shader->texture(), 0);
+    }
+
+    if (depthTextureId) {
+        // Activate depth texture
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, depthTextureId);
+        shader->setUniformValue(shader->shadow(), 1);
+    }
+
+    // 1st attribute buffer : vertices
+    glEnableVertexAttribArray(shader->posAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
+    glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    // 2nd attribute buffer : normals
+    if (shader->normalAtt() >= 0) {
+        glEnableVertexAttribArray(shader->normalAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->normalBuf());
+        glVertexAttribPointer(shader->normalAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    }
+
+    // Per-instance attribute buffer : translation and scale, rotation, gradient UV
+    const GLint instanceAtts[] = {
+        shader->instancePosAtt(),
+        shader->instanceRotAtt(),
+        shader->instanceUVAtt()
+    };
+    const GLint instanceAttSizes[] = { 4, 4, 1 };
+    const int instanceAttOffsets[] = {
+        0,
+        ScatterInstanceBufferHelper::instanceRotationOffset,
+        ScatterInstanceBufferHelper::instanceUVOffset
+    };
+    const GLsizei instanceStride =
+            ScatterInstanceBufferHelper::instanceFloatCount * sizeof(GLfloat);
+    glBindBuffer(GL_ARRAY_BUFFER, instances->instanceBuf());
+    for (int i = 0; i < 3; i++) {
+        if (instanceAtts[i] >= 0) {
+            glEnableVertexAttribArray(instanceAtts[i]);
+            glVertexAttribPointer(instanceAtts[i], instanceAttSizes[i], GL_FLOAT, GL_FALSE,
+                                  instanceStride,
+                                  (void *)(instanceAttOffsets[i] * sizeof(GLfloat)));
+            extraFuncs->glVertexAttribDivisor(instanceAtts[i], 1);
+        }
+    }
+
+    // Index buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+
+    // Draw the triangles of all instances
+    extraFuncs->glDrawElementsInstanced(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT,
+                                        (void *)0, instances->indexCount());
+
+    // Free buffers
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // Divisors are attribute state, so they must be reset for non-instanced draws
+    for (int i = 0; i < 3; i++) {
+        if (instanceAtts[i] >= 0) {
+            extraFuncs->glVertexAttribDivisor(instanceAtts[i], 0);
+            glDisableVertexAttribArray(instanceAtts[i]);
+        }
+    }
+    if (shader->normalAtt() >= 0)
+        glDisableVertexAttribArray(shader->normalAtt());
+    glDisableVertexAttribArray(shader->posAtt());
+
+    // Release textures
+    if (depthTextureId) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (textureId) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void Drawer::drawBarInstances(ShaderHelper *shader, AbstractObjectHelper *object,
+                              BarInstanceBufferHelper *instances, int firstInstance,
+                              int instanceCount, GLuint textureId, GLuint depthTextureId)
+{
+    if (instanceCount <= 0)
+        return;
+
+    // Instanced drawing requires OpenGL 3.3 or OpenGL ES 3.0, see Utils::isInstancingSupported()
+    QOpenGLExtraFunctions *extraFuncs = QOpenGLContext::currentContext()->extraFunctions();
+
+    if (textureId) {
+        // Activate texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        shader->setUniformValue(shader->texture(), 0);
+    }
+
+    if (depthTextureId) {
+        // Activate depth texture
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, depthTextureId);
+        shader->setUniformValue(shader->shadow(), 1);
+    }
+
+    // 1st attribute buffer : vertices
+    glEnableVertexAttribArray(shader->posAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
+    glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    // 2nd attribute buffer : normals
+    if (shader->normalAtt() >= 0) {
+        glEnableVertexAttribArray(shader->normalAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->normalBuf());
+        glVertexAttribPointer(shader->normalAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    }
+
+    // Per-instance attribute buffer : translation and height, rotation, row and column.
+    // Instanced draws have no base instance in OpenGL ES 3.0, so the range is selected by
+    // offsetting the attribute pointers instead.
+    const GLint instanceAtts[] = {
+        shader->instancePosAtt(),
+        shader->instanceRotAtt(),
+        shader->instanceIndexAtt()
+    };
+    const GLint instanceAttSizes[] = { 4, 4, 2 };
+    const int instanceAttOffsets[] = {
+        0,
+        BarInstanceBufferHelper::instanceRotationOffset,
+        BarInstanceBufferHelper::instanceIndexOffset
+    };
+    const GLsizei instanceStride = BarInstanceBufferHelper::instanceFloatCount * sizeof(GLfloat);
+    const int firstInstanceOffset = firstInstance * BarInstanceBufferHelper::instanceFloatCount;
+    glBindBuffer(GL_ARRAY_BUFFER, instances->instanceBuf());
+    for (int i = 0; i < 3; i++) {
+        if (instanceAtts[i] >= 0) {
+            glEnableVertexAttribArray(instanceAtts[i]);
+            glVertexAttribPointer(instanceAtts[i], instanceAttSizes[i], GL_FLOAT, GL_FALSE,
+                                  instanceStride,
+                                  (void *)((firstInstanceOffset + instanceAttOffsets[i])
+                                           * sizeof(GLfloat)));
+            extraFuncs->glVertexAttribDivisor(instanceAtts[i], 1);
+        }
+    }
+
+    // Index buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+
+    // Draw the triangles of the instances in the range
+    extraFuncs->glDrawElementsInstanced(object->primitiveMode(), object->indexCount(),
+                                        object->indexType(), (void *)0, instanceCount);
+
+    // Free buffers
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // Divisors are attribute state, so they must be reset for non-instanced draws
+    for (int i = 0; i < 3; i++) {
+        if (instanceAtts[i] >= 0) {
+            extraFuncs->glVertexAttribDivisor(instanceAtts[i], 0);
+            glDisableVertexAttribArray(instanceAtts[i]);
+        }
+    }
+    if (shader->normalAtt() >= 0)
+        glDisableVertexAttribArray(shader->normalAtt());
+    glDisableVertexAttribArray(shader->posAtt());
+
+    // Release textures
+    if (depthTextureId) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (textureId) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+// Draws the elements of the object from the bound element buffer, as the primitives and with
+// the index type its indices use. Triangle strips are separated by primitive restarts, which
+// need to be enabled on desktop OpenGL and are always enabled on OpenGL ES 3.0.
+void Drawer::drawElements(AbstractObjectHelper *object)
+{
+    const bool restart = object->primitiveMode() == GL_TRIANGLE_STRIP && !Utils::isOpenGLES();
+    if (restart)
+        glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+
+    glDrawElements(object->primitiveMode(), object->indexCount(), object->indexType(),
+                   (void *)0);
+
+    if (restart)
+        glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+}
+
 void Drawer::drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object)
 {
     // 1st attribute buffer : vertices
@@ -205,7 +412,7 @@ void Drawer::drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object)
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->gridElementBuf());
 
     // Draw the lines
-    glDrawElements(GL_LINES, object->gridIndexCount(), GL_UNSIGNED_INT, (void*)0);
+    glDrawElements(GL_LINES, object->gridIndexCount(), object->gridIndexType(), (void*)0);
 
     // Free buffers
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -214,6 +421,71 @@ void Drawer::drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object)
     glDisableVertexAttribArray(shader->posAtt());
 }
 
+// Draws a height field surface, or its grid lines. The vertices are reconstructed in the vertex
+// shader from the grid coordinates and the height texture, which is bound to texture unit 2.
+void Drawer::drawHeightField(ShaderHelper *shader, SurfaceObject *object, GLuint textureId,
+                             GLuint depthTextureId, bool gridLines)
+{
+    if (textureId) {
+        // Activate texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        shader->setUniformValue(shader->texture(), 0);
+    }
+
+    if (depthTextureId) {
+        // Activate depth texture
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, depthTextureId);
+        shader->setUniformValue(shader->shadow(), 1);
+    }
+
+    // Activate height texture
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, object->heightTexture());
+    shader->setUniformValue(shader->heightField(), 2);
+
+    shader->setUniformValue(shader->gridSize(), object->gridSize());
+    shader->setUniformValue(shader->gridOrigin(), object->gridOrigin());
+    shader->setUniformValue(shader->gridStep(), object->gridStep());
+    shader->setUniformValue(shader->gridNeighbor(), object->gridNeighbor());
+    shader->setUniformValue(shader->uvRect(), object->uvRect());
+    shader->setUniformValue(shader->heightRowOffset(), GLfloat(object->heightRowOffset()));
+
+    // The only attribute buffer : grid coordinates
+    glEnableVertexAttribArray(shader->uvAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->gridUVBuf());
+    glVertexAttribPointer(shader->uvAtt(), 2, GL_FLOAT, GL_FALSE, 0, (void *)0);
+
+    if (gridLines) {
+        // Draw the lines
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->gridElementBuf());
+        glDrawElements(GL_LINES, object->gridIndexCount(), object->gridIndexType(),
+                       (void *)0);
+    } else {
+        // Draw the triangles
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+        drawElements(object);
+    }
+
+    // Free buffers
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    glDisableVertexAttribArray(shader->uvAtt());
+
+    // Release textures
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (depthTextureId) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    if (textureId)
+        glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 void Drawer::drawPoint(ShaderHelper *shader)
 {
     // Draw a single point
@@ -239,7 +511,8 @@ void Drawer::drawPoint(ShaderHelper *shader)
     glDisableVertexAttribArray(shader->posAtt());
 }
 
-void Drawer::drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object, GLuint textureId)
+void Drawer::drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object, GLuint textureId,
+                        int itemCount)
 {
     if (textureId) {
         // Activate texture
@@ -260,8 +533,14 @@ void Drawer::drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object,
         glVertexAttribPointer(shader->uvAtt(), 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
     }
 
-    // Draw the points
-    glDrawArrays(GL_POINTS, 0, object->indexCount());
+    // Draw the points, or the first itemCount points of the level of detail order
+    if (itemCount >= 0 && object->elementBuf()) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+        glDrawElements(GL_POINTS, itemCount, GL_UNSIGNED_INT, (void*)0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    } else {
+        glDrawArrays(GL_POINTS, 0, object->indexCount());
+    }
 
     // Free buffers
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -56,6 +56,8 @@ class TextureHelper;
 class Q3DCamera;
 class Abstract3DRenderer;
 class ScatterPointBufferHelper;
+class ScatterInstanceBufferHelper;
+class BarInstanceBufferHelper;
 
 class Drawer : public QObject, public QOpenGLFunctions
 {
@@ -88,9 +90,19 @@ public:
     void drawObject(ShaderHelper *shader, AbstractObjectHelper *object, GLuint textureId = 0,
                     GLuint depthTextureId = 0, GLuint textureId3D = 0);
     void drawSelectionObject(ShaderHelper *shader, AbstractObjectHelper *object);
+    void drawInstancedObject(ShaderHelper *shader, AbstractObjectHelper *object,
+                             ScatterInstanceBufferHelper *instances, GLuint textureId = 0,
+                             GLuint depthTextureId = 0);
+    void drawBarInstances(ShaderHelper *shader, AbstractObjectHelper *object,
+                          BarInstanceBufferHelper *instances, int firstInstance,
+                          int instanceCount, GLuint textureId = 0, GLuint depthTextureId = 0);
+    void drawElements(AbstractObjectHelper *object);
     void drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object);
+    void drawHeightField(ShaderHelper *shader, SurfaceObject *object, GLuint textureId = 0,
+                         GLuint depthTextureId = 0, bool gridLines = false);
     void drawPoint(ShaderHelper *shader);
-    void drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object, GLuint textureId);
+    void drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object, GLuint textureId,
+                    int itemCount = -1);
     void drawLine(ShaderHelper *shader);
     void drawLabel(const AbstractRenderItem &item, const LabelItem &labelItem,
                    const QMatrix4x4 &viewmatrix, const QMatrix4x4 &projectionmatrix,
@@ -705,7 +705,8 @@ qreal QAbstract3DGraph::aspectRatio() const
  * performance. The static mode optimizes graph rendering and is ideal for
  * large non-changing data sets. It is slower with dynamic data changes and item rotations.
  * Selection is not optimized, so using the static mode with massive data sets is not advisable.
- * Static optimization works only on scatter graphs.
+ * Static optimization works on scatter graphs, and on bar graphs when OpenGL 3.3
+ * or OpenGL ES 3.0 is available.
  * Defaults to \l{OptimizationDefault}.
  *
  * \note On some environments, large graphs using static optimization may not render, because
@@ -713,7 +714,8 @@ qreal QAbstract3DGraph::aspectRatio() const
  * support different maximum vertice counts per call.
  * This is mostly an issue on 32bit and OpenGL ES2 platforms.
  * To work around this issue, choose an item mesh with a low vertex count or use
- * the point mesh.
+ * the point mesh. When OpenGL 3.3 or OpenGL ES 3.0 is available, item meshes are
+ * drawn using instanced rendering instead, which avoids this limitation.
  *
  * \sa QAbstract3DSeries::mesh
  */
@@ -930,6 +932,42 @@ qreal QAbstract3DGraph::margin() const
     return d_ptr->m_visualController->margin();
 }
 
+/*!
+ * \property QAbstract3DGraph::rayCastPicking
+ * \since QtDataVisualization 1.4
+ *
+ * \brief Whether series items are picked by casting a ray from the clicked
+ * point instead of rendering them into a selection buffer.
+ *
+ * When enabled, the item under the cursor is found by intersecting a ray
+ * from the camera through the clicked point with the items of the series,
+ * so the items do not need to be drawn a second time when the graph is
+ * clicked. Mesh items are tested using their bounding spheres, so the
+ * picked item may differ from the one the selection buffer would give near
+ * the edges of non-spherical meshes. Axis labels and custom items are
+ * still picked using the selection buffer, and they take precedence over
+ * series items.
+ *
+ * Surfaces are picked by intersecting the ray with their triangles, and the
+ * data point nearest to the intersection is selected. Surface graphs then
+ * need no selection textures for their series, which saves memory and the
+ * time to recreate the textures when the data changes.
+ *
+ * Ray cast picking is currently supported by scatter and surface graphs.
+ * Bar graphs ignore this property.
+ *
+ * Defaults to \c{false}.
+ */
+void QAbstract3DGraph::setRayCastPicking(bool enable)
+{
+    d_ptr->m_visualController->setRayCastPicking(enable);
+}
+
+bool QAbstract3DGraph::isRayCastPicking() const
+{
+    return d_ptr->m_visualController->isRayCastPicking();
+}
+
 /*!
  * Returns \c{true} if the OpenGL context of the graph has been successfully initialized.
  * Trying to use a graph when the context initialization has failed typically results in a crash.
@@ -1116,6 +1154,8 @@ void QAbstract3DGraphPrivate::setVisualController(Abstract3DController *controll
                      &QAbstract3DGraph::queriedGraphPositionChanged);
     QObject::connect(m_visualController, &Abstract3DController::marginChanged, q_ptr,
                      &QAbstract3DGraph::marginChanged);
+    QObject::connect(m_visualController, &Abstract3DController::rayCastPickingChanged, q_ptr,
+                     &QAbstract3DGraph::rayCastPickingChanged);
 }
 
 void QAbstract3DGraphPrivate::handleDevicePixelRatioChange()
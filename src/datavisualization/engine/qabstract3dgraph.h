@@ -70,6 +70,7 @@ class QT_DATAVISUALIZATION_EXPORT QAbstract3DGraph : public QWindow, protected Q
     Q_PROPERTY(QLocale locale READ locale WRITE setLocale NOTIFY localeChanged)
     Q_PROPERTY(QVector3D queriedGraphPosition READ queriedGraphPosition NOTIFY queriedGraphPositionChanged)
     Q_PROPERTY(qreal margin READ margin WRITE setMargin NOTIFY marginChanged)
+    Q_PROPERTY(bool rayCastPicking READ isRayCastPicking WRITE setRayCastPicking NOTIFY rayCastPickingChanged)
 
 protected:
     explicit QAbstract3DGraph(QAbstract3DGraphPrivate *d, const QSurfaceFormat *format,
@@ -194,6 +195,9 @@ public:
     void setMargin(qreal margin);
     qreal margin() const;
 
+    void setRayCastPicking(bool enable);
+    bool isRayCastPicking() const;
+
     bool hasContext() const;
 
 protected:
@@ -229,6 +233,7 @@ Q_SIGNALS:
     void localeChanged(const QLocale &locale);
     void queriedGraphPositionChanged(const QVector3D &data);
     void marginChanged(qreal margin);
+    void rayCastPickingChanged(bool enabled);
 
 private:
     Q_DISABLE_COPY(QAbstract3DGraph)
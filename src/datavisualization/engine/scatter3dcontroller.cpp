@@ -85,9 +85,9 @@ void Scatter3DController::synchDataToRenderer()
 
     // Notify changes to renderer
     if (m_changeTracker.itemChanged) {
-        m_renderer->updateItems(m_changedItems);
+        m_renderer->updateItems(m_changedRanges);
         m_changeTracker.itemChanged = false;
-        m_changedItems.clear();
+        m_changedRanges.clear();
     }
 
     if (m_changeTracker.selectedItemChanged) {
@@ -169,27 +169,27 @@ void Scatter3DController::handleItemsAdded(int startIndex, int count)
 void Scatter3DController::handleItemsChanged(int startIndex, int count)
 {
     QScatter3DSeries *series = static_cast<QScatterDataProxy *>(sender())->series();
-    int oldChangeCount = m_changedItems.size();
-    if (!oldChangeCount)
-        m_changedItems.reserve(count);
-
-    for (int i = 0; i < count; i++) {
-        bool newItem = true;
-        int candidate = startIndex + i;
-        for (int j = 0; j < oldChangeCount; j++) {
-            const ChangeItem &oldChangeItem = m_changedItems.at(j);
-            if (oldChangeItem.index == candidate && series == oldChangeItem.series) {
-                newItem = false;
-                break;
-            }
-        }
-        if (newItem) {
-            ChangeItem newChangeItem = {series, candidate};
-            m_changedItems.append(newChangeItem);
-            if (series == m_selectedItemSeries && m_selectedItem == candidate)
-                series->d_ptr->markItemLabelDirty();
+    bool merged = false;
+    if (!m_changedRanges.isEmpty()) {
+        ChangeRange &lastRange = m_changedRanges.last();
+        const int lastEnd = lastRange.startIndex + lastRange.count;
+        if (lastRange.series == series && startIndex <= lastEnd
+                && startIndex + count >= lastRange.startIndex) {
+            const int newEnd = qMax(lastEnd, startIndex + count);
+            lastRange.startIndex = qMin(lastRange.startIndex, startIndex);
+            lastRange.count = newEnd - lastRange.startIndex;
+            merged = true;
         }
     }
+    if (!merged && count) {
+        ChangeRange newRange = {series, startIndex, count};
+        m_changedRanges.append(newRange);
+    }
+
+    if (series == m_selectedItemSeries && m_selectedItem >= startIndex
+            && m_selectedItem < startIndex + count) {
+        series->d_ptr->markItemLabelDirty();
+    }
 
     if (count) {
         m_changeTracker.itemChanged = true;
@@ -65,13 +65,16 @@ class QT_DATAVISUALIZATION_EXPORT Scatter3DController : public Abstract3DControl
     Q_OBJECT
 
 public:
-    struct ChangeItem {
+    // Contiguous block of changed items. Consecutive changes to the same series are merged into
+    // a single range, so that the renderer can update the static buffers with ranged uploads.
+    struct ChangeRange {
         QScatter3DSeries *series;
-        int index;
+        int startIndex;
+        int count;
     };
 private:
     Scatter3DChangeBitField m_changeTracker;
-    QVector<ChangeItem> m_changedItems;
+    QVector<ChangeRange> m_changedRanges;
 
     // Rendering
     Scatter3DRenderer *m_renderer;
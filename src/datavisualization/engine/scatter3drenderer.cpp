@@ -35,8 +35,18 @@
 #include "scatterseriesrendercache_p.h"
 #include "scatterobjectbufferhelper_p.h"
 #include "scatterpointbufferhelper_p.h"
+#include "scatterinstancebufferhelper_p.h"
+#include "itemtransform_p.h"
+#include "qscatterdataproxy_p.h"
 
 #include <QtCore/qmath.h>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include <algorithm>
+#include <limits>
 
 // You can verify that depth buffer drawing works correctly by uncommenting this.
 // You should see the scene from  where the light is
@@ -48,9 +58,57 @@ const GLfloat defaultMinSize = 0.01f;
 const GLfloat defaultMaxSize = 0.1f;
 const GLfloat itemScaler = 3.0f;
 
+// Data arrays smaller than this are converted to render items serially, as handing the work to
+// other threads would cost more than it saves.
+const int parallelItemUpdateThreshold = 100000;
+const int minItemsPerUpdateChunk = 25000;
+
+// Series with at least this many items are culled against the view frustum before their items
+// are drawn one by one.
+const int octreeCullingThreshold = 1000;
+
+// Meshes are normalized to [-1, 1] range before scaling, so the bounding sphere radius of an
+// item is the length of the scaled half diagonal. Culling and ray cast picking both use it, so
+// that every item that can be drawn can also be picked.
+static inline float itemBoundingRadius(float itemSize)
+{
+    return itemSize * float(qSqrt(3.0));
+}
+
+// Converts a chunk of data items into render items in a thread pool thread.
+class ScatterRenderItemUpdater : public QRunnable
+{
+public:
+    ScatterRenderItemUpdater(Scatter3DRenderer *renderer, const ScatterDataView &dataView,
+                             ScatterRenderItemArray &renderArray, int start, int count,
+                             QSemaphore *done)
+        : m_renderer(renderer),
+          m_dataView(dataView),
+          m_renderArray(renderArray),
+          m_start(start),
+          m_count(count),
+          m_done(done)
+    {
+    }
+
+    void run()
+    {
+        m_renderer->updateRenderItemRange(m_dataView, m_renderArray, m_start, m_count);
+        m_done->release();
+    }
+
+private:
+    Scatter3DRenderer *m_renderer;
+    const ScatterDataView &m_dataView;
+    ScatterRenderItemArray &m_renderArray;
+    int m_start;
+    int m_count;
+    QSemaphore *m_done;
+};
+
 Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
     : Abstract3DRenderer(controller),
-      m_selectedItem(0),
+      m_selectedItem(-1),
       m_updateLabels(false),
       m_dotShader(0),
       m_dotGradientShader(0),
@@ -61,6 +119,9 @@ Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
       m_selectionShader(0),
       m_backgroundShader(0),
       m_staticGradientPointShader(0),
+      m_instancedDotShader(0),
+      m_instancedDotGradientShader(0),
+      m_instancedDepthShader(0),
       m_bgrTexture(0),
       m_selectionTexture(0),
       m_depthFrameBuffer(0),
@@ -80,7 +141,8 @@ Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
       m_havePointSeries(false),
       m_haveMeshSeries(false),
       m_haveUniformColorMeshSeries(false),
-      m_haveGradientMeshSeries(false)
+      m_haveGradientMeshSeries(false),
+      m_instancingSupported(false)
 {
     initializeOpenGL();
 }
@@ -104,12 +166,17 @@ Scatter3DRenderer::~Scatter3DRenderer()
     delete m_selectionShader;
     delete m_backgroundShader;
     delete m_staticGradientPointShader;
+    delete m_instancedDotShader;
+    delete m_instancedDotGradientShader;
+    delete m_instancedDepthShader;
 }
 
 void Scatter3DRenderer::initializeOpenGL()
 {
     Abstract3DRenderer::initializeOpenGL();
 
+    m_instancingSupported = Utils::isInstancingSupported();
+
     // Initialize shaders
 
     if (!m_isOpenGLES) {
@@ -190,15 +257,16 @@ void Scatter3DRenderer::updateData()
             const QScatter3DSeries *currentSeries = cache->series();
             ScatterRenderItemArray &renderArray = cache->renderArray();
             QScatterDataProxy *dataProxy = currentSeries->dataProxy();
-            const QScatterDataArray &dataArray = *dataProxy->array();
-            int dataSize = dataArray.size();
+            const ScatterDataView dataView = dataProxy->dptrc()->dataView();
+            int dataSize = dataView.size();
             totalDataSize += dataSize;
             if (cache->dataDirty()) {
                 if (dataSize != renderArray.size())
                     renderArray.resize(dataSize);
 
-                for (int i = 0; i < dataSize; i++)
-                    updateRenderItem(dataArray.at(i), renderArray[i]);
+                updateRenderItems(dataView, renderArray);
+                cache->octree().setDirty();
+                cache->levelOfDetail().setDirty();
 
                 if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic))
                     cache->setStaticBufferDirty(true);
@@ -229,6 +297,15 @@ void Scatter3DRenderer::updateData()
                     }
                     points->setScaleY(m_scaleY);
                     points->load(cache);
+                } else if (m_instancingSupported) {
+                    // Mesh is uploaded only once, so a full load is always cheap
+                    ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+                    if (!instances) {
+                        instances = new ScatterInstanceBufferHelper();
+                        cache->setBufferInstances(instances);
+                    }
+                    instances->setScaleY(m_scaleY);
+                    instances->fullLoad(cache, m_dotSizeScale);
                 } else {
                     ScatterObjectBufferHelper *object = cache->bufferObject();
                     if (!object) {
@@ -299,6 +376,11 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
                 maxItemSize = itemSize;
             if (cache->itemSize() != itemSize)
                 cache->setItemSize(itemSize);
+            if (cache->isLevelOfDetailEnabled() != scatterSeries->isLevelOfDetailEnabled()) {
+                cache->setLevelOfDetailEnabled(scatterSeries->isLevelOfDetailEnabled());
+                cache->levelOfDetail().setDirty();
+                cache->setLevelOfDetailCount(-1);
+            }
             if (noSelection
                     && scatterSeries->selectedItem() != QScatter3DSeries::invalidSelectionIndex()) {
                 if (m_selectionLabel != cache->itemLabel())
@@ -318,8 +400,12 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
 
             if (cache->staticBufferDirty()) {
                 if (cache->mesh() != QAbstract3DSeries::MeshPoint) {
-                    ScatterObjectBufferHelper *object = cache->bufferObject();
-                    object->update(cache, m_dotSizeScale);
+                    if (cache->bufferInstances()) {
+                        cache->bufferInstances()->update(cache, m_dotSizeScale);
+                    } else {
+                        ScatterObjectBufferHelper *object = cache->bufferObject();
+                        object->update(cache, m_dotSizeScale);
+                    }
                 }
                 cache->setStaticBufferDirty(false);
             }
@@ -327,6 +413,8 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
                 if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
                     ScatterPointBufferHelper *object = cache->bufferPoints();
                     object->updateUVs(cache);
+                } else if (cache->bufferInstances()) {
+                    cache->bufferInstances()->updateUVs(cache);
                 } else {
                     ScatterObjectBufferHelper *object = cache->bufferObject();
                     object->updateUVs(cache);
@@ -350,38 +438,50 @@ SeriesRenderCache *Scatter3DRenderer::createNewCache(QAbstract3DSeries *series)
     return new ScatterSeriesRenderCache(series, this);
 }
 
-void Scatter3DRenderer::updateItems(const QVector<Scatter3DController::ChangeItem> &items)
+void Scatter3DRenderer::updateItems(const QVector<Scatter3DController::ChangeRange> &ranges)
 {
     ScatterSeriesRenderCache *cache = 0;
     const QScatter3DSeries *prevSeries = 0;
-    const QScatterDataArray *dataArray = 0;
+    ScatterDataView dataView;
     const bool optimizationStatic = m_cachedOptimizationHint.testFlag(
                 QAbstract3DGraph::OptimizationStatic);
+    QVector<ScatterSeriesRenderCache *> valueCaches;
 
-    foreach (Scatter3DController::ChangeItem item, items) {
-        QScatter3DSeries *currentSeries = item.series;
+    foreach (Scatter3DController::ChangeRange range, ranges) {
+        QScatter3DSeries *currentSeries = range.series;
         if (currentSeries != prevSeries) {
             cache = static_cast<ScatterSeriesRenderCache *>(m_renderCacheList.value(currentSeries));
             prevSeries = currentSeries;
-            dataArray = item.series->dataProxy()->array();
+            dataView = range.series->dataProxy()->dptrc()->dataView();
             // Invisible series render caches are not updated, but instead just marked dirty, so that
             // they can be completely recalculated when they are turned visible.
             if (!cache->isVisible() && !cache->dataDirty())
                 cache->setDataDirty(true);
+            // Setting the first item value gives every item a value, and with that a new
+            // gradient position, so all the items need their values and not just the changed ones
+            if (cache->isVisible() && cache->renderArray().updateValues(dataView)
+                    && !valueCaches.contains(cache)) {
+                valueCaches.append(cache);
+            }
         }
         if (cache->isVisible()) {
-            const int index = item.index;
-            if (index >= cache->renderArray().size())
-                continue; // Items removed from array for same render
-            bool oldVisibility;
-            ScatterRenderItem &item = cache->renderArray()[index];
-            if (optimizationStatic)
-                oldVisibility = item.isVisible();
-            updateRenderItem(dataArray->at(index), item);
-            if (optimizationStatic) {
-                if (!cache->visibilityChanged() && oldVisibility != item.isVisible())
-                    cache->setVisibilityChanged(true);
-                cache->updateIndices().append(index);
+            // Items removed from array for same render are skipped
+            const int endIndex = qMin(range.startIndex + range.count, cache->renderArray().size());
+            ScatterRenderItemArray &renderArray = cache->renderArray();
+            ScatterLevelOfDetail &levelOfDetail = cache->levelOfDetail();
+            for (int index = range.startIndex; index < endIndex; index++) {
+                bool oldVisibility;
+                if (optimizationStatic)
+                    oldVisibility = renderArray.isVisible(index);
+                updateRenderItem(dataView, renderArray, index);
+                cache->octree().updateItem(renderArray, index);
+                levelOfDetail.updateItem(renderArray, index);
+                if (optimizationStatic) {
+                    if (!cache->visibilityChanged()
+                            && oldVisibility != renderArray.isVisible(index))
+                        cache->setVisibilityChanged(true);
+                    cache->updateIndices().append(index);
+                }
             }
         }
     }
@@ -389,12 +489,30 @@ void Scatter3DRenderer::updateItems(const QVector<Scatter3DController::ChangeIte
         foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
             ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
             if (cache->isVisible() && cache->updateIndices().size()) {
+                // Ranges of separate changes may overlap, so the buffer helpers get the indices
+                // sorted and unique, which allows them to upload contiguous blocks at once.
+                QVector<int> &updateIndices = cache->updateIndices();
+                std::sort(updateIndices.begin(), updateIndices.end());
+                updateIndices.erase(std::unique(updateIndices.begin(), updateIndices.end()),
+                                    updateIndices.end());
+                const bool valuesChanged = valueCaches.contains(cache);
                 if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
                     cache->bufferPoints()->update(cache);
-                    if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient)
+                    if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient) {
+                        if (valuesChanged)
+                            cache->updateIndices().clear();
                         cache->bufferPoints()->updateUVs(cache);
+                    }
+                } else if (cache->bufferInstances()) {
+                    // Instance data includes the gradient, so no separate UV update is needed
+                    if (cache->visibilityChanged() || valuesChanged) {
+                        cache->updateIndices().clear();
+                        cache->bufferInstances()->fullLoad(cache, m_dotSizeScale);
+                    } else {
+                        cache->bufferInstances()->update(cache, m_dotSizeScale);
+                    }
                 } else {
-                    if (cache->visibilityChanged()) {
+                    if (cache->visibilityChanged() || valuesChanged) {
                         // If any change changes item visibility, full load is needed to
                         // resize the buffers.
                         cache->updateIndices().clear();
@@ -444,6 +562,7 @@ void Scatter3DRenderer::updateOptimizationHint(QAbstract3DGraph::OptimizationHin
     Abstract3DRenderer::updateOptimizationHint(hint);
 
     Abstract3DRenderer::reInitShaders();
+    initInstancedShaders();
 
     if (m_isOpenGLES && hint.testFlag(QAbstract3DGraph::OptimizationStatic)
             && !m_staticGradientPointShader) {
@@ -491,6 +610,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
 
     const Q3DCamera *activeCamera = m_cachedScene->activeCamera();
 
+    updateLevelOfDetail(activeCamera);
+
     QVector4D lightColor = Utils::vectorFromColor(m_cachedTheme->lightColor());
 
     // Specify viewport
@@ -605,29 +726,31 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     }
                     QVector3D modelScaler(itemSize, itemSize, itemSize);
 
-                    if (!optimizationDefault
-                            && ((drawingPoints && cache->bufferPoints()->indexCount() == 0)
-                                || (!drawingPoints && cache->bufferObject()->indexCount() == 0))) {
+                    if (!optimizationDefault && !cache->hasStaticBufferData())
                         continue;
-                    }
 
                     int loopCount = 1;
-                    if (optimizationDefault)
-                        loopCount = renderArraySize;
-                    for (int dot = 0; dot < loopCount; dot++) {
-                        const ScatterRenderItem &item = renderArray.at(dot);
-                        if (!item.isVisible() && optimizationDefault)
+                    bool culled = false;
+                    if (optimizationDefault) {
+                        culled = cullItems(cache, depthProjectionViewMatrix, itemSize);
+                        loopCount = culled ? m_culledItems.size() : renderArraySize;
+                    }
+                    for (int loopIndex = 0; loopIndex < loopCount; loopIndex++) {
+                        const int dot = culled ? m_culledItems.at(loopIndex) : loopIndex;
+                        if (optimizationDefault && !renderArray.isVisible(dot))
                             continue;
 
                         QMatrix4x4 modelMatrix;
                         QMatrix4x4 MVPMatrix;
 
                         if (optimizationDefault) {
-                            modelMatrix.translate(item.translation());
-                            if (!drawingPoints) {
-                                if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
-                                    modelMatrix.rotate(seriesRotation * item.rotation());
-                                modelMatrix.scale(modelScaler);
+                            if (drawingPoints) {
+                                modelMatrix.translate(renderArray.translation(dot));
+                            } else {
+                                modelMatrix = ItemTransform::modelMatrix(
+                                            renderArray.translation(dot),
+                                            seriesRotation * renderArray.rotation(dot),
+                                            modelScaler);
                             }
                         }
 
@@ -639,7 +762,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                             if (optimizationDefault)
                                 m_drawer->drawPoint(m_depthShader);
                             else
-                                m_drawer->drawPoints(m_depthShader, cache->bufferPoints(), 0);
+                                m_drawer->drawPoints(m_depthShader, cache->bufferPoints(), 0,
+                                                     cache->levelOfDetailCount());
                         } else {
                             if (optimizationDefault) {
                                 // 1st attribute buffer : vertices
@@ -660,6 +784,13 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                                 glBindBuffer(GL_ARRAY_BUFFER, 0);
 
                                 glDisableVertexAttribArray(m_depthShader->posAtt());
+                            } else if (cache->bufferInstances()) {
+                                m_instancedDepthShader->bind();
+                                m_instancedDepthShader->setUniformValue(
+                                            m_instancedDepthShader->MVP(), MVPMatrix);
+                                m_drawer->drawInstancedObject(m_instancedDepthShader, dotObj,
+                                                              cache->bufferInstances());
+                                m_depthShader->bind();
                             } else {
                                 ScatterObjectBufferHelper *object = cache->bufferObject();
                                 // 1st attribute buffer : vertices
@@ -734,66 +865,71 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Needed for clearing the frame buffer
         glDisable(GL_DITHER); // disable dithering, it may affect colors if enabled
 
-        bool previousDrawingPoints = false;
-        int totalIndex = 0;
-        foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-            if (baseCache->isVisible()) {
-                ScatterSeriesRenderCache *cache =
-                        static_cast<ScatterSeriesRenderCache *>(baseCache);
-                ObjectHelper *dotObj = cache->object();
-                QQuaternion seriesRotation(cache->meshRotation());
-                const ScatterRenderItemArray &renderArray = cache->renderArray();
-                const int renderArraySize = renderArray.size();
-                bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
-                float itemSize = cache->itemSize() / itemScaler;
-                if (itemSize == 0.0f)
-                    itemSize = m_dotSizeScale;
+        // Series items are resolved from the click ray instead when ray cast picking is used
+        if (!m_rayCastPicking) {
+            bool previousDrawingPoints = false;
+            int totalIndex = 0;
+            foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+                if (baseCache->isVisible()) {
+                    ScatterSeriesRenderCache *cache =
+                            static_cast<ScatterSeriesRenderCache *>(baseCache);
+                    ObjectHelper *dotObj = cache->object();
+                    QQuaternion seriesRotation(cache->meshRotation());
+                    const ScatterRenderItemArray &renderArray = cache->renderArray();
+                    const int renderArraySize = renderArray.size();
+                    bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
+                    float itemSize = cache->itemSize() / itemScaler;
+                    if (itemSize == 0.0f)
+                        itemSize = m_dotSizeScale;
 #if !defined(QT_OPENGL_ES_2)
-                if (drawingPoints && !m_isOpenGLES)
-                    m_funcs_2_1->glPointSize(itemSize * activeCamera->zoomLevel());
+                    if (drawingPoints && !m_isOpenGLES)
+                        m_funcs_2_1->glPointSize(itemSize * activeCamera->zoomLevel());
 #endif
-                QVector3D modelScaler(itemSize, itemSize, itemSize);
+                    QVector3D modelScaler(itemSize, itemSize, itemSize);
 
-                // Rebind selection shader if it has changed
-                if (!totalIndex || drawingPoints != previousDrawingPoints) {
-                    previousDrawingPoints = drawingPoints;
-                    if (drawingPoints)
-                        selectionShader = pointSelectionShader;
-                    else
-                        selectionShader = m_selectionShader;
+                    // Rebind selection shader if it has changed
+                    if (!totalIndex || drawingPoints != previousDrawingPoints) {
+                        previousDrawingPoints = drawingPoints;
+                        if (drawingPoints)
+                            selectionShader = pointSelectionShader;
+                        else
+                            selectionShader = m_selectionShader;
 
-                    selectionShader->bind();
-                }
-                cache->setSelectionIndexOffset(totalIndex);
-                for (int dot = 0; dot < renderArraySize; dot++) {
-                    const ScatterRenderItem &item = renderArray.at(dot);
-                    if (!item.isVisible()) {
-                        totalIndex++;
-                        continue;
+                        selectionShader->bind();
                     }
+                    cache->setSelectionIndexOffset(totalIndex);
+                    const bool culled = cullItems(cache, projectionViewMatrix, itemSize);
+                    const int loopCount = culled ? m_culledItems.size() : renderArraySize;
+                    for (int loopIndex = 0; loopIndex < loopCount; loopIndex++) {
+                        const int dot = culled ? m_culledItems.at(loopIndex) : loopIndex;
+                        if (!renderArray.isVisible(dot))
+                            continue;
 
-                    QMatrix4x4 modelMatrix;
-                    QMatrix4x4 MVPMatrix;
+                        QMatrix4x4 modelMatrix;
+                        QMatrix4x4 MVPMatrix;
 
-                    modelMatrix.translate(item.translation());
-                    if (!drawingPoints) {
-                        if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
-                            modelMatrix.rotate(seriesRotation * item.rotation());
-                        modelMatrix.scale(modelScaler);
-                    }
+                        if (drawingPoints) {
+                            modelMatrix.translate(renderArray.translation(dot));
+                        } else {
+                            modelMatrix = ItemTransform::modelMatrix(
+                                        renderArray.translation(dot),
+                                        seriesRotation * renderArray.rotation(dot), modelScaler);
+                        }
 
-                    MVPMatrix = projectionViewMatrix * modelMatrix;
+                        MVPMatrix = projectionViewMatrix * modelMatrix;
 
-                    QVector4D dotColor = indexToSelectionColor(totalIndex++);
-                    dotColor /= 255.0f;
+                        QVector4D dotColor = indexToSelectionColor(totalIndex + dot);
+                        dotColor /= 255.0f;
 
-                    selectionShader->setUniformValue(selectionShader->MVP(), MVPMatrix);
-                    selectionShader->setUniformValue(selectionShader->color(), dotColor);
+                        selectionShader->setUniformValue(selectionShader->MVP(), MVPMatrix);
+                        selectionShader->setUniformValue(selectionShader->color(), dotColor);
 
-                    if (drawingPoints)
-                        m_drawer->drawPoint(selectionShader);
-                    else
-                        m_drawer->drawSelectionObject(selectionShader, dotObj);
+                        if (drawingPoints)
+                            m_drawer->drawPoint(selectionShader);
+                        else
+                            m_drawer->drawSelectionObject(selectionShader, dotObj);
+                    }
+                    totalIndex += renderArraySize;
                 }
             }
         }
@@ -811,6 +947,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
         QVector4D clickedColor = Utils::getSelection(m_inputPosition,
                                                      m_viewport.height());
         selectionColorToSeriesAndIndex(clickedColor, m_clickedIndex, m_clickedSeries);
+        if (m_rayCastPicking && m_clickedType == QAbstract3DGraph::ElementNone)
+            rayCastToSeriesAndIndex(activeCamera, projectionViewMatrix, m_clickedIndex,
+                                    m_clickedSeries);
         m_clickResolved = true;
 
         emit needRender();
@@ -827,7 +966,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
     ShaderHelper *dotShader = 0;
     GLuint gradientTexture = 0;
     bool dotSelectionFound = false;
-    ScatterRenderItem *selectedItem(0);
+    ScatterRenderItem selectedItem;
+    int selectedItemIndex = -1;
     QVector4D baseColor;
     QVector4D dotColor;
 
@@ -860,8 +1000,6 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
         dotShader = pointSelectionShader;
     }
 
-    float rangeGradientYScaler = 0.5f / m_scaleY;
-
     foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
         if (baseCache->isVisible()) {
             ScatterSeriesRenderCache *cache =
@@ -889,11 +1027,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
             int gradientImageHeight = cache->gradientImage().height();
             int maxGradientPositition = gradientImageHeight - 1;
 
-            if (!optimizationDefault
-                    && ((drawingPoints && cache->bufferPoints()->indexCount() == 0)
-                        || (!drawingPoints && cache->bufferObject()->indexCount() == 0))) {
+            if (!optimizationDefault && !cache->hasStaticBufferData())
                 continue;
-            }
 
             // Rebind shader if it has changed
             if (drawingPoints != previousDrawingPoints
@@ -940,12 +1075,71 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 dotColor = baseColor;
             }
             int loopCount = 1;
-            if (optimizationDefault)
-                loopCount = renderArraySize;
+            bool culled = false;
+            if (optimizationDefault) {
+#ifdef SHOW_DEPTH_TEXTURE_SCENE
+                culled = cullItems(cache, depthProjectionViewMatrix, itemSize);
+#else
+                culled = cullItems(cache, projectionViewMatrix, itemSize);
+#endif
+                loopCount = culled ? m_culledItems.size() : renderArraySize;
+            }
+
+            if (!optimizationDefault && !drawingPoints && cache->bufferInstances()) {
+                // Draw all items of the series with a single instanced draw call
+                ShaderHelper *instancedShader = colorStyleIsUniform
+                        ? m_instancedDotShader : m_instancedDotGradientShader;
+                instancedShader->bind();
+                instancedShader->setUniformValue(instancedShader->lightP(), lightPos);
+                instancedShader->setUniformValue(instancedShader->view(), viewMatrix);
+                instancedShader->setUniformValue(instancedShader->ambientS(),
+                                                 m_cachedTheme->ambientLightStrength());
+                instancedShader->setUniformValue(instancedShader->lightColor(), lightColor);
+#ifdef SHOW_DEPTH_TEXTURE_SCENE
+                instancedShader->setUniformValue(instancedShader->MVP(),
+                                                 depthProjectionViewMatrix);
+#else
+                instancedShader->setUniformValue(instancedShader->MVP(), projectionViewMatrix);
+#endif
+                if (colorStyleIsUniform) {
+                    instancedShader->setUniformValue(instancedShader->color(), baseColor);
+                    gradientTexture = 0;
+                } else {
+                    // Range gradient is resolved per instance, object gradient per vertex
+                    if (colorStyle == Q3DTheme::ColorStyleObjectGradient)
+                        instancedShader->setUniformValue(instancedShader->gradientHeight(), 0.5f);
+                    else
+                        instancedShader->setUniformValue(instancedShader->gradientHeight(), 0.0f);
+                    gradientTexture = cache->baseGradientTexture();
+                }
 
-            for (int i = 0; i < loopCount; i++) {
-                ScatterRenderItem &item = renderArray[i];
-                if (!item.isVisible() && optimizationDefault)
+                GLfloat lightStrength = m_cachedTheme->lightStrength();
+                if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone && !m_isOpenGLES) {
+                    // Set shadow shader bindings
+                    instancedShader->setUniformValue(instancedShader->shadowQ(),
+                                                     m_shadowQualityToShader);
+                    instancedShader->setUniformValue(instancedShader->depth(),
+                                                     depthProjectionViewMatrix);
+                    instancedShader->setUniformValue(instancedShader->lightS(),
+                                                     lightStrength / 10.0f);
+                    m_drawer->drawInstancedObject(instancedShader, dotObj,
+                                                  cache->bufferInstances(), gradientTexture,
+                                                  m_depthTexture);
+                } else {
+                    // Set shadowless shader bindings
+                    instancedShader->setUniformValue(instancedShader->lightS(), lightStrength);
+                    m_drawer->drawInstancedObject(instancedShader, dotObj,
+                                                  cache->bufferInstances(), gradientTexture);
+                }
+
+                // Restore the shader the rest of the series loop expects to be bound
+                dotShader->bind();
+                loopCount = 0;
+            }
+
+            for (int loopIndex = 0; loopIndex < loopCount; loopIndex++) {
+                const int i = culled ? m_culledItems.at(loopIndex) : loopIndex;
+                if (optimizationDefault && !renderArray.isVisible(i))
                     continue;
 
                 QMatrix4x4 modelMatrix;
@@ -953,15 +1147,13 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 QMatrix4x4 itModelMatrix;
 
                 if (optimizationDefault) {
-                    modelMatrix.translate(item.translation());
-                    if (!drawingPoints) {
-                        if (!seriesRotation.isIdentity() || !item.rotation().isIdentity()) {
-                            QQuaternion totalRotation = seriesRotation * item.rotation();
-                            modelMatrix.rotate(totalRotation);
-                            itModelMatrix.rotate(totalRotation);
-                        }
-                        modelMatrix.scale(modelScaler);
-                        itModelMatrix.scale(modelScaler);
+                    if (drawingPoints) {
+                        modelMatrix.translate(renderArray.translation(i));
+                    } else {
+                        ItemTransform::modelAndNormalMatrix(
+                                    renderArray.translation(i),
+                                    seriesRotation * renderArray.rotation(i), modelScaler,
+                                    modelMatrix, itModelMatrix);
                     }
                 }
 #ifdef SHOW_DEPTH_TEXTURE_SCENE
@@ -973,8 +1165,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 if (useColor) {
                     if (rangeGradientPoints) {
                         // Drawing points with range gradient
-                        // Get color from gradient based on items y position converted to percent
-                        int position = ((item.translation().y() + m_scaleY) * rangeGradientYScaler) * gradientImageHeight;
+                        // Get color from gradient based on items value or y position
+                        int position = renderArray.gradientPosition(i, m_scaleY)
+                                * gradientImageHeight;
                         position = qMin(maxGradientPositition, position); // clamp to edge
                         dotColor = Utils::vectorFromColor(
                                     cache->gradientImage().pixel(0, position));
@@ -995,8 +1188,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     else
                         gradientTexture = cache->singleHighlightGradientTexture();
                     lightStrength = m_cachedTheme->highlightLightStrength();
-                    // Save the reference to the item to be used in label drawing
-                    selectedItem = &item;
+                    // Save the item to be used in label drawing
+                    selectedItem = renderArray.item(i);
+                    selectedItemIndex = i;
                     dotSelectionFound = true;
                     // Save selected item size (adjusted with font size) for selection label
                     // positioning
@@ -1006,8 +1200,7 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 if (!drawingPoints) {
                     // Set shader bindings
                     dotShader->setUniformValue(dotShader->model(), modelMatrix);
-                    dotShader->setUniformValue(dotShader->nModel(),
-                                               itModelMatrix.inverted().transposed());
+                    dotShader->setUniformValue(dotShader->nModel(), itModelMatrix);
                 }
 
                 dotShader->setUniformValue(dotShader->MVP(), MVPMatrix);
@@ -1015,8 +1208,7 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     dotShader->setUniformValue(dotShader->color(), dotColor);
                 } else if (colorStyle == Q3DTheme::ColorStyleRangeGradient) {
                     dotShader->setUniformValue(dotShader->gradientMin(),
-                                               (item.translation().y() + m_scaleY)
-                                               * rangeGradientYScaler);
+                                               renderArray.gradientPosition(i, m_scaleY));
                 }
                 if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone && !m_isOpenGLES) {
                     if (!drawingPoints) {
@@ -1039,7 +1231,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                         if (optimizationDefault)
                             m_drawer->drawPoint(dotShader);
                         else
-                            m_drawer->drawPoints(dotShader, cache->bufferPoints(), gradientTexture);
+                            m_drawer->drawPoints(dotShader, cache->bufferPoints(), gradientTexture,
+                                                 cache->levelOfDetailCount());
                     }
                 } else {
                     if (!drawingPoints) {
@@ -1055,7 +1248,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                         if (optimizationDefault)
                             m_drawer->drawPoint(dotShader);
                         else
-                            m_drawer->drawPoints(dotShader, cache->bufferPoints(), gradientTexture);
+                            m_drawer->drawPoints(dotShader, cache->bufferPoints(), gradientTexture,
+                                                 cache->levelOfDetailCount());
                     }
                 }
             }
@@ -1064,7 +1258,7 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
             // Draw the selected item on static optimization
             if (!optimizationDefault && selectedSeries
                     && m_selectedItemIndex != Scatter3DController::invalidSelectionIndex()) {
-                ScatterRenderItem &item = renderArray[m_selectedItemIndex];
+                ScatterRenderItem item = renderArray.item(m_selectedItemIndex);
                 if (item.isVisible()) {
                     ShaderHelper *selectionShader;
                     if (drawingPoints) {
@@ -1082,15 +1276,13 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     QMatrix4x4 modelMatrix;
                     QMatrix4x4 itModelMatrix;
 
-                    modelMatrix.translate(item.translation());
-                    if (!drawingPoints) {
-                        if (!seriesRotation.isIdentity() || !item.rotation().isIdentity()) {
-                            QQuaternion totalRotation = seriesRotation * item.rotation();
-                            modelMatrix.rotate(totalRotation);
-                            itModelMatrix.rotate(totalRotation);
-                        }
-                        modelMatrix.scale(modelScaler);
-                        itModelMatrix.scale(modelScaler);
+                    if (drawingPoints) {
+                        modelMatrix.translate(item.translation());
+                    } else {
+                        ItemTransform::modelAndNormalMatrix(item.translation(),
+                                                            seriesRotation * item.rotation(),
+                                                            modelScaler, modelMatrix,
+                                                            itModelMatrix);
 
                         selectionShader->setUniformValue(selectionShader->lightP(),
                                                          lightPos);
@@ -1114,8 +1306,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     else
                         gradientTexture = cache->singleHighlightGradientTexture();
                     GLfloat lightStrength = m_cachedTheme->highlightLightStrength();
-                    // Save the reference to the item to be used in label drawing
-                    selectedItem = &item;
+                    // Save the item to be used in label drawing
+                    selectedItem = item;
+                    selectedItemIndex = m_selectedItemIndex;
                     dotSelectionFound = true;
                     // Save selected item size (adjusted with font size) for selection label
                     // positioning
@@ -1124,8 +1317,7 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     if (!drawingPoints) {
                         // Set shader bindings
                         selectionShader->setUniformValue(selectionShader->model(), modelMatrix);
-                        selectionShader->setUniformValue(selectionShader->nModel(),
-                                                         itModelMatrix.inverted().transposed());
+                        selectionShader->setUniformValue(selectionShader->nModel(), itModelMatrix);
                         if (!colorStyleIsUniform) {
                             if (colorStyle == Q3DTheme::ColorStyleObjectGradient) {
                                 selectionShader->setUniformValue(selectionShader->gradientMin(),
@@ -1133,12 +1325,14 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                                 selectionShader->setUniformValue(selectionShader->gradientHeight(),
                                                                  0.5f);
                             } else {
-                                // Each dot is of uniform color according to its Y-coordinate
+                                // Each dot is of uniform color according to its value or
+                                // Y-coordinate
                                 selectionShader->setUniformValue(selectionShader->gradientHeight(),
                                                                  0.0f);
-                                selectionShader->setUniformValue(selectionShader->gradientMin(),
-                                                                 (item.translation().y() + m_scaleY)
-                                                                 * rangeGradientYScaler);
+                                selectionShader->setUniformValue(
+                                            selectionShader->gradientMin(),
+                                            renderArray.gradientPosition(m_selectedItemIndex,
+                                                                         m_scaleY));
                             }
                         }
                     }
@@ -1611,13 +1805,12 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
 
     // Handle selection clearing and selection label drawing
     if (!dotSelectionFound) {
-        // We have no ownership, don't delete. Just NULL the pointer.
-        m_selectedItem = NULL;
+        m_selectedItem = -1;
     } else {
         glDisable(GL_DEPTH_TEST);
         // Draw the selection label
         LabelItem &labelItem = selectionLabelItem();
-        if (m_selectedItem != selectedItem || m_updateLabels
+        if (m_selectedItem != selectedItemIndex || m_updateLabels
                 || !labelItem.textureId() || m_selectionLabelDirty) {
             QString labelText = selectionLabel();
             if (labelText.isNull() || m_selectionLabelDirty) {
@@ -1626,10 +1819,10 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 m_selectionLabelDirty = false;
             }
             m_drawer->generateLabelItem(labelItem, labelText);
-            m_selectedItem = selectedItem;
+            m_selectedItem = selectedItemIndex;
         }
 
-        m_drawer->drawLabel(*selectedItem, labelItem, viewMatrix, projectionMatrix,
+        m_drawer->drawLabel(selectedItem, labelItem, viewMatrix, projectionMatrix,
                             zeroVector, identityQuaternion, selectedItemSize, m_cachedSelectionMode,
                             m_labelShader, m_labelObj, activeCamera, true, false,
                             Drawer::LabelOver);
@@ -2207,6 +2400,7 @@ void Scatter3DRenderer::updateShadowQuality(QAbstract3DGraph::ShadowQuality qual
     }
 
     handleShadowQualityChange();
+    initInstancedShaders();
 
     // Re-init depth buffer
     updateDepthBuffer();
@@ -2240,10 +2434,10 @@ void Scatter3DRenderer::fixMeshFileName(QString &fileName, QAbstract3DSeries::Me
     }
 }
 
-void Scatter3DRenderer::calculateTranslation(ScatterRenderItem &item)
+void Scatter3DRenderer::calculateTranslation(ScatterRenderItemArray &renderArray, int index)
 {
     // We need to normalize translations
-    const QVector3D &pos = item.position();
+    const QVector3D &pos = renderArray.position(index);
     float xTrans;
     float yTrans = m_axisCacheY.positionAt(pos.y());
     float zTrans;
@@ -2253,7 +2447,7 @@ void Scatter3DRenderer::calculateTranslation(ScatterRenderItem &item)
         xTrans = m_axisCacheX.positionAt(pos.x());
         zTrans = m_axisCacheZ.positionAt(pos.z());
     }
-    item.setTranslation(QVector3D(xTrans, yTrans, zTrans));
+    renderArray.setTranslation(index, QVector3D(xTrans, yTrans, zTrans));
 }
 
 void Scatter3DRenderer::calculateSceneScalingFactors()
@@ -2427,6 +2621,53 @@ void Scatter3DRenderer::initStaticPointShaders(const QString &vertexShader,
     m_staticGradientPointShader->initialize();
 }
 
+void Scatter3DRenderer::initInstancedShaders()
+{
+    delete m_instancedDotShader;
+    delete m_instancedDotGradientShader;
+    delete m_instancedDepthShader;
+    m_instancedDotShader = 0;
+    m_instancedDotGradientShader = 0;
+    m_instancedDepthShader = 0;
+
+    // Instanced shaders are only needed for static optimization
+    if (!m_instancingSupported
+            || !m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)) {
+        return;
+    }
+
+    if (!m_isOpenGLES) {
+        if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+            m_instancedDotShader =
+                    new ShaderHelper(this, QStringLiteral(":/shaders/vertexShadowInstanced"),
+                                     QStringLiteral(":/shaders/fragmentShadowNoTex"));
+            m_instancedDotGradientShader =
+                    new ShaderHelper(this, QStringLiteral(":/shaders/vertexShadowInstanced"),
+                                     QStringLiteral(":/shaders/fragmentShadow"));
+        } else {
+            m_instancedDotShader =
+                    new ShaderHelper(this, QStringLiteral(":/shaders/vertexInstanced"),
+                                     QStringLiteral(":/shaders/fragment"));
+            m_instancedDotGradientShader =
+                    new ShaderHelper(this, QStringLiteral(":/shaders/vertexInstanced"),
+                                     QStringLiteral(":/shaders/fragmentTexture"));
+        }
+        m_instancedDepthShader =
+                new ShaderHelper(this, QStringLiteral(":/shaders/vertexDepthInstanced"),
+                                 QStringLiteral(":/shaders/fragmentDepth"));
+        m_instancedDepthShader->initialize();
+    } else {
+        m_instancedDotShader =
+                new ShaderHelper(this, QStringLiteral(":/shaders/vertexInstanced"),
+                                 QStringLiteral(":/shaders/fragmentES2"));
+        m_instancedDotGradientShader =
+                new ShaderHelper(this, QStringLiteral(":/shaders/vertexInstanced"),
+                                 QStringLiteral(":/shaders/fragmentTextureES2"));
+    }
+    m_instancedDotShader->initialize();
+    m_instancedDotGradientShader->initialize();
+}
+
 void Scatter3DRenderer::selectionColorToSeriesAndIndex(const QVector4D &color,
                                                        int &index,
                                                        QAbstract3DSeries *&series)
@@ -2484,22 +2725,230 @@ void Scatter3DRenderer::selectionColorToSeriesAndIndex(const QVector4D &color,
     series = 0;
 }
 
-void Scatter3DRenderer::updateRenderItem(const QScatterDataItem &dataItem,
-                                         ScatterRenderItem &renderItem)
+void Scatter3DRenderer::rayCastToSeriesAndIndex(const Q3DCamera *activeCamera,
+                                                const QMatrix4x4 &projectionViewMatrix,
+                                                int &index, QAbstract3DSeries *&series)
+{
+    index = Scatter3DController::invalidSelectionIndex();
+    series = 0;
+
+    QVector3D rayOrigin;
+    QVector3D rayDirection;
+    const QPointF click = calculateClickRay(projectionViewMatrix, rayOrigin, rayDirection);
+    const float clickX = float(click.x());
+    const float clickY = float(click.y());
+    const float viewportWidth = float(m_primarySubViewport.width());
+    const float viewportHeight = float(m_primarySubViewport.height());
+
+    float closestDistance = std::numeric_limits<float>::max();
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        if (!baseCache->isVisible())
+            continue;
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        const ScatterRenderItemArray &renderArray = cache->renderArray();
+        const bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
+        float itemSize = cache->itemSize() / itemScaler;
+        if (itemSize == 0.0f)
+            itemSize = m_dotSizeScale;
+
+        // Points have a constant size on screen, so they are hit tested in pixels. Mesh items
+        // are hit tested against the same bounding spheres they are culled with.
+        const float pointRadius = qMax(0.5f, itemSize * activeCamera->zoomLevel() / 2.0f);
+        const float pickRadius = drawingPoints ? pointRadius : 0.5f;
+        const float itemRadius = drawingPoints ? 0.0f : itemBoundingRadius(itemSize);
+
+        // Restrict the frustum to the pixels around the click to find the candidate items
+        QMatrix4x4 pickMatrix;
+        pickMatrix.scale(viewportWidth / (2.0f * pickRadius),
+                         viewportHeight / (2.0f * pickRadius), 1.0f);
+        pickMatrix.translate(-clickX, -clickY, 0.0f);
+        cache->octree().findItems(renderArray, pickMatrix * projectionViewMatrix, itemRadius,
+                                  m_culledItems);
+
+        const int levelOfDetailCount = cache->levelOfDetailCount();
+        foreach (int dot, m_culledItems) {
+            // Only items that are drawn can be picked
+            if (levelOfDetailCount >= 0) {
+                const int rank = cache->levelOfDetail().itemRank(dot);
+                if (rank < 0 || rank >= levelOfDetailCount)
+                    continue;
+            }
+
+            const QVector3D &translation = renderArray.translation(dot);
+            const QVector3D toItem = translation - rayOrigin;
+            const float alongRay = QVector3D::dotProduct(toItem, rayDirection);
+            float distance;
+            if (drawingPoints) {
+                const QVector4D clipPos = projectionViewMatrix * QVector4D(translation, 1.0f);
+                if (clipPos.w() <= 0.0f)
+                    continue;
+                const float pixelX = (clipPos.x() / clipPos.w() - clickX) * viewportWidth / 2.0f;
+                const float pixelY = (clipPos.y() / clipPos.w() - clickY) * viewportHeight / 2.0f;
+                if (pixelX * pixelX + pixelY * pixelY > pointRadius * pointRadius)
+                    continue;
+                distance = alongRay;
+            } else {
+                const float missSquared = toItem.lengthSquared() - alongRay * alongRay;
+                const float radiusSquared = itemRadius * itemRadius;
+                if (missSquared > radiusSquared)
+                    continue;
+                distance = alongRay - float(qSqrt(radiusSquared - missSquared));
+            }
+
+            if (distance >= 0.0f && distance < closestDistance) {
+                closestDistance = distance;
+                index = dot;
+                series = cache->series();
+            }
+        }
+    }
+
+    if (series)
+        m_clickedType = QAbstract3DGraph::ElementSeries;
+}
+
+bool Scatter3DRenderer::cullItems(ScatterSeriesRenderCache *cache,
+                                  const QMatrix4x4 &viewProjectionMatrix, float itemSize)
+{
+    const int levelOfDetailCount = cache->levelOfDetailCount();
+
+    // Small series are cheaper to loop through than to cull
+    if (cache->renderArray().size() < octreeCullingThreshold) {
+        if (levelOfDetailCount < 0)
+            return false;
+        m_culledItems = cache->levelOfDetail().itemOrder().mid(0, levelOfDetailCount);
+        std::sort(m_culledItems.begin(), m_culledItems.end());
+        return true;
+    }
+
+    cache->octree().findItems(cache->renderArray(), viewProjectionMatrix,
+                              itemBoundingRadius(itemSize), m_culledItems);
+
+    if (levelOfDetailCount >= 0) {
+        const ScatterLevelOfDetail &levelOfDetail = cache->levelOfDetail();
+        int count = 0;
+        foreach (int index, m_culledItems) {
+            const int rank = levelOfDetail.itemRank(index);
+            if (rank >= 0 && rank < levelOfDetailCount)
+                m_culledItems[count++] = index;
+        }
+        m_culledItems.resize(count);
+    }
+    return true;
+}
+
+void Scatter3DRenderer::updateLevelOfDetail(const Q3DCamera *activeCamera)
+{
+    // The size of the whole graph on screen decides how many items can be told apart
+    const float graphPixelSize = float(qMin(m_primarySubViewport.width(),
+                                            m_primarySubViewport.height()))
+            * activeCamera->zoomLevel() / 100.0f;
+    const bool optimizationStatic =
+            m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
+
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        if (!cache->isVisible() || !cache->isLevelOfDetailEnabled())
+            continue;
+
+        ScatterLevelOfDetail &levelOfDetail = cache->levelOfDetail();
+        const bool staticPoints = optimizationStatic
+                && cache->mesh() == QAbstract3DSeries::MeshPoint && cache->bufferPoints();
+        const bool rebuild = levelOfDetail.isDirty();
+        if (rebuild)
+            levelOfDetail.build(cache->renderArray());
+        if (staticPoints && (rebuild || !cache->bufferPoints()->m_elementbuffer))
+            cache->bufferPoints()->loadLevelOfDetail(levelOfDetail.itemOrder());
+
+        // Static meshes are baked into a single buffer in data order and cannot be decimated
+        if (optimizationStatic && !staticPoints) {
+            cache->setLevelOfDetailCount(-1);
+        } else {
+            const int count = levelOfDetail.itemCount(graphPixelSize);
+            cache->setLevelOfDetailCount(count < levelOfDetail.itemOrder().size() ? count : -1);
+        }
+    }
+}
+
+void Scatter3DRenderer::updateRenderItems(const ScatterDataView &dataView,
+                                          ScatterRenderItemArray &renderArray)
+{
+    const int dataSize = dataView.size();
+
+    // Rotation storage is prepared before the update, as it can't be allocated while the items
+    // are updated from several threads. Storage is dropped if no item is rotated anymore.
+    bool rotatedItems = false;
+    for (int i = 0; dataView.hasRotations() && i < dataSize; i++) {
+        if (!dataView.rotation(i).isIdentity()) {
+            rotatedItems = true;
+            break;
+        }
+    }
+    renderArray.setRotationsEnabled(rotatedItems);
+    renderArray.setValuesEnabled(dataView.hasValues());
+
+    int chunkCount = 1;
+    if (dataSize >= parallelItemUpdateThreshold)
+        chunkCount = qMin(QThread::idealThreadCount(), dataSize / minItemsPerUpdateChunk);
+
+    if (chunkCount <= 1) {
+        updateRenderItemRange(dataView, renderArray, 0, dataSize);
+        return;
+    }
+
+    // Each chunk writes a separate part of the render array, so the result is identical to
+    // a serial update. Chunks are aligned to visibility blocks, so that no two threads write
+    // the same block. The first chunk is handled in this thread, as are the chunks for which
+    // the pool has no free thread.
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore done;
+    int startedCount = 0;
+    const int blockSize = ScatterRenderItemArray::visibilityBlockSize;
+    int chunkSize = (dataSize + chunkCount - 1) / chunkCount;
+    chunkSize = ((chunkSize + blockSize - 1) / blockSize) * blockSize;
+    for (int start = chunkSize; start < dataSize; start += chunkSize) {
+        const int count = qMin(chunkSize, dataSize - start);
+        ScatterRenderItemUpdater *updater = new ScatterRenderItemUpdater(
+                    this, dataView, renderArray, start, count, &done);
+        if (pool->tryStart(updater)) {
+            startedCount++;
+        } else {
+            delete updater;
+            updateRenderItemRange(dataView, renderArray, start, count);
+        }
+    }
+    updateRenderItemRange(dataView, renderArray, 0, qMin(chunkSize, dataSize));
+    done.acquire(startedCount);
+}
+
+void Scatter3DRenderer::updateRenderItemRange(const ScatterDataView &dataView,
+                                              ScatterRenderItemArray &renderArray,
+                                              int start, int count)
+{
+    const int end = start + count;
+    for (int i = start; i < end; i++)
+        updateRenderItem(dataView, renderArray, i);
+}
+
+void Scatter3DRenderer::updateRenderItem(const ScatterDataView &dataView,
+                                         ScatterRenderItemArray &renderArray, int index)
 {
-    QVector3D dotPos = dataItem.position();
+    QVector3D dotPos = dataView.position(index);
     if ((dotPos.x() >= m_axisCacheX.min() && dotPos.x() <= m_axisCacheX.max() )
             && (dotPos.y() >= m_axisCacheY.min() && dotPos.y() <= m_axisCacheY.max())
             && (dotPos.z() >= m_axisCacheZ.min() && dotPos.z() <= m_axisCacheZ.max())) {
-        renderItem.setPosition(dotPos);
-        renderItem.setVisible(true);
-        if (!dataItem.rotation().isIdentity())
-            renderItem.setRotation(dataItem.rotation().normalized());
+        renderArray.setPosition(index, dotPos);
+        renderArray.setVisible(index, true);
+        const QQuaternion rotation = dataView.rotation(index);
+        if (!rotation.isIdentity())
+            renderArray.setRotation(index, rotation.normalized());
         else
-            renderItem.setRotation(identityQuaternion);
-        calculateTranslation(renderItem);
+            renderArray.setRotation(index, identityQuaternion);
+        if (renderArray.hasValues())
+            renderArray.setValue(index, qBound(0.0f, dataView.value(index), 1.0f));
+        calculateTranslation(renderArray, index);
     } else {
-        renderItem.setVisible(false);
+        renderArray.setVisible(index, false);
     }
 }
 
@@ -44,6 +44,8 @@
 #include "scatter3dcontroller_p.h"
 #include "abstract3drenderer_p.h"
 #include "scatterrenderitem_p.h"
+#include "qscatterdataproxy.h"
+#include "scatterdataview_p.h"
 
 QT_FORWARD_DECLARE_CLASS(QSizeF)
 
@@ -52,7 +54,7 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 class ShaderHelper;
 class Q3DScene;
 class ScatterSeriesRenderCache;
-class QScatterDataItem;
+class ScatterRenderItemUpdater;
 
 class QT_DATAVISUALIZATION_EXPORT Scatter3DRenderer : public Abstract3DRenderer
 {
@@ -60,7 +62,7 @@ class QT_DATAVISUALIZATION_EXPORT Scatter3DRenderer : public Abstract3DRenderer
 
 private:
     // Internal state
-    ScatterRenderItem *m_selectedItem; // points to renderitem array
+    int m_selectedItem; // render array index of the item the selection label was generated for
     bool m_updateLabels;
     ShaderHelper *m_dotShader;
     ShaderHelper *m_dotGradientShader;
@@ -71,6 +73,9 @@ private:
     ShaderHelper *m_selectionShader;
     ShaderHelper *m_backgroundShader;
     ShaderHelper *m_staticGradientPointShader;
+    ShaderHelper *m_instancedDotShader;
+    ShaderHelper *m_instancedDotGradientShader;
+    ShaderHelper *m_instancedDepthShader;
     GLuint m_bgrTexture;
     GLuint m_selectionTexture;
     GLuint m_depthFrameBuffer;
@@ -92,6 +97,8 @@ private:
     bool m_haveMeshSeries;
     bool m_haveUniformColorMeshSeries;
     bool m_haveGradientMeshSeries;
+    bool m_instancingSupported;
+    QVector<int> m_culledItems;
 
 public:
     explicit Scatter3DRenderer(Scatter3DController *controller);
@@ -100,7 +107,7 @@ public:
     void updateData();
     void updateSeries(const QList<QAbstract3DSeries *> &seriesList);
     SeriesRenderCache *createNewCache(QAbstract3DSeries *series);
-    void updateItems(const QVector<Scatter3DController::ChangeItem> &items);
+    void updateItems(const QVector<Scatter3DController::ChangeRange> &ranges);
     void updateScene(Q3DScene *scene);
     void updateAxisLabels(QAbstract3DAxis::AxisOrientation orientation,
                           const QStringList &labels);
@@ -143,16 +150,29 @@ private:
     void initSelectionShader();
     void initBackgroundShaders(const QString &vertexShader, const QString &fragmentShader);
     void initStaticPointShaders(const QString &vertexShader, const QString &fragmentShader);
+    void initInstancedShaders();
     void initSelectionBuffer();
     void initDepthShader();
     void updateDepthBuffer();
     void initPointShader();
-    void calculateTranslation(ScatterRenderItem &item);
+    void calculateTranslation(ScatterRenderItemArray &renderArray, int index);
+    bool cullItems(ScatterSeriesRenderCache *cache, const QMatrix4x4 &viewProjectionMatrix,
+                   float itemSize);
+    void updateLevelOfDetail(const Q3DCamera *activeCamera);
     void calculateSceneScalingFactors();
 
     void selectionColorToSeriesAndIndex(const QVector4D &color, int &index,
                                         QAbstract3DSeries *&series);
-    inline void updateRenderItem(const QScatterDataItem &dataItem, ScatterRenderItem &renderItem);
+    void rayCastToSeriesAndIndex(const Q3DCamera *activeCamera,
+                                 const QMatrix4x4 &projectionViewMatrix, int &index,
+                                 QAbstract3DSeries *&series);
+    inline void updateRenderItem(const ScatterDataView &dataView,
+                                 ScatterRenderItemArray &renderArray, int index);
+    void updateRenderItems(const ScatterDataView &dataView, ScatterRenderItemArray &renderArray);
+    void updateRenderItemRange(const ScatterDataView &dataView,
+                               ScatterRenderItemArray &renderArray, int start, int count);
+
+    friend class ScatterRenderItemUpdater;
 
     Q_DISABLE_COPY(Scatter3DRenderer)
 };
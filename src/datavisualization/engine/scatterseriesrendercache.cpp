@@ -30,12 +30,15 @@
 #include "scatterseriesrendercache_p.h"
 #include "scatterobjectbufferhelper_p.h"
 #include "scatterpointbufferhelper_p.h"
+#include "scatterinstancebufferhelper_p.h"
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
 ScatterSeriesRenderCache::ScatterSeriesRenderCache(QAbstract3DSeries *series,
                                                    Abstract3DRenderer *renderer)
     : SeriesRenderCache(series, renderer),
+      m_levelOfDetailEnabled(false),
+      m_levelOfDetailCount(-1),
       m_itemSize(0.0f),
       m_selectionIndexOffset(0),
       m_staticBufferDirty(false),
@@ -43,6 +46,7 @@ ScatterSeriesRenderCache::ScatterSeriesRenderCache(QAbstract3DSeries *series,
       m_oldMeshFileName(QString()),
       m_scatterBufferObj(0),
       m_scatterBufferPoints(0),
+      m_scatterBufferInstances(0),
       m_visibilityChanged(false)
 {
 }
@@ -51,13 +55,27 @@ ScatterSeriesRenderCache::~ScatterSeriesRenderCache()
 {
     delete m_scatterBufferObj;
     delete m_scatterBufferPoints;
+    delete m_scatterBufferInstances;
 }
 
 void ScatterSeriesRenderCache::cleanup(TextureHelper *texHelper)
 {
     m_renderArray.clear();
+    m_octree.setDirty();
+    m_levelOfDetail.setDirty();
+    m_levelOfDetailCount = -1;
 
     SeriesRenderCache::cleanup(texHelper);
 }
 
+bool ScatterSeriesRenderCache::hasStaticBufferData() const
+{
+    if (m_mesh == QAbstract3DSeries::MeshPoint)
+        return m_scatterBufferPoints && m_scatterBufferPoints->indexCount() > 0;
+    else if (m_scatterBufferInstances)
+        return m_scatterBufferInstances->indexCount() > 0;
+    else
+        return m_scatterBufferObj && m_scatterBufferObj->indexCount() > 0;
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -44,11 +44,14 @@
 #include "seriesrendercache_p.h"
 #include "qscatter3dseries_p.h"
 #include "scatterrenderitem_p.h"
+#include "scatteritemoctree_p.h"
+#include "scatterlevelofdetail_p.h"
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
 class ScatterObjectBufferHelper;
 class ScatterPointBufferHelper;
+class ScatterInstanceBufferHelper;
 
 class ScatterSeriesRenderCache : public SeriesRenderCache
 {
@@ -59,6 +62,12 @@ public:
     void cleanup(TextureHelper *texHelper);
 
     inline ScatterRenderItemArray &renderArray() { return m_renderArray; }
+    inline ScatterItemOctree &octree() { return m_octree; }
+    inline ScatterLevelOfDetail &levelOfDetail() { return m_levelOfDetail; }
+    inline void setLevelOfDetailEnabled(bool enabled) { m_levelOfDetailEnabled = enabled; }
+    inline bool isLevelOfDetailEnabled() const { return m_levelOfDetailEnabled; }
+    inline void setLevelOfDetailCount(int count) { m_levelOfDetailCount = count; }
+    inline int levelOfDetailCount() const { return m_levelOfDetailCount; }
     inline QScatter3DSeries *series() const { return static_cast<QScatter3DSeries *>(m_series); }
     inline void setItemSize(float size) { m_itemSize = size; }
     inline float itemSize() const { return m_itemSize; }
@@ -74,6 +83,9 @@ public:
     inline ScatterObjectBufferHelper *bufferObject() const { return m_scatterBufferObj; }
     inline void setBufferPoints(ScatterPointBufferHelper *object) { m_scatterBufferPoints = object; }
     inline ScatterPointBufferHelper *bufferPoints() const { return m_scatterBufferPoints; }
+    inline void setBufferInstances(ScatterInstanceBufferHelper *object) { m_scatterBufferInstances = object; }
+    inline ScatterInstanceBufferHelper *bufferInstances() const { return m_scatterBufferInstances; }
+    bool hasStaticBufferData() const;
     inline QVector<int> &updateIndices() { return m_updateIndices; }
     inline QVector<int> &bufferIndices() { return m_bufferIndices; }
     inline void setVisibilityChanged(bool changed) { m_visibilityChanged = changed; }
@@ -81,6 +93,10 @@ public:
 
 protected:
     ScatterRenderItemArray m_renderArray;
+    ScatterItemOctree m_octree;
+    ScatterLevelOfDetail m_levelOfDetail;
+    bool m_levelOfDetailEnabled;
+    int m_levelOfDetailCount; // Count of items to draw from level of detail order, -1 for all
     float m_itemSize;
     int m_selectionIndexOffset; // Temporarily cached value for selection color calculations
     bool m_staticBufferDirty;
@@ -88,6 +104,7 @@ protected:
     QString m_oldMeshFileName; // Used to detect if full buffer change needed
     ScatterObjectBufferHelper *m_scatterBufferObj;
     ScatterPointBufferHelper *m_scatterBufferPoints;
+    ScatterInstanceBufferHelper *m_scatterBufferInstances;
     QVector<int> m_updateIndices; // Used as temporary cache during item updates
     QVector<int> m_bufferIndices; // Cache for mapping renderarray to mesh buffer
     bool m_visibilityChanged; // Used to detect if full buffer change needed
@@ -0,0 +1,18 @@
+uniform highp mat4 MVP;
+uniform highp vec4 barScale;
+
+attribute highp vec3 vertexPosition_mdl;
+attribute highp vec4 instancePosition_wrld;
+attribute highp vec4 instanceRotation;
+
+highp vec3 rotate(highp vec4 q, highp vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main() {
+    highp float height = instancePosition_wrld.y * barScale.y;
+    highp vec3 scale = vec3(barScale.x, height, barScale.z);
+    vec3 position_wrld = rotate(instanceRotation, vertexPosition_mdl * scale)
+            + vec3(instancePosition_wrld.x, height + barScale.w, instancePosition_wrld.z);
+    gl_Position = MVP * vec4(position_wrld, 1.0);
+}
@@ -0,0 +1,43 @@
+#version 120
+
+uniform highp mat4 MVP;
+uniform highp mat4 V;
+uniform highp mat4 depthMVP;
+uniform highp vec3 lightPosition_wrld;
+uniform highp float gradHeight;
+
+attribute highp vec3 vertexPosition_mdl;
+attribute highp vec3 vertexNormal_mdl;
+attribute highp vec4 instancePosition_wrld;
+attribute highp vec4 instanceRotation;
+attribute highp float instanceUV;
+
+varying highp vec2 UV;
+varying highp vec3 position_wrld;
+varying highp vec3 normal_cmr;
+varying highp vec3 eyeDirection_cmr;
+varying highp vec3 lightDirection_cmr;
+varying highp vec4 shadowCoord;
+varying highp vec2 coords_mdl;
+
+const highp mat4 bias = mat4(0.5, 0.0, 0.0, 0.0,
+                             0.0, 0.5, 0.0, 0.0,
+                             0.0, 0.0, 0.5, 0.0,
+                             0.5, 0.5, 0.5, 1.0);
+
+highp vec3 rotate(highp vec4 q, highp vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main() {
+    position_wrld = rotate(instanceRotation, vertexPosition_mdl * instancePosition_wrld.w)
+            + instancePosition_wrld.xyz;
+    gl_Position = MVP * vec4(position_wrld, 1.0);
+    coords_mdl = vertexPosition_mdl.xy;
+    shadowCoord = bias * depthMVP * vec4(position_wrld, 1.0);
+    vec3 vertexPosition_cmr = vec4(V * vec4(position_wrld, 1.0)).xyz;
+    eyeDirection_cmr = vec3(0.0, 0.0, 0.0) - vertexPosition_cmr;
+    lightDirection_cmr = vec4(V * vec4(lightPosition_wrld, 0.0)).xyz;
+    normal_cmr = vec4(V * vec4(rotate(instanceRotation, vertexNormal_mdl), 0.0)).xyz;
+    UV = vec2(0.0, instanceUV + (vertexPosition_mdl.y + 1.0) * gradHeight);
+}
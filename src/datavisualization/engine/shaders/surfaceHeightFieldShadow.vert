@@ -0,0 +1,64 @@
+#version 120
+
+uniform highp mat4 MVP;
+uniform highp mat4 V;
+uniform highp mat4 M;
+uniform highp mat4 itM;
+uniform highp mat4 depthMVP;
+uniform highp vec3 lightPosition_wrld;
+uniform sampler2D heightSampler;
+uniform highp vec2 gridSize;
+uniform highp vec2 gridOrigin;
+uniform highp vec2 gridStep;
+uniform highp vec2 gridNeighbor;
+uniform highp vec4 uvRect;
+uniform highp float heightRowOffset;
+
+attribute highp vec2 vertexUV;
+
+varying highp vec2 UV;
+varying highp vec3 position_wrld;
+varying highp vec3 normal_cmr;
+varying highp vec3 eyeDirection_cmr;
+varying highp vec3 lightDirection_cmr;
+varying highp vec4 shadowCoord;
+varying highp vec2 coords_mdl;
+
+const highp mat4 bias = mat4(0.5, 0.0, 0.0, 0.0,
+                             0.0, 0.5, 0.0, 0.0,
+                             0.0, 0.0, 0.5, 0.0,
+                             0.5, 0.5, 0.5, 1.0);
+
+highp vec3 gridPosition(highp vec2 cell) {
+    // Rows of the height texture are a ring starting at heightRowOffset
+    highp float row = mod(cell.y + heightRowOffset, gridSize.y);
+    highp float height = texture2DLod(heightSampler, (vec2(cell.x, row) + 0.5) / gridSize, 0.0).r;
+    return vec3(gridOrigin.x + cell.x * gridStep.x, height, gridOrigin.y + cell.y * gridStep.y);
+}
+
+void main() {
+    highp vec2 cell = floor(vertexUV * (gridSize - 1.0) + 0.5);
+    highp vec3 vertexPosition_mdl = gridPosition(cell);
+
+    highp vec2 direction = gridNeighbor;
+    highp vec2 neighbor = cell + direction;
+    if (neighbor.x < 0.0 || neighbor.x > gridSize.x - 1.0)
+        direction.x = -direction.x;
+    if (neighbor.y < 0.0 || neighbor.y > gridSize.y - 1.0)
+        direction.y = -direction.y;
+    highp vec3 xTangent = (gridPosition(cell + vec2(direction.x, 0.0)) - vertexPosition_mdl)
+            * (direction.x * gridNeighbor.x);
+    highp vec3 zTangent = (gridPosition(cell + vec2(0.0, direction.y)) - vertexPosition_mdl)
+            * (direction.y * gridNeighbor.y);
+    highp vec3 vertexNormal_mdl = cross(xTangent, zTangent);
+
+    gl_Position = MVP * vec4(vertexPosition_mdl, 1.0);
+    coords_mdl = vertexPosition_mdl.xy;
+    shadowCoord = bias * depthMVP * vec4(vertexPosition_mdl, 1.0);
+    position_wrld = vec4(M * vec4(vertexPosition_mdl, 1.0)).xyz;
+    vec3 vertexPosition_cmr = vec4(V * M * vec4(vertexPosition_mdl, 1.0)).xyz;
+    eyeDirection_cmr = vec3(0.0, 0.0, 0.0) - vertexPosition_cmr;
+    lightDirection_cmr = vec4(V * vec4(lightPosition_wrld, 0.0)).xyz;
+    normal_cmr = vec4(V * itM * vec4(vertexNormal_mdl, 0.0)).xyz;
+    UV = uvRect.xy + vertexUV * uvRect.zw;
+}
@@ -77,6 +77,13 @@ void Surface3DController::synchDataToRenderer()
     if (!isInitialized())
         return;
 
+    // Scrolled rows are applied when the data is updated, so they need to be known before it
+    if (m_changeTracker.rowsScrolled) {
+        m_renderer->updateScrolledRows(m_scrolledRows);
+        m_changeTracker.rowsScrolled = false;
+        m_scrolledRows.clear();
+    }
+
     Abstract3DController::synchDataToRenderer();
 
     // Notify changes to renderer
@@ -480,6 +487,60 @@ void Surface3DController::handleRowsRemoved(int startIndex, int count)
     emitNeedRender();
 }
 
+void Surface3DController::handleRowsScrolled(int count)
+{
+    QSurface3DSeries *series = static_cast<QSurfaceDataProxy *>(sender())->series();
+    if (series == m_selectedSeries) {
+        // The selection moves with the selected row, until the row is scrolled out
+        int selectedRow = m_selectedPoint.x();
+        if (selectedRow >= 0) {
+            selectedRow = (selectedRow >= count) ? selectedRow - count : -1;
+            setSelectedPoint(QPoint(selectedRow, m_selectedPoint.y()), m_selectedSeries, false);
+        }
+    }
+
+    // Pending row and item changes refer to the rows before the scroll
+    for (int i = m_changedRows.size() - 1; i >= 0; i--) {
+        ChangeRow &changeRow = m_changedRows[i];
+        if (changeRow.series == series) {
+            changeRow.row -= count;
+            if (changeRow.row < 0)
+                m_changedRows.remove(i);
+        }
+    }
+    for (int i = m_changedItems.size() - 1; i >= 0; i--) {
+        ChangeItem &changeItem = m_changedItems[i];
+        if (changeItem.series == series) {
+            changeItem.point.rx() -= count;
+            if (changeItem.point.x() < 0)
+                m_changedItems.remove(i);
+        }
+    }
+
+    if (series->isVisible()) {
+        bool newScroll = true;
+        for (int i = 0; i < m_scrolledRows.size(); i++) {
+            if (m_scrolledRows.at(i).series == series) {
+                m_scrolledRows[i].count += count;
+                newScroll = false;
+                break;
+            }
+        }
+        if (newScroll) {
+            ChangeScroll newChangeScroll = {series, count};
+            m_scrolledRows.append(newChangeScroll);
+        }
+        m_changeTracker.rowsScrolled = true;
+
+        adjustAxisRanges();
+        m_isDataDirty = true;
+    } else if (!m_changedSeriesList.contains(series)) {
+        m_changedSeriesList.append(series);
+    }
+
+    emitNeedRender();
+}
+
 void Surface3DController::updateSurfaceTexture(QSurface3DSeries *series)
 {
     m_changeTracker.surfaceTextureChanged = true;
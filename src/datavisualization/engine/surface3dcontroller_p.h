@@ -54,13 +54,15 @@ struct Surface3DChangeBitField {
     bool itemChanged               : 1;
     bool flipHorizontalGridChanged : 1;
     bool surfaceTextureChanged     : 1;
+    bool rowsScrolled              : 1;
 
     Surface3DChangeBitField() :
         selectedPointChanged(true),
         rowsChanged(false),
         itemChanged(false),
         flipHorizontalGridChanged(true),
-        surfaceTextureChanged(true)
+        surfaceTextureChanged(true),
+        rowsScrolled(false)
     {
     }
 };
@@ -78,6 +80,10 @@ public:
         QSurface3DSeries *series;
         int row;
     };
+    struct ChangeScroll {
+        QSurface3DSeries *series;
+        int count;
+    };
 
 private:
     Surface3DChangeBitField m_changeTracker;
@@ -88,6 +94,7 @@ private:
     bool m_flatShadingSupported;
     QVector<ChangeItem> m_changedItems;
     QVector<ChangeRow> m_changedRows;
+    QVector<ChangeScroll> m_scrolledRows;
     bool m_flipHorizontalGrid;
     QVector<QSurface3DSeries *> m_changedTextures;
 
@@ -130,6 +137,7 @@ public Q_SLOTS:
     void handleRowsRemoved(int startIndex, int count);
     void handleRowsInserted(int startIndex, int count);
     void handleItemChanged(int rowIndex, int columnIndex);
+    void handleRowsScrolled(int count);
 
     void handleFlatShadingSupportedChange(bool supported);
 
@@ -35,6 +35,8 @@
 
 #include <QtCore/qmath.h>
 
+#include <limits>
+
 static const int ID_TO_RGBA_MASK = 0xff;
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
@@ -60,6 +62,11 @@ Surface3DRenderer::Surface3DRenderer(Surface3DController *controller)
       m_surfaceSliceFlatShader(0),
       m_surfaceSliceSmoothShader(0),
       m_selectionShader(0),
+      m_heightFieldSmoothShader(0),
+      m_heightFieldTexturedSmoothShader(0),
+      m_heightFieldGridShader(0),
+      m_heightFieldSelectionShader(0),
+      m_heightFieldDepthShader(0),
       m_heightNormalizer(0.0f),
       m_scaleX(0.0f),
       m_scaleY(0.0f),
@@ -70,6 +77,7 @@ Surface3DRenderer::Surface3DRenderer(Surface3DController *controller)
       m_selectionResultTexture(0),
       m_shadowQualityToShader(33.3f),
       m_flatSupported(true),
+      m_heightFieldSupported(false),
       m_selectionActive(false),
       m_shadowQualityMultiplier(3),
       m_selectedPoint(Surface3DController::invalidSelectionPosition()),
@@ -116,12 +124,19 @@ Surface3DRenderer::~Surface3DRenderer()
     delete m_surfaceGridShader;
     delete m_surfaceSliceFlatShader;
     delete m_surfaceSliceSmoothShader;
+    delete m_heightFieldSmoothShader;
+    delete m_heightFieldTexturedSmoothShader;
+    delete m_heightFieldGridShader;
+    delete m_heightFieldSelectionShader;
+    delete m_heightFieldDepthShader;
 }
 
 void Surface3DRenderer::initializeOpenGL()
 {
     Abstract3DRenderer::initializeOpenGL();
 
+    m_heightFieldSupported = !m_isOpenGLES && Utils::isHeightFieldSupported();
+
     // Initialize shaders
     initSurfaceShaders();
 
@@ -193,12 +208,29 @@ void Surface3DRenderer::getVisibleItemBounds(QVector3D &minBounds, QVector3D &ma
         maxBounds.setZ(-1.0f);
 }
 
+// Sample rows that cover the whole data row share the implicitly shared row data with the proxy
+// instead of copying it. The proxy detaches its row when it modifies it, so the renderer keeps
+// a consistent snapshot, and only sample space windows narrower than the data are materialized.
+static inline void updateSampleRow(QSurfaceDataRow &dstRow, const QSurfaceDataRow &srcRow,
+                                   const QRect &sampleSpace)
+{
+    if (srcRow.size() == sampleSpace.width())
+        dstRow = srcRow;
+    else
+        dstRow = srcRow.mid(sampleSpace.x(), sampleSpace.width());
+}
+
 void Surface3DRenderer::updateData()
 {
     calculateSceneScalingFactors();
 
     foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
         SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
+        // Scrolled rows are only applied to surfaces that are not set up again anyway
+        if (cache->isVisible() && cache->scrolledRowCount() && !cache->dataDirty())
+            cache->setDataDirty(!scrollObjects(cache));
+        cache->setScrolledRowCount(0);
+
         if (cache->isVisible() && cache->dataDirty()) {
             const QSurface3DSeries *currentSeries = cache->series();
             QSurfaceDataProxy *dataProxy = currentSeries->dataProxy();
@@ -227,13 +259,11 @@ void Surface3DRenderer::updateData()
                 if (dimensionsChanged) {
                     dataArray.reserve(sampleSpace.height());
                     for (int i = 0; i < sampleSpace.height(); i++)
-                        dataArray << new QSurfaceDataRow(sampleSpace.width());
+                        dataArray << new QSurfaceDataRow;
                 }
                 for (int i = 0; i < sampleSpace.height(); i++) {
-                    for (int j = 0; j < sampleSpace.width(); j++) {
-                        (*(dataArray.at(i)))[j] = array.at(i + sampleSpace.y())->at(
-                                    j + sampleSpace.x());
-                    }
+                    updateSampleRow(*dataArray.at(i), *array.at(i + sampleSpace.y()),
+                                    sampleSpace);
                 }
 
                 checkFlatSupport(cache);
@@ -356,29 +386,32 @@ void Surface3DRenderer::updateRows(const QVector<Surface3DController::ChangeRow>
 
         if (cache && srcArray->size() >= 2 && srcArray->at(0)->size() >= 2 &&
                 sampleSpace.width() >= 2 && sampleSpace.height() >= 2) {
-            bool updateBuffers = false;
             int sampleSpaceTop = sampleSpace.y() + sampleSpace.height();
             int row = item.row;
             if (row >= sampleSpace.y() && row <= sampleSpaceTop) {
-                updateBuffers = true;
-                for (int j = 0; j < sampleSpace.width(); j++) {
-                    (*(dstArray.at(row - sampleSpace.y())))[j] =
-                            srcArray->at(row)->at(j + sampleSpace.x());
-                }
-
-                if (cache->isFlatShadingEnabled()) {
+                updateSampleRow(*dstArray.at(row - sampleSpace.y()), *srcArray->at(row),
+                                sampleSpace);
+
+                SurfaceObject *object = cache->surfaceObject();
+                if (object->surfaceType() == SurfaceObject::SurfaceHeightField) {
+                    // Rows that break the regular grid fall back to the vertex buffers
+                    if (!object->updateHeightFieldRow(dstArray, row - sampleSpace.y()))
+                        updateObjects(cache, true);
+                } else if (cache->isFlatShadingEnabled()) {
                     cache->surfaceObject()->updateCoarseRow(dstArray, row - sampleSpace.y(),
                                                             m_polarGraph);
                 } else {
                     cache->surfaceObject()->updateSmoothRow(dstArray, row - sampleSpace.y(),
                                                             m_polarGraph);
                 }
+                cache->heightHierarchy().updateRows(*object, row - sampleSpace.y(),
+                                                    row - sampleSpace.y());
             }
-            if (updateBuffers)
-                cache->surfaceObject()->uploadBuffers();
         }
     }
 
+    uploadDirtySurfaceBuffers();
+
     updateSelectedPoint(m_selectedPoint, m_selectedSeries);
 }
 
@@ -399,31 +432,81 @@ void Surface3DRenderer::updateItems(const QVector<Surface3DController::ChangeIte
                 sampleSpace.width() >= 2 && sampleSpace.height() >= 2) {
             int sampleSpaceTop = sampleSpace.y() + sampleSpace.height();
             int sampleSpaceRight = sampleSpace.x() + sampleSpace.width();
-            bool updateBuffers = false;
             // Note: Point is (row, column), samplespace is (columns x rows)
             QPoint point = item.point;
 
             if (point.x() <= sampleSpaceTop && point.x() >= sampleSpace.y() &&
                     point.y() <= sampleSpaceRight && point.y() >= sampleSpace.x()) {
-                updateBuffers = true;
                 int x = point.y() - sampleSpace.x();
                 int y = point.x() - sampleSpace.y();
-                (*(dstArray.at(y)))[x] = srcArray->at(point.x())->at(point.y());
+                const QSurfaceDataRow &srcRow = *srcArray->at(point.x());
+                if (srcRow.size() == sampleSpace.width())
+                    *dstArray.at(y) = srcRow; // Shares the row the proxy already detached
+                else
+                    (*(dstArray.at(y)))[x] = srcRow.at(point.y());
 
-                if (cache->isFlatShadingEnabled())
+                SurfaceObject *object = cache->surfaceObject();
+                if (object->surfaceType() == SurfaceObject::SurfaceHeightField) {
+                    if (!object->updateHeightFieldItem(dstArray, y, x))
+                        updateObjects(cache, true);
+                } else if (cache->isFlatShadingEnabled()) {
                     cache->surfaceObject()->updateCoarseItem(dstArray, y, x, m_polarGraph);
-                else
+                } else {
                     cache->surfaceObject()->updateSmoothItem(dstArray, y, x, m_polarGraph);
+                }
+                cache->heightHierarchy().updateRows(*object, y, y);
             }
-            if (updateBuffers)
-                cache->surfaceObject()->uploadBuffers();
         }
 
     }
 
+    uploadDirtySurfaceBuffers();
+
     updateSelectedPoint(m_selectedPoint, m_selectedSeries);
 }
 
+void Surface3DRenderer::updateScrolledRows(
+        const QVector<Surface3DController::ChangeScroll> &scrolls)
+{
+    foreach (Surface3DController::ChangeScroll scroll, scrolls) {
+        SurfaceSeriesRenderCache *cache =
+                static_cast<SurfaceSeriesRenderCache *>(m_renderCacheList.value(scroll.series));
+        if (cache)
+            cache->setScrolledRowCount(cache->scrolledRowCount() + scroll.count);
+    }
+}
+
+void Surface3DRenderer::updateAxisRange(QAbstract3DAxis::AxisOrientation orientation, float min,
+                                        float max)
+{
+    if (orientation != QAbstract3DAxis::AxisOrientationZ) {
+        Abstract3DRenderer::updateAxisRange(orientation, min, max);
+        return;
+    }
+
+    AxisRenderCache &cache = axisCacheForOrientation(orientation);
+    cache.setMin(min);
+    cache.setMax(max);
+
+    // Waterfall charts move the z-axis range along with the scrolled rows. The scroll path places
+    // the rows at the new range, and sets the surface up again if the sample space changes, so
+    // the scrolled surfaces do not need to be set up again here.
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        SurfaceSeriesRenderCache *seriesCache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
+        if (!seriesCache->scrolledRowCount())
+            seriesCache->setDataDirty(true);
+    }
+}
+
+// Uploads the parts of the surface buffers changed by row and item updates. All changes of a
+// sync are collected before the upload, so that the regions shared by the changed rows and
+// items are uploaded only once.
+void Surface3DRenderer::uploadDirtySurfaceBuffers()
+{
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList)
+        static_cast<SurfaceSeriesRenderCache *>(baseCache)->surfaceObject()->uploadDirtyBuffers();
+}
+
 void Surface3DRenderer::updateSliceDataModel(const QPoint &point)
 {
     foreach (SeriesRenderCache *baseCache, m_renderCacheList)
@@ -1134,6 +1217,8 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
 
     QMatrix4x4 projectionViewMatrix = projectionMatrix * viewMatrix;
 
+    updateLevelOfDetail(projectionViewMatrix, projectionMatrix);
+
     // Calculate flipping indicators
     if (viewMatrix.row(0).x() > 0)
         m_zFlipped = false;
@@ -1215,6 +1300,15 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
             SurfaceObject *object = cache->surfaceObject();
             if (object->indexCount() && cache->surfaceVisible() && cache->isVisible()
                     && cache->sampleSpace().width() >= 2 && cache->sampleSpace().height() >= 2) {
+                if (object->surfaceType() == SurfaceObject::SurfaceHeightField) {
+                    m_heightFieldDepthShader->bind();
+                    m_heightFieldDepthShader->setUniformValue(m_heightFieldDepthShader->MVP(),
+                                                              depthProjectionViewMatrix);
+                    m_drawer->drawHeightField(m_heightFieldDepthShader, object);
+                    m_depthShader->bind();
+                    continue;
+                }
+
                 // No translation nor scaling for surfaces, therefore no modelMatrix
                 // Use directly projectionViewMatrix
                 m_depthShader->setUniformValue(m_depthShader->MVP(), depthProjectionViewMatrix);
@@ -1229,7 +1323,7 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                 glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
 
                 // Draw the triangles
-                glDrawElements(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT, (void *)0);
+                m_drawer->drawElements(object);
             }
         }
 
@@ -1288,15 +1382,26 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
 
         glDisable(GL_CULL_FACE);
 
+        // Surfaces are picked by ray casting after the selection buffer is read, when enabled
         foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
             SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
-            if (cache->surfaceObject()->indexCount() && cache->renderable()) {
+            if (!m_rayCastPicking && cache->surfaceObject()->indexCount()
+                    && cache->renderable()) {
                 m_selectionShader->setUniformValue(m_selectionShader->MVP(), projectionViewMatrix);
 
                 cache->surfaceObject()->activateSurfaceTexture(false);
 
-                m_drawer->drawObject(m_selectionShader, cache->surfaceObject(),
-                                     cache->selectionTexture());
+                if (cache->surfaceObject()->surfaceType() == SurfaceObject::SurfaceHeightField) {
+                    m_heightFieldSelectionShader->bind();
+                    m_heightFieldSelectionShader->setUniformValue(
+                                m_heightFieldSelectionShader->MVP(), projectionViewMatrix);
+                    m_drawer->drawHeightField(m_heightFieldSelectionShader,
+                                              cache->surfaceObject(), cache->selectionTexture());
+                    m_selectionShader->bind();
+                } else {
+                    m_drawer->drawObject(m_selectionShader, cache->surfaceObject(),
+                                         cache->selectionTexture());
+                }
             }
         }
         m_surfaceGridShader->bind();
@@ -1319,6 +1424,8 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                 + uint(clickedColor.w()) * alphaMultiplier;
 
         m_clickedPosition = selectionIdToSurfacePoint(selectionId);
+        if (m_rayCastPicking && m_clickedType == QAbstract3DGraph::ElementNone)
+            m_clickedPosition = rayCastToSurfacePoint(projectionViewMatrix);
         m_clickResolved = true;
 
         emit needRender();
@@ -1393,10 +1500,16 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                 }
 
                 if (cache->surfaceVisible()) {
+                    bool heightField = cache->surfaceObject()->surfaceType()
+                            == SurfaceObject::SurfaceHeightField;
                     ShaderHelper *shader = m_surfaceFlatShader;
                     if (cache->surfaceTexture())
                         shader = m_surfaceTexturedFlatShader;
-                    if (!cache->isFlatShadingEnabled()) {
+                    if (heightField) {
+                        shader = m_heightFieldSmoothShader;
+                        if (cache->surfaceTexture())
+                            shader = m_heightFieldTexturedSmoothShader;
+                    } else if (!cache->isFlatShadingEnabled()) {
                         shader = m_surfaceSmoothShader;
                         if (cache->surfaceTexture())
                             shader = m_surfaceTexturedSmoothShader;
@@ -1450,13 +1563,21 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                         shader->setUniformValue(shader->lightS(), adjustedLightStrength);
 
                         // Draw the objects
-                        m_drawer->drawObject(shader, cache->surfaceObject(), texture,
-                                             m_depthTexture);
+                        if (heightField) {
+                            m_drawer->drawHeightField(shader, cache->surfaceObject(), texture,
+                                                      m_depthTexture);
+                        } else {
+                            m_drawer->drawObject(shader, cache->surfaceObject(), texture,
+                                                 m_depthTexture);
+                        }
                     } else {
                         // Set shadowless shader bindings
                         shader->setUniformValue(shader->lightS(), m_cachedTheme->lightStrength());
                         // Draw the objects
-                        m_drawer->drawObject(shader, cache->surfaceObject(), texture);
+                        if (heightField)
+                            m_drawer->drawHeightField(shader, cache->surfaceObject(), texture);
+                        else
+                            m_drawer->drawObject(shader, cache->surfaceObject(), texture);
                     }
                 }
             }
@@ -1480,7 +1601,20 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                 if (cache->surfaceObject()->indexCount() && cache->surfaceGridVisible()
                         && cache->isVisible() && sampleSpace.width() >= 2
                         && sampleSpace.height() >= 2) {
-                    m_drawer->drawSurfaceGrid(m_surfaceGridShader, cache->surfaceObject());
+                    if (cache->surfaceObject()->surfaceType()
+                            == SurfaceObject::SurfaceHeightField) {
+                        m_heightFieldGridShader->bind();
+                        m_heightFieldGridShader->setUniformValue(
+                                    m_heightFieldGridShader->color(),
+                                    Utils::vectorFromColor(m_cachedTheme->gridLineColor()));
+                        m_heightFieldGridShader->setUniformValue(m_heightFieldGridShader->MVP(),
+                                                                 cache->MVPMatrix());
+                        m_drawer->drawHeightField(m_heightFieldGridShader,
+                                                  cache->surfaceObject(), 0, 0, true);
+                        m_surfaceGridShader->bind();
+                    } else {
+                        m_drawer->drawSurfaceGrid(m_surfaceGridShader, cache->surfaceObject());
+                    }
                 }
             }
         }
@@ -2444,6 +2578,14 @@ void Surface3DRenderer::updateSelectionMode(QAbstract3DGraph::SelectionFlags mod
         updateSelectionTextures();
 }
 
+void Surface3DRenderer::updateRayCastPicking(bool enable)
+{
+    Abstract3DRenderer::updateRayCastPicking(enable);
+
+    if (m_cachedSelectionMode > QAbstract3DGraph::SelectionNone)
+        updateSelectionTextures();
+}
+
 void Surface3DRenderer::updateSelectionTextures()
 {
     uint lastSelectionId = 1;
@@ -2453,7 +2595,13 @@ void Surface3DRenderer::updateSelectionTextures()
                 static_cast<SurfaceSeriesRenderCache *>(baseCache);
         GLuint texture = cache->selectionTexture();
         m_textureHelper->deleteTexture(&texture);
-        createSelectionTexture(cache, lastSelectionId);
+        // Ray cast picking needs no selection textures
+        if (m_rayCastPicking) {
+            cache->setSelectionIdRange(~0U, ~0U);
+            cache->setSelectionTexture(0);
+        } else {
+            createSelectionTexture(cache, lastSelectionId);
+        }
     }
     m_selectionTexturesDirty = false;
 }
@@ -2620,15 +2768,73 @@ void Surface3DRenderer::updateObjects(SurfaceSeriesRenderCache *cache, bool dime
     QSurfaceDataProxy *dataProxy = currentSeries->dataProxy();
     const QSurfaceDataArray &array = *dataProxy->array();
 
+    SurfaceObject *object = cache->surfaceObject();
+    object->setLevelOfDetailEnabled(cache->isLevelOfDetailEnabled());
+    cache->heightHierarchy().setDirty();
     if (cache->isFlatShadingEnabled()) {
-        cache->surfaceObject()->setUpData(dataArray, sampleSpace, dimensionChanged, m_polarGraph);
+        if (object->surfaceType() != SurfaceObject::SurfaceFlat)
+            dimensionChanged = true;
+        object->setUpData(dataArray, sampleSpace, dimensionChanged, m_polarGraph);
         if (cache->surfaceTexture())
-            cache->surfaceObject()->coarseUVs(array, dataArray);
+            object->coarseUVs(array, dataArray);
     } else {
-        cache->surfaceObject()->setUpSmoothData(dataArray, sampleSpace, dimensionChanged,
-                                                m_polarGraph);
+        // Height fields need a regular grid, otherwise the vertex buffers are used
+        if (!cache->isHeightFieldEnabled() || !m_heightFieldSupported || m_polarGraph
+                || !object->setUpHeightFieldData(dataArray, sampleSpace, dimensionChanged)) {
+            if (object->surfaceType() != SurfaceObject::SurfaceSmooth)
+                dimensionChanged = true;
+            object->setUpSmoothData(dataArray, sampleSpace, dimensionChanged, m_polarGraph);
+        }
         if (cache->surfaceTexture())
-            cache->surfaceObject()->smoothUVs(array, dataArray);
+            object->smoothUVs(array, dataArray);
+    }
+}
+
+// Moves the surface along with the rows scrolled out of the start of the proxy array. The sampled
+// rows that are still shown are kept, and only the rows added to the end are sampled. Returns
+// false if the sample space changed, in which case the surface needs to be set up again.
+bool Surface3DRenderer::scrollObjects(SurfaceSeriesRenderCache *cache)
+{
+    const QSurfaceDataArray &array = *cache->series()->dataProxy()->array();
+    QSurfaceDataArray &dataArray = cache->dataArray();
+    const QRect &sampleSpace = cache->sampleSpace();
+    const int count = cache->scrolledRowCount();
+
+    if (sampleSpace.width() < 2 || sampleSpace.height() <= count
+            || array.size() < 2 || array.at(0)->size() < 2
+            || calculateSampleRect(array) != sampleSpace) {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++)
+        dataArray.append(dataArray.takeFirst());
+    for (int i = sampleSpace.height() - count; i < sampleSpace.height(); i++)
+        updateSampleRow(*dataArray.at(i), *array.at(i + sampleSpace.y()), sampleSpace);
+
+    // Height fields only upload the new rows, other surfaces keep their indices
+    SurfaceObject *object = cache->surfaceObject();
+    if (object->surfaceType() == SurfaceObject::SurfaceHeightField
+            && object->scrollHeightFieldRows(dataArray, count)) {
+        cache->heightHierarchy().setDirty();
+    } else {
+        updateObjects(cache, false);
+    }
+    return true;
+}
+
+// Selects the level of detail tiles of the surfaces for the frame. The same tiles are used in all
+// passes, so the shadows and the selection match the drawn surface.
+void Surface3DRenderer::updateLevelOfDetail(const QMatrix4x4 &projectionViewMatrix,
+                                            const QMatrix4x4 &projectionMatrix)
+{
+    // Pixels per unit of height at unit depth
+    const float pixelScale = 0.5f * float(m_primarySubViewport.height())
+            * projectionMatrix(1, 1);
+
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
+        if (cache->isVisible() && cache->isLevelOfDetailEnabled())
+            cache->surfaceObject()->updateLevelOfDetail(projectionViewMatrix, pixelScale);
     }
 }
 
@@ -2807,6 +3013,44 @@ QPoint Surface3DRenderer::selectionIdToSurfacePoint(uint id)
     return QPoint(row, column);
 }
 
+// Finds the surface point nearest to the clicked position by intersecting the click ray with
+// the height hierarchies of the surfaces. The hierarchies are built on the first click after
+// the data changes.
+QPoint Surface3DRenderer::rayCastToSurfacePoint(const QMatrix4x4 &projectionViewMatrix)
+{
+    m_clickedSeries = 0;
+
+    QVector3D rayOrigin;
+    QVector3D rayDirection;
+    calculateClickRay(projectionViewMatrix, rayOrigin, rayDirection);
+
+    float closestDistance = std::numeric_limits<float>::max();
+    QPoint clickedPoint = Surface3DController::invalidSelectionPosition();
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
+        const QRect &sampleSpace = cache->sampleSpace();
+        if (!cache->surfaceObject()->indexCount() || !cache->renderable()
+                || sampleSpace.width() < 2 || sampleSpace.height() < 2) {
+            continue;
+        }
+
+        SurfaceHeightHierarchy &hierarchy = cache->heightHierarchy();
+        if (hierarchy.isDirty())
+            hierarchy.build(*cache->surfaceObject());
+
+        QPoint point;
+        if (hierarchy.intersect(*cache->surfaceObject(), rayOrigin, rayDirection,
+                                closestDistance, point)) {
+            clickedPoint = QPoint(point.y() + sampleSpace.y(), point.x() + sampleSpace.x());
+            m_clickedSeries = cache->series();
+        }
+    }
+
+    if (m_clickedSeries)
+        m_clickedType = QAbstract3DGraph::ElementSeries;
+    return clickedPoint;
+}
+
 void Surface3DRenderer::updateShadowQuality(QAbstract3DGraph::ShadowQuality quality)
 {
     m_cachedShadowQuality = quality;
@@ -2890,6 +3134,10 @@ void Surface3DRenderer::initShaders(const QString &vertexShader, const QString &
     delete m_surfaceTexturedFlatShader;
     delete m_surfaceSliceFlatShader;
     delete m_surfaceSliceSmoothShader;
+    delete m_heightFieldSmoothShader;
+    delete m_heightFieldTexturedSmoothShader;
+    m_heightFieldSmoothShader = 0;
+    m_heightFieldTexturedSmoothShader = 0;
 
     if (!m_isOpenGLES) {
         if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
@@ -2905,6 +3153,21 @@ void Surface3DRenderer::initShaders(const QString &vertexShader, const QString &
         }
         m_surfaceSliceSmoothShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertex"),
                                                       QStringLiteral(":/shaders/fragmentSurface"));
+        if (m_heightFieldSupported) {
+            if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+                m_heightFieldSmoothShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightFieldShadow"),
+                                                             QStringLiteral(":/shaders/fragmentSurfaceShadowNoTex"));
+                m_heightFieldTexturedSmoothShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightFieldShadow"),
+                                                                     QStringLiteral(":/shaders/fragmentTexturedSurfaceShadow"));
+            } else {
+                m_heightFieldSmoothShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightField"),
+                                                             QStringLiteral(":/shaders/fragmentSurface"));
+                m_heightFieldTexturedSmoothShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightField"),
+                                                                     QStringLiteral(":/shaders/fragmentTexture"));
+            }
+            m_heightFieldSmoothShader->initialize();
+            m_heightFieldTexturedSmoothShader->initialize();
+        }
         if (m_flatSupported) {
             if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
                 m_surfaceFlatShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceShadowFlat"),
@@ -2965,6 +3228,13 @@ void Surface3DRenderer::initSelectionShaders()
     m_selectionShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexLabel"),
                                          QStringLiteral(":/shaders/fragmentLabel"));
     m_selectionShader->initialize();
+
+    if (m_heightFieldSupported) {
+        delete m_heightFieldSelectionShader;
+        m_heightFieldSelectionShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightField"),
+                                                        QStringLiteral(":/shaders/fragmentLabel"));
+        m_heightFieldSelectionShader->initialize();
+    }
 }
 
 void Surface3DRenderer::initSurfaceShaders()
@@ -2976,6 +3246,13 @@ void Surface3DRenderer::initSurfaceShaders()
                                            QStringLiteral(":/shaders/fragmentPlainColor"));
     m_surfaceGridShader->initialize();
 
+    if (m_heightFieldSupported) {
+        delete m_heightFieldGridShader;
+        m_heightFieldGridShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightField"),
+                                                   QStringLiteral(":/shaders/fragmentPlainColor"));
+        m_heightFieldGridShader->initialize();
+    }
+
     // Triggers surface shader selection by shadow setting
     handleShadowQualityChange();
 }
@@ -2987,6 +3264,13 @@ void Surface3DRenderer::initDepthShader()
         m_depthShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexDepth"),
                                          QStringLiteral(":/shaders/fragmentDepth"));
         m_depthShader->initialize();
+
+        if (m_heightFieldSupported) {
+            delete m_heightFieldDepthShader;
+            m_heightFieldDepthShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightField"),
+                                                        QStringLiteral(":/shaders/fragmentDepth"));
+            m_heightFieldDepthShader->initialize();
+        }
     }
 }
 
@@ -68,6 +68,11 @@ private:
     ShaderHelper *m_surfaceSliceFlatShader;
     ShaderHelper *m_surfaceSliceSmoothShader;
     ShaderHelper *m_selectionShader;
+    ShaderHelper *m_heightFieldSmoothShader;
+    ShaderHelper *m_heightFieldTexturedSmoothShader;
+    ShaderHelper *m_heightFieldGridShader;
+    ShaderHelper *m_heightFieldSelectionShader;
+    ShaderHelper *m_heightFieldDepthShader;
     float m_heightNormalizer;
     float m_scaleX;
     float m_scaleY;
@@ -78,6 +83,7 @@ private:
     GLuint m_selectionResultTexture;
     GLfloat m_shadowQualityToShader;
     bool m_flatSupported;
+    bool m_heightFieldSupported;
     bool m_selectionActive;
     AbstractRenderItem m_dummyRenderItem;
     GLint m_shadowQualityMultiplier;
@@ -98,8 +104,10 @@ public:
     SeriesRenderCache *createNewCache(QAbstract3DSeries *series);
     void cleanCache(SeriesRenderCache *cache);
     void updateSelectionMode(QAbstract3DGraph::SelectionFlags mode);
+    void updateRayCastPicking(bool enable);
     void updateRows(const QVector<Surface3DController::ChangeRow> &rows);
     void updateItems(const QVector<Surface3DController::ChangeItem> &points);
+    void updateScrolledRows(const QVector<Surface3DController::ChangeScroll> &scrolls);
     void updateScene(Q3DScene *scene);
     void updateSlicingActive(bool isSlicing);
     void updateSelectedPoint(const QPoint &position, QSurface3DSeries *series);
@@ -113,6 +121,10 @@ public:
                                    bool visible);
     void updateMargin(float margin);
 
+    // Overloaded from abstract renderer
+    virtual void updateAxisRange(QAbstract3DAxis::AxisOrientation orientation, float min,
+                                 float max);
+
     void render(GLuint defaultFboHandle = 0);
 
 protected:
@@ -126,7 +138,11 @@ Q_SIGNALS:
 private:
     void checkFlatSupport(SurfaceSeriesRenderCache *cache);
     void updateObjects(SurfaceSeriesRenderCache *cache, bool dimensionChanged);
+    bool scrollObjects(SurfaceSeriesRenderCache *cache);
+    void updateLevelOfDetail(const QMatrix4x4 &projectionViewMatrix,
+                             const QMatrix4x4 &projectionMatrix);
     void updateSliceDataModel(const QPoint &point);
+    void uploadDirtySurfaceBuffers();
     QPoint mapCoordsToSampleSpace(SurfaceSeriesRenderCache *cache, const QPointF &coords);
     void findMatchingRow(float z, int &sample, int direction, QSurfaceDataArray &dataArray);
     void findMatchingColumn(float x, int &sample, int direction, QSurfaceDataArray &dataArray);
@@ -155,6 +171,7 @@ private:
     void surfacePointSelected(const QPoint &point);
     void updateSelectionPoint(SurfaceSeriesRenderCache *cache, const QPoint &point, bool label);
     QPoint selectionIdToSurfacePoint(uint id);
+    QPoint rayCastToSurfacePoint(const QMatrix4x4 &projectionViewMatrix);
     void updateDepthBuffer();
     void emitSelectedPointChanged(QPoint position);
 
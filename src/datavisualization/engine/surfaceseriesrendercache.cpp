@@ -39,6 +39,8 @@ SurfaceSeriesRenderCache::SurfaceSeriesRenderCache(QAbstract3DSeries *series,
       m_surfaceVisible(false),
       m_surfaceGridVisible(false),
       m_surfaceFlatShading(false),
+      m_heightFieldEnabled(false),
+      m_levelOfDetailEnabled(false),
       m_surfaceObj(new SurfaceObject(renderer)),
       m_sliceSurfaceObj(new SurfaceObject(renderer)),
       m_sampleSpace(QRect(0, 0, 0, 0)),
@@ -51,7 +53,8 @@ SurfaceSeriesRenderCache::SurfaceSeriesRenderCache(QAbstract3DSeries *series,
       m_mainSelectionPointer(0),
       m_slicePointerActive(false),
       m_mainPointerActive(false),
-      m_surfaceTexture(0)
+      m_surfaceTexture(0),
+      m_scrolledRowCount(0)
 {
 }
 
@@ -70,6 +73,14 @@ void SurfaceSeriesRenderCache::populate(bool newSeries)
         m_surfaceFlatShading = series()->isFlatShadingEnabled();
         m_flatStatusDirty = true;
     }
+    if (m_heightFieldEnabled != series()->isHeightFieldEnabled()) {
+        m_heightFieldEnabled = series()->isHeightFieldEnabled();
+        m_flatStatusDirty = true;
+    }
+    if (m_levelOfDetailEnabled != series()->isLevelOfDetailEnabled()) {
+        m_levelOfDetailEnabled = series()->isLevelOfDetailEnabled();
+        m_flatStatusDirty = true;
+    }
 }
 
 void SurfaceSeriesRenderCache::cleanup(TextureHelper *texHelper)
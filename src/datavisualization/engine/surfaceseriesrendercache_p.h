@@ -44,6 +44,7 @@
 #include "seriesrendercache_p.h"
 #include "qsurface3dseries_p.h"
 #include "surfaceobject_p.h"
+#include "surfaceheighthierarchy_p.h"
 #include "selectionpointer_p.h"
 
 #include <QtGui/QMatrix4x4>
@@ -66,8 +67,11 @@ public:
     inline bool isFlatShadingEnabled() const { return m_surfaceFlatShading; }
     inline void setFlatShadingEnabled(bool enabled) { m_surfaceFlatShading = enabled; }
     inline void setFlatChangeAllowed(bool allowed) { m_flatChangeAllowed = allowed; }
+    inline bool isHeightFieldEnabled() const { return m_heightFieldEnabled; }
+    inline bool isLevelOfDetailEnabled() const { return m_levelOfDetailEnabled; }
     inline SurfaceObject *surfaceObject() { return m_surfaceObj; }
     inline SurfaceObject *sliceSurfaceObject() { return m_sliceSurfaceObj; }
+    inline SurfaceHeightHierarchy &heightHierarchy() { return m_heightHierarchy; }
     inline const QRect &sampleSpace() const { return m_sampleSpace; }
     inline void setSampleSpace(const QRect &sampleSpace) { m_sampleSpace = sampleSpace; }
     inline QSurface3DSeries *series() const { return static_cast<QSurface3DSeries *>(m_series); }
@@ -98,13 +102,18 @@ public:
     inline bool mainPointerActive() const { return m_mainPointerActive; }
     inline void setSurfaceTexture(GLuint texture) { m_surfaceTexture = texture; }
     inline GLuint surfaceTexture() const { return m_surfaceTexture; }
+    inline void setScrolledRowCount(int count) { m_scrolledRowCount = count; }
+    inline int scrolledRowCount() const { return m_scrolledRowCount; }
 
 protected:
     bool m_surfaceVisible;
     bool m_surfaceGridVisible;
     bool m_surfaceFlatShading;
+    bool m_heightFieldEnabled;
+    bool m_levelOfDetailEnabled;
     SurfaceObject *m_surfaceObj;
     SurfaceObject *m_sliceSurfaceObj;
+    SurfaceHeightHierarchy m_heightHierarchy;
     QRect m_sampleSpace;
     QSurfaceDataArray m_dataArray;
     QSurfaceDataArray m_sliceDataArray;
@@ -119,6 +128,7 @@ protected:
     bool m_slicePointerActive;
     bool m_mainPointerActive;
     GLuint m_surfaceTexture;
+    int m_scrolledRowCount; // Rows scrolled out of the proxy since the last data update
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -37,6 +37,8 @@ AbstractObjectHelper::AbstractObjectHelper()
       m_uvbuffer(0),
       m_elementbuffer(0),
       m_indexCount(0),
+      m_indexType(GL_UNSIGNED_INT),
+      m_primitiveMode(GL_TRIANGLES),
       m_meshDataLoaded(false)
 {
     initializeOpenGLFunctions();
@@ -85,4 +87,37 @@ GLuint AbstractObjectHelper::indexCount()
     return m_indexCount;
 }
 
+GLenum AbstractObjectHelper::indexType()
+{
+    return m_indexType;
+}
+
+GLenum AbstractObjectHelper::primitiveMode()
+{
+    return m_primitiveMode;
+}
+
+// Uploads changed items to the currently bound array buffer. Item i is stored to buffer slot
+// bufferPositions[i], which must be in ascending order. Items in consecutive slots are combined
+// into a single sub-data upload. By default the source data is packed, i.e. item i is at offset
+// i * itemSize in the data. If dataMirrorsBuffer is set, the data has the same layout as the
+// buffer instead.
+void AbstractObjectHelper::updateBufferSpans(const QVector<int> &bufferPositions, int itemSize,
+                                             const void *data, bool dataMirrorsBuffer)
+{
+    const char *source = static_cast<const char *>(data);
+    const int positionCount = bufferPositions.size();
+    int spanStart = 0;
+    for (int i = 1; i <= positionCount; i++) {
+        if (i == positionCount || bufferPositions.at(i) != bufferPositions.at(i - 1) + 1) {
+            const GLintptr bufferOffset = GLintptr(bufferPositions.at(spanStart)) * itemSize;
+            const GLintptr sourceOffset = dataMirrorsBuffer ? bufferOffset
+                                                            : GLintptr(spanStart) * itemSize;
+            glBufferSubData(GL_ARRAY_BUFFER, bufferOffset, GLsizeiptr(i - spanStart) * itemSize,
+                            source + sourceOffset);
+            spanStart = i;
+        }
+    }
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
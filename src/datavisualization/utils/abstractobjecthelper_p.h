@@ -56,6 +56,12 @@ public:
     virtual GLuint uvBuf();
     GLuint elementBuf();
     GLuint indexCount();
+    GLenum indexType();
+    GLenum primitiveMode();
+
+protected:
+    void updateBufferSpans(const QVector<int> &bufferPositions, int itemSize, const void *data,
+                           bool dataMirrorsBuffer = false);
 
 public:
     GLuint m_vertexbuffer;
@@ -64,6 +70,8 @@ public:
     GLuint m_elementbuffer;
 
     GLuint m_indexCount;
+    GLenum m_indexType;
+    GLenum m_primitiveMode;
     GLboolean m_meshDataLoaded;
 };
 
@@ -0,0 +1,218 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "barinstancebufferhelper_p.h"
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+BarInstanceBufferHelper::BarInstanceBufferHelper()
+    : m_instancebuffer(0),
+      m_positiveCount(0),
+      m_negativeStart(0),
+      m_rowCount(0),
+      m_columnCount(0)
+{
+    for (int i = 0; i < InstanceRangeCount; i++)
+        setRange(InstanceRange(i), 0, 0);
+}
+
+BarInstanceBufferHelper::~BarInstanceBufferHelper()
+{
+    if (QOpenGLContext::currentContext())
+        glDeleteBuffers(1, &m_instancebuffer);
+}
+
+GLuint BarInstanceBufferHelper::instanceBuf()
+{
+    if (!m_meshDataLoaded)
+        qFatal("No loaded object");
+    return m_instancebuffer;
+}
+
+void BarInstanceBufferHelper::beginLoad(int rowCount, int columnCount)
+{
+    const int maxInstanceCount = rowCount * columnCount;
+    m_rowCount = rowCount;
+    m_columnCount = columnCount;
+    m_barInstances.clear();
+    m_updatedInstances.clear();
+    m_bufferedInstances.resize(maxInstanceCount * instanceFloatCount);
+    m_positiveHighlights.clear();
+    m_negativeHighlights.clear();
+    m_positiveCount = 0;
+    m_negativeStart = maxInstanceCount;
+}
+
+void BarInstanceBufferHelper::addInstance(const QVector3D &translation,
+                                          const QQuaternion &rotation, float gradientHeight,
+                                          int row, int column, bool highlighted)
+{
+    const bool negative = translation.y() < 0.0f;
+    GLfloat *instance;
+    if (highlighted) {
+        QVector<GLfloat> &highlights = negative ? m_negativeHighlights : m_positiveHighlights;
+        highlights.resize(highlights.size() + instanceFloatCount);
+        instance = highlights.data() + highlights.size() - instanceFloatCount;
+    } else if (negative) {
+        instance = m_bufferedInstances.data() + --m_negativeStart * instanceFloatCount;
+    } else {
+        instance = m_bufferedInstances.data() + m_positiveCount++ * instanceFloatCount;
+    }
+
+    createInstance(translation, rotation, gradientHeight, row, column, instance);
+}
+
+void BarInstanceBufferHelper::endLoad(bool staticData)
+{
+    const int maxInstanceCount = m_bufferedInstances.size() / instanceFloatCount;
+    const int positiveHighlightCount = m_positiveHighlights.size() / instanceFloatCount;
+    const int negativeHighlightCount = m_negativeHighlights.size() / instanceFloatCount;
+    const int negativeCount = maxInstanceCount - m_negativeStart;
+
+    // Close the gap between the bars added from the start and the ones added from the end,
+    // placing the highlighted bars in between. Every bar took one slot of the gap at most, so
+    // the negative bars only ever move towards the start of the buffer.
+    GLfloat *instances = m_bufferedInstances.data();
+    int position = m_positiveCount;
+    memcpy(instances + position * instanceFloatCount, m_positiveHighlights.constData(),
+           m_positiveHighlights.size() * sizeof(GLfloat));
+    position += positiveHighlightCount;
+    memcpy(instances + position * instanceFloatCount, m_negativeHighlights.constData(),
+           m_negativeHighlights.size() * sizeof(GLfloat));
+    position += negativeHighlightCount;
+    memmove(instances + position * instanceFloatCount,
+            instances + m_negativeStart * instanceFloatCount,
+            negativeCount * instanceFloatCount * sizeof(GLfloat));
+    const int instanceCount = position + negativeCount;
+    m_bufferedInstances.resize(instanceCount * instanceFloatCount);
+
+    setRange(PositiveBars, 0, m_positiveCount + positiveHighlightCount);
+    setRange(NegativeBars, m_positiveCount + positiveHighlightCount,
+             negativeHighlightCount + negativeCount);
+    setRange(PositiveBaseBars, 0, m_positiveCount);
+    setRange(NegativeBaseBars, position, negativeCount);
+
+    m_indexCount = instanceCount;
+    if (instanceCount > 0) {
+        if (!m_instancebuffer)
+            glGenBuffers(1, &m_instancebuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_instancebuffer);
+        glBufferData(GL_ARRAY_BUFFER, m_bufferedInstances.size() * sizeof(GLfloat),
+                     m_bufferedInstances.constData(),
+                     staticData ? GL_DYNAMIC_DRAW : GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_meshDataLoaded = true;
+    }
+}
+
+// Updates the instance of a bar in place. Returns false if that is not possible because the bar
+// would move to another range of the buffer, in which case all the instances need reloading.
+bool BarInstanceBufferHelper::updateInstance(const QVector3D &translation,
+                                             const QQuaternion &rotation, float gradientHeight,
+                                             int row, int column, bool highlighted)
+{
+    if (m_barInstances.isEmpty())
+        resolveBarInstances();
+
+    const int instanceIndex = m_barInstances.at(row * m_columnCount + column);
+    if (instanceIndex < 0 || translation.y() == 0.0f)
+        return instanceIndex < 0 && translation.y() == 0.0f;
+
+    const bool negative = translation.y() < 0.0f;
+    if (negative != (instanceIndex >= m_rangeStart[NegativeBars]))
+        return false;
+    if (highlighted != (instanceIndex >= m_rangeCount[PositiveBaseBars]
+                        && instanceIndex < m_rangeStart[NegativeBaseBars])) {
+        return false;
+    }
+
+    createInstance(translation, rotation, gradientHeight, row, column,
+                   m_bufferedInstances.data() + instanceIndex * instanceFloatCount);
+    m_updatedInstances.append(instanceIndex);
+    return true;
+}
+
+void BarInstanceBufferHelper::uploadUpdates()
+{
+    if (m_updatedInstances.isEmpty())
+        return;
+
+    std::sort(m_updatedInstances.begin(), m_updatedInstances.end());
+    m_updatedInstances.erase(std::unique(m_updatedInstances.begin(), m_updatedInstances.end()),
+                             m_updatedInstances.end());
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instancebuffer);
+    updateBufferSpans(m_updatedInstances, instanceFloatCount * sizeof(GLfloat),
+                      m_bufferedInstances.constData(), true);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_updatedInstances.clear();
+}
+
+void BarInstanceBufferHelper::setRange(InstanceRange range, int start, int count)
+{
+    m_rangeStart[range] = start;
+    m_rangeCount[range] = count;
+}
+
+void BarInstanceBufferHelper::createInstance(const QVector3D &translation,
+                                             const QQuaternion &rotation, float gradientHeight,
+                                             int row, int column, GLfloat *instance)
+{
+    instance[0] = translation.x();
+    instance[1] = translation.y();
+    instance[2] = translation.z();
+    instance[3] = gradientHeight;
+
+    // Shader expects the quaternion as (x, y, z, scalar)
+    instance[instanceRotationOffset] = rotation.x();
+    instance[instanceRotationOffset + 1] = rotation.y();
+    instance[instanceRotationOffset + 2] = rotation.z();
+    instance[instanceRotationOffset + 3] = rotation.scalar();
+
+    instance[instanceIndexOffset] = GLfloat(row);
+    instance[instanceIndexOffset + 1] = GLfloat(column);
+}
+
+// Instances are grouped by range rather than stored in bar order, so the instance of each bar is
+// looked up from the row and column stored in the instances. This is only needed for updating
+// instances in place, so it is done on the first update after a load.
+void BarInstanceBufferHelper::resolveBarInstances()
+{
+    m_barInstances.fill(-1, m_rowCount * m_columnCount);
+    const int instanceCount = m_bufferedInstances.size() / instanceFloatCount;
+    const GLfloat *instance = m_bufferedInstances.constData() + instanceIndexOffset;
+    for (int i = 0; i < instanceCount; i++, instance += instanceFloatCount)
+        m_barInstances[int(instance[0]) * m_columnCount + int(instance[1])] = i;
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+
+#ifndef BARINSTANCEBUFFERHELPER_P_H
+#define BARINSTANCEBUFFERHELPER_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "abstractobjecthelper_p.h"
+
+#include <QtGui/QQuaternion>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+class BarInstanceBufferHelper : public AbstractObjectHelper
+{
+public:
+    // Per-instance data: translation with the bar height as y and the gradient height as w (4),
+    // rotation quaternion (4), row and column of the bar (2)
+    static const int instanceFloatCount = 10;
+    static const int instanceRotationOffset = 4;
+    static const int instanceIndexOffset = 8;
+
+    // Bars with positive and negative heights need different face culling, so they are drawn
+    // as separate ranges of the buffer. Highlighted bars are kept between the two, so that the
+    // bars drawn with the base color of the series are ranges of their own as well.
+    enum InstanceRange {
+        PositiveBars = 0,
+        NegativeBars,
+        PositiveBaseBars,
+        NegativeBaseBars,
+        InstanceRangeCount
+    };
+
+    BarInstanceBufferHelper();
+    virtual ~BarInstanceBufferHelper();
+
+    GLuint instanceBuf();
+
+    void beginLoad(int rowCount, int columnCount);
+    void addInstance(const QVector3D &translation, const QQuaternion &rotation,
+                     float gradientHeight, int row, int column, bool highlighted);
+    void endLoad(bool staticData = false);
+    bool updateInstance(const QVector3D &translation, const QQuaternion &rotation,
+                        float gradientHeight, int row, int column, bool highlighted);
+    void uploadUpdates();
+
+    inline int rangeStart(InstanceRange range) const { return m_rangeStart[range]; }
+    inline int rangeCount(InstanceRange range) const { return m_rangeCount[range]; }
+
+public:
+    GLuint m_instancebuffer;
+
+private:
+    void setRange(InstanceRange range, int start, int count);
+    void createInstance(const QVector3D &translation, const QQuaternion &rotation,
+                        float gradientHeight, int row, int column, GLfloat *instance);
+    void resolveBarInstances();
+
+    QVector<GLfloat> m_bufferedInstances;
+    QVector<GLfloat> m_positiveHighlights;
+    QVector<GLfloat> m_negativeHighlights;
+    int m_positiveCount; // Positive bars with base color, stored from the start of the buffer
+    int m_negativeStart; // Negative bars with base color, stored from the end of the buffer
+    int m_rangeStart[InstanceRangeCount];
+    int m_rangeCount[InstanceRangeCount];
+    int m_rowCount;
+    int m_columnCount;
+    QVector<int> m_barInstances; // Instance of each bar, -1 for bars without one
+    QVector<int> m_updatedInstances;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
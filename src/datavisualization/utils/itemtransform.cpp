@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "itemtransform_p.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Rotation matrix of the quaternion in row-major order. Matches QMatrix4x4::rotate(), which does
+// not normalize the quaternion either.
+static inline void rotationMatrix(const QQuaternion &rotation, float r[3][3])
+{
+    const float f2x = rotation.x() + rotation.x();
+    const float f2y = rotation.y() + rotation.y();
+    const float f2z = rotation.z() + rotation.z();
+    const float f2xw = f2x * rotation.scalar();
+    const float f2yw = f2y * rotation.scalar();
+    const float f2zw = f2z * rotation.scalar();
+    const float f2xx = f2x * rotation.x();
+    const float f2xy = f2x * rotation.y();
+    const float f2xz = f2x * rotation.z();
+    const float f2yy = f2y * rotation.y();
+    const float f2yz = f2y * rotation.z();
+    const float f2zz = f2z * rotation.z();
+
+    r[0][0] = 1.0f - (f2yy + f2zz);
+    r[0][1] = f2xy - f2zw;
+    r[0][2] = f2xz + f2yw;
+    r[1][0] = f2xy + f2zw;
+    r[1][1] = 1.0f - (f2xx + f2zz);
+    r[1][2] = f2yz - f2xw;
+    r[2][0] = f2xz - f2yw;
+    r[2][1] = f2yz + f2xw;
+    r[2][2] = 1.0f - (f2xx + f2yy);
+}
+
+static inline QMatrix4x4 modelMatrixFromRotation(const QVector3D &translation,
+                                                 const float r[3][3], const QVector3D &scale)
+{
+    return QMatrix4x4(r[0][0] * scale.x(), r[0][1] * scale.y(), r[0][2] * scale.z(),
+                      translation.x(),
+                      r[1][0] * scale.x(), r[1][1] * scale.y(), r[1][2] * scale.z(),
+                      translation.y(),
+                      r[2][0] * scale.x(), r[2][1] * scale.y(), r[2][2] * scale.z(),
+                      translation.z(),
+                      0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+static inline QMatrix4x4 normalMatrixFromRotation(const float r[3][3], const QVector3D &scale)
+{
+    // Same as QMatrix4x4::inverted(), which gives identity for matrices that cannot be inverted
+    if (scale.x() == 0.0f || scale.y() == 0.0f || scale.z() == 0.0f)
+        return QMatrix4x4();
+
+    const float invX = 1.0f / scale.x();
+    const float invY = 1.0f / scale.y();
+    const float invZ = 1.0f / scale.z();
+    return QMatrix4x4(r[0][0] * invX, r[0][1] * invY, r[0][2] * invZ, 0.0f,
+                      r[1][0] * invX, r[1][1] * invY, r[1][2] * invZ, 0.0f,
+                      r[2][0] * invX, r[2][1] * invY, r[2][2] * invZ, 0.0f,
+                      0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+// Returns translation * rotation * scale.
+QMatrix4x4 ItemTransform::modelMatrix(const QVector3D &translation, const QQuaternion &rotation,
+                                      const QVector3D &scale)
+{
+    float r[3][3];
+    rotationMatrix(rotation, r);
+    return modelMatrixFromRotation(translation, r, scale);
+}
+
+// Returns the inverse transpose of rotation * scale.
+QMatrix4x4 ItemTransform::normalMatrix(const QQuaternion &rotation, const QVector3D &scale)
+{
+    float r[3][3];
+    rotationMatrix(rotation, r);
+    return normalMatrixFromRotation(r, scale);
+}
+
+void ItemTransform::modelAndNormalMatrix(const QVector3D &translation,
+                                         const QQuaternion &rotation, const QVector3D &scale,
+                                         QMatrix4x4 &modelMatrix, QMatrix4x4 &normalMatrix)
+{
+    float r[3][3];
+    rotationMatrix(rotation, r);
+    modelMatrix = modelMatrixFromRotation(translation, r, scale);
+    normalMatrix = normalMatrixFromRotation(r, scale);
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,68 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+
+#ifndef ITEMTRANSFORM_P_H
+#define ITEMTRANSFORM_P_H
+
+#include "datavisualizationglobal_p.h"
+
+#include <QtGui/QMatrix4x4>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Builds the matrices of items that are translated, rotated and scaled, in that order, such as
+// bars, scatter items and custom items. The matrices are written directly from the rotation and
+// the scale instead of being accumulated with general matrix products. Since the rotation is
+// orthonormal and the scale diagonal, the inverse transpose of (rotation * scale) used for
+// transforming the normals is (rotation * inverse scale), so no matrix inversion is needed.
+class QT_DATAVISUALIZATION_EXPORT ItemTransform
+{
+public:
+    static QMatrix4x4 modelMatrix(const QVector3D &translation, const QQuaternion &rotation,
+                                  const QVector3D &scale);
+    static QMatrix4x4 normalMatrix(const QQuaternion &rotation, const QVector3D &scale);
+    static void modelAndNormalMatrix(const QVector3D &translation, const QQuaternion &rotation,
+                                     const QVector3D &scale, QMatrix4x4 &modelMatrix,
+                                     QMatrix4x4 &normalMatrix);
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
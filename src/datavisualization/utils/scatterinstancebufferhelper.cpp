@@ -0,0 +1,214 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scatterinstancebufferhelper_p.h"
+#include <QtCore/qmath.h>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+const GLfloat itemScaler = 3.0f;
+
+ScatterInstanceBufferHelper::ScatterInstanceBufferHelper()
+    : m_instancebuffer(0),
+      m_scaleY(0.0f)
+{
+}
+
+ScatterInstanceBufferHelper::~ScatterInstanceBufferHelper()
+{
+    if (QOpenGLContext::currentContext())
+        glDeleteBuffers(1, &m_instancebuffer);
+}
+
+GLuint ScatterInstanceBufferHelper::instanceBuf()
+{
+    if (!m_meshDataLoaded)
+        qFatal("No loaded object");
+    return m_instancebuffer;
+}
+
+void ScatterInstanceBufferHelper::fullLoad(ScatterSeriesRenderCache *cache, qreal dotScale)
+{
+    m_indexCount = 0;
+    m_bufferedInstances.clear();
+
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const int renderArraySize = renderArray.size();
+
+    if (renderArraySize == 0)
+        return;  // No use to go forward
+
+    float itemSize = cache->itemSize() / itemScaler;
+    if (itemSize == 0.0f)
+        itemSize = dotScale;
+
+    m_bufferedInstances.resize(renderArraySize * instanceFloatCount);
+    cache->bufferIndices().resize(renderArraySize);
+
+    GLfloat *instances = m_bufferedInstances.data();
+    uint itemCount = 0;
+    for (int i = 0; i < renderArraySize; i++) {
+        if (!renderArray.isVisible(i))
+            continue;
+        else
+            cache->bufferIndices()[i] = itemCount;
+
+        createInstance(cache, i, itemSize, instances + itemCount * instanceFloatCount);
+        itemCount++;
+    }
+    m_bufferedInstances.resize(itemCount * instanceFloatCount);
+
+    if (itemCount > 0) {
+        if (!m_instancebuffer)
+            glGenBuffers(1, &m_instancebuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_instancebuffer);
+        glBufferData(GL_ARRAY_BUFFER, m_bufferedInstances.size() * sizeof(GLfloat),
+                     m_bufferedInstances.constData(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_indexCount = itemCount;
+        m_meshDataLoaded = true;
+    }
+}
+
+void ScatterInstanceBufferHelper::update(ScatterSeriesRenderCache *cache, qreal dotScale)
+{
+    const int updateSize = cache->updateIndices().size();
+
+    // Updating everything costs the same as a full load, as the instances are tiny
+    if (!updateSize || !m_indexCount) {
+        fullLoad(cache, dotScale);
+        return;
+    }
+
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const int instanceSize = instanceFloatCount * sizeof(GLfloat);
+
+    float itemSize = cache->itemSize() / itemScaler;
+    if (itemSize == 0.0f)
+        itemSize = dotScale;
+
+    QVector<int> bufferPositions;
+    bufferPositions.reserve(updateSize);
+    for (int i = 0; i < updateSize; i++) {
+        const int index = cache->updateIndices().at(i);
+        if (!renderArray.isVisible(index))
+            continue;
+
+        const int dataPos = cache->bufferIndices().at(index);
+        createInstance(cache, index, itemSize,
+                       m_bufferedInstances.data() + dataPos * instanceFloatCount);
+        bufferPositions.append(dataPos);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instancebuffer);
+    updateBufferSpans(bufferPositions, instanceSize, m_bufferedInstances.constData(), true);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ScatterInstanceBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
+{
+    if (!m_indexCount)
+        return;
+
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const bool updateAll = (cache->updateIndices().size() == 0);
+    const int updateSize = updateAll ? renderArray.size() : cache->updateIndices().size();
+    const int instanceSize = instanceFloatCount * sizeof(GLfloat);
+
+    QVector<int> bufferPositions;
+    if (!updateAll)
+        bufferPositions.reserve(updateSize);
+    for (int i = 0; i < updateSize; i++) {
+        const int index = updateAll ? i : cache->updateIndices().at(i);
+        if (!renderArray.isVisible(index))
+            continue;
+
+        const int dataPos = cache->bufferIndices().at(index);
+        m_bufferedInstances[dataPos * instanceFloatCount + instanceUVOffset] =
+                createUV(cache, index);
+        if (!updateAll)
+            bufferPositions.append(dataPos);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instancebuffer);
+    if (updateAll) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_bufferedInstances.size() * sizeof(GLfloat),
+                        m_bufferedInstances.constData());
+    } else {
+        updateBufferSpans(bufferPositions, instanceSize, m_bufferedInstances.constData(), true);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ScatterInstanceBufferHelper::createInstance(ScatterSeriesRenderCache *cache, int index,
+                                                 float itemSize, GLfloat *instance)
+{
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const QVector3D &translation = renderArray.translation(index);
+    instance[0] = translation.x();
+    instance[1] = translation.y();
+    instance[2] = translation.z();
+    instance[3] = itemSize;
+
+    // Shader expects the quaternion as (x, y, z, scalar)
+    QQuaternion totalRotation = cache->meshRotation() * renderArray.rotation(index);
+    instance[instanceRotationOffset] = totalRotation.x();
+    instance[instanceRotationOffset + 1] = totalRotation.y();
+    instance[instanceRotationOffset + 2] = totalRotation.z();
+    instance[instanceRotationOffset + 3] = totalRotation.scalar();
+
+    instance[instanceUVOffset] = createUV(cache, index);
+}
+
+float ScatterInstanceBufferHelper::createUV(ScatterSeriesRenderCache *cache, int index)
+{
+    // Object gradient is resolved in the shader from the vertex position, so only
+    // range gradient needs a per-instance value.
+    if (cache->colorStyle() != Q3DTheme::ColorStyleRangeGradient)
+        return 0.0f;
+
+    const float yAdjustment = 0.1f;
+    const float flippedYAdjustment = 0.9f;
+
+    float y = cache->renderArray().gradientPosition(index, m_scaleY);
+
+    // Avoid values near gradient texel boundary, as this causes artifacts
+    // with some graphics cards.
+    const float floorY = float(qFloor(y * gradientTextureHeight));
+    const float diff = (y * gradientTextureHeight) - floorY;
+    if (diff < yAdjustment)
+        y += yAdjustment / gradientTextureHeight;
+    else if (diff > flippedYAdjustment)
+        y -= yAdjustment / gradientTextureHeight;
+
+    return y;
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERINSTANCEBUFFERHELPER_P_H
+#define SCATTERINSTANCEBUFFERHELPER_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "abstractobjecthelper_p.h"
+#include "scatterseriesrendercache_p.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+class ScatterInstanceBufferHelper : public AbstractObjectHelper
+{
+public:
+    // Per-instance data: translation and scale (4), rotation quaternion (4), gradient UV (1)
+    static const int instanceFloatCount = 9;
+    static const int instanceRotationOffset = 4;
+    static const int instanceUVOffset = 8;
+
+    ScatterInstanceBufferHelper();
+    virtual ~ScatterInstanceBufferHelper();
+
+    GLuint instanceBuf();
+
+    void fullLoad(ScatterSeriesRenderCache *cache, qreal dotScale);
+    void update(ScatterSeriesRenderCache *cache, qreal dotScale);
+    void updateUVs(ScatterSeriesRenderCache *cache);
+    void setScaleY(float scale) { m_scaleY = scale; }
+
+public:
+    GLuint m_instancebuffer;
+
+private:
+    void createInstance(ScatterSeriesRenderCache *cache, int index, float itemSize,
+                        GLfloat *instance);
+    float createUV(ScatterSeriesRenderCache *cache, int index);
+
+    QVector<GLfloat> m_bufferedInstances;
+    float m_scaleY;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
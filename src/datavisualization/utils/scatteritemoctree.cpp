@@ -0,0 +1,273 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scatteritemoctree_p.h"
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+const int maxLeafItems = 32;
+const int maxNodeDepth = 10;
+
+ScatterItemOctree::ScatterItemOctree()
+    : m_dirty(true)
+{
+}
+
+ScatterItemOctree::~ScatterItemOctree()
+{
+}
+
+void ScatterItemOctree::build(const ScatterRenderItemArray &renderArray)
+{
+    const int renderArraySize = renderArray.size();
+
+    m_nodes.clear();
+    m_itemNodes.fill(-1, renderArraySize);
+    m_dirty = false;
+
+    bool itemsVisible = false;
+    QVector3D minBounds;
+    QVector3D maxBounds;
+    for (int i = 0; i < renderArraySize; i++) {
+        if (!renderArray.isVisible(i))
+            continue;
+        const QVector3D &translation = renderArray.translation(i);
+        if (!itemsVisible) {
+            minBounds = translation;
+            maxBounds = translation;
+            itemsVisible = true;
+        } else {
+            minBounds.setX(qMin(minBounds.x(), translation.x()));
+            minBounds.setY(qMin(minBounds.y(), translation.y()));
+            minBounds.setZ(qMin(minBounds.z(), translation.z()));
+            maxBounds.setX(qMax(maxBounds.x(), translation.x()));
+            maxBounds.setY(qMax(maxBounds.y(), translation.y()));
+            maxBounds.setZ(qMax(maxBounds.z(), translation.z()));
+        }
+    }
+
+    if (!itemsVisible)
+        return;
+
+    // Root is a cube with some slack, so that items moving slightly don't force a rebuild
+    const QVector3D extents = maxBounds - minBounds;
+    const float maxExtent = qMax(extents.x(), qMax(extents.y(), extents.z()));
+    Node root;
+    root.center = (minBounds + maxBounds) / 2.0f;
+    root.halfSize = qMax(maxExtent * 0.55f, 0.001f);
+    root.depth = 0;
+    root.firstChild = -1;
+    m_nodes.append(root);
+
+    for (int i = 0; i < renderArraySize; i++) {
+        if (renderArray.isVisible(i))
+            insertItem(renderArray, i);
+    }
+}
+
+void ScatterItemOctree::updateItem(const ScatterRenderItemArray &renderArray, int index)
+{
+    if (m_dirty)
+        return;
+
+    if (index >= m_itemNodes.size()) {
+        m_dirty = true;
+        return;
+    }
+
+    const int oldNode = m_itemNodes.at(index);
+    if (oldNode >= 0) {
+        m_nodes[oldNode].items.removeOne(index);
+        m_itemNodes[index] = -1;
+    }
+
+    if (renderArray.isVisible(index)) {
+        // Items moved outside the root bounds require a rebuild
+        const QVector3D &translation = renderArray.translation(index);
+        if (m_nodes.isEmpty()) {
+            m_dirty = true;
+            return;
+        }
+        const Node &root = m_nodes.at(0);
+        const QVector3D offset = translation - root.center;
+        if (qAbs(offset.x()) > root.halfSize || qAbs(offset.y()) > root.halfSize
+                || qAbs(offset.z()) > root.halfSize) {
+            m_dirty = true;
+            return;
+        }
+        insertItem(renderArray, index);
+    }
+}
+
+void ScatterItemOctree::findItems(const ScatterRenderItemArray &renderArray,
+                                  const QMatrix4x4 &viewProjectionMatrix, float itemRadius,
+                                  QVector<int> &indices)
+{
+    if (m_dirty)
+        build(renderArray);
+
+    indices.clear();
+    if (m_nodes.isEmpty())
+        return;
+
+    // Extract the frustum planes from the matrix, normals pointing inside
+    const QVector4D row0 = viewProjectionMatrix.row(0);
+    const QVector4D row1 = viewProjectionMatrix.row(1);
+    const QVector4D row2 = viewProjectionMatrix.row(2);
+    const QVector4D row3 = viewProjectionMatrix.row(3);
+    QVector4D planes[6] = {
+        row3 + row0, row3 - row0,
+        row3 + row1, row3 - row1,
+        row3 + row2, row3 - row2
+    };
+    for (int i = 0; i < 6; i++) {
+        const float length = planes[i].toVector3D().length();
+        if (length > 0.0f)
+            planes[i] /= length;
+    }
+
+    collectItems(renderArray, 0, planes, 0x3f, itemRadius, indices);
+
+    // Keep the drawing order of the render array
+    std::sort(indices.begin(), indices.end());
+}
+
+void ScatterItemOctree::insertItem(const ScatterRenderItemArray &renderArray, int index)
+{
+    const QVector3D &translation = renderArray.translation(index);
+    int nodeIndex = 0;
+    while (m_nodes.at(nodeIndex).firstChild >= 0) {
+        const Node &node = m_nodes.at(nodeIndex);
+        nodeIndex = node.firstChild + childOctant(node, translation);
+    }
+
+    m_nodes[nodeIndex].items.append(index);
+    m_itemNodes[index] = nodeIndex;
+
+    if (m_nodes.at(nodeIndex).items.size() > maxLeafItems
+            && m_nodes.at(nodeIndex).depth < maxNodeDepth) {
+        splitNode(renderArray, nodeIndex);
+    }
+}
+
+void ScatterItemOctree::splitNode(const ScatterRenderItemArray &renderArray, int nodeIndex)
+{
+    // Copy the parent, as adding the children may reallocate the node array
+    const Node parent = m_nodes.at(nodeIndex);
+    const int firstChild = m_nodes.size();
+    const float childHalfSize = parent.halfSize / 2.0f;
+
+    for (int i = 0; i < 8; i++) {
+        Node child;
+        child.center = parent.center
+                + QVector3D((i & 1) ? childHalfSize : -childHalfSize,
+                            (i & 2) ? childHalfSize : -childHalfSize,
+                            (i & 4) ? childHalfSize : -childHalfSize);
+        child.halfSize = childHalfSize;
+        child.depth = parent.depth + 1;
+        child.firstChild = -1;
+        m_nodes.append(child);
+    }
+
+    m_nodes[nodeIndex].firstChild = firstChild;
+    m_nodes[nodeIndex].items.clear();
+
+    foreach (int item, parent.items) {
+        const int childIndex = firstChild + childOctant(parent, renderArray.translation(item));
+        m_nodes[childIndex].items.append(item);
+        m_itemNodes[item] = childIndex;
+    }
+
+    for (int i = 0; i < 8; i++) {
+        const Node &child = m_nodes.at(firstChild + i);
+        if (child.items.size() > maxLeafItems && child.depth < maxNodeDepth)
+            splitNode(renderArray, firstChild + i);
+    }
+}
+
+void ScatterItemOctree::collectItems(const ScatterRenderItemArray &renderArray, int nodeIndex,
+                                     const QVector4D *planes, int planeMask, float itemRadius,
+                                     QVector<int> &indices) const
+{
+    const Node &node = m_nodes.at(nodeIndex);
+
+    // Node bounds are grown by the item radius, as items reach outside their center point.
+    // Planes the node is fully inside of need not be tested for its children.
+    const float extent = node.halfSize + itemRadius;
+    int intersectMask = 0;
+    for (int i = 0; i < 6; i++) {
+        if (!(planeMask & (1 << i)))
+            continue;
+        const QVector4D &plane = planes[i];
+        const float distance = QVector3D::dotProduct(plane.toVector3D(), node.center) + plane.w();
+        const float reach = extent * (qAbs(plane.x()) + qAbs(plane.y()) + qAbs(plane.z()));
+        if (distance < -reach)
+            return;
+        if (distance < reach)
+            intersectMask |= (1 << i);
+    }
+
+    if (!intersectMask) {
+        collectAllItems(nodeIndex, indices);
+    } else if (node.firstChild >= 0) {
+        for (int i = 0; i < 8; i++) {
+            collectItems(renderArray, node.firstChild + i, planes, intersectMask, itemRadius,
+                         indices);
+        }
+    } else {
+        foreach (int item, node.items) {
+            const QVector3D &translation = renderArray.translation(item);
+            bool inside = true;
+            for (int i = 0; i < 6 && inside; i++) {
+                if ((intersectMask & (1 << i))
+                        && QVector3D::dotProduct(planes[i].toVector3D(), translation)
+                        + planes[i].w() < -itemRadius) {
+                    inside = false;
+                }
+            }
+            if (inside)
+                indices.append(item);
+        }
+    }
+}
+
+void ScatterItemOctree::collectAllItems(int nodeIndex, QVector<int> &indices) const
+{
+    const Node &node = m_nodes.at(nodeIndex);
+    if (node.firstChild >= 0) {
+        for (int i = 0; i < 8; i++)
+            collectAllItems(node.firstChild + i, indices);
+    } else {
+        indices += node.items;
+    }
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERITEMOCTREE_P_H
+#define SCATTERITEMOCTREE_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "scatterrenderitem_p.h"
+
+#include <QtGui/QMatrix4x4>
+#include <QtGui/QVector4D>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Spatial index over the visible items of a scatter render array. Used to find the items inside
+// a view frustum without testing every item of the series.
+class ScatterItemOctree
+{
+public:
+    ScatterItemOctree();
+    ~ScatterItemOctree();
+
+    inline void setDirty() { m_dirty = true; }
+    inline bool isDirty() const { return m_dirty; }
+
+    void build(const ScatterRenderItemArray &renderArray);
+    void updateItem(const ScatterRenderItemArray &renderArray, int index);
+    void findItems(const ScatterRenderItemArray &renderArray,
+                   const QMatrix4x4 &viewProjectionMatrix, float itemRadius,
+                   QVector<int> &indices);
+
+private:
+    struct Node {
+        QVector3D center;
+        float halfSize;
+        int depth;
+        int firstChild; // Children are stored consecutively, -1 for leaves
+        QVector<int> items;
+    };
+
+    void insertItem(const ScatterRenderItemArray &renderArray, int index);
+    void splitNode(const ScatterRenderItemArray &renderArray, int nodeIndex);
+    void collectItems(const ScatterRenderItemArray &renderArray, int nodeIndex,
+                      const QVector4D *planes, int planeMask, float itemRadius,
+                      QVector<int> &indices) const;
+    void collectAllItems(int nodeIndex, QVector<int> &indices) const;
+    inline int childOctant(const Node &node, const QVector3D &pos) const
+    {
+        return (pos.x() >= node.center.x() ? 1 : 0)
+                | (pos.y() >= node.center.y() ? 2 : 0)
+                | (pos.z() >= node.center.z() ? 4 : 0);
+    }
+
+    QVector<Node> m_nodes;
+    QVector<int> m_itemNodes; // Leaf node of each render array item, -1 if not in the tree
+    bool m_dirty;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
@@ -0,0 +1,178 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scatterlevelofdetail_p.h"
+
+#include <QtCore/QBitArray>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+const int firstLevelResolution = 8;
+const int maxLevelCount = 6; // Finest coarse level grid has 256 cells per axis
+// The finest level with at most this many items per pixel of the graph area on screen is drawn
+const float maxItemsPerPixel = 0.5f;
+
+ScatterLevelOfDetail::ScatterLevelOfDetail()
+    : m_movedCount(0),
+      m_dirty(true)
+{
+}
+
+ScatterLevelOfDetail::~ScatterLevelOfDetail()
+{
+}
+
+void ScatterLevelOfDetail::build(const ScatterRenderItemArray &renderArray)
+{
+    const int renderArraySize = renderArray.size();
+
+    m_itemOrder.clear();
+    m_levelCounts.clear();
+    m_itemRanks.fill(-1, renderArraySize);
+    m_movedCount = 0;
+    m_dirty = false;
+
+    int visibleCount = 0;
+    QVector3D minBounds;
+    QVector3D maxBounds;
+    for (int i = 0; i < renderArraySize; i++) {
+        if (!renderArray.isVisible(i))
+            continue;
+        const QVector3D &translation = renderArray.translation(i);
+        if (!visibleCount) {
+            minBounds = translation;
+            maxBounds = translation;
+        } else {
+            minBounds.setX(qMin(minBounds.x(), translation.x()));
+            minBounds.setY(qMin(minBounds.y(), translation.y()));
+            minBounds.setZ(qMin(minBounds.z(), translation.z()));
+            maxBounds.setX(qMax(maxBounds.x(), translation.x()));
+            maxBounds.setY(qMax(maxBounds.y(), translation.y()));
+            maxBounds.setZ(qMax(maxBounds.z(), translation.z()));
+        }
+        visibleCount++;
+    }
+
+    m_minBounds = minBounds;
+    m_maxBounds = maxBounds;
+    if (!visibleCount)
+        return;
+
+    m_itemOrder.reserve(visibleCount);
+
+    const QVector3D extents = maxBounds - minBounds;
+    const QVector3D scaler(extents.x() > 0.0f ? 1.0f / extents.x() : 0.0f,
+                           extents.y() > 0.0f ? 1.0f / extents.y() : 0.0f,
+                           extents.z() > 0.0f ? 1.0f / extents.z() : 0.0f);
+
+    QBitArray occupiedCells;
+    int resolution = firstLevelResolution;
+    for (int level = 0; level < maxLevelCount && m_itemOrder.size() < visibleCount; level++) {
+        const float maxCell = float(resolution - 1);
+        occupiedCells.fill(false, resolution * resolution * resolution);
+        for (int pass = 0; pass < 2; pass++) {
+            // First pass marks the cells of the items picked on coarser levels, second pass
+            // picks an item for each remaining cell.
+            const int itemCount = pass ? renderArraySize : m_itemOrder.size();
+            for (int i = 0; i < itemCount; i++) {
+                const int index = pass ? i : m_itemOrder.at(i);
+                if (pass && (m_itemRanks.at(index) >= 0 || !renderArray.isVisible(index)))
+                    continue;
+                const QVector3D cellPos = (renderArray.translation(index) - minBounds) * scaler
+                        * float(resolution);
+                const int cell = int(qMin(cellPos.x(), maxCell))
+                        + int(qMin(cellPos.y(), maxCell)) * resolution
+                        + int(qMin(cellPos.z(), maxCell)) * resolution * resolution;
+                if (!pass) {
+                    occupiedCells.setBit(cell);
+                } else if (!occupiedCells.testBit(cell)) {
+                    occupiedCells.setBit(cell);
+                    m_itemRanks[index] = m_itemOrder.size();
+                    m_itemOrder.append(index);
+                }
+            }
+        }
+        m_levelCounts.append(m_itemOrder.size());
+        resolution *= 2;
+    }
+
+    for (int i = 0; i < renderArraySize; i++) {
+        if (m_itemRanks.at(i) < 0 && renderArray.isVisible(i)) {
+            m_itemRanks[i] = m_itemOrder.size();
+            m_itemOrder.append(i);
+        }
+    }
+}
+
+// Updates the order for an item whose position changed. The item keeps its rank as long as its
+// visibility does not change and it stays within the bounds of the grid, so that streamed items
+// do not need the order to be built again. The moved items no longer sample the grid cells
+// evenly, though, so the order is built again once a quarter of the items have moved.
+void ScatterLevelOfDetail::updateItem(const ScatterRenderItemArray &renderArray, int index)
+{
+    if (m_dirty)
+        return;
+
+    if (renderArray.size() != m_itemRanks.size()
+            || renderArray.isVisible(index) != (m_itemRanks.at(index) >= 0)) {
+        m_dirty = true;
+        return;
+    }
+    if (!renderArray.isVisible(index))
+        return;
+
+    const QVector3D &translation = renderArray.translation(index);
+    if (translation.x() < m_minBounds.x() || translation.x() > m_maxBounds.x()
+            || translation.y() < m_minBounds.y() || translation.y() > m_maxBounds.y()
+            || translation.z() < m_minBounds.z() || translation.z() > m_maxBounds.z()
+            || ++m_movedCount > m_itemOrder.size() / 4) {
+        m_dirty = true;
+    }
+}
+
+// Returns the number of items from the start of the item order to draw, when the whole graph
+// spans graphPixelSize pixels on screen. The count depends on the projected item density rather
+// than on the grid resolution, as dense clouds fill most of the grid cells of the fine levels.
+int ScatterLevelOfDetail::itemCount(float graphPixelSize) const
+{
+    const float maxItemCount = graphPixelSize * graphPixelSize * maxItemsPerPixel;
+    if (float(m_itemOrder.size()) <= maxItemCount || m_levelCounts.isEmpty())
+        return m_itemOrder.size();
+
+    // The coarsest level is drawn even if it is too dense, so that something is always shown
+    int itemCount = m_levelCounts.first();
+    foreach (int levelCount, m_levelCounts) {
+        if (float(levelCount) > maxItemCount)
+            break;
+        itemCount = levelCount;
+    }
+    return itemCount;
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERLEVELOFDETAIL_P_H
+#define SCATTERLEVELOFDETAIL_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "scatterrenderitem_p.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Progressive decimation of the visible items of a scatter render array. The items are ordered
+// so that each level of detail is a prefix of the order. Each level adds an item to every cell
+// of a grid over the items that does not have one yet, and the grid gets twice as fine on each
+// level. Items not included in any of the coarse levels form the full detail level.
+class QT_DATAVISUALIZATION_EXPORT ScatterLevelOfDetail
+{
+public:
+    ScatterLevelOfDetail();
+    ~ScatterLevelOfDetail();
+
+    inline void setDirty() { m_dirty = true; }
+    inline bool isDirty() const { return m_dirty; }
+
+    void build(const ScatterRenderItemArray &renderArray);
+    void updateItem(const ScatterRenderItemArray &renderArray, int index);
+    int itemCount(float graphPixelSize) const;
+
+    inline const QVector<int> &itemOrder() const { return m_itemOrder; }
+    inline int itemRank(int index) const { return m_itemRanks.at(index); }
+
+private:
+    QVector<int> m_itemOrder;
+    QVector<int> m_itemRanks; // Position of each item in the order, -1 for hidden items
+    QVector<int> m_levelCounts; // Item count of each coarse level
+    QVector3D m_minBounds;
+    QVector3D m_maxBounds;
+    int m_movedCount; // Items moved since the order was built
+    bool m_dirty;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
@@ -120,21 +120,22 @@ void ScatterObjectBufferHelper::fullLoad(ScatterSeriesRenderCache *cache, qreal
     cache->bufferIndices().resize(renderArraySize);
 
     for (uint i = 0; i < renderArraySize; i++) {
-        const ScatterRenderItem &item = renderArray.at(i);
-        if (!item.isVisible())
+        if (!renderArray.isVisible(i))
             continue;
         else
             cache->bufferIndices()[i] = itemCount;
 
+        const QVector3D &translation = renderArray.translation(i);
+        const QQuaternion &rotation = renderArray.rotation(i);
         int offset = itemCount * verticeCount;
-        if (item.rotation().isIdentity()) {
+        if (rotation.isIdentity()) {
             for (int j = 0; j < verticeCount; j++) {
-                buffered_vertices[j + offset] = scaled_vertices[j] + item.translation();
+                buffered_vertices[j + offset] = scaled_vertices[j] + translation;
                 buffered_normals[j + offset] = indexed_normals[j];
             }
         } else {
             QMatrix4x4 matrix;
-            QQuaternion totalRotation = seriesRotation * item.rotation();
+            QQuaternion totalRotation = seriesRotation * rotation;
             matrix.rotate(totalRotation);
             matrix.scale(modelScaler);
             QMatrix4x4 itModelMatrix = matrix.inverted();
@@ -142,7 +143,7 @@ void ScatterObjectBufferHelper::fullLoad(ScatterSeriesRenderCache *cache, qreal
 
             for (int j = 0; j < verticeCount; j++) {
                 buffered_vertices[j + offset] = indexed_vertices[j] * modelMatrix
-                        + item.translation();
+                        + translation;
                 buffered_normals[j + offset] = indexed_normals[j] * itModelMatrix;
             }
         }
@@ -218,15 +219,14 @@ void ScatterObjectBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
     glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
     int itemSize = uvsCount * sizeof(QVector2D);
     if (cache->updateIndices().size()) {
-        int pos = 0;
+        QVector<int> bufferPositions;
+        bufferPositions.reserve(updateSize);
         for (int i = 0; i < updateSize; i++) {
             int index = cache->updateIndices().at(i);
-            if (renderArray.at(index).isVisible()) {
-                int dataPos = cache->bufferIndices().at(index);
-                glBufferSubData(GL_ARRAY_BUFFER, itemSize * dataPos, itemSize,
-                                &buffered_uvs.at(uvsCount * pos++));
-            }
+            if (renderArray.isVisible(index))
+                bufferPositions.append(cache->bufferIndices().at(index));
         }
+        updateBufferSpans(bufferPositions, itemSize, buffered_uvs.constData());
     } else {
         glBufferData(GL_ARRAY_BUFFER, itemSize * itemCount, &buffered_uvs.at(0), GL_STATIC_DRAW);
     }
@@ -249,11 +249,10 @@ uint ScatterObjectBufferHelper::createRangeGradientUVs(ScatterSeriesRenderCache
     uint pos = 0;
     for (int i = 0; i < updateSize; i++) {
         int index = updateAll ? i : cache->updateIndices().at(i);
-        const ScatterRenderItem &item = renderArray.at(index);
-        if (!item.isVisible())
+        if (!renderArray.isVisible(index))
             continue;
 
-        float y = ((item.translation().y() + m_scaleY) * 0.5f) / m_scaleY;
+        float y = renderArray.gradientPosition(index, m_scaleY);
 
         // Avoid values near gradient texel boundary, as this causes artifacts
         // with some graphics cards.
@@ -288,8 +287,7 @@ uint ScatterObjectBufferHelper::createObjectGradientUVs(ScatterSeriesRenderCache
     uv.setX(0.0f);
     uint pos = 0;
     for (uint i = 0; i < renderArraySize; i++) {
-        const ScatterRenderItem &item = renderArray.at(i);
-        if (!item.isVisible())
+        if (!renderArray.isVisible(i))
             continue;
 
         int offset = pos * uvsCount;
@@ -342,23 +340,24 @@ void ScatterObjectBufferHelper::update(ScatterSeriesRenderCache *cache, qreal do
     int itemCount = 0;
     for (int i = 0; i < updateSize; i++) {
         int index = updateAll ? i : cache->updateIndices().at(i);
-        const ScatterRenderItem &item = renderArray.at(index);
-        if (!item.isVisible())
+        if (!renderArray.isVisible(index))
             continue;
 
+        const QVector3D &translation = renderArray.translation(index);
+        const QQuaternion &rotation = renderArray.rotation(index);
         const int offset = itemCount * verticeCount;
-        if (item.rotation().isIdentity()) {
+        if (rotation.isIdentity()) {
             for (int j = 0; j < verticeCount; j++)
-                buffered_vertices[j + offset] = scaled_vertices[j] + item.translation();
+                buffered_vertices[j + offset] = scaled_vertices[j] + translation;
         } else {
             QMatrix4x4 matrix;
-            matrix.rotate(seriesRotation * item.rotation());
+            matrix.rotate(seriesRotation * rotation);
             modelMatrix = matrix.transposed();
             modelMatrix.scale(modelScaler);
 
             for (int j = 0; j < verticeCount; j++)
                 buffered_vertices[j + offset] = indexed_vertices[j] * modelMatrix
-                        + item.translation();
+                        + translation;
         }
         itemCount++;
     }
@@ -371,15 +370,15 @@ void ScatterObjectBufferHelper::update(ScatterSeriesRenderCache *cache, qreal do
                          &buffered_vertices.at(0), GL_STATIC_DRAW);
         }
     } else {
-        itemCount = 0;
+        // Changed items that are adjacent in the buffer are uploaded together
+        QVector<int> bufferPositions;
+        bufferPositions.reserve(itemCount);
         for (int i = 0; i < updateSize; i++) {
-            int index = updateAll ? i : cache->updateIndices().at(i);
-            if (renderArray.at(index).isVisible()) {
-                glBufferSubData(GL_ARRAY_BUFFER, cache->bufferIndices().at(index) * sizeOfItem,
-                                sizeOfItem, &buffered_vertices.at(itemCount * verticeCount));
-                itemCount++;
-            }
+            int index = cache->updateIndices().at(i);
+            if (renderArray.isVisible(index))
+                bufferPositions.append(cache->bufferIndices().at(index));
         }
+        updateBufferSpans(bufferPositions, sizeOfItem, buffered_vertices.constData());
     }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -102,12 +102,11 @@ void ScatterPointBufferHelper::load(ScatterSeriesRenderCache *cache)
     bool itemsVisible = false;
     m_bufferedPoints.resize(renderArraySize);
     for (int i = 0; i < renderArraySize; i++) {
-        const ScatterRenderItem &item = renderArray.at(i);
-        if (!item.isVisible()) {
+        if (!renderArray.isVisible(i)) {
             m_bufferedPoints[i] = hiddenPos;
         } else {
             itemsVisible = true;
-            m_bufferedPoints[i] = item.translation();
+            m_bufferedPoints[i] = renderArray.translation(i);
         }
     }
 
@@ -146,19 +145,24 @@ void ScatterPointBufferHelper::update(ScatterSeriesRenderCache *cache)
         const ScatterRenderItemArray &renderArray = cache->renderArray();
         const int updateSize = cache->updateIndices().size();
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
+        bool removedPointUpdated = false;
         for (int i = 0; i < updateSize; i++) {
             int index = cache->updateIndices().at(i);
-            const ScatterRenderItem &item = renderArray.at(index);
-            if (!item.isVisible())
+            if (!renderArray.isVisible(index))
                 m_bufferedPoints[index] = hiddenPos;
             else
-                m_bufferedPoints[index] = item.translation();
+                m_bufferedPoints[index] = renderArray.translation(index);
+            if (index == m_oldRemoveIndex)
+                removedPointUpdated = true;
+        }
 
-            if (index != m_oldRemoveIndex) {
-                glBufferSubData(GL_ARRAY_BUFFER, index * sizeof(QVector3D),
-                                sizeof(QVector3D), &m_bufferedPoints.at(index));
-            }
+        glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
+        updateBufferSpans(cache->updateIndices(), sizeof(QVector3D), m_bufferedPoints.constData(),
+                          true);
+        // Keep the removed point hidden even if it was included in an uploaded span
+        if (removedPointUpdated) {
+            glBufferSubData(GL_ARRAY_BUFFER, m_oldRemoveIndex * sizeof(QVector3D),
+                            sizeof(QVector3D), &hiddenPos);
         }
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
@@ -179,12 +183,8 @@ void ScatterPointBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
             int updateSize = cache->updateIndices().size();
             glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
             if (updateSize) {
-                for (int i = 0; i < updateSize; i++) {
-                    int index = cache->updateIndices().at(i);
-                    glBufferSubData(GL_ARRAY_BUFFER, index * sizeof(QVector2D),
-                                    sizeof(QVector2D), &buffered_uvs.at(i));
-
-                }
+                updateBufferSpans(cache->updateIndices(), sizeof(QVector2D),
+                                  buffered_uvs.constData());
             } else {
                 glBufferData(GL_ARRAY_BUFFER, buffered_uvs.size() * sizeof(QVector2D),
                              &buffered_uvs.at(0), GL_STATIC_DRAW);
@@ -195,6 +195,21 @@ void ScatterPointBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
     }
 }
 
+void ScatterPointBufferHelper::loadLevelOfDetail(const QVector<int> &itemOrder)
+{
+    // Level of detail subsets are prefixes of the item order, so a single element buffer
+    // serves all levels.
+    if (m_indexCount > 0 && itemOrder.size()) {
+        if (!m_elementbuffer)
+            glGenBuffers(1, &m_elementbuffer);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, itemOrder.size() * sizeof(GLuint),
+                     itemOrder.constData(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+}
+
 void ScatterPointBufferHelper::createRangeGradientUVs(ScatterSeriesRenderCache *cache,
                                                       QVector<QVector2D> &buffered_uvs)
 {
@@ -207,9 +222,7 @@ void ScatterPointBufferHelper::createRangeGradientUVs(ScatterSeriesRenderCache *
     uv.setX(0.0f);
     for (int i = 0; i < updateSize; i++) {
         int index = updateAll ? i : cache->updateIndices().at(i);
-        const ScatterRenderItem &item = renderArray.at(index);
-
-        float y = ((item.translation().y() + m_scaleY) * 0.5f) / m_scaleY;
+        float y = renderArray.gradientPosition(index, m_scaleY);
         uv.setY(y);
         buffered_uvs[i] = uv;
     }
@@ -60,6 +60,7 @@ public:
     void update(ScatterSeriesRenderCache *cache);
     void setScaleY(float scale) { m_scaleY = scale; }
     void updateUVs(ScatterSeriesRenderCache *cache);
+    void loadLevelOfDetail(const QVector<int> &itemOrder);
 
 public:
     GLuint m_pointbuffer;
@@ -55,6 +55,10 @@ ShaderHelper::ShaderHelper(QObject *parent,
       m_positionAttr(0),
       m_uvAttr(0),
       m_normalAttr(0),
+      m_instancePositionAttr(0),
+      m_instanceRotationAttr(0),
+      m_instanceUVAttr(0),
+      m_instanceIndexAttr(0),
       m_colorUniform(0),
       m_viewMatrixUniform(0),
       m_modelMatrixUniform(0),
@@ -81,6 +85,14 @@ ShaderHelper::ShaderHelper(QObject *parent,
       m_minBoundsUniform(0),
       m_maxBoundsUniform(0),
       m_sliceFrameWidthUniform(0),
+      m_heightFieldUniform(0),
+      m_gridSizeUniform(0),
+      m_gridOriginUniform(0),
+      m_gridStepUniform(0),
+      m_gridNeighborUniform(0),
+      m_uvRectUniform(0),
+      m_heightRowOffsetUniform(0),
+      m_barScaleUniform(0),
       m_initialized(false)
 {
 }
@@ -118,6 +130,10 @@ void ShaderHelper::initialize()
     m_positionAttr = m_program->attributeLocation("vertexPosition_mdl");
     m_normalAttr = m_program->attributeLocation("vertexNormal_mdl");
     m_uvAttr = m_program->attributeLocation("vertexUV");
+    m_instancePositionAttr = m_program->attributeLocation("instancePosition_wrld");
+    m_instanceRotationAttr = m_program->attributeLocation("instanceRotation");
+    m_instanceUVAttr = m_program->attributeLocation("instanceUV");
+    m_instanceIndexAttr = m_program->attributeLocation("instanceIndex");
 
     m_mvpMatrixUniform = m_program->uniformLocation("MVP");
     m_viewMatrixUniform = m_program->uniformLocation("V");
@@ -145,6 +161,14 @@ void ShaderHelper::initialize()
     m_minBoundsUniform = m_program->uniformLocation("minBounds");
     m_maxBoundsUniform = m_program->uniformLocation("maxBounds");
     m_sliceFrameWidthUniform = m_program->uniformLocation("sliceFrameWidth");
+    m_heightFieldUniform = m_program->uniformLocation("heightSampler");
+    m_gridSizeUniform = m_program->uniformLocation("gridSize");
+    m_gridOriginUniform = m_program->uniformLocation("gridOrigin");
+    m_gridStepUniform = m_program->uniformLocation("gridStep");
+    m_gridNeighborUniform = m_program->uniformLocation("gridNeighbor");
+    m_uvRectUniform = m_program->uniformLocation("uvRect");
+    m_heightRowOffsetUniform = m_program->uniformLocation("heightRowOffset");
+    m_barScaleUniform = m_program->uniformLocation("barScale");
     m_initialized = true;
 }
 
@@ -395,6 +419,62 @@ GLint ShaderHelper::sliceFrameWidth()
     return m_sliceFrameWidthUniform;
 }
 
+GLint ShaderHelper::heightField()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_heightFieldUniform;
+}
+
+GLint ShaderHelper::gridSize()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_gridSizeUniform;
+}
+
+GLint ShaderHelper::gridOrigin()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_gridOriginUniform;
+}
+
+GLint ShaderHelper::gridStep()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_gridStepUniform;
+}
+
+GLint ShaderHelper::gridNeighbor()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_gridNeighborUniform;
+}
+
+GLint ShaderHelper::uvRect()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_uvRectUniform;
+}
+
+GLint ShaderHelper::heightRowOffset()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_heightRowOffsetUniform;
+}
+
+GLint ShaderHelper::barScale()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_barScaleUniform;
+}
+
 GLint ShaderHelper::posAtt()
 {
     if (!m_initialized)
@@ -416,4 +496,32 @@ GLint ShaderHelper::normalAtt()
     return m_normalAttr;
 }
 
+GLint ShaderHelper::instancePosAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instancePositionAttr;
+}
+
+GLint ShaderHelper::instanceRotAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instanceRotationAttr;
+}
+
+GLint ShaderHelper::instanceUVAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instanceUVAttr;
+}
+
+GLint ShaderHelper::instanceIndexAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instanceIndexAttr;
+}
+
 QT_END_NAMESPACE_DATAVISUALIZATION
@@ -97,10 +97,22 @@ class ShaderHelper
     GLint maxBounds();
     GLint minBounds();
     GLint sliceFrameWidth();
+    GLint heightField();
+    GLint gridSize();
+    GLint gridOrigin();
+    GLint gridStep();
+    GLint gridNeighbor();
+    GLint uvRect();
+    GLint heightRowOffset();
+    GLint barScale();
 
     GLint posAtt();
     GLint uvAtt();
     GLint normalAtt();
+    GLint instancePosAtt();
+    GLint instanceRotAtt();
+    GLint instanceUVAtt();
+    GLint instanceIndexAtt();
 
     private:
     QObject *m_caller;
@@ -115,6 +127,10 @@ class ShaderHelper
     GLint m_positionAttr;
     GLint m_uvAttr;
     GLint m_normalAttr;
+    GLint m_instancePositionAttr;
+    GLint m_instanceRotationAttr;
+    GLint m_instanceUVAttr;
+    GLint m_instanceIndexAttr;
 
     GLint m_colorUniform;
     GLint m_viewMatrixUniform;
@@ -142,6 +158,14 @@ class ShaderHelper
     GLint m_minBoundsUniform;
     GLint m_maxBoundsUniform;
     GLint m_sliceFrameWidthUniform;
+    GLint m_heightFieldUniform;
+    GLint m_gridSizeUniform;
+    GLint m_gridOriginUniform;
+    GLint m_gridStepUniform;
+    GLint m_gridNeighborUniform;
+    GLint m_uvRectUniform;
+    GLint m_heightRowOffsetUniform;
+    GLint m_barScaleUniform;
 
     GLboolean m_initialized;
 };
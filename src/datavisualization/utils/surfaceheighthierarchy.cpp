@@ -0,0 +1,341 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "surfaceheighthierarchy_p.h"
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+const int blockCells = 8; // Grid cells along each side of the blocks of the lowest level
+// Triangles closer to parallel with the ray than this are not intersected
+const float parallelEpsilon = 1.0e-9f;
+
+SurfaceHeightHierarchy::SurfaceHeightHierarchy()
+    : m_columns(0),
+      m_rows(0),
+      m_sameDirections(true),
+      m_dirty(true)
+{
+}
+
+SurfaceHeightHierarchy::~SurfaceHeightHierarchy()
+{
+}
+
+void SurfaceHeightHierarchy::build(const SurfaceObject &object)
+{
+    build(SurfaceObjectGrid(object));
+}
+
+void SurfaceHeightHierarchy::build(const SurfaceHeightGrid &grid)
+{
+    m_levels.clear();
+    m_dirty = false;
+
+    m_columns = grid.columns();
+    m_rows = grid.rows();
+    m_sameDirections = grid.sameDirections();
+
+    if (m_columns < 2 || m_rows < 2)
+        return;
+
+    Level level;
+    level.columns = (m_columns - 2) / blockCells + 1;
+    level.rows = (m_rows - 2) / blockCells + 1;
+    level.bounds.resize(level.columns * level.rows);
+    m_levels.append(level);
+    for (int row = 0; row < level.rows; row++) {
+        for (int column = 0; column < level.columns; column++)
+            updateBlock(grid, column, row);
+    }
+
+    // Combine 2x2 nodes of each level until a single node covers the whole surface
+    while (level.columns > 1 || level.rows > 1) {
+        level.columns = (level.columns + 1) / 2;
+        level.rows = (level.rows + 1) / 2;
+        level.bounds.resize(level.columns * level.rows);
+        m_levels.append(level);
+        const int levelIndex = m_levels.size() - 1;
+        for (int row = 0; row < level.rows; row++) {
+            for (int column = 0; column < level.columns; column++)
+                updateNode(levelIndex, column, row);
+        }
+    }
+}
+
+void SurfaceHeightHierarchy::updateRows(const SurfaceObject &object, int startRow, int endRow)
+{
+    updateRows(SurfaceObjectGrid(object), startRow, endRow);
+}
+
+// Updates the bounds of the nodes that contain the vertex rows from startRow to endRow,
+// inclusive. A hierarchy that is going to be rebuilt is left as it is.
+void SurfaceHeightHierarchy::updateRows(const SurfaceHeightGrid &grid, int startRow, int endRow)
+{
+    if (m_dirty || m_levels.isEmpty())
+        return;
+
+    // Vertices on the edge of a block belong to the blocks on both sides of the edge
+    int startBlockRow = qMax(0, startRow - 1) / blockCells;
+    int endBlockRow = qMin(endRow, m_rows - 2) / blockCells;
+    const int blockColumns = m_levels.at(0).columns;
+    for (int row = startBlockRow; row <= endBlockRow; row++) {
+        for (int column = 0; column < blockColumns; column++)
+            updateBlock(grid, column, row);
+    }
+
+    for (int level = 1; level < m_levels.size(); level++) {
+        startBlockRow /= 2;
+        endBlockRow /= 2;
+        const int columns = m_levels.at(level).columns;
+        for (int row = startBlockRow; row <= endBlockRow; row++) {
+            for (int column = 0; column < columns; column++)
+                updateNode(level, column, row);
+        }
+    }
+}
+
+bool SurfaceHeightHierarchy::intersect(const SurfaceObject &object, const QVector3D &rayOrigin,
+                                       const QVector3D &rayDirection, float &distance,
+                                       QPoint &point) const
+{
+    return intersect(SurfaceObjectGrid(object), rayOrigin, rayDirection, distance, point);
+}
+
+// Finds the nearest intersection of the ray with the surface that is closer than the given
+// distance. On a hit, the distance is updated and the point is set to the column and row of the
+// grid vertex nearest to the intersection.
+bool SurfaceHeightHierarchy::intersect(const SurfaceHeightGrid &grid, const QVector3D &rayOrigin,
+                                       const QVector3D &rayDirection, float &distance,
+                                       QPoint &point) const
+{
+    if (m_levels.isEmpty())
+        return false;
+
+    Ray ray;
+    ray.origin = rayOrigin;
+    ray.direction = rayDirection;
+    ray.inverseDirection = QVector3D(1.0f / rayDirection.x(), 1.0f / rayDirection.y(),
+                                     1.0f / rayDirection.z());
+
+    const float startDistance = distance;
+    intersectNode(grid, ray, m_levels.size() - 1, 0, 0, distance, point);
+    return distance < startDistance;
+}
+
+void SurfaceHeightHierarchy::updateBlock(const SurfaceHeightGrid &grid, int blockColumn,
+                                         int blockRow)
+{
+    const int startColumn = blockColumn * blockCells;
+    const int startRow = blockRow * blockCells;
+    const int endColumn = qMin(startColumn + blockCells, m_columns - 1);
+    const int endRow = qMin(startRow + blockCells, m_rows - 1);
+
+    Bounds &bounds = m_levels[0].bounds[blockRow * m_levels.at(0).columns + blockColumn];
+    bounds.minBounds = grid.gridPosition(startColumn, startRow);
+    bounds.maxBounds = bounds.minBounds;
+    for (int row = startRow; row <= endRow; row++) {
+        for (int column = startColumn; column <= endColumn; column++) {
+            const QVector3D position = grid.gridPosition(column, row);
+            bounds.minBounds.setX(qMin(bounds.minBounds.x(), position.x()));
+            bounds.minBounds.setY(qMin(bounds.minBounds.y(), position.y()));
+            bounds.minBounds.setZ(qMin(bounds.minBounds.z(), position.z()));
+            bounds.maxBounds.setX(qMax(bounds.maxBounds.x(), position.x()));
+            bounds.maxBounds.setY(qMax(bounds.maxBounds.y(), position.y()));
+            bounds.maxBounds.setZ(qMax(bounds.maxBounds.z(), position.z()));
+        }
+    }
+}
+
+void SurfaceHeightHierarchy::updateNode(int level, int column, int row)
+{
+    const Level &children = m_levels.at(level - 1);
+    const int endColumn = qMin(column * 2 + 2, children.columns);
+    const int endRow = qMin(row * 2 + 2, children.rows);
+
+    Bounds &bounds = m_levels[level].bounds[row * m_levels.at(level).columns + column];
+    bounds = children.bounds.at(row * 2 * children.columns + column * 2);
+    for (int childRow = row * 2; childRow < endRow; childRow++) {
+        for (int childColumn = column * 2; childColumn < endColumn; childColumn++) {
+            const Bounds &child = children.bounds.at(childRow * children.columns + childColumn);
+            bounds.minBounds.setX(qMin(bounds.minBounds.x(), child.minBounds.x()));
+            bounds.minBounds.setY(qMin(bounds.minBounds.y(), child.minBounds.y()));
+            bounds.minBounds.setZ(qMin(bounds.minBounds.z(), child.minBounds.z()));
+            bounds.maxBounds.setX(qMax(bounds.maxBounds.x(), child.maxBounds.x()));
+            bounds.maxBounds.setY(qMax(bounds.maxBounds.y(), child.maxBounds.y()));
+            bounds.maxBounds.setZ(qMax(bounds.maxBounds.z(), child.maxBounds.z()));
+        }
+    }
+}
+
+void SurfaceHeightHierarchy::intersectNode(const SurfaceHeightGrid &grid, const Ray &ray,
+                                           int level, int column, int row, float &distance,
+                                           QPoint &point) const
+{
+    float entry;
+    const Level &nodeLevel = m_levels.at(level);
+    if (!intersectBounds(ray, nodeLevel.bounds.at(row * nodeLevel.columns + column), entry)
+            || entry > distance) {
+        return;
+    }
+
+    if (level == 0) {
+        const int startColumn = column * blockCells;
+        const int startRow = row * blockCells;
+        const int endColumn = qMin(startColumn + blockCells, m_columns - 1);
+        const int endRow = qMin(startRow + blockCells, m_rows - 1);
+        for (int cellRow = startRow; cellRow < endRow; cellRow++) {
+            for (int cellColumn = startColumn; cellColumn < endColumn; cellColumn++)
+                intersectCell(grid, ray, cellColumn, cellRow, distance, point);
+        }
+        return;
+    }
+
+    // Visit the children nearest first, so that the farther ones are likely to be
+    // rejected by their bounds
+    const Level &children = m_levels.at(level - 1);
+    const int endColumn = qMin(column * 2 + 2, children.columns);
+    const int endRow = qMin(row * 2 + 2, children.rows);
+    float childEntries[4];
+    QPoint childNodes[4];
+    int childCount = 0;
+    for (int childRow = row * 2; childRow < endRow; childRow++) {
+        for (int childColumn = column * 2; childColumn < endColumn; childColumn++) {
+            float childEntry;
+            if (!intersectBounds(ray, children.bounds.at(childRow * children.columns
+                                                         + childColumn), childEntry)) {
+                continue;
+            }
+            int i = childCount++;
+            for (; i > 0 && childEntries[i - 1] > childEntry; i--) {
+                childEntries[i] = childEntries[i - 1];
+                childNodes[i] = childNodes[i - 1];
+            }
+            childEntries[i] = childEntry;
+            childNodes[i] = QPoint(childColumn, childRow);
+        }
+    }
+
+    for (int i = 0; i < childCount; i++) {
+        if (childEntries[i] > distance)
+            break;
+        intersectNode(grid, ray, level - 1, childNodes[i].x(), childNodes[i].y(), distance,
+                      point);
+    }
+}
+
+// Intersects the ray with the two triangles of a grid cell, split along the same diagonal as
+// the drawn surface. Both sides of the triangles are hit, as surfaces are drawn without culling.
+void SurfaceHeightHierarchy::intersectCell(const SurfaceHeightGrid &grid, const Ray &ray,
+                                           int column, int row, float &distance,
+                                           QPoint &point) const
+{
+    const QPoint cornerA(column, row);
+    const QPoint cornerB(column + 1, row);
+    const QPoint cornerC(column, row + 1);
+    const QPoint cornerD(column + 1, row + 1);
+    QPoint triangles[2][3];
+    if (m_sameDirections) {
+        triangles[0][0] = cornerB;
+        triangles[0][1] = cornerC;
+        triangles[0][2] = cornerA;
+        triangles[1][0] = cornerD;
+        triangles[1][1] = cornerC;
+        triangles[1][2] = cornerB;
+    } else {
+        triangles[0][0] = cornerC;
+        triangles[0][1] = cornerD;
+        triangles[0][2] = cornerA;
+        triangles[1][0] = cornerA;
+        triangles[1][1] = cornerD;
+        triangles[1][2] = cornerB;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        const QPoint *corners = triangles[i];
+        const QVector3D v0 = grid.gridPosition(corners[0].x(), corners[0].y());
+        const QVector3D edge1 = grid.gridPosition(corners[1].x(), corners[1].y()) - v0;
+        const QVector3D edge2 = grid.gridPosition(corners[2].x(), corners[2].y()) - v0;
+
+        const QVector3D p = QVector3D::crossProduct(ray.direction, edge2);
+        const float determinant = QVector3D::dotProduct(edge1, p);
+        if (qAbs(determinant) < parallelEpsilon)
+            continue;
+        const float inverseDeterminant = 1.0f / determinant;
+
+        const QVector3D s = ray.origin - v0;
+        const float u = QVector3D::dotProduct(s, p) * inverseDeterminant;
+        if (u < 0.0f || u > 1.0f)
+            continue;
+        const QVector3D q = QVector3D::crossProduct(s, edge1);
+        const float v = QVector3D::dotProduct(ray.direction, q) * inverseDeterminant;
+        if (v < 0.0f || u + v > 1.0f)
+            continue;
+        const float t = QVector3D::dotProduct(edge2, q) * inverseDeterminant;
+        if (t < 0.0f || t >= distance)
+            continue;
+
+        // Pick the grid vertex nearest to the hit, like the quadrants of the selection ID
+        // texture do
+        const float w = 1.0f - u - v;
+        const float gridColumn = w * corners[0].x() + u * corners[1].x() + v * corners[2].x();
+        const float gridRow = w * corners[0].y() + u * corners[1].y() + v * corners[2].y();
+        distance = t;
+        point = QPoint(qRound(gridColumn), qRound(gridRow));
+    }
+}
+
+// Slab test of the ray against the bounds. Entry is the distance along the ray where it enters
+// the bounds, or zero if the ray starts inside them.
+bool SurfaceHeightHierarchy::intersectBounds(const Ray &ray, const Bounds &bounds, float &entry)
+{
+    float nearDistance = 0.0f;
+    float farDistance = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; axis++) {
+        const float origin = ray.origin[axis];
+        if (ray.direction[axis] == 0.0f) {
+            if (origin < bounds.minBounds[axis] || origin > bounds.maxBounds[axis])
+                return false;
+            continue;
+        }
+        float t0 = (bounds.minBounds[axis] - origin) * ray.inverseDirection[axis];
+        float t1 = (bounds.maxBounds[axis] - origin) * ray.inverseDirection[axis];
+        if (t0 > t1)
+            qSwap(t0, t1);
+        nearDistance = qMax(nearDistance, t0);
+        farDistance = qMin(farDistance, t1);
+        if (nearDistance > farDistance)
+            return false;
+    }
+    entry = nearDistance;
+    return true;
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SURFACEHEIGHTHIERARCHY_P_H
+#define SURFACEHEIGHTHIERARCHY_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "surfaceobject_p.h"
+
+#include <QtCore/QPoint>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Vertex grid that a height hierarchy is built over. Surface objects are accessed through this,
+// so that the hierarchy does not depend on how their vertices are stored.
+class QT_DATAVISUALIZATION_EXPORT SurfaceHeightGrid
+{
+public:
+    virtual ~SurfaceHeightGrid() {}
+
+    virtual int columns() const = 0;
+    virtual int rows() const = 0;
+    // True if the cells are split along the diagonal from (column + 1, row) to
+    // (column, row + 1), and false if from (column, row) to (column + 1, row + 1)
+    virtual bool sameDirections() const = 0;
+    virtual QVector3D gridPosition(int column, int row) const = 0;
+};
+
+// Vertex grid of a surface object
+class SurfaceObjectGrid : public SurfaceHeightGrid
+{
+public:
+    explicit SurfaceObjectGrid(const SurfaceObject &object)
+        : m_object(object)
+    {
+    }
+
+    // Surfaces that have not been set up have no grid
+    int columns() const
+    {
+        if (m_object.surfaceType() == SurfaceObject::Undefined)
+            return 0;
+        return int(m_object.gridSize().x());
+    }
+    int rows() const
+    {
+        if (m_object.surfaceType() == SurfaceObject::Undefined)
+            return 0;
+        return int(m_object.gridSize().y());
+    }
+    bool sameDirections() const
+    {
+        return m_object.dataDimension() == SurfaceObject::BothAscending
+                || m_object.dataDimension() == SurfaceObject::BothDescending;
+    }
+    QVector3D gridPosition(int column, int row) const
+    {
+        return m_object.gridPosition(column, row);
+    }
+
+private:
+    const SurfaceObject &m_object;
+};
+
+// Hierarchy of bounds over the grid cells of a surface, used to intersect rays with the surface
+// without testing every triangle. The lowest level holds the bounds of blocks of cells, and each
+// level above combines 2x2 nodes of the level below. The bounds hold the minimum and maximum
+// heights of the nodes, as well as their extents on the other axes, so that polar surfaces are
+// handled too.
+class QT_DATAVISUALIZATION_EXPORT SurfaceHeightHierarchy
+{
+public:
+    SurfaceHeightHierarchy();
+    ~SurfaceHeightHierarchy();
+
+    inline void setDirty() { m_dirty = true; }
+    inline bool isDirty() const { return m_dirty; }
+
+    void build(const SurfaceObject &object);
+    void build(const SurfaceHeightGrid &grid);
+    void updateRows(const SurfaceObject &object, int startRow, int endRow);
+    void updateRows(const SurfaceHeightGrid &grid, int startRow, int endRow);
+    bool intersect(const SurfaceObject &object, const QVector3D &rayOrigin,
+                   const QVector3D &rayDirection, float &distance, QPoint &point) const;
+    bool intersect(const SurfaceHeightGrid &grid, const QVector3D &rayOrigin,
+                   const QVector3D &rayDirection, float &distance, QPoint &point) const;
+
+private:
+    struct Bounds {
+        QVector3D minBounds;
+        QVector3D maxBounds;
+    };
+
+    struct Level {
+        int columns;
+        int rows;
+        QVector<Bounds> bounds;
+    };
+
+    struct Ray {
+        QVector3D origin;
+        QVector3D direction;
+        QVector3D inverseDirection;
+    };
+
+    void updateBlock(const SurfaceHeightGrid &grid, int blockColumn, int blockRow);
+    void updateNode(int level, int column, int row);
+    void intersectNode(const SurfaceHeightGrid &grid, const Ray &ray, int level, int column,
+                       int row, float &distance, QPoint &point) const;
+    void intersectCell(const SurfaceHeightGrid &grid, const Ray &ray, int column, int row,
+                       float &distance, QPoint &point) const;
+    static bool intersectBounds(const Ray &ray, const Bounds &bounds, float &entry);
+
+    QVector<Level> m_levels;
+    int m_columns;
+    int m_rows;
+    bool m_sameDirections; // Cells are split along the same diagonal as the drawn triangles
+    bool m_dirty;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
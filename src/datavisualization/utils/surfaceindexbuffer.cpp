@@ -0,0 +1,194 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "surfaceindexbuffer_p.h"
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+typedef QHash<SurfaceIndexBuffer::Key, SurfaceIndexBuffer *> IndexBufferTable;
+
+// The "Abstract3DRenderer *" key identifies the renderer, as the buffers belong to its context
+static QHash<const Abstract3DRenderer *, IndexBufferTable *> cacheTable;
+
+SurfaceIndexBuffer::SurfaceIndexBuffer()
+    : m_buffer(0),
+      m_indexCount(0),
+      m_indexType(GL_UNSIGNED_INT),
+      m_primitiveMode(GL_TRIANGLES),
+      m_refCount(0)
+{
+    initializeOpenGLFunctions();
+    glGenBuffers(1, &m_buffer);
+}
+
+SurfaceIndexBuffer::~SurfaceIndexBuffer()
+{
+    if (QOpenGLContext::currentContext())
+        glDeleteBuffers(1, &m_buffer);
+}
+
+// Returns the shared buffer for the key, creating an empty one if no surface of the renderer
+// uses it yet. The caller uploads the indices to an empty buffer.
+SurfaceIndexBuffer *SurfaceIndexBuffer::getIndexBuffer(const Abstract3DRenderer *cacheId,
+                                                       const Key &key)
+{
+    Q_ASSERT(cacheId);
+
+    IndexBufferTable *bufferTable = cacheTable.value(cacheId, 0);
+    if (!bufferTable) {
+        bufferTable = new IndexBufferTable;
+        cacheTable.insert(cacheId, bufferTable);
+    }
+
+    SurfaceIndexBuffer *buffer = bufferTable->value(key, 0);
+    if (!buffer) {
+        buffer = new SurfaceIndexBuffer;
+        buffer->m_key = key;
+        bufferTable->insert(key, buffer);
+    }
+    buffer->m_refCount++;
+    return buffer;
+}
+
+void SurfaceIndexBuffer::releaseIndexBuffer(const Abstract3DRenderer *cacheId,
+                                            SurfaceIndexBuffer *&buffer)
+{
+    Q_ASSERT(cacheId);
+
+    if (buffer) {
+        IndexBufferTable *bufferTable = cacheTable.value(cacheId, 0);
+        if (bufferTable) {
+            // Delete the buffer if the last reference is released
+            buffer->m_refCount--;
+            if (buffer->m_refCount <= 0) {
+                bufferTable->remove(buffer->m_key);
+                delete buffer;
+            }
+            if (bufferTable->isEmpty()) {
+                // Remove the entire cache if the last buffer was removed
+                cacheTable.remove(cacheId);
+                delete bufferTable;
+            }
+        } else {
+            // Just delete the buffer if unknown cache
+            delete buffer;
+        }
+        buffer = 0;
+    }
+}
+
+// Creates the indices of the quads from column x to endX and from row y to endY of a grid of
+// vertices with the given number of columns. With lowerRowFirst the quads are split along the
+// diagonal from the upper row to the next vertex of the lower row, otherwise along the other
+// diagonal. Triangle lists take six indices per quad. Triangle strips take two, as each row of
+// quads is a strip, and the strips are separated by restart indices.
+QVector<GLint> SurfaceIndexBuffer::createSmoothIndices(int columns, int x, int y, int endX,
+                                                       int endY, bool lowerRowFirst,
+                                                       GLenum primitiveMode)
+{
+    QVector<GLint> indices;
+    if (endX <= x || endY <= y)
+        return indices;
+
+    const int rowEnd = endY * columns;
+    if (primitiveMode == GL_TRIANGLE_STRIP) {
+        const int stripLength = 2 * (endX - x + 1);
+        indices.reserve((stripLength + 1) * (endY - y) - 1);
+        for (int row = y * columns; row < rowEnd; row += columns) {
+            if (!indices.isEmpty())
+                indices.append(GLint(restartIndex)); // A copy, as the constant has no definition
+            const int firstRow = lowerRowFirst ? row : row + columns;
+            const int secondRow = lowerRowFirst ? row + columns : row;
+            for (int j = x; j <= endX; j++) {
+                indices.append(firstRow + j);
+                indices.append(secondRow + j);
+            }
+        }
+        return indices;
+    }
+
+    indices.resize(6 * (endX - x) * (endY - y));
+    GLint *data = indices.data();
+    int p = 0;
+    for (int row = y * columns; row < rowEnd; row += columns) {
+        for (int j = x; j < endX; j++) {
+            if (lowerRowFirst) {
+                // Left triangle
+                data[p++] = row + j + 1;
+                data[p++] = row + columns + j;
+                data[p++] = row + j;
+
+                // Right triangle
+                data[p++] = row + columns + j + 1;
+                data[p++] = row + columns + j;
+                data[p++] = row + j + 1;
+            } else {
+                // Left triangle
+                data[p++] = row + columns + j;
+                data[p++] = row + columns + j + 1;
+                data[p++] = row + j;
+
+                // Right triangle
+                data[p++] = row + j;
+                data[p++] = row + columns + j + 1;
+                data[p++] = row + j + 1;
+            }
+        }
+    }
+    return indices;
+}
+
+// Uploads the indices of a surface with the given number of vertices. The indices of surfaces
+// that have fewer vertices than the restart index of unsigned shorts are stored as unsigned
+// shorts, which halves the size of the buffer.
+void SurfaceIndexBuffer::upload(const GLint *indices, GLuint indexCount, int vertexCount,
+                                GLenum primitiveMode, GLenum usage)
+{
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffer);
+    if (vertexCount < std::numeric_limits<GLushort>::max()) {
+        // Converting also turns the restart index into the largest unsigned short
+        QVector<GLushort> shortIndices(indexCount);
+        for (GLuint i = 0; i < indexCount; i++)
+            shortIndices[i] = GLushort(indices[i]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(GLushort),
+                     shortIndices.constData(), usage);
+        m_indexType = GL_UNSIGNED_SHORT;
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(GLint), indices, usage);
+        m_indexType = GL_UNSIGNED_INT;
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    m_indexCount = indexCount;
+    m_primitiveMode = primitiveMode;
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SURFACEINDEXBUFFER_P_H
+#define SURFACEINDEXBUFFER_P_H
+
+#include "datavisualizationglobal_p.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+#ifndef GL_PRIMITIVE_RESTART_FIXED_INDEX
+#define GL_PRIMITIVE_RESTART_FIXED_INDEX 0x8D69
+#endif
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+class Abstract3DRenderer;
+
+// Element buffer of surface indices. The indices only depend on the size of the grid, the type
+// of the indices and the directions of the data, so surfaces of a renderer with the same grid
+// share a single buffer, which stays alive as long as any of them uses it. Buffers that are not
+// shared, such as the indices of the level of detail tiles, are created directly.
+class QT_DATAVISUALIZATION_EXPORT SurfaceIndexBuffer : protected QOpenGLFunctions
+{
+public:
+    enum IndexType {
+        SmoothTriangles,
+        CoarseTriangles,
+        SmoothGridLines,
+        CoarseGridLines
+    };
+
+    struct Key {
+        IndexType type;
+        int columns;
+        int rows;
+        int dataDimension;
+    };
+
+    // Index that restarts a triangle strip. It is stored as the largest value of the index type.
+    static const GLint restartIndex = -1;
+
+    SurfaceIndexBuffer();
+    ~SurfaceIndexBuffer();
+
+    static SurfaceIndexBuffer *getIndexBuffer(const Abstract3DRenderer *cacheId, const Key &key);
+    static void releaseIndexBuffer(const Abstract3DRenderer *cacheId, SurfaceIndexBuffer *&buffer);
+
+    static QVector<GLint> createSmoothIndices(int columns, int x, int y, int endX, int endY,
+                                              bool lowerRowFirst, GLenum primitiveMode);
+
+    void upload(const GLint *indices, GLuint indexCount, int vertexCount,
+                GLenum primitiveMode = GL_TRIANGLES, GLenum usage = GL_STATIC_DRAW);
+
+    inline GLuint buffer() const { return m_buffer; }
+    inline GLuint indexCount() const { return m_indexCount; }
+    inline GLenum indexType() const { return m_indexType; }
+    inline GLenum primitiveMode() const { return m_primitiveMode; }
+
+private:
+    Key m_key; // Only set for shared buffers
+    GLuint m_buffer;
+    GLuint m_indexCount; // Zero until the indices are uploaded
+    GLenum m_indexType;
+    GLenum m_primitiveMode;
+    int m_refCount;
+};
+
+inline bool operator==(const SurfaceIndexBuffer::Key &a, const SurfaceIndexBuffer::Key &b)
+{
+    return a.type == b.type && a.columns == b.columns && a.rows == b.rows
+            && a.dataDimension == b.dataDimension;
+}
+
+inline uint qHash(const SurfaceIndexBuffer::Key &key, uint seed = 0)
+{
+    return qHash(key.columns, seed) ^ qHash((key.rows << 4) | (key.dataDimension << 2) | key.type,
+                                            seed);
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
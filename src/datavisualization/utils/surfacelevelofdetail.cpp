@@ -0,0 +1,414 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "surfacelevelofdetail_p.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+const int tileCells = 32; // Grid cells along each side of a tile, at the step of its level
+// A tile is split when it differs from the full detail surface by more pixels than this
+const float maxPixelError = 2.0f;
+
+// Lists the vertex lines from start to end that are drawn with the given step. The last line is
+// always included, even if it is not a full step from the previous one.
+static void gridLines(int start, int end, int step, QVector<int> &lines)
+{
+    lines.clear();
+    for (int line = start; line < end; line += step)
+        lines.append(line);
+    lines.append(end);
+}
+
+SurfaceLevelOfDetail::SurfaceLevelOfDetail()
+    : m_columns(0),
+      m_rows(0),
+      m_leafColumns(0),
+      m_leafRows(0),
+      m_dirty(true)
+{
+}
+
+SurfaceLevelOfDetail::~SurfaceLevelOfDetail()
+{
+}
+
+void SurfaceLevelOfDetail::build(const SurfaceObject &object)
+{
+    build(SurfaceObjectGrid(object));
+}
+
+void SurfaceLevelOfDetail::build(const SurfaceHeightGrid &grid)
+{
+    const int columns = grid.columns();
+    const int rows = grid.rows();
+
+    m_nodes.clear();
+    m_selection.clear();
+    m_leafLevels.clear();
+    m_columns = columns;
+    m_rows = rows;
+    m_dirty = false;
+
+    if (columns < 2 || rows < 2)
+        return;
+
+    m_leafColumns = (columns - 2) / tileCells + 1;
+    m_leafRows = (rows - 2) / tileCells + 1;
+    m_leafLevels.fill(-1, m_leafColumns * m_leafRows);
+
+    int rootLevel = 0;
+    while ((tileCells << rootLevel) < qMax(columns, rows) - 1)
+        rootLevel++;
+
+    Node root;
+    root.column = 0;
+    root.row = 0;
+    root.endColumn = columns - 1;
+    root.endRow = rows - 1;
+    root.level = rootLevel;
+    root.firstChild = -1;
+    root.childCount = 0;
+    root.error = 0.0f;
+    m_nodes.append(root);
+
+    // Nodes are created breadth first, so children always come after their parents
+    for (int i = 0; i < m_nodes.size(); i++) {
+        // Copy the parent, as adding the children may reallocate the node array
+        const Node parent = m_nodes.at(i);
+        if (!parent.level)
+            continue;
+
+        const int childCells = tileCells << (parent.level - 1);
+        m_nodes[i].firstChild = m_nodes.size();
+        for (int row = parent.row; row < parent.endRow; row += childCells) {
+            for (int column = parent.column; column < parent.endColumn; column += childCells) {
+                Node child;
+                child.column = column;
+                child.row = row;
+                child.endColumn = qMin(column + childCells, parent.endColumn);
+                child.endRow = qMin(row + childCells, parent.endRow);
+                child.level = parent.level - 1;
+                child.firstChild = -1;
+                child.childCount = 0;
+                child.error = 0.0f;
+                m_nodes.append(child);
+                m_nodes[i].childCount++;
+            }
+        }
+    }
+
+    for (int i = m_nodes.size() - 1; i >= 0; i--)
+        updateNode(grid, i);
+}
+
+void SurfaceLevelOfDetail::updateRows(const SurfaceObject &object, int startRow, int endRow)
+{
+    updateRows(SurfaceObjectGrid(object), startRow, endRow);
+}
+
+// Updates the bounds and errors of the tiles that contain vertices of the given rows
+void SurfaceLevelOfDetail::updateRows(const SurfaceHeightGrid &grid, int startRow, int endRow)
+{
+    if (m_dirty)
+        return;
+
+    for (int i = m_nodes.size() - 1; i >= 0; i--) {
+        const Node &node = m_nodes.at(i);
+        if (node.row <= endRow && node.endRow >= startRow)
+            updateNode(grid, i);
+    }
+}
+
+void SurfaceLevelOfDetail::updateNode(const SurfaceHeightGrid &grid, int nodeIndex)
+{
+    Node &node = m_nodes[nodeIndex];
+
+    if (node.firstChild < 0) {
+        // Leaves are drawn at full detail and only need their bounds
+        node.minBounds = grid.gridPosition(node.column, node.row);
+        node.maxBounds = node.minBounds;
+        for (int row = node.row; row <= node.endRow; row++) {
+            for (int column = node.column; column <= node.endColumn; column++) {
+                const QVector3D position = grid.gridPosition(column, row);
+                node.minBounds.setX(qMin(node.minBounds.x(), position.x()));
+                node.minBounds.setY(qMin(node.minBounds.y(), position.y()));
+                node.minBounds.setZ(qMin(node.minBounds.z(), position.z()));
+                node.maxBounds.setX(qMax(node.maxBounds.x(), position.x()));
+                node.maxBounds.setY(qMax(node.maxBounds.y(), position.y()));
+                node.maxBounds.setZ(qMax(node.maxBounds.z(), position.z()));
+            }
+        }
+        node.error = 0.0f;
+        return;
+    }
+
+    float error = 0.0f;
+    node.minBounds = m_nodes.at(node.firstChild).minBounds;
+    node.maxBounds = m_nodes.at(node.firstChild).maxBounds;
+    for (int i = 0; i < node.childCount; i++) {
+        const Node &child = m_nodes.at(node.firstChild + i);
+        node.minBounds.setX(qMin(node.minBounds.x(), child.minBounds.x()));
+        node.minBounds.setY(qMin(node.minBounds.y(), child.minBounds.y()));
+        node.minBounds.setZ(qMin(node.minBounds.z(), child.minBounds.z()));
+        node.maxBounds.setX(qMax(node.maxBounds.x(), child.maxBounds.x()));
+        node.maxBounds.setY(qMax(node.maxBounds.y(), child.maxBounds.y()));
+        node.maxBounds.setZ(qMax(node.maxBounds.z(), child.maxBounds.z()));
+        error = qMax(error, child.error);
+    }
+
+    // Compare the heights the tile interpolates to the vertices its children draw
+    const int step = 1 << node.level;
+    QVector<int> columns;
+    QVector<int> rows;
+    QVector<int> fineColumns;
+    QVector<int> fineRows;
+    gridLines(node.column, node.endColumn, step, columns);
+    gridLines(node.row, node.endRow, step, rows);
+    gridLines(node.column, node.endColumn, step / 2, fineColumns);
+    gridLines(node.row, node.endRow, step / 2, fineRows);
+
+    QVector<float> heights(columns.size() * rows.size());
+    int index = 0;
+    foreach (int row, rows) {
+        foreach (int column, columns)
+            heights[index++] = grid.gridPosition(column, row).y();
+    }
+
+    const int columnCount = columns.size();
+    int r = 0;
+    foreach (int row, fineRows) {
+        while (rows.at(r + 1) < row)
+            r++;
+        const float rowFraction = float(row - rows.at(r)) / float(rows.at(r + 1) - rows.at(r));
+        const float *lower = heights.constData() + r * columnCount;
+        const float *upper = lower + columnCount;
+        int c = 0;
+        foreach (int column, fineColumns) {
+            while (columns.at(c + 1) < column)
+                c++;
+            const float columnFraction = float(column - columns.at(c))
+                    / float(columns.at(c + 1) - columns.at(c));
+            const float lowerHeight = lower[c] + (lower[c + 1] - lower[c]) * columnFraction;
+            const float upperHeight = upper[c] + (upper[c + 1] - upper[c]) * columnFraction;
+            const float height = lowerHeight + (upperHeight - lowerHeight) * rowFraction;
+            error = qMax(error, qAbs(grid.gridPosition(column, row).y() - height));
+        }
+    }
+    node.error = error;
+}
+
+// Selects the tiles to draw for the view. Returns true if the selection changed.
+bool SurfaceLevelOfDetail::select(const QMatrix4x4 &viewProjectionMatrix, float pixelScale)
+{
+    QVector<int> previousSelection;
+    previousSelection.swap(m_selection);
+
+    if (m_nodes.isEmpty())
+        return !previousSelection.isEmpty();
+
+    // Extract the frustum planes from the matrix, normals pointing inside
+    const QVector4D row0 = viewProjectionMatrix.row(0);
+    const QVector4D row1 = viewProjectionMatrix.row(1);
+    const QVector4D row2 = viewProjectionMatrix.row(2);
+    const QVector4D row3 = viewProjectionMatrix.row(3);
+    QVector4D planes[6] = {
+        row3 + row0, row3 - row0,
+        row3 + row1, row3 - row1,
+        row3 + row2, row3 - row2
+    };
+    for (int i = 0; i < 6; i++) {
+        const float length = planes[i].toVector3D().length();
+        if (length > 0.0f)
+            planes[i] /= length;
+    }
+
+    m_selection.reserve(previousSelection.size());
+    selectNode(0, planes, 0x3f, viewProjectionMatrix, pixelScale);
+
+    if (m_selection == previousSelection)
+        return false;
+
+    // Map the selected levels to the leaf tiles, so that coarser neighbors can be found
+    m_leafLevels.fill(-1);
+    foreach (int nodeIndex, m_selection) {
+        const Node &node = m_nodes.at(nodeIndex);
+        const int endLeafRow = (node.endRow - 1) / tileCells;
+        const int endLeafColumn = (node.endColumn - 1) / tileCells;
+        for (int leafRow = node.row / tileCells; leafRow <= endLeafRow; leafRow++) {
+            for (int leafColumn = node.column / tileCells; leafColumn <= endLeafColumn;
+                 leafColumn++) {
+                m_leafLevels[leafRow * m_leafColumns + leafColumn] = node.level;
+            }
+        }
+    }
+    return true;
+}
+
+void SurfaceLevelOfDetail::selectNode(int nodeIndex, const QVector4D *planes, int planeMask,
+                                      const QMatrix4x4 &viewProjectionMatrix, float pixelScale)
+{
+    const Node &node = m_nodes.at(nodeIndex);
+    const QVector3D center = (node.minBounds + node.maxBounds) / 2.0f;
+    const QVector3D halfSize = (node.maxBounds - node.minBounds) / 2.0f;
+
+    // Planes the tile is completely inside of are not tested for its children
+    for (int i = 0; i < 6; i++) {
+        if (!(planeMask & (1 << i)))
+            continue;
+        const QVector4D &plane = planes[i];
+        const float distance = QVector3D::dotProduct(plane.toVector3D(), center) + plane.w();
+        const float radius = qAbs(plane.x()) * halfSize.x() + qAbs(plane.y()) * halfSize.y()
+                + qAbs(plane.z()) * halfSize.z();
+        if (distance < -radius)
+            return;
+        if (distance > radius)
+            planeMask &= ~(1 << i);
+    }
+
+    if (node.firstChild >= 0) {
+        // The error is projected at the nearest possible depth of the tile. Tiles reaching
+        // behind the camera are always split.
+        const QVector4D row3 = viewProjectionMatrix.row(3);
+        const float w = QVector3D::dotProduct(row3.toVector3D(), center) + row3.w()
+                - row3.toVector3D().length() * halfSize.length();
+        if (w <= 0.0f || node.error * pixelScale > maxPixelError * w) {
+            for (int i = 0; i < node.childCount; i++) {
+                selectNode(node.firstChild + i, planes, planeMask, viewProjectionMatrix,
+                           pixelScale);
+            }
+            return;
+        }
+    }
+
+    m_selection.append(nodeIndex);
+}
+
+// Creates the triangle and grid line indices of the selected tiles
+void SurfaceLevelOfDetail::createIndices(SurfaceObject::DataDimensions dataDimension,
+                                         QVector<GLint> &indices,
+                                         QVector<GLint> &gridIndices) const
+{
+    indices.clear();
+    gridIndices.clear();
+    indices.reserve(m_selection.size() * tileCells * tileCells * 6);
+    gridIndices.reserve(m_selection.size() * tileCells * (tileCells + 1) * 4);
+
+    const bool sameDirections = (dataDimension == SurfaceObject::BothAscending)
+            || (dataDimension == SurfaceObject::BothDescending);
+    QVector<int> columns;
+    QVector<int> rows;
+    foreach (int nodeIndex, m_selection) {
+        const Node &node = m_nodes.at(nodeIndex);
+        const int step = 1 << node.level;
+        gridLines(node.column, node.endColumn, step, columns);
+        gridLines(node.row, node.endRow, step, rows);
+
+        // Same triangulation as in SurfaceObject::createSmoothIndices()
+        for (int r = 0; r < rows.size() - 1; r++) {
+            const int row = rows.at(r) * m_columns;
+            const int upperRow = rows.at(r + 1) * m_columns;
+            for (int c = 0; c < columns.size() - 1; c++) {
+                const int left = columns.at(c);
+                const int right = columns.at(c + 1);
+                if (sameDirections) {
+                    indices << row + right << upperRow + left << row + left
+                            << upperRow + right << upperRow + left << row + right;
+                } else {
+                    indices << upperRow + left << upperRow + right << row + left
+                            << row + left << upperRow + right << row + right;
+                }
+            }
+        }
+
+        foreach (int row, rows) {
+            const int rowStart = row * m_columns;
+            for (int c = 0; c < columns.size() - 1; c++)
+                gridIndices << rowStart + columns.at(c) << rowStart + columns.at(c + 1);
+        }
+        foreach (int column, columns) {
+            for (int r = 0; r < rows.size() - 1; r++) {
+                gridIndices << rows.at(r) * m_columns + column
+                            << rows.at(r + 1) * m_columns + column;
+            }
+        }
+
+        // Close the gaps to coarser neighbors, which skip some of the vertices on shared edges.
+        // Tiles are aligned to their size, so a coarser neighbor covers the whole edge.
+        const int leafColumn = node.column / tileCells;
+        const int leafRow = node.row / tileCells;
+        if (node.row > 0) {
+            const int level = neighborLevel(leafColumn, leafRow - 1);
+            if (level > node.level)
+                fillSeam(indices, columns, level, node.row, true);
+        }
+        if (node.endRow < m_rows - 1) {
+            const int level = neighborLevel(leafColumn, node.endRow / tileCells);
+            if (level > node.level)
+                fillSeam(indices, columns, level, node.endRow, true);
+        }
+        if (node.column > 0) {
+            const int level = neighborLevel(leafColumn - 1, leafRow);
+            if (level > node.level)
+                fillSeam(indices, rows, level, node.column, false);
+        }
+        if (node.endColumn < m_columns - 1) {
+            const int level = neighborLevel(node.endColumn / tileCells, leafRow);
+            if (level > node.level)
+                fillSeam(indices, rows, level, node.endColumn, false);
+        }
+    }
+}
+
+int SurfaceLevelOfDetail::neighborLevel(int leafColumn, int leafRow) const
+{
+    return m_leafLevels.at(leafRow * m_leafColumns + leafColumn);
+}
+
+// Fills the gap between the vertices of an edge and the straight lines a coarser neighbor draws
+// between its vertices, which are at multiples of its step. Each gap is filled with a fan of
+// triangles from the coarse vertex before it.
+void SurfaceLevelOfDetail::fillSeam(QVector<GLint> &indices, const QVector<int> &edge, int level,
+                                    int fixedIndex, bool alongRow) const
+{
+    const int step = 1 << level;
+    for (int i = 0; i < edge.size() - 1; i++) {
+        const int anchor = edge.at(i) / step * step;
+        if (anchor == edge.at(i))
+            continue;
+        if (alongRow) {
+            const int row = fixedIndex * m_columns;
+            indices << row + anchor << row + edge.at(i) << row + edge.at(i + 1);
+        } else {
+            indices << anchor * m_columns + fixedIndex << edge.at(i) * m_columns + fixedIndex
+                    << edge.at(i + 1) * m_columns + fixedIndex;
+        }
+    }
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SURFACELEVELOFDETAIL_P_H
+#define SURFACELEVELOFDETAIL_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "surfaceheighthierarchy_p.h"
+
+#include <QtGui/QMatrix4x4>
+#include <QtGui/QVector4D>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Quadtree of tiles over the vertex grid of a smooth surface. Each tile draws a fixed number of
+// grid cells, so tiles on coarser levels skip vertices and cover larger parts of the surface.
+// The tiles drawn are selected per frame by their projected error in pixels. Seams between
+// tiles of different levels are closed with triangles filling the gaps along the finer tile.
+class QT_DATAVISUALIZATION_EXPORT SurfaceLevelOfDetail
+{
+public:
+    SurfaceLevelOfDetail();
+    ~SurfaceLevelOfDetail();
+
+    inline void setDirty() { m_dirty = true; }
+    inline bool isDirty() const { return m_dirty; }
+
+    void build(const SurfaceObject &object);
+    void build(const SurfaceHeightGrid &grid);
+    void updateRows(const SurfaceObject &object, int startRow, int endRow);
+    void updateRows(const SurfaceHeightGrid &grid, int startRow, int endRow);
+    bool select(const QMatrix4x4 &viewProjectionMatrix, float pixelScale);
+    void createIndices(SurfaceObject::DataDimensions dataDimension, QVector<GLint> &indices,
+                       QVector<GLint> &gridIndices) const;
+
+private:
+    struct Node {
+        int column; // First vertex column and row of the tile
+        int row;
+        int endColumn; // Last vertex column and row of the tile
+        int endRow;
+        int level; // Tiles on level n draw every 2^n:th vertex
+        int firstChild; // Children are stored consecutively, -1 for leaves
+        int childCount;
+        QVector3D minBounds;
+        QVector3D maxBounds;
+        float error; // Largest height difference to the full detail surface
+    };
+
+    void updateNode(const SurfaceHeightGrid &grid, int nodeIndex);
+    void selectNode(int nodeIndex, const QVector4D *planes, int planeMask,
+                    const QMatrix4x4 &viewProjectionMatrix, float pixelScale);
+    int neighborLevel(int leafColumn, int leafRow) const;
+    void fillSeam(QVector<GLint> &indices, const QVector<int> &edge, int level, int fixedIndex,
+                  bool alongRow) const;
+
+    QVector<Node> m_nodes;
+    QVector<int> m_selection;
+    QVector<int> m_leafLevels; // Selected level covering each leaf tile, -1 if culled
+    int m_columns;
+    int m_rows;
+    int m_leafColumns;
+    int m_leafRows;
+    bool m_dirty;
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "surfacenormals_p.h"
+
+#include <QtCore/private/qsimd_p.h>
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+Q_STATIC_ASSERT(sizeof(QVector3D) == 3 * sizeof(float));
+
+typedef void (*CrossProductsFunction)(const float *a, const float *b, const float *c,
+                                      float *normals, int count);
+
+static CrossProductsFunction crossProductsFunction(SurfaceNormals::Kernel kernel)
+{
+    switch (kernel) {
+#ifdef QT_COMPILER_SUPPORTS_SSE2
+    case SurfaceNormals::KernelSse2:
+        return &SurfaceNormals::crossProductsSse2;
+#endif
+#ifdef QT_COMPILER_SUPPORTS_AVX
+    case SurfaceNormals::KernelAvx:
+        return &SurfaceNormals::crossProductsAvx;
+#endif
+    default:
+        return &SurfaceNormals::crossProductsScalar;
+    }
+}
+
+// Computes the normals with the fastest kernel the processor supports.
+void SurfaceNormals::crossProducts(const QVector3D *a, const QVector3D *b, const QVector3D *c,
+                                   QVector3D *normals, int count)
+{
+    static const CrossProductsFunction function = crossProductsFunction(bestKernel());
+    function(reinterpret_cast<const float *>(a), reinterpret_cast<const float *>(b),
+             reinterpret_cast<const float *>(c), reinterpret_cast<float *>(normals), count);
+}
+
+// Computes the normals with the given kernel. Unsupported kernels fall back to the scalar one.
+void SurfaceNormals::crossProducts(Kernel kernel, const QVector3D *a, const QVector3D *b,
+                                   const QVector3D *c, QVector3D *normals, int count)
+{
+    if (!isKernelSupported(kernel))
+        kernel = KernelScalar;
+    crossProductsFunction(kernel)(reinterpret_cast<const float *>(a),
+                                  reinterpret_cast<const float *>(b),
+                                  reinterpret_cast<const float *>(c),
+                                  reinterpret_cast<float *>(normals), count);
+}
+
+bool SurfaceNormals::isKernelSupported(Kernel kernel)
+{
+    switch (kernel) {
+    case KernelScalar:
+        return true;
+#ifdef QT_COMPILER_SUPPORTS_SSE2
+    case KernelSse2:
+        return qCpuHasFeature(SSE2);
+#endif
+#ifdef QT_COMPILER_SUPPORTS_AVX
+    case KernelAvx:
+        return qCpuHasFeature(AVX);
+#endif
+    default:
+        return false;
+    }
+}
+
+SurfaceNormals::Kernel SurfaceNormals::bestKernel()
+{
+    if (isKernelSupported(KernelAvx))
+        return KernelAvx;
+    if (isKernelSupported(KernelSse2))
+        return KernelSse2;
+    return KernelScalar;
+}
+
+// Vertices are packed x, y, z triplets, the same layout as an array of QVector3D.
+void SurfaceNormals::crossProductsScalar(const float *a, const float *b, const float *c,
+                                         float *normals, int count)
+{
+    for (int i = 0; i < count; i++) {
+        const float v1x = b[0] - a[0];
+        const float v1y = b[1] - a[1];
+        const float v1z = b[2] - a[2];
+        const float v2x = c[0] - a[0];
+        const float v2y = c[1] - a[1];
+        const float v2z = c[2] - a[2];
+        normals[0] = v1y * v2z - v1z * v2y;
+        normals[1] = v1z * v2x - v1x * v2z;
+        normals[2] = v1x * v2y - v1y * v2x;
+        a += 3;
+        b += 3;
+        c += 3;
+        normals += 3;
+    }
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
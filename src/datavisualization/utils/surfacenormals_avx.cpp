@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "surfacenormals_p.h"
+
+#include <QtCore/private/qsimd_p.h>
+
+#ifdef QT_COMPILER_SUPPORTS_AVX
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Splits eight packed x, y, z triplets into separate x, y, and z vectors. The lower lane holds
+// the first four vertices and the upper lane the last four, so the same in-lane shuffles as in
+// the SSE2 kernel can be used.
+static inline void loadVertices(const float *data, __m256 &x, __m256 &y, __m256 &z)
+{
+    const __m256 m0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data)),
+                                           _mm_loadu_ps(data + 12), 1);
+    const __m256 m1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data + 4)),
+                                           _mm_loadu_ps(data + 16), 1);
+    const __m256 m2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data + 8)),
+                                           _mm_loadu_ps(data + 20), 1);
+    const __m256 xy = _mm256_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+    const __m256 yz = _mm256_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+    x = _mm256_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm256_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+// Packs separate x, y, and z vectors back to eight x, y, z triplets
+static inline void storeVertices(float *data, __m256 x, __m256 y, __m256 z)
+{
+    const __m256 xy0 = _mm256_unpacklo_ps(x, y);
+    const __m256 xy1 = _mm256_unpackhi_ps(x, y);
+    const __m256 zx0 = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+    const __m256 yz1 = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m256 zx2 = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+    const __m256 yz3 = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m256 m0 = _mm256_shuffle_ps(xy0, zx0, _MM_SHUFFLE(2, 0, 1, 0));
+    const __m256 m1 = _mm256_shuffle_ps(yz1, xy1, _MM_SHUFFLE(1, 0, 2, 0));
+    const __m256 m2 = _mm256_shuffle_ps(zx2, yz3, _MM_SHUFFLE(2, 0, 2, 0));
+    _mm256_storeu_ps(data, _mm256_permute2f128_ps(m0, m1, 0x20));
+    _mm256_storeu_ps(data + 8, _mm256_permute2f128_ps(m2, m0, 0x30));
+    _mm256_storeu_ps(data + 16, _mm256_permute2f128_ps(m1, m2, 0x31));
+}
+
+void SurfaceNormals::crossProductsAvx(const float *a, const float *b, const float *c,
+                                      float *normals, int count)
+{
+    const int vectorCount = count & ~7;
+    for (int i = 0; i < vectorCount; i += 8) {
+        __m256 ax, ay, az, bx, by, bz, cx, cy, cz;
+        loadVertices(a, ax, ay, az);
+        loadVertices(b, bx, by, bz);
+        loadVertices(c, cx, cy, cz);
+
+        const __m256 v1x = _mm256_sub_ps(bx, ax);
+        const __m256 v1y = _mm256_sub_ps(by, ay);
+        const __m256 v1z = _mm256_sub_ps(bz, az);
+        const __m256 v2x = _mm256_sub_ps(cx, ax);
+        const __m256 v2y = _mm256_sub_ps(cy, ay);
+        const __m256 v2z = _mm256_sub_ps(cz, az);
+
+        storeVertices(normals,
+                      _mm256_sub_ps(_mm256_mul_ps(v1y, v2z), _mm256_mul_ps(v1z, v2y)),
+                      _mm256_sub_ps(_mm256_mul_ps(v1z, v2x), _mm256_mul_ps(v1x, v2z)),
+                      _mm256_sub_ps(_mm256_mul_ps(v1x, v2y), _mm256_mul_ps(v1y, v2x)));
+
+        a += 24;
+        b += 24;
+        c += 24;
+        normals += 24;
+    }
+
+    crossProductsScalar(a, b, c, normals, count - vectorCount);
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SURFACENORMALS_P_H
+#define SURFACENORMALS_P_H
+
+#include "datavisualizationglobal_p.h"
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Computes surface normals for runs of vertices stored in contiguous arrays. Each normal is the
+// cross product (b - a) x (c - a) of the corresponding vertices of the three input runs, which
+// typically point to the same row, its neighbor column, and its neighbor row of a surface.
+// Vectorized kernels are used when the processor supports them.
+class QT_DATAVISUALIZATION_EXPORT SurfaceNormals
+{
+public:
+    enum Kernel {
+        KernelScalar = 0,
+        KernelSse2,
+        KernelAvx
+    };
+
+    static void crossProducts(const QVector3D *a, const QVector3D *b, const QVector3D *c,
+                              QVector3D *normals, int count);
+    static void crossProducts(Kernel kernel, const QVector3D *a, const QVector3D *b,
+                              const QVector3D *c, QVector3D *normals, int count);
+
+    static bool isKernelSupported(Kernel kernel);
+    static Kernel bestKernel();
+
+    static void crossProductsScalar(const float *a, const float *b, const float *c,
+                                    float *normals, int count);
+    static void crossProductsSse2(const float *a, const float *b, const float *c,
+                                  float *normals, int count);
+    static void crossProductsAvx(const float *a, const float *b, const float *c,
+                                 float *normals, int count);
+};
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
@@ -0,0 +1,98 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "surfacenormals_p.h"
+
+#include <QtCore/private/qsimd_p.h>
+
+#ifdef QT_COMPILER_SUPPORTS_SSE2
+
+QT_BEGIN_NAMESPACE_DATAVISUALIZATION
+
+// Splits four packed x, y, z triplets into separate x, y, and z vectors
+static inline void loadVertices(const float *data, __m128 &x, __m128 &y, __m128 &z)
+{
+    const __m128 m0 = _mm_loadu_ps(data);     // x0 y0 z0 x1
+    const __m128 m1 = _mm_loadu_ps(data + 4); // y1 z1 x2 y2
+    const __m128 m2 = _mm_loadu_ps(data + 8); // z2 x3 y3 z3
+    const __m128 xy = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+    const __m128 yz = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+    x = _mm_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+// Packs separate x, y, and z vectors back to four x, y, z triplets
+static inline void storeVertices(float *data, __m128 x, __m128 y, __m128 z)
+{
+    const __m128 xy0 = _mm_unpacklo_ps(x, y);                           // x0 y0 x1 y1
+    const __m128 xy1 = _mm_unpackhi_ps(x, y);                           // x2 y2 x3 y3
+    const __m128 zx0 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));   // z0 z0 x1 x1
+    const __m128 yz1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));   // y1 y1 z1 z1
+    const __m128 zx2 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));   // z2 z2 x3 x3
+    const __m128 yz3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));   // y3 y3 z3 z3
+    _mm_storeu_ps(data, _mm_shuffle_ps(xy0, zx0, _MM_SHUFFLE(2, 0, 1, 0)));
+    _mm_storeu_ps(data + 4, _mm_shuffle_ps(yz1, xy1, _MM_SHUFFLE(1, 0, 2, 0)));
+    _mm_storeu_ps(data + 8, _mm_shuffle_ps(zx2, yz3, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+void SurfaceNormals::crossProductsSse2(const float *a, const float *b, const float *c,
+                                       float *normals, int count)
+{
+    const int vectorCount = count & ~3;
+    for (int i = 0; i < vectorCount; i += 4) {
+        __m128 ax, ay, az, bx, by, bz, cx, cy, cz;
+        loadVertices(a, ax, ay, az);
+        loadVertices(b, bx, by, bz);
+        loadVertices(c, cx, cy, cz);
+
+        const __m128 v1x = _mm_sub_ps(bx, ax);
+        const __m128 v1y = _mm_sub_ps(by, ay);
+        const __m128 v1z = _mm_sub_ps(bz, az);
+        const __m128 v2x = _mm_sub_ps(cx, ax);
+        const __m128 v2y = _mm_sub_ps(cy, ay);
+        const __m128 v2z = _mm_sub_ps(cz, az);
+
+        storeVertices(normals,
+                      _mm_sub_ps(_mm_mul_ps(v1y, v2z), _mm_mul_ps(v1z, v2y)),
+                      _mm_sub_ps(_mm_mul_ps(v1z, v2x), _mm_mul_ps(v1x, v2z)),
+                      _mm_sub_ps(_mm_mul_ps(v1x, v2y), _mm_mul_ps(v1y, v2x)));
+
+        a += 12;
+        b += 12;
+        c += 12;
+        normals += 12;
+    }
+
+    crossProductsScalar(a, b, c, normals, count - vectorCount);
+}
+
+QT_END_NAMESPACE_DATAVISUALIZATION
+
+#endif
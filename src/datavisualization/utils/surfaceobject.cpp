@@ -29,38 +29,134 @@
 
 #include "surfaceobject_p.h"
 #include "surface3drenderer_p.h"
-
+#include "surfacenormals_p.h"
+#include "surfacelevelofdetail_p.h"
+#include "utils_p.h"
+
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtGui/QVector2D>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
+// Surfaces with fewer vertices than this are set up serially, as handing the work to other
+// threads would cost more than it saves.
+const int parallelSetUpThreshold = 250000;
+const int minVerticesPerBand = 65536;
+
+// Returns true if the values are evenly spaced, allowing for rounding errors
+static bool isEvenlySpaced(const QVector<float> &values)
+{
+    const int last = values.size() - 1;
+    const float step = (values.at(last) - values.at(0)) / float(last);
+    if (step == 0.0f || qIsNaN(step) || qIsInf(step))
+        return false;
+
+    const float tolerance = qAbs(step) * 0.001f;
+    for (int i = 1; i < last; i++) {
+        if (qAbs(values.at(i) - (values.at(0) + step * float(i))) > tolerance)
+            return false;
+    }
+    return true;
+}
+
+// Returns true if the items of the row are at the grid column X values and the row Z value
+static bool isGridRow(const QSurfaceDataRow &row, const QVector<float> &columnX, float z)
+{
+    for (int j = 0; j < columnX.size(); j++) {
+        const QSurfaceDataItem &item = row.at(j);
+        if (item.x() != columnX.at(j) || item.z() != z)
+            return false;
+    }
+    return true;
+}
+
+// Part of the surface rows processed by one thread when the surface data is set up
+struct SurfaceObject::RowBand
+{
+    const QSurfaceDataArray *dataArray;
+    QVector2D *uvs;
+    GLint *indices;
+    bool polar;
+    bool flipXZ;
+    int startRow;
+    int endRow;
+    float minY;
+    float maxY;
+};
+
+// Processes a band of surface rows in a thread pool thread.
+class SurfaceRowBandProcessor : public QRunnable
+{
+public:
+    SurfaceRowBandProcessor(SurfaceObject *object, SurfaceObject::RowBandFunction function,
+                            SurfaceObject::RowBand &band, QSemaphore *done)
+        : m_object(object),
+          m_function(function),
+          m_band(band),
+          m_done(done)
+    {
+    }
+
+    void run()
+    {
+        (m_object->*m_function)(m_band);
+        m_done->release();
+    }
+
+private:
+    SurfaceObject *m_object;
+    SurfaceObject::RowBandFunction m_function;
+    SurfaceObject::RowBand &m_band;
+    QSemaphore *m_done;
+};
+
 SurfaceObject::SurfaceObject(Surface3DRenderer *renderer)
     : m_surfaceType(Undefined),
       m_columns(0),
       m_rows(0),
+      m_gridElementbuffer(0),
       m_gridIndexCount(0),
+      m_gridIndexType(GL_UNSIGNED_INT),
+      m_uploadedVertexCount(0),
+      m_uploadedNormalCount(0),
       m_axisCacheX(renderer->m_axisCacheX),
       m_axisCacheY(renderer->m_axisCacheY),
       m_axisCacheZ(renderer->m_axisCacheZ),
       m_renderer(renderer),
       m_returnTextureBuffer(false),
       m_dataDimension(0),
-      m_oldDataDimension(-1)
+      m_oldDataDimension(-1),
+      m_heightTexture(0),
+      m_heightRowOffset(0),
+      m_levelOfDetail(0),
+      m_sharedIndices(0),
+      m_sharedGridIndices(0),
+      m_detailIndices(0),
+      m_detailGridIndices(0)
 {
     glGenBuffers(1, &m_vertexbuffer);
     glGenBuffers(1, &m_normalbuffer);
     glGenBuffers(1, &m_uvbuffer);
-    glGenBuffers(1, &m_elementbuffer);
-    glGenBuffers(1, &m_gridElementbuffer);
     glGenBuffers(1, &m_uvTextureBuffer);
 }
 
 SurfaceObject::~SurfaceObject()
 {
+    // Leaves no element buffer for the base class to delete
+    releaseSharedIndices();
+    delete m_detailIndices;
+    delete m_detailGridIndices;
     if (QOpenGLContext::currentContext()) {
-        glDeleteBuffers(1, &m_gridElementbuffer);
         glDeleteBuffers(1, &m_uvTextureBuffer);
+        if (m_heightTexture)
+            glDeleteTextures(1, &m_heightTexture);
     }
+    delete m_levelOfDetail;
 }
 
 void SurfaceObject::setUpSmoothData(const QSurfaceDataArray &dataArray, const QRect &space,
@@ -69,10 +165,9 @@ void SurfaceObject::setUpSmoothData(const QSurfaceDataArray &dataArray, const QR
     m_columns = space.width();
     m_rows = space.height();
     int totalSize = m_rows * m_columns;
-    GLfloat uvX = 1.0f / GLfloat(m_columns - 1);
-    GLfloat uvY = 1.0f / GLfloat(m_rows - 1);
 
     m_surfaceType = SurfaceSmooth;
+    releaseHeightField();
 
     checkDirections(dataArray);
     bool indicesDirty = false;
@@ -87,147 +182,227 @@ void SurfaceObject::setUpSmoothData(const QSurfaceDataArray &dataArray, const QR
     QVector<QVector2D> uvs;
     if (changeGeometry)
         uvs.resize(totalSize);
-    int totalIndex = 0;
 
-    // Init min and max to ridiculous values
-    m_minY = 10000000.0;
-    m_maxY = -10000000.0f;
+    // Create normals
+    int rowLimit = m_rows - 1;
+    int colLimit = m_columns - 1;
+    if (changeGeometry)
+        m_normals.resize(totalSize);
 
-    for (int i = 0; i < m_rows; i++) {
-        const QSurfaceDataRow &p = *dataArray.at(i);
-        for (int j = 0; j < m_columns; j++) {
-            getNormalizedVertex(p.at(j), m_vertices[totalIndex], polar, flipXZ);
-            if (changeGeometry)
-                uvs[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
-            totalIndex++;
+    // Normals depend on the vertices of the neighboring rows, so all vertices are created
+    // before any normals.
+    QVector<RowBand> bands = createRowBands(dataArray, uvs, 0, polar, flipXZ, totalSize);
+    processRowBands(&SurfaceObject::createSmoothVertexBand, bands);
+    updateMinMaxY(bands);
+    processRowBands(&SurfaceObject::createSmoothNormalBand, bands);
+
+    if (m_levelOfDetail) {
+        // Indices are created for the tiles selected on the next frame
+        m_levelOfDetail->setDirty();
+        releaseSharedIndices();
+    } else {
+        // Create indices table, unless another surface of the same size has already created it
+        if ((changeGeometry || indicesDirty || !m_sharedIndices)
+                && shareIndices(SurfaceIndexBuffer::SmoothTriangles)) {
+            createSmoothIndices(0, 0, colLimit, rowLimit);
         }
-    }
 
-    if (flipXZ) {
-        for (int i = 0; i < m_vertices.size(); i++) {
-            m_vertices[i].setX(-m_vertices.at(i).x());
-            m_vertices[i].setZ(-m_vertices.at(i).z());
+        // Create line element indices
+        if ((changeGeometry || !m_sharedGridIndices)
+                && shareIndices(SurfaceIndexBuffer::SmoothGridLines)) {
+            createSmoothGridlineIndices(0, 0, colLimit, rowLimit);
         }
     }
 
-    // Create normals
-    int rowLimit = m_rows - 1;
-    int colLimit = m_columns - 1;
-    if (changeGeometry)
-        m_normals.resize(totalSize);
+    createBuffers(m_vertices, uvs, m_normals, 0);
+}
 
-    totalIndex = 0;
+// Sets up a surface that is drawn from a texture of heights, which requires that the data
+// forms a regular grid with evenly spaced columns and rows. Returns false if the data does not
+// fit, in which case the surface must be set up with setUpSmoothData() instead.
+bool SurfaceObject::setUpHeightFieldData(const QSurfaceDataArray &dataArray, const QRect &space,
+                                         bool changeGeometry)
+{
+    const int columns = space.width();
+    const int rows = space.height();
+    const GLint maxTextureSize = Utils::maximumTextureSize();
+    if (columns > maxTextureSize || rows > maxTextureSize)
+        return false;
+
+    // Both the data values and the normalized positions need to be evenly spaced, so that
+    // the vertex positions and the texture coordinates are linear in the grid coordinates
+    QVector<float> columnX(columns);
+    QVector<float> rowZ(rows);
+    QVector<float> normalizedX(columns);
+    QVector<float> normalizedZ(rows);
+    const QSurfaceDataRow &firstRow = *dataArray.at(0);
+    for (int j = 0; j < columns; j++) {
+        columnX[j] = firstRow.at(j).x();
+        normalizedX[j] = m_axisCacheX.positionAt(columnX.at(j));
+    }
+    for (int i = 0; i < rows; i++) {
+        rowZ[i] = dataArray.at(i)->at(0).z();
+        normalizedZ[i] = m_axisCacheZ.positionAt(rowZ.at(i));
+    }
+    if (!isEvenlySpaced(columnX) || !isEvenlySpaced(rowZ) || !isEvenlySpaced(normalizedX)
+            || !isEvenlySpaced(normalizedZ)) {
+        return false;
+    }
 
-    if ((m_dataDimension == BothAscending) || (m_dataDimension == XDescending)) {
-        for (int row = 0; row < rowLimit; row++)
-            createSmoothNormalBodyLine(totalIndex, row * m_columns);
-        createSmoothNormalUpperLine(totalIndex);
-    } else { // BothDescending || ZDescending
-        createSmoothNormalUpperLine(totalIndex);
-        for (int row = 1; row < m_rows; row++)
-            createSmoothNormalBodyLine(totalIndex, row * m_columns);
+    // Every row needs the same X values and a single Z value. The grid is checked before any
+    // state is changed, so that a surface set up with setUpSmoothData() instead still compares
+    // against the previous data.
+    for (int i = 0; i < rows; i++) {
+        if (!isGridRow(*dataArray.at(i), columnX, rowZ.at(i)))
+            return false;
     }
 
-    // Create indices table
-    if (changeGeometry || indicesDirty)
-        createSmoothIndices(0, 0, colLimit, rowLimit);
+    if (m_surfaceType != SurfaceHeightField || columns != m_columns || rows != m_rows)
+        changeGeometry = true;
+
+    m_columns = columns;
+    m_rows = rows;
+    m_gridColumnX = columnX;
+    m_gridRowZ = rowZ;
+    m_heightRowOffset = 0;
+    int totalSize = m_rows * m_columns;
+
+    checkDirections(dataArray);
+    bool indicesDirty = false;
+    if (m_dataDimension != m_oldDataDimension)
+        indicesDirty = true;
+    m_oldDataDimension = m_dataDimension;
+
+    if (changeGeometry)
+        m_heights.resize(totalSize);
 
-    // Create line element indices
+    QVector<QVector2D> uvs;
     if (changeGeometry)
-        createSmoothGridlineIndices(0, 0, colLimit, rowLimit);
+        uvs.resize(totalSize);
 
-    createBuffers(m_vertices, uvs, m_normals, 0);
+    QVector<RowBand> bands = createRowBands(dataArray, uvs, 0, false, false, totalSize);
+    processRowBands(&SurfaceObject::createHeightFieldBand, bands);
+    updateMinMaxY(bands);
+
+    m_surfaceType = SurfaceHeightField;
+    m_gridOrigin = QVector2D(normalizedX.first(), normalizedZ.first());
+    m_gridStep = QVector2D((normalizedX.last() - normalizedX.first()) / GLfloat(m_columns - 1),
+                           (normalizedZ.last() - normalizedZ.first()) / GLfloat(m_rows - 1));
+
+    int rowLimit = m_rows - 1;
+    int colLimit = m_columns - 1;
+    if (m_levelOfDetail) {
+        m_levelOfDetail->setDirty();
+        releaseSharedIndices();
+    } else {
+        // Height fields are indexed like smooth surfaces, so they share the same indices
+        if ((changeGeometry || indicesDirty || !m_sharedIndices)
+                && shareIndices(SurfaceIndexBuffer::SmoothTriangles)) {
+            createSmoothIndices(0, 0, colLimit, rowLimit);
+        }
+        if ((changeGeometry || !m_sharedGridIndices)
+                && shareIndices(SurfaceIndexBuffer::SmoothGridLines)) {
+            createSmoothGridlineIndices(0, 0, colLimit, rowLimit);
+        }
+    }
+
+    if (changeGeometry) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
+        glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(QVector2D),
+                     &uvs.at(0), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        releaseVertexBuffers();
+    }
+
+    uploadHeights(0, 0, m_columns, m_rows, changeGeometry);
+
+    m_meshDataLoaded = true;
+    return true;
 }
 
 void SurfaceObject::createSmoothNormalBodyLine(int &totalIndex, int column)
 {
     int colLimit = m_columns - 1;
+    const QVector3D *vertices = m_vertices.constData();
+    QVector3D *normals = m_normals.data();
 
+    // All normals of the line except the one at the edge are computed with the same pattern
     if (m_dataDimension == BothAscending) {
         int end = colLimit + column;
-        for (int j = column; j < end; j++) {
-            m_normals[totalIndex++] = normal(m_vertices.at(j),
-                                             m_vertices.at(j + 1),
-                                             m_vertices.at(j + m_columns));
-        }
-        m_normals[totalIndex++] = normal(m_vertices.at(end),
-                                         m_vertices.at(end + m_columns),
-                                         m_vertices.at(end - 1));
+        SurfaceNormals::crossProducts(vertices + column, vertices + column + 1,
+                                      vertices + column + m_columns, normals + totalIndex,
+                                      colLimit);
+        totalIndex += colLimit;
+        normals[totalIndex++] = normal(vertices[end],
+                                       vertices[end + m_columns],
+                                       vertices[end - 1]);
     } else if (m_dataDimension == XDescending) {
-        m_normals[totalIndex++] = normal(m_vertices.at(column),
-                                         m_vertices.at(column + m_columns),
-                                         m_vertices.at(column + 1));
-        int end = column + m_columns;
-        for (int j = column + 1; j < end; j++) {
-            m_normals[totalIndex++] = normal(m_vertices.at(j),
-                                             m_vertices.at(j - 1),
-                                             m_vertices.at(j + m_columns));
-        }
+        normals[totalIndex++] = normal(vertices[column],
+                                       vertices[column + m_columns],
+                                       vertices[column + 1]);
+        SurfaceNormals::crossProducts(vertices + column + 1, vertices + column,
+                                      vertices + column + 1 + m_columns, normals + totalIndex,
+                                      colLimit);
+        totalIndex += colLimit;
     } else if (m_dataDimension == ZDescending) {
         int end = colLimit + column;
-        for (int j = column; j < end; j++) {
-            m_normals[totalIndex++] = normal(m_vertices.at(j),
-                                             m_vertices.at(j + 1),
-                                             m_vertices.at(j - m_columns));
-        }
-        m_normals[totalIndex++] = normal(m_vertices.at(end),
-                                         m_vertices.at(end - m_columns),
-                                         m_vertices.at(end - 1));
+        SurfaceNormals::crossProducts(vertices + column, vertices + column + 1,
+                                      vertices + column - m_columns, normals + totalIndex,
+                                      colLimit);
+        totalIndex += colLimit;
+        normals[totalIndex++] = normal(vertices[end],
+                                       vertices[end - m_columns],
+                                       vertices[end - 1]);
     } else { // BothDescending
-        m_normals[totalIndex++] = normal(m_vertices.at(column),
-                                         m_vertices.at(column - m_columns),
-                                         m_vertices.at(column + 1));
-        int end = column + m_columns;
-        for (int j = column + 1; j < end; j++) {
-            m_normals[totalIndex++] = normal(m_vertices.at(j),
-                                             m_vertices.at(j - 1),
-                                             m_vertices.at(j - m_columns));
-        }
+        normals[totalIndex++] = normal(vertices[column],
+                                       vertices[column - m_columns],
+                                       vertices[column + 1]);
+        SurfaceNormals::crossProducts(vertices + column + 1, vertices + column,
+                                      vertices + column + 1 - m_columns, normals + totalIndex,
+                                      colLimit);
+        totalIndex += colLimit;
     }
 }
 
 void SurfaceObject::createSmoothNormalUpperLine(int &totalIndex)
 {
+    int colLimit = m_columns - 1;
+    const QVector3D *vertices = m_vertices.constData();
+    QVector3D *normals = m_normals.data();
+
     if (m_dataDimension == BothAscending) {
+        int lineStart = (m_rows - 1) * m_columns;
         int lineEnd = m_rows * m_columns - 1;
-        for (int j = (m_rows - 1) * m_columns; j < lineEnd; j++) {
-            m_normals[totalIndex++] = normal(m_vertices.at(j),
-                                             m_vertices.at(j - m_columns),
-                                             m_vertices.at(j + 1));
-        }
-        m_normals[totalIndex++] = normal(m_vertices.at(lineEnd),
-                                         m_vertices.at(lineEnd - 1),
-                                         m_vertices.at(lineEnd - m_columns));
+        SurfaceNormals::crossProducts(vertices + lineStart, vertices + lineStart - m_columns,
+                                      vertices + lineStart + 1, normals + totalIndex, colLimit);
+        totalIndex += colLimit;
+        normals[totalIndex++] = normal(vertices[lineEnd],
+                                       vertices[lineEnd - 1],
+                                       vertices[lineEnd - m_columns]);
     } else if (m_dataDimension == XDescending) {
         int lineStart = (m_rows - 1) * m_columns;
-        int lineEnd = m_rows * m_columns;
-        m_normals[totalIndex++] = normal(m_vertices.at(lineStart),
-                                         m_vertices.at(lineStart + 1),
-                                         m_vertices.at(lineStart - m_columns));
-        for (int j = lineStart + 1; j < lineEnd; j++) {
-            m_normals[totalIndex++] = normal(m_vertices.at(j),
-                                             m_vertices.at(j - m_columns),
-                                             m_vertices.at(j - 1));
-        }
+        normals[totalIndex++] = normal(vertices[lineStart],
+                                       vertices[lineStart + 1],
+                                       vertices[lineStart - m_columns]);
+        SurfaceNormals::crossProducts(vertices + lineStart + 1,
+                                      vertices + lineStart + 1 - m_columns,
+                                      vertices + lineStart, normals + totalIndex, colLimit);
+        totalIndex += colLimit;
     } else if (m_dataDimension == ZDescending) {
-        int colLimit = m_columns - 1;
-        for (int j = 0; j < colLimit; j++) {
-            m_normals[totalIndex++] = normal(m_vertices.at(j),
-                                             m_vertices.at(j + m_columns),
-                                             m_vertices.at(j + 1));
-        }
-        m_normals[totalIndex++] = normal(m_vertices.at(colLimit),
-                                         m_vertices.at(colLimit - 1),
-                                         m_vertices.at(colLimit + m_columns));
+        SurfaceNormals::crossProducts(vertices, vertices + m_columns, vertices + 1,
+                                      normals + totalIndex, colLimit);
+        totalIndex += colLimit;
+        normals[totalIndex++] = normal(vertices[colLimit],
+                                       vertices[colLimit - 1],
+                                       vertices[colLimit + m_columns]);
     } else { // BothDescending
-        m_normals[totalIndex++] = normal(m_vertices.at(0),
-                                         m_vertices.at(1),
-                                         m_vertices.at(m_columns));
-        for (int j = 1; j < m_columns; j++) {
-            m_normals[totalIndex++] = normal(m_vertices.at(j),
-                                             m_vertices.at(j + m_columns),
-                                             m_vertices.at(j - 1));
-        }
+        normals[totalIndex++] = normal(vertices[0],
+                                       vertices[1],
+                                       vertices[m_columns]);
+        SurfaceNormals::crossProducts(vertices + 1, vertices + 1 + m_columns, vertices,
+                                      normals + totalIndex, colLimit);
+        totalIndex += colLimit;
     }
 }
 
@@ -322,6 +497,27 @@ void SurfaceObject::smoothUVs(const QSurfaceDataArray &dataArray,
     const bool zDescending = m_dataDimension.testFlag(SurfaceObject::ZDescending);
     const bool xDescending = m_dataDimension.testFlag(SurfaceObject::XDescending);
 
+    if (m_surfaceType == SurfaceHeightField) {
+        // Texture coordinates of a regular grid are linear in the grid coordinates
+        const QSurfaceDataItem &first = modelArray.at(0)->at(0);
+        const QSurfaceDataItem &last = modelArray.at(m_rows - 1)->at(m_columns - 1);
+        float u0 = (first.x() - xMin) / xRangeNormalizer;
+        float u1 = (last.x() - xMin) / xRangeNormalizer;
+        float v0 = (first.z() - zMin) / zRangeNormalizer;
+        float v1 = (last.z() - zMin) / zRangeNormalizer;
+        if (xDescending) {
+            u0 = 1.0f - u0;
+            u1 = 1.0f - u1;
+        }
+        if (zDescending) {
+            v0 = 1.0f - v0;
+            v1 = 1.0f - v1;
+        }
+        m_textureUVRect = QVector4D(u0, v0, u1 - u0, v1 - v0);
+        m_returnTextureBuffer = true;
+        return;
+    }
+
     QVector<QVector2D> uvs;
     uvs.resize(m_rows * m_columns);
     int index = 0;
@@ -369,6 +565,7 @@ void SurfaceObject::updateSmoothRow(const QSurfaceDataArray &dataArray, int rowI
     if ((endRow == m_rows - 1) && upwards)
         endRow--;
     int totalIndex = startRow * m_columns;
+    const int dirtyStart = qMin(totalIndex, rowIndex * m_columns);
 
     if ((startRow == 0) && !upwards) {
         createSmoothNormalUpperLine(totalIndex);
@@ -380,6 +577,11 @@ void SurfaceObject::updateSmoothRow(const QSurfaceDataArray &dataArray, int rowI
 
     if ((rowIndex == m_rows - 1) && upwards)
         createSmoothNormalUpperLine(totalIndex);
+
+    addDirtySpan(dirtyStart, qMax(totalIndex, (rowIndex + 1) * m_columns));
+
+    if (m_levelOfDetail)
+        m_levelOfDetail->updateRows(*this, rowIndex, rowIndex);
 }
 
 void SurfaceObject::updateSmoothItem(const QSurfaceDataArray &dataArray, int row, int column,
@@ -418,9 +620,102 @@ void SurfaceObject::updateSmoothItem(const QSurfaceDataArray &dataArray, int row
                 m_normals[p] = createSmoothNormalBodyLineItem(j, i);
          }
     }
+
+    addDirtySpan(qMin(startRow, row) * m_columns + qMin(startCol, column),
+                 qMax(endRow, row) * m_columns + qMax(endCol, column) + 1);
+
+    if (m_levelOfDetail)
+        m_levelOfDetail->updateRows(*this, row, row);
 }
 
 
+// Updates the heights of a row of a height field surface. Returns false if the row no longer
+// fits the grid, in which case the surface must be set up again.
+bool SurfaceObject::updateHeightFieldRow(const QSurfaceDataArray &dataArray, int rowIndex)
+{
+    const QSurfaceDataRow &dataRow = *dataArray.at(rowIndex);
+    if (!isGridRow(dataRow, m_gridColumnX, m_gridRowZ.at(rowIndex)))
+        return false;
+
+    const int heightRow = heightFieldRow(rowIndex);
+    int p = heightRow * m_columns;
+    for (int j = 0; j < m_columns; j++) {
+        float y = m_axisCacheY.positionAt(dataRow.at(j).y());
+        m_heights[p++] = y;
+        m_minY = qMin(y, m_minY);
+        m_maxY = qMax(y, m_maxY);
+    }
+
+    uploadHeights(0, heightRow, m_columns, 1);
+    if (m_levelOfDetail)
+        m_levelOfDetail->updateRows(*this, rowIndex, rowIndex);
+    return true;
+}
+
+bool SurfaceObject::updateHeightFieldItem(const QSurfaceDataArray &dataArray, int row, int column)
+{
+    const QSurfaceDataItem &item = dataArray.at(row)->at(column);
+    if (item.x() != m_gridColumnX.at(column) || item.z() != m_gridRowZ.at(row))
+        return false;
+    float y = m_axisCacheY.positionAt(item.y());
+    const int heightRow = heightFieldRow(row);
+    m_heights[heightRow * m_columns + column] = y;
+    m_minY = qMin(y, m_minY);
+    m_maxY = qMax(y, m_maxY);
+
+    uploadHeights(column, heightRow, 1, 1);
+    if (m_levelOfDetail)
+        m_levelOfDetail->updateRows(*this, row, row);
+    return true;
+}
+
+// Scrolls a height field by the given number of rows removed from the start of the data array
+// and added to its end. The rows of the height texture are used as a ring, so the heights of the
+// rows that are still shown stay in place, and only the added rows overwrite the oldest rows in
+// the texture. The vertex shader offsets the rows it samples by the start of the ring.
+// Returns false if the scrolled rows do not make a regular grid, in which case the surface
+// needs to be set up again.
+bool SurfaceObject::scrollHeightFieldRows(const QSurfaceDataArray &dataArray, int count)
+{
+    Q_ASSERT(m_surfaceType == SurfaceHeightField);
+    if (count >= m_rows || dataArray.size() != m_rows)
+        return false;
+
+    // The rows move along the z-axis, so their positions need to stay evenly spaced
+    QVector<float> rowZ(m_rows);
+    QVector<float> normalizedZ(m_rows);
+    for (int i = 0; i < m_rows; i++) {
+        rowZ[i] = dataArray.at(i)->at(0).z();
+        normalizedZ[i] = m_axisCacheZ.positionAt(rowZ.at(i));
+    }
+    if (!isEvenlySpaced(rowZ) || !isEvenlySpaced(normalizedZ))
+        return false;
+    for (int i = m_rows - count; i < m_rows; i++) {
+        if (!isGridRow(*dataArray.at(i), m_gridColumnX, rowZ.at(i)))
+            return false;
+    }
+
+    // Changed directions would change the triangles
+    checkDirections(dataArray);
+    if (m_dataDimension != m_oldDataDimension) {
+        m_dataDimension = m_oldDataDimension;
+        return false;
+    }
+
+    m_gridRowZ = rowZ;
+    m_heightRowOffset = (m_heightRowOffset + count) % m_rows;
+    for (int i = m_rows - count; i < m_rows; i++)
+        updateHeightFieldRow(dataArray, i);
+
+    m_gridOrigin.setY(normalizedZ.first());
+    m_gridStep.setY((normalizedZ.last() - normalizedZ.first()) / GLfloat(m_rows - 1));
+
+    // All the rows moved, so the tiles need to be built again
+    if (m_levelOfDetail)
+        m_levelOfDetail->setDirty();
+    return true;
+}
+
 void SurfaceObject::createSmoothIndices(int x, int y, int endX, int endY)
 {
     if (endX >= m_columns)
@@ -432,54 +727,18 @@ void SurfaceObject::createSmoothIndices(int x, int y, int endX, int endY)
     if (y > endY)
         y = endY - 1;
 
-    m_indexCount = 6 * (endX - x) * (endY - y);
-    GLint *indices = new GLint[m_indexCount];
-    int p = 0;
-    int rowEnd = endY * m_columns;
-    for (int row = y * m_columns; row < rowEnd; row += m_columns) {
-        for (int j = x; j < endX; j++) {
-            if ((m_dataDimension == BothAscending) || (m_dataDimension == BothDescending)) {
-                // Left triangle
-                indices[p++] = row + j + 1;
-                indices[p++] = row + m_columns + j;
-                indices[p++] = row + j;
-
-                // Right triangle
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + m_columns + j;
-                indices[p++] = row + j + 1;
-            } else if (m_dataDimension == XDescending) {
-                // Right triangle
-                indices[p++] = row + m_columns + j;
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + j;
-
-                // Left triangle
-                indices[p++] = row + j;
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + j + 1;
-            } else {
-                // Left triangle
-                indices[p++] = row + m_columns + j;
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + j;
-
-                // Right triangle
-                indices[p++] = row + j;
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + j + 1;
-
-            }
-        }
-    }
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexCount * sizeof(GLint),
-                 indices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-    delete[] indices;
+    // The diagonals that split the quads depend on the data directions
+    const bool lowerRowFirst = (m_dataDimension == BothAscending)
+            || (m_dataDimension == BothDescending);
+    const GLenum primitiveMode = Utils::isPrimitiveRestartSupported() ? GL_TRIANGLE_STRIP
+                                                                      : GL_TRIANGLES;
+    const QVector<GLint> indices =
+            SurfaceIndexBuffer::createSmoothIndices(m_columns, x, y, endX, endY, lowerRowFirst,
+                                                    primitiveMode);
+
+    m_sharedIndices->upload(indices.constData(), indices.size(), m_columns * m_rows,
+                            primitiveMode);
+    useIndices(m_sharedIndices);
 }
 
 void SurfaceObject::createSmoothGridlineIndices(int x, int y, int endX, int endY)
@@ -511,11 +770,8 @@ void SurfaceObject::createSmoothGridlineIndices(int x, int y, int endX, int endY
         }
     }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_gridElementbuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_gridIndexCount * sizeof(GLint),
-                 gridIndices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    m_sharedGridIndices->upload(gridIndices, m_gridIndexCount, m_columns * m_rows, GL_LINES);
+    useGridIndices(m_sharedGridIndices);
 
     delete[] gridIndices;
 }
@@ -526,8 +782,6 @@ void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &s
     m_columns = space.width();
     m_rows = space.height();
     int totalSize = m_rows * m_columns * 2;
-    GLfloat uvX = 1.0f / GLfloat(m_columns - 1);
-    GLfloat uvY = 1.0f / GLfloat(m_rows - 1);
 
     checkDirections(dataArray);
     bool indicesDirty = false;
@@ -536,6 +790,7 @@ void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &s
     m_oldDataDimension = m_dataDimension;
 
     m_surfaceType = SurfaceFlat;
+    releaseHeightField();
 
     // Create vertix table
     if (changeGeometry)
@@ -545,71 +800,216 @@ void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &s
     if (changeGeometry)
         uvs.resize(totalSize);
 
-    int totalIndex = 0;
     int rowLimit = m_rows - 1;
     int colLimit = m_columns - 1;
-    int doubleColumns = m_columns * 2 - 2;
-    int rowColLimit = rowLimit * doubleColumns;
 
+    // Create normals & indices table
+    GLint *indices = 0;
+    if (changeGeometry || indicesDirty || !m_sharedIndices) {
+        int normalCount = 2 * colLimit * rowLimit;
+        if (shareIndices(SurfaceIndexBuffer::CoarseTriangles)) {
+            m_indexCount = 3 * normalCount;
+            indices = new GLint[m_indexCount];
+        }
+        m_normals.resize(normalCount);
+    }
+
+    // Normals depend on the vertices of the upper row, so all vertices are created before
+    // any normals.
+    QVector<RowBand> bands = createRowBands(dataArray, uvs, indices, polar, flipXZ, totalSize);
+    processRowBands(&SurfaceObject::createCoarseVertexBand, bands);
+    updateMinMaxY(bands);
+    processRowBands(&SurfaceObject::createCoarseNormalBand, bands);
+
+    // Create grid line element indices
+    if ((changeGeometry || !m_sharedGridIndices)
+            && shareIndices(SurfaceIndexBuffer::CoarseGridLines)) {
+        createCoarseGridlineIndices(0, 0, colLimit, rowLimit);
+    }
+
+    createBuffers(m_vertices, uvs, m_normals, indices);
+
+    delete[] indices;
+}
+
+QVector<SurfaceObject::RowBand> SurfaceObject::createRowBands(const QSurfaceDataArray &dataArray,
+                                                              QVector<QVector2D> &uvs,
+                                                              GLint *indices, bool polar,
+                                                              bool flipXZ, int vertexCount)
+{
+    int bandCount = 1;
+    if (vertexCount >= parallelSetUpThreshold) {
+        bandCount = qMin(QThread::idealThreadCount(), vertexCount / minVerticesPerBand);
+        bandCount = qBound(1, bandCount, m_rows);
+    }
+
+    RowBand band;
+    band.dataArray = &dataArray;
+    band.uvs = uvs.isEmpty() ? 0 : uvs.data();
+    band.indices = indices;
+    band.polar = polar;
+    band.flipXZ = flipXZ;
+    // Init min and max to ridiculous values
+    band.minY = 10000000.0f;
+    band.maxY = -10000000.0f;
+
+    QVector<RowBand> bands;
+    bands.reserve(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        band.startRow = m_rows * i / bandCount;
+        band.endRow = m_rows * (i + 1) / bandCount;
+        bands.append(band);
+    }
+    return bands;
+}
+
+// Calls function for each band. Bands other than the first are handed to the thread pool, and
+// the first one is processed in this thread, as are the bands for which the pool has no free
+// thread. Each band writes a separate part of the buffers, so the result is identical to
+// processing the rows serially.
+void SurfaceObject::processRowBands(RowBandFunction function, QVector<RowBand> &bands)
+{
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore done;
+    int startedCount = 0;
+    for (int i = 1; i < bands.size(); i++) {
+        SurfaceRowBandProcessor *processor = new SurfaceRowBandProcessor(this, function, bands[i],
+                                                                         &done);
+        if (pool->tryStart(processor)) {
+            startedCount++;
+        } else {
+            delete processor;
+            (this->*function)(bands[i]);
+        }
+    }
+    if (!bands.isEmpty())
+        (this->*function)(bands[0]);
+    done.acquire(startedCount);
+}
+
+void SurfaceObject::updateMinMaxY(const QVector<RowBand> &bands)
+{
     // Init min and max to ridiculous values
-    m_minY = 10000000.0;
+    m_minY = 10000000.0f;
     m_maxY = -10000000.0f;
+    foreach (const RowBand &band, bands) {
+        m_minY = qMin(band.minY, m_minY);
+        m_maxY = qMax(band.maxY, m_maxY);
+    }
+}
 
-    for (int i = 0; i < m_rows; i++) {
-        const QSurfaceDataRow &row = *dataArray.at(i);
+void SurfaceObject::createSmoothVertexBand(RowBand &band)
+{
+    GLfloat uvX = 1.0f / GLfloat(m_columns - 1);
+    GLfloat uvY = 1.0f / GLfloat(m_rows - 1);
+    int totalIndex = band.startRow * m_columns;
+
+    for (int i = band.startRow; i < band.endRow; i++) {
+        const QSurfaceDataRow &p = *band.dataArray->at(i);
         for (int j = 0; j < m_columns; j++) {
-            getNormalizedVertex(row.at(j), m_vertices[totalIndex], polar, flipXZ);
-            if (changeGeometry)
-                uvs[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
+            QVector3D &vertex = m_vertices[totalIndex];
+            normalizeVertex(p.at(j), vertex, band.polar, band.flipXZ);
+            band.minY = qMin(vertex.y(), band.minY);
+            band.maxY = qMax(vertex.y(), band.maxY);
+            if (band.flipXZ) {
+                vertex.setX(-vertex.x());
+                vertex.setZ(-vertex.z());
+            }
+            if (band.uvs)
+                band.uvs[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
+            totalIndex++;
+        }
+    }
+}
+
+void SurfaceObject::createSmoothNormalBand(RowBand &band)
+{
+    // The last row in the data direction has no upper neighbor, so it uses the upper line normals
+    bool upwards = (m_dataDimension == BothAscending) || (m_dataDimension == XDescending);
+    int upperLineRow = upwards ? m_rows - 1 : 0;
+    int totalIndex = band.startRow * m_columns;
+
+    for (int row = band.startRow; row < band.endRow; row++) {
+        if (row == upperLineRow)
+            createSmoothNormalUpperLine(totalIndex);
+        else
+            createSmoothNormalBodyLine(totalIndex, row * m_columns);
+    }
+}
+
+void SurfaceObject::createCoarseVertexBand(RowBand &band)
+{
+    GLfloat uvX = 1.0f / GLfloat(m_columns - 1);
+    GLfloat uvY = 1.0f / GLfloat(m_rows - 1);
+    int colLimit = m_columns - 1;
+    int doubleColumns = m_columns * 2 - 2;
+    int totalIndex = band.startRow * doubleColumns;
+
+    for (int i = band.startRow; i < band.endRow; i++) {
+        const QSurfaceDataRow &row = *band.dataArray->at(i);
+        for (int j = 0; j < m_columns; j++) {
+            QVector3D &vertex = m_vertices[totalIndex];
+            normalizeVertex(row.at(j), vertex, band.polar, band.flipXZ);
+            band.minY = qMin(vertex.y(), band.minY);
+            band.maxY = qMax(vertex.y(), band.maxY);
+            if (band.flipXZ) {
+                vertex.setX(-vertex.x());
+                vertex.setZ(-vertex.z());
+            }
+            if (band.uvs)
+                band.uvs[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
 
             totalIndex++;
 
             if (j > 0 && j < colLimit) {
                 m_vertices[totalIndex] = m_vertices[totalIndex - 1];
-                if (changeGeometry)
-                    uvs[totalIndex] = uvs[totalIndex - 1];
+                if (band.uvs)
+                    band.uvs[totalIndex] = band.uvs[totalIndex - 1];
                 totalIndex++;
             }
         }
     }
+}
 
-    if (flipXZ) {
-        for (int i = 0; i < m_vertices.size(); i++) {
-            m_vertices[i].setX(-m_vertices.at(i).x());
-            m_vertices[i].setZ(-m_vertices.at(i).z());
-        }
-    }
-
-    // Create normals & indices table
-    GLint *indices = 0;
-    if (changeGeometry || indicesDirty) {
-        int normalCount = 2 * colLimit * rowLimit;
-        m_indexCount = 3 * normalCount;
-        indices = new GLint[m_indexCount];
-        m_normals.resize(normalCount);
-    }
+void SurfaceObject::createCoarseNormalBand(RowBand &band)
+{
+    // The topmost row has no normals
+    int endRow = qMin(band.endRow, m_rows - 1);
+    int doubleColumns = m_columns * 2 - 2;
 
-    int p = 0;
-    totalIndex = 0;
-    for (int row = 0, upperRow = doubleColumns;
-         row < rowColLimit;
-         row += doubleColumns, upperRow += doubleColumns) {
+    for (int i = band.startRow; i < endRow; i++) {
+        int row = i * doubleColumns;
+        int upperRow = row + doubleColumns;
+        int totalIndex = row;
+        int p = row * 3; // Six indices for each pair of normals
         for (int j = 0; j < doubleColumns; j += 2) {
             createNormals(totalIndex, row, upperRow, j);
 
-            if (changeGeometry || indicesDirty) {
-                createCoarseIndices(indices, p, row, upperRow, j);
-            }
+            if (band.indices)
+                createCoarseIndices(band.indices, p, row, upperRow, j);
         }
     }
+}
 
-    // Create grid line element indices
-    if (changeGeometry)
-        createCoarseGridlineIndices(0, 0, colLimit, rowLimit);
-
-    createBuffers(m_vertices, uvs, m_normals, indices);
+void SurfaceObject::createHeightFieldBand(RowBand &band)
+{
+    GLfloat uvX = 1.0f / GLfloat(m_columns - 1);
+    GLfloat uvY = 1.0f / GLfloat(m_rows - 1);
+    int totalIndex = band.startRow * m_columns;
+    float *heights = m_heights.data();
 
-    delete[] indices;
+    for (int i = band.startRow; i < band.endRow; i++) {
+        const QSurfaceDataRow &p = *band.dataArray->at(i);
+        for (int j = 0; j < m_columns; j++) {
+            float y = m_axisCacheY.positionAt(p.at(j).y());
+            band.minY = qMin(y, band.minY);
+            band.maxY = qMax(y, band.maxY);
+            heights[totalIndex] = y;
+            if (band.uvs)
+                band.uvs[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
+            totalIndex++;
+        }
+    }
 }
 
 void SurfaceObject::coarseUVs(const QSurfaceDataArray &dataArray,
@@ -679,6 +1079,7 @@ void SurfaceObject::updateCoarseRow(const QSurfaceDataArray &dataArray, int rowI
     p = rowIndex * doubleColumns;
     if (p > 0)
         p -= doubleColumns;
+    const int dirtyStart = p;
     int rowLimit = (rowIndex + 1) * doubleColumns;
     if (rowIndex == m_rows - 1)
         rowLimit = rowIndex * doubleColumns; //Topmost row, no normals
@@ -688,6 +1089,8 @@ void SurfaceObject::updateCoarseRow(const QSurfaceDataArray &dataArray, int rowI
         for (int j = 0; j < doubleColumns; j += 2)
             createNormals(p, row, upperRow, j);
     }
+
+    addDirtySpan(dirtyStart, (rowIndex + 1) * doubleColumns);
 }
 
 void SurfaceObject::updateCoarseItem(const QSurfaceDataArray &dataArray, int row, int column,
@@ -698,6 +1101,7 @@ void SurfaceObject::updateCoarseItem(const QSurfaceDataArray &dataArray, int row
 
     // Update a vertice
     int p = row * doubleColumns + column * 2 - (column > 0);
+    const int vertexIndex = p;
     getNormalizedVertex(dataArray.at(row)->at(column), m_vertices[p++], polar, false);
 
     if (column > 0 && column < colLimit)
@@ -721,6 +1125,9 @@ void SurfaceObject::updateCoarseItem(const QSurfaceDataArray &dataArray, int row
             createNormals(p, i * doubleColumns, (i + 1) * doubleColumns, j * 2);
         }
     }
+
+    addDirtySpan(qMin(vertexIndex, startRow * doubleColumns + startCol * 2),
+                 qMax(vertexIndex + 2, row * doubleColumns + column * 2 + 2));
 }
 
 void SurfaceObject::createCoarseSubSection(int x, int y, int columns, int rows)
@@ -749,11 +1156,8 @@ void SurfaceObject::createCoarseSubSection(int x, int y, int columns, int rows)
             createCoarseIndices(indices, p, row, upperRow, j);
     }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexCount * sizeof(GLint),
-                 indices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    m_sharedIndices->upload(indices, m_indexCount, 2 * m_columns * m_rows);
+    useIndices(m_sharedIndices);
 
     delete[] indices;
 }
@@ -798,11 +1202,8 @@ void SurfaceObject::createCoarseGridlineIndices(int x, int y, int endX, int endY
         gridIndices[p++] = i  + doubleColumns;
     }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_gridElementbuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_gridIndexCount * sizeof(GLint),
-                 gridIndices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    m_sharedGridIndices->upload(gridIndices, m_gridIndexCount, 2 * m_columns * m_rows, GL_LINES);
+    useGridIndices(m_sharedGridIndices);
 
     delete[] gridIndices;
 }
@@ -813,6 +1214,251 @@ void SurfaceObject::uploadBuffers()
     createBuffers(m_vertices, uvs, m_normals, 0);
 }
 
+// Uploads the vertices and normals changed by the row and item updates since the last upload.
+// Overlapping and adjacent spans are combined, so each changed region is uploaded only once.
+void SurfaceObject::uploadDirtyBuffers()
+{
+    if (m_dirtySpans.isEmpty())
+        return;
+
+    // The buffers must be reallocated if their size has changed since the last upload
+    if (m_uploadedVertexCount != m_vertices.size() || m_uploadedNormalCount != m_normals.size()) {
+        uploadBuffers();
+        return;
+    }
+
+    std::sort(m_dirtySpans.begin(), m_dirtySpans.end());
+    int mergedCount = 0;
+    int dirtyVertexCount = 0;
+    for (int i = 0; i < m_dirtySpans.size(); i++) {
+        const DirtySpan &span = m_dirtySpans.at(i);
+        if (mergedCount && span.start <= m_dirtySpans.at(mergedCount - 1).end) {
+            DirtySpan &previous = m_dirtySpans[mergedCount - 1];
+            dirtyVertexCount += qMax(0, span.end - previous.end);
+            previous.end = qMax(previous.end, span.end);
+        } else {
+            dirtyVertexCount += span.end - span.start;
+            m_dirtySpans[mergedCount++] = span;
+        }
+    }
+    m_dirtySpans.resize(mergedCount);
+
+    // Reuploading everything in one call is cheaper than many spans covering most of the data
+    if (dirtyVertexCount > m_vertices.size() / 2) {
+        uploadBuffers();
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
+    foreach (const DirtySpan &span, m_dirtySpans) {
+        glBufferSubData(GL_ARRAY_BUFFER, span.start * sizeof(QVector3D),
+                        (span.end - span.start) * sizeof(QVector3D), &m_vertices.at(span.start));
+    }
+
+    // Flat shaded surfaces have no normals for the topmost row
+    glBindBuffer(GL_ARRAY_BUFFER, m_normalbuffer);
+    foreach (const DirtySpan &span, m_dirtySpans) {
+        const int end = qMin(span.end, m_normals.size());
+        if (end > span.start) {
+            glBufferSubData(GL_ARRAY_BUFFER, span.start * sizeof(QVector3D),
+                            (end - span.start) * sizeof(QVector3D), &m_normals.at(span.start));
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_dirtySpans.clear();
+}
+
+void SurfaceObject::addDirtySpan(int start, int end)
+{
+    DirtySpan span;
+    span.start = qMax(0, start);
+    span.end = qMin(end, m_vertices.size());
+    if (span.end > span.start)
+        m_dirtySpans.append(span);
+}
+
+void SurfaceObject::setLevelOfDetailEnabled(bool enabled)
+{
+    if (enabled == isLevelOfDetailEnabled())
+        return;
+
+    if (enabled) {
+        m_levelOfDetail = new SurfaceLevelOfDetail;
+    } else {
+        delete m_levelOfDetail;
+        m_levelOfDetail = 0;
+    }
+}
+
+// Selects the level of detail tiles of smooth and height field surfaces for the view, and
+// replaces the indices if the selection changed
+void SurfaceObject::updateLevelOfDetail(const QMatrix4x4 &viewProjectionMatrix, float pixelScale)
+{
+    if (!m_levelOfDetail || (m_surfaceType != SurfaceSmooth
+                             && m_surfaceType != SurfaceHeightField)) {
+        return;
+    }
+
+    const bool rebuild = m_levelOfDetail->isDirty();
+    if (rebuild)
+        m_levelOfDetail->build(*this);
+    if (!m_levelOfDetail->select(viewProjectionMatrix, pixelScale) && !rebuild)
+        return;
+
+    QVector<GLint> indices;
+    QVector<GLint> gridIndices;
+    m_levelOfDetail->createIndices(m_dataDimension, indices, gridIndices);
+
+    // The tiles are drawn from element buffers of their own
+    if (!m_detailIndices) {
+        m_detailIndices = new SurfaceIndexBuffer;
+        m_detailGridIndices = new SurfaceIndexBuffer;
+    }
+    releaseSharedIndices();
+
+    // The tiles index the vertices of the whole grid, so they can use short indices only if
+    // the whole grid fits
+    const int vertexCount = m_columns * m_rows;
+    m_detailIndices->upload(indices.constData(), indices.size(), vertexCount, GL_TRIANGLES,
+                            GL_DYNAMIC_DRAW);
+    m_detailGridIndices->upload(gridIndices.constData(), gridIndices.size(), vertexCount,
+                                GL_LINES, GL_DYNAMIC_DRAW);
+    useIndices(m_detailIndices);
+    useGridIndices(m_detailGridIndices);
+}
+
+// Uploads a part of the height texture. The part must either span whole rows or lie within
+// a single row, as it is uploaded directly from the height array.
+void SurfaceObject::uploadHeights(int column, int row, int width, int height, bool allocate)
+{
+#if defined(QT_OPENGL_ES_2)
+    Q_UNUSED(column)
+    Q_UNUSED(row)
+    Q_UNUSED(width)
+    Q_UNUSED(height)
+    Q_UNUSED(allocate)
+#else
+    if (!m_heightTexture) {
+        glGenTextures(1, &m_heightTexture);
+        allocate = true;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_heightTexture);
+    if (allocate) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, m_columns, m_rows, 0, GL_RED, GL_FLOAT,
+                     m_heights.constData());
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, column, row, width, height, GL_RED, GL_FLOAT,
+                        m_heights.constData() + row * m_columns + column);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+#endif
+}
+
+// Switches to the shared indices of the given type for the current grid. Returns true if no
+// other surface has created the indices yet, in which case the caller creates and uploads them.
+bool SurfaceObject::shareIndices(SurfaceIndexBuffer::IndexType type)
+{
+    const bool gridLines = type == SurfaceIndexBuffer::SmoothGridLines
+            || type == SurfaceIndexBuffer::CoarseGridLines;
+    SurfaceIndexBuffer::Key key;
+    key.type = type;
+    key.columns = m_columns;
+    key.rows = m_rows;
+    // Grid lines are the same regardless of the data directions
+    key.dataDimension = gridLines ? 0 : int(m_dataDimension);
+
+    // The new buffer is acquired before the old one is released, so that a buffer with the same
+    // key is not deleted and created again
+    SurfaceIndexBuffer *&shared = gridLines ? m_sharedGridIndices : m_sharedIndices;
+    SurfaceIndexBuffer *buffer = SurfaceIndexBuffer::getIndexBuffer(m_renderer, key);
+    SurfaceIndexBuffer::releaseIndexBuffer(m_renderer, shared);
+    shared = buffer;
+
+    if (gridLines)
+        useGridIndices(buffer);
+    else
+        useIndices(buffer);
+    return !buffer->indexCount();
+}
+
+// Releases the shared indices, leaving the surface without indices until new ones are created
+void SurfaceObject::releaseSharedIndices()
+{
+    SurfaceIndexBuffer::releaseIndexBuffer(m_renderer, m_sharedIndices);
+    SurfaceIndexBuffer::releaseIndexBuffer(m_renderer, m_sharedGridIndices);
+    useIndices(0);
+    useGridIndices(0);
+}
+
+// Draws the surface from the given indices
+void SurfaceObject::useIndices(const SurfaceIndexBuffer *indices)
+{
+    m_elementbuffer = indices ? indices->buffer() : 0;
+    m_indexCount = indices ? indices->indexCount() : 0;
+    m_indexType = indices ? indices->indexType() : GLenum(GL_UNSIGNED_INT);
+    m_primitiveMode = indices ? indices->primitiveMode() : GLenum(GL_TRIANGLES);
+}
+
+void SurfaceObject::useGridIndices(const SurfaceIndexBuffer *gridIndices)
+{
+    m_gridElementbuffer = gridIndices ? gridIndices->buffer() : 0;
+    m_gridIndexCount = gridIndices ? gridIndices->indexCount() : 0;
+    m_gridIndexType = gridIndices ? gridIndices->indexType() : GLenum(GL_UNSIGNED_INT);
+}
+
+void SurfaceObject::releaseHeightField()
+{
+    if (m_heightTexture) {
+        glDeleteTextures(1, &m_heightTexture);
+        m_heightTexture = 0;
+    }
+    m_heights.clear();
+    m_heights.squeeze();
+    m_heightRowOffset = 0;
+    m_gridColumnX.clear();
+    m_gridRowZ.clear();
+}
+
+// Frees the vertices and normals, which height field surfaces don't use
+void SurfaceObject::releaseVertexBuffers()
+{
+    m_vertices.clear();
+    m_vertices.squeeze();
+    m_normals.clear();
+    m_normals.squeeze();
+    m_dirtySpans.clear();
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
+    glBufferData(GL_ARRAY_BUFFER, 0, 0, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, m_normalbuffer);
+    glBufferData(GL_ARRAY_BUFFER, 0, 0, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_uploadedVertexCount = 0;
+    m_uploadedNormalCount = 0;
+}
+
+QVector2D SurfaceObject::gridNeighbor() const
+{
+    // Direction of increasing data values in the grid, in which the normals are calculated
+    return QVector2D(m_dataDimension.testFlag(XDescending) ? -1.0f : 1.0f,
+                     m_dataDimension.testFlag(ZDescending) ? -1.0f : 1.0f);
+}
+
+QVector4D SurfaceObject::uvRect() const
+{
+    if (m_returnTextureBuffer)
+        return m_textureUVRect;
+    return QVector4D(0.0f, 0.0f, 1.0f, 1.0f);
+}
+
 void SurfaceObject::createBuffers(const QVector<QVector3D> &vertices, const QVector<QVector2D> &uvs,
                                   const QVector<QVector3D> &normals, const GLint *indices)
 {
@@ -831,14 +1477,16 @@ void SurfaceObject::createBuffers(const QVector<QVector3D> &vertices, const QVec
                      &uvs.at(0), GL_STATIC_DRAW);
     }
 
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
     if (indices) {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexCount * sizeof(GLint),
-                     indices, GL_STATIC_DRAW);
+        m_sharedIndices->upload(indices, m_indexCount, vertices.size());
+        useIndices(m_sharedIndices);
     }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_uploadedVertexCount = vertices.size();
+    m_uploadedNormalCount = normals.size();
+    m_dirtySpans.clear();
 
     m_meshDataLoaded = true;
 }
@@ -860,6 +1508,16 @@ void SurfaceObject::checkDirections(const QSurfaceDataArray &array)
 
 void SurfaceObject::getNormalizedVertex(const QSurfaceDataItem &data, QVector3D &vertex,
                                         bool polar, bool flipXZ)
+{
+    normalizeVertex(data, vertex, polar, flipXZ);
+    m_minY = qMin(vertex.y(), m_minY);
+    m_maxY = qMax(vertex.y(), m_maxY);
+}
+
+// Unlike getNormalizedVertex(), doesn't update the minimum and maximum Y values, so it can be
+// called from several threads at once.
+void SurfaceObject::normalizeVertex(const QSurfaceDataItem &data, QVector3D &vertex,
+                                    bool polar, bool flipXZ) const
 {
     float normalizedX;
     float normalizedZ;
@@ -876,8 +1534,6 @@ void SurfaceObject::getNormalizedVertex(const QSurfaceDataItem &data, QVector3D
         }
     }
     float normalizedY = m_axisCacheY.positionAt(data.y());
-    m_minY = qMin(normalizedY, m_minY);
-    m_maxY = qMax(normalizedY, m_maxY);
     vertex.setX(normalizedX);
     vertex.setY(normalizedY);
     vertex.setZ(normalizedZ);
@@ -908,24 +1564,24 @@ GLuint SurfaceObject::gridIndexCount()
 
 QVector3D SurfaceObject::vertexAt(int column, int row)
 {
-    int pos = 0;
-    if (m_surfaceType == Undefined || !m_vertices.size())
+    if (m_surfaceType == Undefined
+            || (m_surfaceType != SurfaceHeightField && !m_vertices.size())) {
         return zeroVector;
+    }
 
-    if (m_surfaceType == SurfaceFlat)
-        pos = row * (m_columns * 2 - 2) + column * 2 - (column > 0);
-    else
-        pos = row * m_columns + column;
-    return m_vertices.at(pos);
+    return gridPosition(column, row);
 }
 
 void SurfaceObject::clear()
 {
-    m_gridIndexCount = 0;
-    m_indexCount = 0;
+    releaseSharedIndices();
     m_surfaceType = Undefined;
     m_vertices.clear();
     m_normals.clear();
+    m_dirtySpans.clear();
+    releaseHeightField();
+    if (m_levelOfDetail)
+        m_levelOfDetail->setDirty();
 }
 
 void SurfaceObject::createCoarseIndices(GLint *indices, int &p, int row, int upperRow, int j)
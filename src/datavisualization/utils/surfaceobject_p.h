@@ -42,14 +42,19 @@
 
 #include "datavisualizationglobal_p.h"
 #include "abstractobjecthelper_p.h"
+#include "surfaceindexbuffer_p.h"
 #include "qsurfacedataproxy.h"
 
 #include <QtCore/QRect>
+#include <QtGui/QMatrix4x4>
+#include <QtGui/QVector2D>
+#include <QtGui/QVector4D>
 
 QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 
 class Surface3DRenderer;
 class AxisRenderCache;
+class SurfaceLevelOfDetail;
 
 class SurfaceObject : public AbstractObjectHelper
 {
@@ -57,6 +62,7 @@ public:
     enum SurfaceType {
         SurfaceSmooth,
         SurfaceFlat,
+        SurfaceHeightField,
         Undefined
     };
 
@@ -76,27 +82,76 @@ public:
                    bool changeGeometry, bool polar, bool flipXZ = false);
     void setUpSmoothData(const QSurfaceDataArray &dataArray, const QRect &space,
                          bool changeGeometry, bool polar, bool flipXZ = false);
+    bool setUpHeightFieldData(const QSurfaceDataArray &dataArray, const QRect &space,
+                              bool changeGeometry);
     void smoothUVs(const QSurfaceDataArray &dataArray, const QSurfaceDataArray &modelArray);
     void coarseUVs(const QSurfaceDataArray &dataArray, const QSurfaceDataArray &modelArray);
     void updateCoarseRow(const QSurfaceDataArray &dataArray, int rowIndex, bool polar);
     void updateSmoothRow(const QSurfaceDataArray &dataArray, int startRow, bool polar);
     void updateSmoothItem(const QSurfaceDataArray &dataArray, int row, int column, bool polar);
     void updateCoarseItem(const QSurfaceDataArray &dataArray, int row, int column, bool polar);
+    bool updateHeightFieldRow(const QSurfaceDataArray &dataArray, int rowIndex);
+    bool updateHeightFieldItem(const QSurfaceDataArray &dataArray, int row, int column);
+    bool scrollHeightFieldRows(const QSurfaceDataArray &dataArray, int count);
     void createSmoothIndices(int x, int y, int endX, int endY);
     void createCoarseSubSection(int x, int y, int columns, int rows);
     void createSmoothGridlineIndices(int x, int y, int endX, int endY);
     void createCoarseGridlineIndices(int x, int y, int endX, int endY);
     void uploadBuffers();
+    void uploadDirtyBuffers();
     GLuint gridElementBuf();
     GLuint uvBuf();
     GLuint gridIndexCount();
+    inline GLenum gridIndexType() const { return m_gridIndexType; }
     QVector3D vertexAt(int column, int row);
     void clear();
     float minYValue() const { return m_minY; }
     float maxYValue() const { return m_maxY; }
     inline void activateSurfaceTexture(bool value) { m_returnTextureBuffer = value; }
+    inline SurfaceType surfaceType() const { return m_surfaceType; }
+    void setLevelOfDetailEnabled(bool enabled);
+    inline bool isLevelOfDetailEnabled() const { return m_levelOfDetail; }
+    void updateLevelOfDetail(const QMatrix4x4 &viewProjectionMatrix, float pixelScale);
+
+    inline DataDimensions dataDimension() const { return m_dataDimension; }
+
+    // Position of a vertex of the surface grid
+    inline QVector3D gridPosition(int column, int row) const
+    {
+        if (m_surfaceType == SurfaceHeightField) {
+            return QVector3D(m_gridOrigin.x() + GLfloat(column) * m_gridStep.x(),
+                             m_heights.at(heightFieldRow(row) * m_columns + column),
+                             m_gridOrigin.y() + GLfloat(row) * m_gridStep.y());
+        }
+        if (m_surfaceType == SurfaceFlat)
+            return m_vertices.at(row * (m_columns * 2 - 2) + column * 2 - (column > 0));
+        return m_vertices.at(row * m_columns + column);
+    }
+
+    // Height field surfaces have no vertex or normal buffers. Their vertices are reconstructed
+    // in the vertex shader from the height texture and the grid coordinates in gridUVBuf().
+    inline GLuint heightTexture() const { return m_heightTexture; }
+    inline int heightRowOffset() const { return m_heightRowOffset; }
+    inline GLuint gridUVBuf() const { return m_uvbuffer; }
+    inline QVector2D gridSize() const { return QVector2D(m_columns, m_rows); }
+    inline const QVector2D &gridOrigin() const { return m_gridOrigin; }
+    inline const QVector2D &gridStep() const { return m_gridStep; }
+    QVector2D gridNeighbor() const;
+    QVector4D uvRect() const;
 
 private:
+    struct RowBand;
+    typedef void (SurfaceObject::*RowBandFunction)(RowBand &band);
+
+    QVector<RowBand> createRowBands(const QSurfaceDataArray &dataArray, QVector<QVector2D> &uvs,
+                                   GLint *indices, bool polar, bool flipXZ, int vertexCount);
+    void processRowBands(RowBandFunction function, QVector<RowBand> &bands);
+    void updateMinMaxY(const QVector<RowBand> &bands);
+    void createSmoothVertexBand(RowBand &band);
+    void createSmoothNormalBand(RowBand &band);
+    void createCoarseVertexBand(RowBand &band);
+    void createCoarseNormalBand(RowBand &band);
+    void createHeightFieldBand(RowBand &band);
     void createCoarseIndices(GLint *indices, int &p, int row, int upperRow, int j);
     void createNormals(int &p, int row, int upperRow, int j);
     void createSmoothNormalBodyLine(int &totalIndex, int column);
@@ -109,6 +164,27 @@ private:
     void checkDirections(const QSurfaceDataArray &array);
     inline void getNormalizedVertex(const QSurfaceDataItem &data, QVector3D &vertex, bool polar,
                                     bool flipXZ);
+    inline void normalizeVertex(const QSurfaceDataItem &data, QVector3D &vertex, bool polar,
+                                bool flipXZ) const;
+    void addDirtySpan(int start, int end);
+    bool shareIndices(SurfaceIndexBuffer::IndexType type);
+    void releaseSharedIndices();
+    void useIndices(const SurfaceIndexBuffer *indices);
+    void useGridIndices(const SurfaceIndexBuffer *gridIndices);
+    void uploadHeights(int column, int row, int width, int height, bool allocate = false);
+    // Row of the height texture that holds the heights of a row of the grid
+    inline int heightFieldRow(int row) const { return (row + m_heightRowOffset) % m_rows; }
+    void releaseHeightField();
+    void releaseVertexBuffers();
+
+    // Range of vertex indices, from start up to but not including end, whose vertices or
+    // normals have changed since the last upload. Normals share the vertex indexing.
+    struct DirtySpan {
+        int start;
+        int end;
+
+        inline bool operator<(const DirtySpan &other) const { return start < other.start; }
+    };
 
 private:
     SurfaceType m_surfaceType;
@@ -116,8 +192,12 @@ private:
     int m_rows;
     GLuint m_gridElementbuffer;
     GLuint m_gridIndexCount;
+    GLenum m_gridIndexType;
     QVector<QVector3D> m_vertices;
     QVector<QVector3D> m_normals;
+    QVector<DirtySpan> m_dirtySpans;
+    int m_uploadedVertexCount;
+    int m_uploadedNormalCount;
     // Caches are not owned
     AxisRenderCache &m_axisCacheX;
     AxisRenderCache &m_axisCacheY;
@@ -129,6 +209,24 @@ private:
     bool m_returnTextureBuffer;
     SurfaceObject::DataDimensions m_dataDimension;
     SurfaceObject::DataDimensions m_oldDataDimension;
+    GLuint m_heightTexture;
+    QVector<float> m_heights;
+    int m_heightRowOffset; // Row of the height texture that holds the first row of the grid
+    QVector<float> m_gridColumnX; // Data X values of the columns of a height field
+    QVector<float> m_gridRowZ; // Data Z values of the rows of a height field
+    QVector2D m_gridOrigin;
+    QVector2D m_gridStep;
+    QVector4D m_textureUVRect;
+    SurfaceLevelOfDetail *m_levelOfDetail;
+    // Indices of the whole grid are shared with the other surfaces of the renderer, and
+    // m_elementbuffer and m_gridElementbuffer refer to the shared buffers. The level of detail
+    // tiles change with the view, so their indices are kept in buffers of their own.
+    SurfaceIndexBuffer *m_sharedIndices;
+    SurfaceIndexBuffer *m_sharedGridIndices;
+    SurfaceIndexBuffer *m_detailIndices;
+    SurfaceIndexBuffer *m_detailGridIndices;
+
+    friend class SurfaceRowBandProcessor;
 };
 
 QT_END_NAMESPACE_DATAVISUALIZATION
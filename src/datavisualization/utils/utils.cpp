@@ -43,6 +43,9 @@ QT_BEGIN_NAMESPACE_DATAVISUALIZATION
 static bool staticsResolved = false;
 static GLint maxTextureSize = 0;
 static bool isES = false;
+static bool isInstancing = false;
+static bool isHeightField = false;
+static bool isPrimitiveRestart = false;
 
 GLuint Utils::getNearestPowerOfTwo(GLuint value)
 {
@@ -335,6 +338,34 @@ bool Utils::isOpenGLES()
     return isES;
 }
 
+bool Utils::isInstancingSupported()
+{
+    if (!staticsResolved)
+        resolveStatics();
+    return isInstancing;
+}
+
+bool Utils::isHeightFieldSupported()
+{
+    if (!staticsResolved)
+        resolveStatics();
+    return isHeightField;
+}
+
+bool Utils::isPrimitiveRestartSupported()
+{
+    if (!staticsResolved)
+        resolveStatics();
+    return isPrimitiveRestart;
+}
+
+GLint Utils::maximumTextureSize()
+{
+    if (!staticsResolved)
+        resolveStatics();
+    return maxTextureSize;
+}
+
 void Utils::resolveStatics()
 {
     QOpenGLContext *ctx = QOpenGLContext::currentContext();
@@ -360,6 +391,30 @@ void Utils::resolveStatics()
 
     ctx->functions()->glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
 
+    // Instanced drawing is core in OpenGL 3.3 and OpenGL ES 3.0
+    const QPair<int, int> glVersion = ctx->format().version();
+    if (isES)
+        isInstancing = glVersion >= qMakePair(3, 0);
+    else
+        isInstancing = glVersion >= qMakePair(3, 3);
+
+    // Height field surfaces sample single channel float textures in the vertex shader, which
+    // needs OpenGL 3.0. The shaders use desktop GLSL, so OpenGL ES is not supported.
+    if (!isES) {
+        GLint vertexTextureUnits = 0;
+        ctx->functions()->glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &vertexTextureUnits);
+        isHeightField = glVersion >= qMakePair(3, 0) && vertexTextureUnits > 0;
+    }
+
+    // Restarting primitives at the largest index value is core in OpenGL 4.3, where it needs
+    // to be enabled, and always enabled in OpenGL ES 3.0
+    if (isES) {
+        isPrimitiveRestart = glVersion >= qMakePair(3, 0);
+    } else {
+        isPrimitiveRestart = glVersion >= qMakePair(4, 3)
+                || ctx->hasExtension(QByteArrayLiteral("GL_ARB_ES3_compatibility"));
+    }
+
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 4, 0))
     // We support only ES2 emulation with software renderer for now
     QString versionStr;
@@ -371,6 +426,9 @@ void Utils::resolveStatics()
             || QCoreApplication::testAttribute(Qt::AA_UseSoftwareOpenGL)) {
         qWarning("Only OpenGL ES2 emulation is available for software rendering.");
         isES = true;
+        isInstancing = false;
+        isHeightField = false;
+        isPrimitiveRestart = false;
     }
 #endif
 
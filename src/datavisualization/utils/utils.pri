@@ -7,9 +7,18 @@ HEADERS += $$PWD/meshloader_p.h \
            $$PWD/utils_p.h \
            $$PWD/abstractobjecthelper_p.h \
            $$PWD/surfaceobject_p.h \
+           $$PWD/surfacenormals_p.h \
+           $$PWD/surfacelevelofdetail_p.h \
+           $$PWD/surfaceheighthierarchy_p.h \
+           $$PWD/surfaceindexbuffer_p.h \
            $$PWD/qutils.h \
            $$PWD/scatterobjectbufferhelper_p.h \
-           $$PWD/scatterpointbufferhelper_p.h
+           $$PWD/scatterpointbufferhelper_p.h \
+           $$PWD/scatterinstancebufferhelper_p.h \
+           $$PWD/barinstancebufferhelper_p.h \
+           $$PWD/scatteritemoctree_p.h \
+           $$PWD/scatterlevelofdetail_p.h \
+           $$PWD/itemtransform_p.h
 
 SOURCES += $$PWD/meshloader.cpp \
            $$PWD/vertexindexer.cpp \
@@ -20,7 +29,19 @@ SOURCES += $$PWD/meshloader.cpp \
            $$PWD/utils.cpp \
            $$PWD/abstractobjecthelper.cpp \
            $$PWD/surfaceobject.cpp \
+           $$PWD/surfacenormals.cpp \
+           $$PWD/surfacelevelofdetail.cpp \
+           $$PWD/surfaceheighthierarchy.cpp \
+           $$PWD/surfaceindexbuffer.cpp \
            $$PWD/scatterobjectbufferhelper.cpp \
-           $$PWD/scatterpointbufferhelper.cpp
+           $$PWD/scatterpointbufferhelper.cpp \
+           $$PWD/scatterinstancebufferhelper.cpp \
+           $$PWD/barinstancebufferhelper.cpp \
+           $$PWD/scatteritemoctree.cpp \
+           $$PWD/scatterlevelofdetail.cpp \
+           $$PWD/itemtransform.cpp
+
+SSE2_SOURCES += $$PWD/surfacenormals_sse2.cpp
+AVX_SOURCES += $$PWD/surfacenormals_avx.cpp
 
 INCLUDEPATH += $$PWD
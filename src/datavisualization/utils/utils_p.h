@@ -81,6 +81,10 @@ public:
     static float wrapValue(float value, float min, float max);
     static QQuaternion calculateRotation(const QVector3D &xyzRotations);
     static bool isOpenGLES();
+    static bool isInstancingSupported();
+    static bool isHeightFieldSupported();
+    static bool isPrimitiveRestartSupported();
+    static GLint maximumTextureSize();
     static void resolveStatics();
 
 private:
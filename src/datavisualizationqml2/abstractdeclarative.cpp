@@ -348,6 +348,8 @@ void AbstractDeclarative::setSharedController(Abstract3DController *controller)
                      &AbstractDeclarative::queriedGraphPositionChanged);
     QObject::connect(m_controller.data(), &Abstract3DController::marginChanged, this,
                      &AbstractDeclarative::marginChanged);
+    QObject::connect(m_controller.data(), &Abstract3DController::rayCastPickingChanged, this,
+                     &AbstractDeclarative::rayCastPickingChanged);
 }
 
 void AbstractDeclarative::activateOpenGLContext(QQuickWindow *window)
@@ -840,6 +842,16 @@ qreal AbstractDeclarative::margin() const
     return m_controller->margin();
 }
 
+void AbstractDeclarative::setRayCastPicking(bool enable)
+{
+    m_controller->setRayCastPicking(enable);
+}
+
+bool AbstractDeclarative::isRayCastPicking() const
+{
+    return m_controller->isRayCastPicking();
+}
+
 void AbstractDeclarative::windowDestroyed(QObject *obj)
 {
     // Remove destroyed window from window lists
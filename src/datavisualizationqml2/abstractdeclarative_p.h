@@ -91,6 +91,7 @@ class AbstractDeclarative : public QQuickItem
     Q_PROPERTY(QLocale locale READ locale WRITE setLocale NOTIFY localeChanged REVISION 2)
     Q_PROPERTY(QVector3D queriedGraphPosition READ queriedGraphPosition NOTIFY queriedGraphPositionChanged REVISION 2)
     Q_PROPERTY(qreal margin READ margin WRITE setMargin NOTIFY marginChanged REVISION 2)
+    Q_PROPERTY(bool rayCastPicking READ isRayCastPicking WRITE setRayCastPicking NOTIFY rayCastPickingChanged REVISION 3)
 
 public:
     enum SelectionFlag {
@@ -235,6 +236,9 @@ public:
     void setMargin(qreal margin);
     qreal margin() const;
 
+    void setRayCastPicking(bool enable);
+    bool isRayCastPicking() const;
+
     QMutex *mutex() { return &m_mutex; }
 
 public Q_SLOTS:
@@ -285,6 +289,7 @@ Q_SIGNALS:
     Q_REVISION(2) void localeChanged(const QLocale &locale);
     Q_REVISION(2) void queriedGraphPositionChanged(const QVector3D &data);
     Q_REVISION(2) void marginChanged(qreal margin);
+    Q_REVISION(3) void rayCastPickingChanged(bool enabled);
 
 protected:
     QSharedPointer<QMutex> m_nodeMutex;
@@ -142,6 +142,24 @@ void QtDataVisualizationQml2Plugin::registerTypes(const char *uri)
 
     // New revisions
     qmlRegisterType<Q3DLight, 1>(uri, 1, 3, "Light3D");
+
+    // QtDataVisualization 1.4
+
+    // New revisions
+    qmlRegisterUncreatableType<AbstractDeclarative, 3>(uri, 1, 4, "AbstractGraph3D",
+                                                       QLatin1String("Trying to create uncreatable: AbstractGraph3D."));
+    qmlRegisterUncreatableType<QScatter3DSeries, 1>(uri, 1, 4, "QScatter3DSeries",
+                                                    QLatin1String("Trying to create uncreatable: QScatter3DSeries, use Scatter3DSeries instead."));
+    qmlRegisterType<DeclarativeScatter3DSeries, 1>(uri, 1, 4, "Scatter3DSeries");
+    qmlRegisterUncreatableType<QScatterDataProxy, 1>(uri, 1, 4, "ScatterDataProxy",
+                                                     QLatin1String("Trying to create uncreatable: ScatterDataProxy."));
+    qmlRegisterType<QItemModelScatterDataProxy, 1>(uri, 1, 4, "ItemModelScatterDataProxy");
+    qmlRegisterUncreatableType<QSurface3DSeries, 1>(uri, 1, 4, "QSurface3DSeries",
+                                                    QLatin1String("Trying to create uncreatable: QSurface3DSeries, use Surface3DSeries instead."));
+    qmlRegisterType<DeclarativeSurface3DSeries, 1>(uri, 1, 4, "Surface3DSeries");
+    qmlRegisterUncreatableType<QSurfaceDataProxy, 1>(uri, 1, 4, "SurfaceDataProxy",
+                                                     QLatin1String("Trying to create uncreatable: SurfaceDataProxy."));
+    qmlRegisterType<QHeightMapSurfaceDataProxy, 1>(uri, 1, 4, "HeightMapSurfaceDataProxy");
 }
 
 QT_END_NAMESPACE_DATAVISUALIZATION
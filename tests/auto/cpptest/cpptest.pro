@@ -3,15 +3,22 @@ SUBDIRS = q3dbars \
           q3dbars-proxy \
           q3dbars-modelproxy \
           q3dbars-series \
+          q3dbars-transform \
           q3dscatter \
           q3dscatter-proxy \
           q3dscatter-modelproxy \
+          q3dscatter-externalproxy \
           q3dscatter-series \
+          q3dscatter-levelofdetail \
           q3dsurface \
           q3dsurface-proxy \
           q3dsurface-modelproxy \
           q3dsurface-heightproxy \
           q3dsurface-series \
+          q3dsurface-normals \
+          q3dsurface-indices \
+          q3dsurface-hierarchy \
+          q3dsurface-levelofdetail \
           q3daxis-category \
           q3daxis-logvalue \
           q3daxis-value \
@@ -0,0 +1,8 @@
+QT += testlib datavisualization datavisualization-private
+
+TARGET = tst_cpptest
+CONFIG += console testcase
+
+TEMPLATE = app
+
+SOURCES += tst_transform.cpp
@@ -0,0 +1,207 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/itemtransform_p.h>
+
+using namespace QtDataVisualization;
+
+class tst_transform: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void modelMatrix_data();
+    void modelMatrix();
+    void normalMatrix_data();
+    void normalMatrix();
+    void zeroScale();
+
+    void itemMatrices_data();
+    void itemMatrices();
+
+private:
+    void addTransformRows();
+    bool fuzzyCompare(const QMatrix4x4 &a, const QMatrix4x4 &b);
+
+    QVector<QVector3D> m_translations;
+    QVector<QQuaternion> m_rotations;
+    QMatrix4x4 m_projectionViewMatrix;
+};
+
+void tst_transform::initTestCase()
+{
+    // Items of a bar graph with 100 rows and columns, a few of them rotated
+    for (int row = 0; row < 100; row++) {
+        for (int column = 0; column < 100; column++) {
+            m_translations.append(QVector3D(float(column) / 50.0f - 1.0f,
+                                            float((row * 7 + column * 3) % 11 + 1) / 11.0f,
+                                            float(row) / 50.0f - 1.0f));
+            m_rotations.append(QQuaternion::fromAxisAndAngle(0.0f, 1.0f, 0.0f,
+                                                             float((row + column) % 4) * 15.0f));
+        }
+    }
+    m_projectionViewMatrix.perspective(45.0f, 1.5f, 0.1f, 100.0f);
+    m_projectionViewMatrix.lookAt(QVector3D(0.0f, 3.0f, 6.0f), QVector3D(),
+                                  QVector3D(0.0f, 1.0f, 0.0f));
+}
+
+void tst_transform::addTransformRows()
+{
+    QTest::addColumn<QVector3D>("translation");
+    QTest::addColumn<QQuaternion>("rotation");
+    QTest::addColumn<QVector3D>("scale");
+
+    QTest::newRow("identity") << QVector3D() << QQuaternion() << QVector3D(1.0f, 1.0f, 1.0f);
+    QTest::newRow("bar") << QVector3D(0.5f, 0.8f, -0.25f) << QQuaternion()
+                         << QVector3D(0.9f, 0.8f, 0.9f);
+    QTest::newRow("negative bar") << QVector3D(-0.5f, -0.3f, 0.25f) << QQuaternion()
+                                  << QVector3D(0.9f, -0.3f, 0.9f);
+    QTest::newRow("y rotation") << QVector3D(1.0f, 2.0f, 3.0f)
+                                << QQuaternion::fromAxisAndAngle(0.0f, 1.0f, 0.0f, 30.0f)
+                                << QVector3D(0.1f, 2.0f, 0.5f);
+    QTest::newRow("any rotation") << QVector3D(-1.0f, 0.5f, 0.0f)
+                                  << QQuaternion::fromEulerAngles(20.0f, -75.0f, 130.0f)
+                                  << QVector3D(0.2f, 0.3f, 4.0f);
+}
+
+bool tst_transform::fuzzyCompare(const QMatrix4x4 &a, const QMatrix4x4 &b)
+{
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (qAbs(a(i, j) - b(i, j)) > 1e-5f * qMax(1.0f, qAbs(b(i, j))))
+                return false;
+        }
+    }
+    return true;
+}
+
+void tst_transform::modelMatrix_data()
+{
+    addTransformRows();
+}
+
+void tst_transform::modelMatrix()
+{
+    QFETCH(QVector3D, translation);
+    QFETCH(QQuaternion, rotation);
+    QFETCH(QVector3D, scale);
+
+    QMatrix4x4 expected;
+    expected.translate(translation);
+    expected.rotate(rotation);
+    expected.scale(scale);
+
+    QVERIFY(fuzzyCompare(ItemTransform::modelMatrix(translation, rotation, scale), expected));
+}
+
+void tst_transform::normalMatrix_data()
+{
+    addTransformRows();
+}
+
+void tst_transform::normalMatrix()
+{
+    QFETCH(QVector3D, translation);
+    QFETCH(QQuaternion, rotation);
+    QFETCH(QVector3D, scale);
+
+    QMatrix4x4 itModelMatrix;
+    itModelMatrix.rotate(rotation);
+    itModelMatrix.scale(scale);
+    const QMatrix4x4 expected = itModelMatrix.inverted().transposed();
+
+    QVERIFY(fuzzyCompare(ItemTransform::normalMatrix(rotation, scale), expected));
+
+    QMatrix4x4 modelMatrix;
+    QMatrix4x4 normalMatrix;
+    ItemTransform::modelAndNormalMatrix(translation, rotation, scale, modelMatrix, normalMatrix);
+    QVERIFY(fuzzyCompare(modelMatrix,
+                         ItemTransform::modelMatrix(translation, rotation, scale)));
+    QVERIFY(fuzzyCompare(normalMatrix, expected));
+}
+
+void tst_transform::zeroScale()
+{
+    // Like QMatrix4x4::inverted(), matrices that cannot be inverted give identity
+    const QQuaternion rotation = QQuaternion::fromAxisAndAngle(0.0f, 1.0f, 0.0f, 45.0f);
+    QCOMPARE(ItemTransform::normalMatrix(rotation, QVector3D(1.0f, 0.0f, 1.0f)), QMatrix4x4());
+}
+
+void tst_transform::itemMatrices_data()
+{
+    QTest::addColumn<bool>("closedForm");
+
+    QTest::newRow("matrix products") << false;
+    QTest::newRow("closed form") << true;
+}
+
+// Measures the CPU cost of the matrices the color pass sets for each bar
+void tst_transform::itemMatrices()
+{
+    QFETCH(bool, closedForm);
+
+    const QVector3D scale(0.9f, 1.0f, 0.9f);
+    const int count = m_translations.size();
+    float sum = 0.0f;
+
+    QBENCHMARK {
+        for (int i = 0; i < count; i++) {
+            QVector3D barScale = scale;
+            barScale.setY(m_translations.at(i).y());
+            QMatrix4x4 modelMatrix;
+            QMatrix4x4 normalMatrix;
+            if (closedForm) {
+                ItemTransform::modelAndNormalMatrix(m_translations.at(i), m_rotations.at(i),
+                                                    barScale, modelMatrix, normalMatrix);
+            } else {
+                QMatrix4x4 itModelMatrix;
+                modelMatrix.translate(m_translations.at(i));
+                if (!m_rotations.at(i).isIdentity()) {
+                    modelMatrix.rotate(m_rotations.at(i));
+                    itModelMatrix.rotate(m_rotations.at(i));
+                }
+                modelMatrix.scale(barScale);
+                itModelMatrix.scale(barScale);
+                normalMatrix = itModelMatrix.transposed().inverted();
+            }
+            const QMatrix4x4 MVPMatrix = m_projectionViewMatrix * modelMatrix;
+            sum += MVPMatrix(0, 0) + normalMatrix(1, 1);
+        }
+    }
+
+    // Keeps the loop from being optimized away
+    QVERIFY(!qIsNaN(sum));
+}
+
+QTEST_MAIN(tst_transform)
+#include "tst_transform.moc"
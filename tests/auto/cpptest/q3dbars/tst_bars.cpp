@@ -70,6 +70,9 @@ private slots:
 
     void renderToImage();
 
+    void staticInstances_data();
+    void staticInstances();
+
 private:
     Q3DBars *m_graph;
 };
@@ -83,6 +86,34 @@ QBar3DSeries *newSeries()
     return series;
 }
 
+// Colors are shaded by the lighting, so a color is recognized by its dominant channel
+static bool isRed(const QColor &color)
+{
+    return color.red() - qMax(color.green(), color.blue()) > 40;
+}
+
+static bool isGreen(const QColor &color)
+{
+    return color.green() - qMax(color.red(), color.blue()) > 40;
+}
+
+static bool isBlue(const QColor &color)
+{
+    return color.blue() - qMax(color.red(), color.green()) > 40;
+}
+
+static int countPixels(const QImage &image, bool (*matches)(const QColor &))
+{
+    int count = 0;
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            if (matches(image.pixelColor(x, y)))
+                count++;
+        }
+    }
+    return count;
+}
+
 void tst_bars::initTestCase()
 {
 }
@@ -416,5 +447,98 @@ void tst_bars::renderToImage()
     */
 }
 
+void tst_bars::staticInstances_data()
+{
+    QTest::addColumn<bool>("staticOptimization");
+
+    QTest::newRow("default") << false;
+    QTest::newRow("static") << true;
+}
+
+void tst_bars::staticInstances()
+{
+    QFETCH(bool, staticOptimization);
+
+    // A row of three bars seen from the front, so that the middle bar is in the middle of the
+    // image and rises above or sinks below the middle by its sign
+    QBar3DSeries *series = new QBar3DSeries;
+    QBarDataRow *data = new QBarDataRow;
+    *data << 5.0f << 5.0f << 5.0f;
+    series->dataProxy()->addRow(data);
+    series->setMesh(QAbstract3DSeries::MeshBar);
+
+    Q3DTheme *theme = m_graph->activeTheme();
+    theme->setColorStyle(Q3DTheme::ColorStyleUniform);
+    theme->setBaseColors(QList<QColor>() << Qt::red);
+    theme->setSingleHighlightColor(Qt::green);
+    theme->setMultiHighlightColor(Qt::blue);
+    theme->setBackgroundEnabled(false);
+    theme->setGridEnabled(false);
+    theme->setWindowColor(Qt::white);
+    theme->setLabelTextColor(Qt::black);
+    theme->setLabelBackgroundColor(Qt::white);
+    theme->setLabelBorderEnabled(false);
+
+    m_graph->valueAxis()->setRange(-10.0f, 10.0f);
+    m_graph->scene()->activeCamera()->setCameraPreset(Q3DCamera::CameraPresetFront);
+    m_graph->setOrthoProjection(true);
+    m_graph->setShadowQuality(QAbstract3DGraph::ShadowQualityNone);
+    if (staticOptimization)
+        m_graph->setOptimizationHints(QAbstract3DGraph::OptimizationStatic);
+    m_graph->addSeries(series);
+    series->setSelectedBar(QPoint(0, 1));
+
+    const QSize size(200, 200);
+    const QPoint above(100, 94);
+    const QPoint below(100, 106);
+    QImage image = m_graph->renderToImage(0, size);
+    QVERIFY(isGreen(image.pixelColor(above)));
+    QVERIFY(countPixels(image, isRed) > 0);
+
+    // The bars of the selected row are highlighted, and none are drawn in the base color
+    m_graph->setSelectionMode(QAbstract3DGraph::SelectionItemAndRow);
+    image = m_graph->renderToImage(0, size);
+    QVERIFY(isGreen(image.pixelColor(above)));
+    QVERIFY(countPixels(image, isBlue) > 0);
+    QCOMPARE(countPixels(image, isRed), 0);
+
+    // Without selection, the selected bar is drawn in the base color
+    m_graph->setSelectionMode(QAbstract3DGraph::SelectionNone);
+    image = m_graph->renderToImage(0, size);
+    QVERIFY(isRed(image.pixelColor(above)));
+    QCOMPARE(countPixels(image, isGreen), 0);
+    QCOMPARE(countPixels(image, isBlue), 0);
+
+    // Changing sign, disappearing and appearing move the bar between the instance ranges
+    series->dataProxy()->setItem(0, 1, QBarDataItem(-5.0f));
+    image = m_graph->renderToImage(0, size);
+    QVERIFY(!isRed(image.pixelColor(above)));
+    QVERIFY(isRed(image.pixelColor(below)));
+
+    series->dataProxy()->setItem(0, 1, QBarDataItem(0.0f));
+    image = m_graph->renderToImage(0, size);
+    QVERIFY(!isRed(image.pixelColor(above)));
+    QVERIFY(!isRed(image.pixelColor(below)));
+
+    series->dataProxy()->setItem(0, 1, QBarDataItem(5.0f));
+    image = m_graph->renderToImage(0, size);
+    QVERIFY(isRed(image.pixelColor(above)));
+    QVERIFY(!isRed(image.pixelColor(below)));
+
+    // Changed bars of the highlighted row stay highlighted
+    m_graph->setSelectionMode(QAbstract3DGraph::SelectionItemAndRow);
+    series->setSelectedBar(QPoint(0, 1));
+    m_graph->renderToImage(0, size);
+    series->dataProxy()->setItem(0, 0, QBarDataItem(7.0f));
+    series->dataProxy()->setItem(0, 2, QBarDataItem(-3.0f));
+    image = m_graph->renderToImage(0, size);
+    QVERIFY(isGreen(image.pixelColor(above)));
+    QVERIFY(countPixels(image, isBlue) > 0);
+    QCOMPARE(countPixels(image, isRed), 0);
+
+    m_graph->removeSeries(series);
+    delete series;
+}
+
 QTEST_MAIN(tst_bars)
 #include "tst_bars.moc"
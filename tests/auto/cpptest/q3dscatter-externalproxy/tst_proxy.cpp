@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/QExternalScatterDataProxy>
+
+using namespace QtDataVisualization;
+
+class tst_proxy: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void construct();
+
+    void initialProperties();
+    void initializeProperties();
+    void interleavedBuffer();
+    void itemsChanged();
+    void arrayMutators();
+
+private:
+    QExternalScatterDataProxy *m_proxy;
+};
+
+void tst_proxy::initTestCase()
+{
+}
+
+void tst_proxy::cleanupTestCase()
+{
+}
+
+void tst_proxy::init()
+{
+    m_proxy = new QExternalScatterDataProxy();
+}
+
+void tst_proxy::cleanup()
+{
+    delete m_proxy;
+}
+
+void tst_proxy::construct()
+{
+    QExternalScatterDataProxy *proxy = new QExternalScatterDataProxy();
+    QVERIFY(proxy);
+    delete proxy;
+
+    const float positions[] = { 0.5f, 0.5f, 0.5f, -0.3f, -0.5f, -0.4f };
+    proxy = new QExternalScatterDataProxy(positions, 2);
+    QVERIFY(proxy);
+    QCOMPARE(proxy->itemCount(), 2);
+    QCOMPARE(proxy->positions(), positions);
+    delete proxy;
+}
+
+void tst_proxy::initialProperties()
+{
+    QVERIFY(m_proxy);
+
+    QCOMPARE(m_proxy->itemCount(), 0);
+    QVERIFY(!m_proxy->positions());
+    QVERIFY(!m_proxy->rotations());
+    QCOMPARE(m_proxy->array()->size(), 0);
+    QVERIFY(!m_proxy->series());
+
+    QCOMPARE(m_proxy->type(), QAbstractDataProxy::DataTypeScatter);
+}
+
+void tst_proxy::initializeProperties()
+{
+    QVERIFY(m_proxy);
+
+    QSignalSpy resetSpy(m_proxy, &QScatterDataProxy::arrayReset);
+
+    const float positions[] = { 0.5f, 0.5f, 0.5f, -0.3f, -0.5f, -0.4f };
+    m_proxy->setBuffer(positions, 2);
+
+    QCOMPARE(m_proxy->itemCount(), 2);
+    QCOMPARE(m_proxy->positionStride(), int(3 * sizeof(float)));
+    QCOMPARE(m_proxy->itemAt(1)->position(), QVector3D(-0.3f, -0.5f, -0.4f));
+    QVERIFY(m_proxy->itemAt(1)->rotation().isIdentity());
+    QCOMPARE(resetSpy.count(), 1);
+
+    m_proxy->setBuffer(Q_NULLPTR, 2);
+    QCOMPARE(m_proxy->itemCount(), 0);
+    QCOMPARE(resetSpy.count(), 2);
+}
+
+void tst_proxy::interleavedBuffer()
+{
+    QVERIFY(m_proxy);
+
+    // x, y, z, w, rotation scalar, rotation x, rotation y, rotation z
+    const float data[] = {
+        1.0f, 2.0f, 3.0f, 9.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+        4.0f, 5.0f, 6.0f, 9.0f, 0.0f, 0.0f, 1.0f, 0.0f
+    };
+    const int stride = 8 * sizeof(float);
+    m_proxy->setBuffer(data, 2, stride, data + 4, stride);
+
+    QCOMPARE(m_proxy->itemCount(), 2);
+    QCOMPARE(m_proxy->itemAt(0)->position(), QVector3D(1.0f, 2.0f, 3.0f));
+    QCOMPARE(m_proxy->itemAt(1)->position(), QVector3D(4.0f, 5.0f, 6.0f));
+    QCOMPARE(m_proxy->itemAt(1)->rotation(), QQuaternion(0.0f, 0.0f, 1.0f, 0.0f));
+
+    QTest::ignoreMessage(QtWarningMsg, "Invalid stride. Stride cannot be negative.");
+    m_proxy->setBuffer(data, 2, -stride);
+    QCOMPARE(m_proxy->positionStride(), stride);
+}
+
+void tst_proxy::itemsChanged()
+{
+    QVERIFY(m_proxy);
+
+    float positions[] = { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+    m_proxy->setBuffer(positions, 2);
+
+    QSignalSpy changedSpy(m_proxy, &QScatterDataProxy::itemsChanged);
+
+    positions[3] = 2.0f;
+    m_proxy->notifyItemsChanged(1, 1);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).toInt(), 1);
+    QCOMPARE(m_proxy->itemAt(1)->position(), QVector3D(2.0f, 1.0f, 1.0f));
+
+    QTest::ignoreMessage(QtWarningMsg,
+                         "Invalid range. The changed items must be within the buffer.");
+    m_proxy->notifyItemsChanged(1, 2);
+    QCOMPARE(changedSpy.count(), 1);
+}
+
+void tst_proxy::arrayMutators()
+{
+    QVERIFY(m_proxy);
+
+    const float positions[] = { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+    m_proxy->setBuffer(positions, 2);
+
+    QSignalSpy resetSpy(m_proxy, &QScatterDataProxy::arrayReset);
+    QSignalSpy addedSpy(m_proxy, &QScatterDataProxy::itemsAdded);
+    QSignalSpy changedSpy(m_proxy, &QScatterDataProxy::itemsChanged);
+    QSignalSpy insertedSpy(m_proxy, &QScatterDataProxy::itemsInserted);
+    QSignalSpy removedSpy(m_proxy, &QScatterDataProxy::itemsRemoved);
+
+    const char *warning = "Invalid operation. The items of an external proxy can only be "
+                          "changed through its buffers.";
+    const QScatterDataItem item(QVector3D(5.0f, 5.0f, 5.0f));
+    QScatterDataArray items;
+    items << item << item;
+
+    for (int i = 0; i < 12; i++)
+        QTest::ignoreMessage(QtWarningMsg, warning);
+    m_proxy->resetArray(new QScatterDataArray(items));
+    m_proxy->resetArray(new QScatterDataArray(items), QVector<float>() << 0.5f << 0.5f);
+    m_proxy->setItem(0, item);
+    m_proxy->setItems(0, items);
+    QCOMPARE(m_proxy->addItem(item), -1);
+    QCOMPARE(m_proxy->addItems(items), -1);
+    m_proxy->insertItem(0, item);
+    m_proxy->insertItems(0, items);
+    m_proxy->removeItems(0, 1);
+    m_proxy->setCapacity(1);
+    m_proxy->setItemValue(1, 0.5f);
+    m_proxy->setItemValues(0, QVector<float>() << 0.5f << 0.5f);
+
+    QCOMPARE(m_proxy->itemCount(), 2);
+    QCOMPARE(m_proxy->capacity(), 0);
+    QVERIFY(!m_proxy->hasItemValues());
+    QCOMPARE(m_proxy->itemAt(0)->position(), QVector3D(0.0f, 0.0f, 0.0f));
+    QCOMPARE(m_proxy->itemAt(1)->position(), QVector3D(1.0f, 1.0f, 1.0f));
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(addedSpy.count(), 0);
+    QCOMPARE(changedSpy.count(), 0);
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(removedSpy.count(), 0);
+}
+
+QTEST_MAIN(tst_proxy)
+#include "tst_proxy.moc"
@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/scatterlevelofdetail_p.h>
+
+using namespace QtDataVisualization;
+
+class tst_levelofdetail: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void itemOrder();
+    void decimation_data();
+    void decimation();
+    void fullDetail();
+};
+
+// Deterministic pseudo random numbers in [0, 1), so that failures can be reproduced
+static float randomFloat(quint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return float(state >> 8) / float(1 << 24);
+}
+
+// Items spread uniformly over the graph cube, with every hiddenStep:th item hidden
+static void fillUniform(ScatterRenderItemArray &renderArray, int itemCount, int hiddenStep = 0)
+{
+    quint32 state = 1;
+    renderArray.resize(itemCount);
+    for (int i = 0; i < itemCount; i++) {
+        const QVector3D translation(randomFloat(state) * 2.0f - 1.0f,
+                                    randomFloat(state) * 2.0f - 1.0f,
+                                    randomFloat(state) * 2.0f - 1.0f);
+        renderArray.setTranslation(i, translation);
+        renderArray.setVisible(i, !hiddenStep || i % hiddenStep);
+    }
+}
+
+void tst_levelofdetail::itemOrder()
+{
+    ScatterRenderItemArray renderArray;
+    fillUniform(renderArray, 10000, 7);
+
+    ScatterLevelOfDetail levelOfDetail;
+    QVERIFY(levelOfDetail.isDirty());
+    levelOfDetail.build(renderArray);
+    QVERIFY(!levelOfDetail.isDirty());
+
+    // Every visible item is in the order exactly once, and the ranks point back into the order
+    const QVector<int> &order = levelOfDetail.itemOrder();
+    int visibleCount = 0;
+    for (int i = 0; i < renderArray.size(); i++) {
+        if (renderArray.isVisible(i)) {
+            visibleCount++;
+            const int rank = levelOfDetail.itemRank(i);
+            QVERIFY(rank >= 0 && rank < order.size());
+            QCOMPARE(order.at(rank), i);
+        } else {
+            QCOMPARE(levelOfDetail.itemRank(i), -1);
+        }
+    }
+    QCOMPARE(order.size(), visibleCount);
+}
+
+void tst_levelofdetail::decimation_data()
+{
+    QTest::addColumn<float>("graphPixelSize");
+
+    QTest::newRow("200") << 200.0f;
+    QTest::newRow("400") << 400.0f;
+    QTest::newRow("600") << 600.0f;
+    QTest::newRow("800") << 800.0f;
+    QTest::newRow("1000") << 1000.0f;
+}
+
+void tst_levelofdetail::decimation()
+{
+    QFETCH(float, graphPixelSize);
+
+    const int cloudSize = 1000000;
+    ScatterRenderItemArray renderArray;
+    fillUniform(renderArray, cloudSize);
+
+    ScatterLevelOfDetail levelOfDetail;
+    levelOfDetail.build(renderArray);
+    QCOMPARE(levelOfDetail.itemOrder().size(), cloudSize);
+
+    // A large cloud is drawn well decimated at typical viewport sizes, and more items are drawn
+    // on larger graphs
+    const int count = levelOfDetail.itemCount(graphPixelSize);
+    QVERIFY(count > 0);
+    QVERIFY(count < cloudSize / 2);
+    QVERIFY(count <= levelOfDetail.itemCount(graphPixelSize * 1.5f));
+    QVERIFY(count >= levelOfDetail.itemCount(graphPixelSize / 1.5f));
+}
+
+void tst_levelofdetail::fullDetail()
+{
+    ScatterRenderItemArray renderArray;
+    fillUniform(renderArray, 1000);
+
+    ScatterLevelOfDetail levelOfDetail;
+    levelOfDetail.build(renderArray);
+
+    // Sparse clouds and large graphs are drawn in full detail
+    QCOMPARE(levelOfDetail.itemCount(400.0f), 1000);
+
+    fillUniform(renderArray, 100000);
+    levelOfDetail.build(renderArray);
+    QVERIFY(levelOfDetail.itemCount(200.0f) < 100000);
+    QCOMPARE(levelOfDetail.itemCount(4000.0f), 100000);
+
+    // Tiny graphs still draw the coarsest level
+    QVERIFY(levelOfDetail.itemCount(1.0f) > 0);
+
+    ScatterRenderItemArray emptyArray;
+    levelOfDetail.build(emptyArray);
+    QCOMPARE(levelOfDetail.itemCount(400.0f), 0);
+}
+
+QTEST_MAIN(tst_levelofdetail)
+#include "tst_levelofdetail.moc"
@@ -47,6 +47,8 @@ private slots:
 
     void initialProperties();
     void initializeProperties();
+    void capacity();
+    void itemValues();
 
 private:
     QScatterDataProxy *m_proxy;
@@ -83,6 +85,8 @@ void tst_proxy::initialProperties()
 
     QCOMPARE(m_proxy->itemCount(), 0);
     QVERIFY(!m_proxy->series());
+    QCOMPARE(m_proxy->capacity(), 0);
+    QVERIFY(!m_proxy->hasItemValues());
 
     QCOMPARE(m_proxy->type(), QAbstractDataProxy::DataTypeScatter);
 }
@@ -98,5 +102,100 @@ void tst_proxy::initializeProperties()
     QCOMPARE(m_proxy->itemCount(), 2);
 }
 
+void tst_proxy::capacity()
+{
+    QVERIFY(m_proxy);
+
+    QSignalSpy addedSpy(m_proxy, &QScatterDataProxy::itemsAdded);
+    QSignalSpy changedSpy(m_proxy, &QScatterDataProxy::itemsChanged);
+
+    m_proxy->setCapacity(3);
+    QCOMPARE(m_proxy->capacity(), 3);
+
+    QScatterDataArray data;
+    data << QVector3D(0.0f, 0.0f, 0.0f) << QVector3D(1.0f, 1.0f, 1.0f);
+    QCOMPARE(m_proxy->addItems(data), 0);
+    QCOMPARE(m_proxy->itemCount(), 2);
+    QCOMPARE(addedSpy.count(), 1);
+
+    // Fills the last slot and overwrites the oldest item
+    data.clear();
+    data << QVector3D(2.0f, 2.0f, 2.0f) << QVector3D(3.0f, 3.0f, 3.0f);
+    QCOMPARE(m_proxy->addItems(data), 2);
+    QCOMPARE(m_proxy->itemCount(), 3);
+    QCOMPARE(addedSpy.count(), 2);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(m_proxy->itemAt(0)->position(), QVector3D(3.0f, 3.0f, 3.0f));
+
+    QCOMPARE(m_proxy->addItem(QScatterDataItem(QVector3D(4.0f, 4.0f, 4.0f))), 1);
+    QCOMPARE(m_proxy->itemCount(), 3);
+    QCOMPARE(m_proxy->itemAt(1)->position(), QVector3D(4.0f, 4.0f, 4.0f));
+
+    // Items that wrap around the end of the array are reported as separate spans
+    QSignalSpy countSpy(m_proxy, &QScatterDataProxy::itemCountChanged);
+    changedSpy.clear();
+    data.clear();
+    data << QVector3D(5.0f, 5.0f, 5.0f) << QVector3D(6.0f, 6.0f, 6.0f);
+    QCOMPARE(m_proxy->addItems(data), 2);
+    QCOMPARE(addedSpy.count(), 2);
+    QCOMPARE(countSpy.count(), 0);
+    QCOMPARE(changedSpy.count(), 2);
+    QCOMPARE(changedSpy.at(0).at(0).toInt(), 2);
+    QCOMPARE(changedSpy.at(0).at(1).toInt(), 1);
+    QCOMPARE(changedSpy.at(1).at(0).toInt(), 0);
+    QCOMPARE(changedSpy.at(1).at(1).toInt(), 1);
+
+    // Shrinking keeps the newest items in chronological order
+    m_proxy->setCapacity(2);
+    QCOMPARE(m_proxy->itemCount(), 2);
+    QCOMPARE(m_proxy->itemAt(0)->position(), QVector3D(5.0f, 5.0f, 5.0f));
+    QCOMPARE(m_proxy->itemAt(1)->position(), QVector3D(6.0f, 6.0f, 6.0f));
+
+    QTest::ignoreMessage(QtWarningMsg, "Invalid capacity. Capacity cannot be negative.");
+    m_proxy->setCapacity(-1);
+    QCOMPARE(m_proxy->capacity(), 2);
+}
+
+void tst_proxy::itemValues()
+{
+    QVERIFY(m_proxy);
+
+    QScatterDataArray data;
+    data << QVector3D(0.0f, 0.0f, 0.0f) << QVector3D(1.0f, 1.0f, 1.0f);
+    m_proxy->addItems(data);
+
+    QSignalSpy changedSpy(m_proxy, &QScatterDataProxy::itemsChanged);
+
+    m_proxy->setItemValue(1, 0.5f);
+    QVERIFY(m_proxy->hasItemValues());
+    QCOMPARE(m_proxy->itemValue(0), 0.0f);
+    QCOMPARE(m_proxy->itemValue(1), 0.5f);
+    QCOMPARE(changedSpy.count(), 1);
+
+    // Values follow the items when items are inserted and removed
+    m_proxy->insertItem(0, QScatterDataItem(QVector3D(2.0f, 2.0f, 2.0f)));
+    QCOMPARE(m_proxy->itemValue(0), 0.0f);
+    QCOMPARE(m_proxy->itemValue(2), 0.5f);
+    m_proxy->removeItems(0, 2);
+    QCOMPARE(m_proxy->itemCount(), 1);
+    QCOMPARE(m_proxy->itemValue(0), 0.5f);
+
+    QVector<float> values;
+    values << 0.25f << 0.75f;
+    QTest::ignoreMessage(QtWarningMsg,
+                         "Invalid values. The number of values must match the number of items.");
+    QScatterDataArray *rejectedArray = new QScatterDataArray(data);
+    m_proxy->resetArray(rejectedArray, QVector<float>() << 1.0f);
+    QCOMPARE(m_proxy->itemCount(), 1);
+    delete rejectedArray;
+
+    m_proxy->resetArray(new QScatterDataArray(data), values);
+    QCOMPARE(m_proxy->itemCount(), 2);
+    QCOMPARE(m_proxy->itemValue(1), 0.75f);
+
+    m_proxy->resetArray(new QScatterDataArray(data));
+    QVERIFY(!m_proxy->hasItemValues());
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
@@ -91,6 +91,7 @@ void tst_series::initialProperties()
     QVERIFY(m_series->dataProxy());
     QCOMPARE(m_series->itemSize(), 0.0f);
     QCOMPARE(m_series->selectedItem(), m_series->invalidSelectionIndex());
+    QCOMPARE(m_series->isLevelOfDetailEnabled(), false);
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     QCOMPARE(m_series->itemLabelFormat(), QString("@xLabel, @yLabel, @zLabel"));
@@ -105,9 +106,11 @@ void tst_series::initializeProperties()
     m_series->setDataProxy(new QScatterDataProxy());
     m_series->setItemSize(0.5f);
     m_series->setSelectedItem(0);
+    m_series->setLevelOfDetailEnabled(true);
 
     QCOMPARE(m_series->itemSize(), 0.5f);
     QCOMPARE(m_series->selectedItem(), 0);
+    QCOMPARE(m_series->isLevelOfDetailEnabled(), true);
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     m_series->setMesh(QAbstract3DSeries::MeshPoint);
@@ -55,6 +55,9 @@ private slots:
     void removeSeries();
     void removeMultipleSeries();
 
+    void itemValues_data();
+    void itemValues();
+
 private:
     Q3DScatter *m_graph;
 };
@@ -125,6 +128,7 @@ void tst_scatter::initialProperties()
     QCOMPARE(m_graph->locale(), QLocale("C"));
     QCOMPARE(m_graph->queriedGraphPosition(), QVector3D(0, 0, 0));
     QCOMPARE(m_graph->margin(), -1.0);
+    QCOMPARE(m_graph->isRayCastPicking(), false);
 }
 
 void tst_scatter::initializeProperties()
@@ -145,6 +149,7 @@ void tst_scatter::initializeProperties()
     m_graph->setReflectivity(0.1);
     m_graph->setLocale(QLocale("FI"));
     m_graph->setMargin(1.0);
+    m_graph->setRayCastPicking(true);
 
     QCOMPARE(m_graph->activeTheme()->type(), Q3DTheme::ThemeDigia);
     QCOMPARE(m_graph->selectionMode(), QAbstract3DGraph::SelectionNone);
@@ -160,6 +165,7 @@ void tst_scatter::initializeProperties()
     QCOMPARE(m_graph->reflectivity(), 0.1);
     QCOMPARE(m_graph->locale(), QLocale("FI"));
     QCOMPARE(m_graph->margin(), 1.0);
+    QCOMPARE(m_graph->isRayCastPicking(), true);
 }
 
 void tst_scatter::invalidProperties()
@@ -251,5 +257,57 @@ void tst_scatter::removeMultipleSeries()
     delete series3;
 }
 
+void tst_scatter::itemValues_data()
+{
+    QTest::addColumn<bool>("staticOptimization");
+
+    QTest::newRow("default") << false;
+    QTest::newRow("static") << true;
+}
+
+void tst_scatter::itemValues()
+{
+    QFETCH(bool, staticOptimization);
+
+    // A large item in the middle of the graph, with a gradient that turns from red to blue
+    // just above the Y-coordinate of the item
+    QScatter3DSeries *series = new QScatter3DSeries;
+    series->dataProxy()->addItem(QScatterDataItem(QVector3D(0.0f, 4.5f, 0.0f)));
+    series->setMesh(QAbstract3DSeries::MeshCube);
+    series->setItemSize(1.0f);
+    QLinearGradient gradient;
+    gradient.setColorAt(0.0, Qt::red);
+    gradient.setColorAt(0.55, Qt::red);
+    gradient.setColorAt(0.6, Qt::blue);
+    gradient.setColorAt(1.0, Qt::blue);
+    series->setBaseGradient(gradient);
+    series->setColorStyle(Q3DTheme::ColorStyleRangeGradient);
+
+    m_graph->axisX()->setRange(-1.0f, 1.0f);
+    m_graph->axisY()->setRange(0.0f, 10.0f);
+    m_graph->axisZ()->setRange(-1.0f, 1.0f);
+    m_graph->setShadowQuality(QAbstract3DGraph::ShadowQualityNone);
+    if (staticOptimization)
+        m_graph->setOptimizationHints(QAbstract3DGraph::OptimizationStatic);
+    m_graph->addSeries(series);
+
+    const QSize size(200, 200);
+    QColor color = m_graph->renderToImage(0, size).pixelColor(100, 100);
+    QVERIFY(color.red() > color.blue());
+
+    // Values set on a displayed series that had no values color the rendered item
+    series->dataProxy()->setItemValue(0, 1.0f);
+    QVERIFY(series->dataProxy()->hasItemValues());
+    color = m_graph->renderToImage(0, size).pixelColor(100, 100);
+    QVERIFY(color.blue() > color.red());
+
+    series->dataProxy()->setItemValue(0, 0.0f);
+    color = m_graph->renderToImage(0, size).pixelColor(100, 100);
+    QVERIFY(color.red() > color.blue());
+
+    m_graph->removeSeries(series);
+    delete series;
+}
+
 QTEST_MAIN(tst_scatter)
 #include "tst_scatter.moc"
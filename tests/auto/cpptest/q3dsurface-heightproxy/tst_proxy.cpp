@@ -49,6 +49,11 @@ private slots:
     void initializeProperties();
     void invalidProperties();
 
+    void backgroundResolve();
+    void cancelResolve();
+    void rawHeightMap();
+    void grayscaleImage();
+
 private:
     QHeightMapSurfaceDataProxy *m_proxy;
 };
@@ -104,6 +109,7 @@ void tst_proxy::initialProperties()
     QCOMPARE(m_proxy->maxZValue(), 10.0f);
     QCOMPARE(m_proxy->minXValue(), 0.0f);
     QCOMPARE(m_proxy->minZValue(), 0.0f);
+    QCOMPARE(m_proxy->resolveProgress(), 1.0f);
 
     QCOMPARE(m_proxy->columnCount(), 0);
     QCOMPARE(m_proxy->rowCount(), 0);
@@ -165,5 +171,172 @@ void tst_proxy::invalidProperties()
     QCOMPARE(m_proxy->minZValue(), 10.0f);
 }
 
+void tst_proxy::backgroundResolve()
+{
+    // Large enough to be resolved in a worker thread
+    QImage image(QSize(1024, 600), QImage::Format_RGB32);
+    image.fill(QColor(10, 10, 10));
+    image.setPixel(0, 599, qRgb(20, 20, 20));
+    image.setPixel(1023, 0, qRgb(30, 60, 90));
+
+    QSignalSpy resetSpy(m_proxy, &QSurfaceDataProxy::arrayReset);
+    QSignalSpy progressSpy(m_proxy, &QHeightMapSurfaceDataProxy::resolveProgressChanged);
+    m_proxy->setValueRanges(-5.0f, 5.0f, 0.0f, 6.0f);
+    m_proxy->setHeightMap(image);
+
+    QTRY_COMPARE(resetSpy.count(), 1);
+    QCOMPARE(m_proxy->resolveProgress(), 1.0f);
+    QVERIFY(progressSpy.count() >= 2);
+    QCOMPARE(progressSpy.first().at(0).toFloat(), 0.0f);
+    QCOMPARE(progressSpy.last().at(0).toFloat(), 1.0f);
+    for (int i = 1; i < progressSpy.count(); i++)
+        QVERIFY(progressSpy.at(i).at(0).toFloat() > progressSpy.at(i - 1).at(0).toFloat());
+
+    QCOMPARE(m_proxy->columnCount(), 1024);
+    QCOMPARE(m_proxy->rowCount(), 600);
+    QCOMPARE(m_proxy->itemAt(0, 0)->position(), QVector3D(-5.0f, 20.0f, 0.0f));
+    QCOMPARE(m_proxy->itemAt(599, 1023)->position(), QVector3D(5.0f, 60.0f, 6.0f));
+    QCOMPARE(m_proxy->itemAt(300, 512)->y(), 10.0f);
+}
+
+void tst_proxy::cancelResolve()
+{
+    QImage image(QSize(2048, 2048), QImage::Format_RGB32);
+    image.fill(QColor(10, 10, 10));
+    QImage otherImage(QSize(800, 700), QImage::Format_RGB32);
+    otherImage.fill(QColor(50, 50, 50));
+
+    QSignalSpy resetSpy(m_proxy, &QSurfaceDataProxy::arrayReset);
+    QSignalSpy heightMapSpy(m_proxy, &QHeightMapSurfaceDataProxy::heightMapChanged);
+
+    // The first height map is replaced while it is being resolved
+    m_proxy->setHeightMap(image);
+    QCoreApplication::processEvents();
+    m_proxy->setHeightMap(otherImage);
+
+    QTRY_COMPARE(m_proxy->resolveProgress(), 1.0f);
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(heightMapSpy.count(), 1);
+    QCOMPARE(heightMapSpy.at(0).at(0).value<QImage>(), otherImage);
+    QCOMPARE(m_proxy->columnCount(), 800);
+    QCOMPARE(m_proxy->rowCount(), 700);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 50.0f);
+
+    // A small height map is resolved at once, and cancels a running resolve
+    m_proxy->setHeightMap(image);
+    QCoreApplication::processEvents();
+    m_proxy->setHeightMap(QImage(":/customtexture.jpg"));
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 24);
+    QCOMPARE(m_proxy->rowCount(), 24);
+    QCOMPARE(m_proxy->resolveProgress(), 1.0f);
+
+    QTest::qWait(100);
+    QCOMPARE(m_proxy->columnCount(), 24);
+    QCOMPARE(resetSpy.count(), 2);
+
+    // Destroying the proxy cancels the resolve and waits for it
+    m_proxy->setHeightMap(image);
+    QCoreApplication::processEvents();
+}
+
+void tst_proxy::rawHeightMap()
+{
+    // Three rows of four heights, stored from the top row down, followed by extra data
+    QTemporaryFile uint16File;
+    QVERIFY(uint16File.open());
+    const quint16 uint16Heights[] = { 1000, 1001, 1002, 1003,
+                                      2000, 2001, 2002, 2003,
+                                      65535, 3001, 3002, 0,
+                                      7777 };
+    for (int i = 0; i < 13; i++) {
+        uchar bytes[2];
+        qToLittleEndian(uint16Heights[i], bytes);
+        uint16File.write(reinterpret_cast<const char *>(bytes), 2);
+    }
+    uint16File.close();
+
+    QSignalSpy fileSpy(m_proxy, &QHeightMapSurfaceDataProxy::heightMapFileChanged);
+    QVERIFY(m_proxy->setRawHeightMapFile(uint16File.fileName(), 4, 3,
+                                         QHeightMapSurfaceDataProxy::RawDataUInt16));
+    QCOMPARE(fileSpy.count(), 1);
+    QCOMPARE(m_proxy->heightMapFile(), uint16File.fileName());
+    QCOMPARE(m_proxy->heightMap(), QImage());
+
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 4);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(m_proxy->itemAt(0, 0)->position(), QVector3D(0.0f, 65535.0f, 0.0f));
+    QCOMPARE(m_proxy->itemAt(0, 3)->position(), QVector3D(10.0f, 0.0f, 0.0f));
+    QCOMPARE(m_proxy->itemAt(1, 2)->y(), 2002.0f);
+    QCOMPARE(m_proxy->itemAt(2, 1)->position(), QVector3D(10.0f / 3.0f, 1001.0f, 10.0f));
+
+    QTemporaryFile floatFile;
+    QVERIFY(floatFile.open());
+    const float floatHeights[] = { -1.5f, 2.25f,
+                                   1000.125f, -0.0625f };
+    for (int i = 0; i < 4; i++) {
+        quint32 value;
+        memcpy(&value, &floatHeights[i], sizeof(value));
+        uchar bytes[4];
+        qToLittleEndian(value, bytes);
+        floatFile.write(reinterpret_cast<const char *>(bytes), 4);
+    }
+    floatFile.close();
+
+    QVERIFY(m_proxy->setRawHeightMapFile(floatFile.fileName(), 2, 2,
+                                         QHeightMapSurfaceDataProxy::RawDataFloat32));
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 2);
+    QCOMPARE(m_proxy->rowCount(), 2);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 1000.125f);
+    QCOMPARE(m_proxy->itemAt(0, 1)->y(), -0.0625f);
+    QCOMPARE(m_proxy->itemAt(1, 0)->y(), -1.5f);
+    QCOMPARE(m_proxy->itemAt(1, 1)->y(), 2.25f);
+
+    // Invalid files leave the data unchanged
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("too small"));
+    QVERIFY(!m_proxy->setRawHeightMapFile(floatFile.fileName(), 3, 2,
+                                          QHeightMapSurfaceDataProxy::RawDataFloat32));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Could not open"));
+    QVERIFY(!m_proxy->setRawHeightMapFile(QStringLiteral("nonexistent.raw"), 2, 2,
+                                          QHeightMapSurfaceDataProxy::RawDataFloat32));
+    QTest::ignoreMessage(QtWarningMsg, "Invalid raw height map dimensions.");
+    QVERIFY(!m_proxy->setRawHeightMapFile(floatFile.fileName(), 0, 2,
+                                          QHeightMapSurfaceDataProxy::RawDataFloat32));
+    QCOMPARE(fileSpy.count(), 2);
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 2);
+    QCOMPARE(m_proxy->itemAt(1, 1)->y(), 2.25f);
+
+    // Setting an image replaces the raw height map
+    m_proxy->setHeightMap(QImage(":/customtexture.jpg"));
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 24);
+    QCOMPARE(m_proxy->rowCount(), 24);
+}
+
+void tst_proxy::grayscaleImage()
+{
+    QImage image(QSize(3, 2), QImage::Format_Grayscale8);
+    image.fill(0);
+    image.setPixel(0, 1, qRgb(10, 10, 10));
+    image.setPixel(2, 0, qRgb(200, 200, 200));
+
+    m_proxy->setHeightMap(image);
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 3);
+    QCOMPARE(m_proxy->rowCount(), 2);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 10.0f);
+    QCOMPARE(m_proxy->itemAt(0, 1)->y(), 0.0f);
+    QCOMPARE(m_proxy->itemAt(1, 2)->y(), 200.0f);
+
+    // Same heights as the image converted to RGB32
+    m_proxy->setHeightMap(image.convertToFormat(QImage::Format_ARGB32));
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 10.0f);
+    QCOMPARE(m_proxy->itemAt(1, 2)->y(), 200.0f);
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
@@ -0,0 +1,262 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/surfaceheighthierarchy_p.h>
+#include <QtCore/qmath.h>
+
+#include <limits>
+
+using namespace QtDataVisualization;
+
+// Vertex grid stored as a plain array of positions
+class TestGrid : public SurfaceHeightGrid
+{
+public:
+    TestGrid(int columns, int rows, bool sameDirections)
+        : m_columns(columns),
+          m_rows(rows),
+          m_sameDirections(sameDirections),
+          m_positions(columns * rows)
+    {
+    }
+
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+    bool sameDirections() const { return m_sameDirections; }
+    QVector3D gridPosition(int column, int row) const
+    {
+        return m_positions.at(row * m_columns + column);
+    }
+    void setGridPosition(int column, int row, const QVector3D &position)
+    {
+        m_positions[row * m_columns + column] = position;
+    }
+
+private:
+    int m_columns;
+    int m_rows;
+    bool m_sameDirections;
+    QVector<QVector3D> m_positions;
+};
+
+class tst_hierarchy: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void intersect_data();
+    void intersect();
+    void emptyGrid();
+
+private:
+    void compareRays(const SurfaceHeightHierarchy &hierarchy, const TestGrid &grid);
+};
+
+// Deterministic pseudo random numbers in [0, 1), so that failures can be reproduced
+static float randomFloat(quint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return float(state >> 8) / float(1 << 24);
+}
+
+// Intersects the ray with every triangle of the grid. Returns the distance to the nearest hit,
+// or the largest float if the ray misses, and sets point to the grid vertex nearest to the hit.
+static float bruteForceIntersect(const TestGrid &grid, const QVector3D &origin,
+                                 const QVector3D &direction, QPoint &point)
+{
+    float nearest = std::numeric_limits<float>::max();
+    for (int row = 0; row < grid.rows() - 1; row++) {
+        for (int column = 0; column < grid.columns() - 1; column++) {
+            const QPoint a(column, row);
+            const QPoint b(column + 1, row);
+            const QPoint c(column, row + 1);
+            const QPoint d(column + 1, row + 1);
+            QPoint triangles[2][3];
+            if (grid.sameDirections()) {
+                triangles[0][0] = a;
+                triangles[0][1] = b;
+                triangles[0][2] = c;
+                triangles[1][0] = b;
+                triangles[1][1] = d;
+                triangles[1][2] = c;
+            } else {
+                triangles[0][0] = a;
+                triangles[0][1] = c;
+                triangles[0][2] = d;
+                triangles[1][0] = a;
+                triangles[1][1] = d;
+                triangles[1][2] = b;
+            }
+
+            for (int i = 0; i < 2; i++) {
+                const QPoint *corners = triangles[i];
+                const QVector3D p0 = grid.gridPosition(corners[0].x(), corners[0].y());
+                const QVector3D p1 = grid.gridPosition(corners[1].x(), corners[1].y());
+                const QVector3D p2 = grid.gridPosition(corners[2].x(), corners[2].y());
+
+                // Hit of the plane of the triangle, and its barycentric coordinates
+                const QVector3D normal = QVector3D::crossProduct(p1 - p0, p2 - p0);
+                const float denominator = QVector3D::dotProduct(normal, direction);
+                if (qAbs(denominator) < 1.0e-9f)
+                    continue;
+                const float t = QVector3D::dotProduct(normal, p0 - origin) / denominator;
+                if (t < 0.0f || t >= nearest)
+                    continue;
+                const QVector3D hit = origin + t * direction;
+                const float area = normal.lengthSquared();
+                const float w1 = QVector3D::dotProduct(
+                            QVector3D::crossProduct(hit - p0, p2 - p0), normal) / area;
+                const float w2 = QVector3D::dotProduct(
+                            QVector3D::crossProduct(p1 - p0, hit - p0), normal) / area;
+                const float w0 = 1.0f - w1 - w2;
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                    continue;
+
+                nearest = t;
+                point = QPoint(qRound(w0 * corners[0].x() + w1 * corners[1].x()
+                                      + w2 * corners[2].x()),
+                               qRound(w0 * corners[0].y() + w1 * corners[1].y()
+                                      + w2 * corners[2].y()));
+            }
+        }
+    }
+    return nearest;
+}
+
+// Casts rays from above, from below, and along the surface, and checks that the hierarchy finds
+// the same nearest hits as testing every triangle
+void tst_hierarchy::compareRays(const SurfaceHeightHierarchy &hierarchy, const TestGrid &grid)
+{
+    quint32 state = 1;
+    for (int i = 0; i < 300; i++) {
+        QVector3D origin;
+        QVector3D target;
+        if (i < 100) {
+            origin = QVector3D(randomFloat(state) * 3.0f - 1.5f, 2.0f,
+                               randomFloat(state) * 3.0f - 1.5f);
+            target = QVector3D(randomFloat(state) * 2.4f - 1.2f, 0.0f,
+                               randomFloat(state) * 2.4f - 1.2f);
+        } else if (i < 200) {
+            origin = QVector3D(randomFloat(state) * 3.0f - 1.5f, -2.0f,
+                               randomFloat(state) * 3.0f - 1.5f);
+            target = QVector3D(randomFloat(state) * 2.4f - 1.2f, 0.0f,
+                               randomFloat(state) * 2.4f - 1.2f);
+        } else {
+            origin = QVector3D(-3.0f, randomFloat(state) - 0.5f, randomFloat(state) * 2.0f - 1.0f);
+            target = QVector3D(3.0f, randomFloat(state) - 0.5f, randomFloat(state) * 2.0f - 1.0f);
+        }
+        const QVector3D direction = (target - origin).normalized();
+
+        QPoint expectedPoint;
+        const float expectedDistance = bruteForceIntersect(grid, origin, direction,
+                                                           expectedPoint);
+        const bool expectedHit = expectedDistance < std::numeric_limits<float>::max();
+
+        float distance = std::numeric_limits<float>::max();
+        QPoint point;
+        const bool hit = hierarchy.intersect(grid, origin, direction, distance, point);
+
+        QVERIFY2(hit == expectedHit, qPrintable(QStringLiteral("ray %1").arg(i)));
+        if (hit) {
+            QVERIFY2(qAbs(distance - expectedDistance) <= 1.0e-4f,
+                     qPrintable(QStringLiteral("ray %1").arg(i)));
+            QCOMPARE(point, expectedPoint);
+        }
+    }
+}
+
+void tst_hierarchy::intersect_data()
+{
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<bool>("sameDirections");
+
+    QTest::newRow("2x2") << 2 << 2 << true;
+    QTest::newRow("9x9") << 9 << 9 << true;
+    QTest::newRow("37x29") << 37 << 29 << true;
+    QTest::newRow("37x29 flipped") << 37 << 29 << false;
+    QTest::newRow("100x3") << 100 << 3 << false;
+}
+
+void tst_hierarchy::intersect()
+{
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    QFETCH(bool, sameDirections);
+
+    // A bumpy surface in the normalized range of the graphs
+    TestGrid grid(columns, rows, sameDirections);
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            const float x = 2.0f * float(column) / float(columns - 1) - 1.0f;
+            const float z = 2.0f * float(row) / float(rows - 1) - 1.0f;
+            const float y = 0.4f * qSin(3.0f * x + 1.0f) * qCos(4.0f * z)
+                    + 0.01f * float((column * 7 + row * 3) % 5);
+            grid.setGridPosition(column, row, QVector3D(x, y, z));
+        }
+    }
+
+    SurfaceHeightHierarchy hierarchy;
+    QVERIFY(hierarchy.isDirty());
+    hierarchy.build(grid);
+    QVERIFY(!hierarchy.isDirty());
+    compareRays(hierarchy, grid);
+    if (QTest::currentTestFailed())
+        return;
+
+    // Raised rows need the bounds of their nodes to be updated
+    const int startRow = rows / 3;
+    const int endRow = qMin(startRow + 1, rows - 1);
+    for (int row = startRow; row <= endRow; row++) {
+        for (int column = 0; column < columns; column++) {
+            grid.setGridPosition(column, row,
+                                 grid.gridPosition(column, row) + QVector3D(0.0f, 0.3f, 0.0f));
+        }
+    }
+    hierarchy.updateRows(grid, startRow, endRow);
+    compareRays(hierarchy, grid);
+}
+
+void tst_hierarchy::emptyGrid()
+{
+    TestGrid grid(1, 5, true);
+    SurfaceHeightHierarchy hierarchy;
+    hierarchy.build(grid);
+
+    float distance = std::numeric_limits<float>::max();
+    QPoint point;
+    QVERIFY(!hierarchy.intersect(grid, QVector3D(0.0f, 2.0f, 0.0f), QVector3D(0.0f, -1.0f, 0.0f),
+                                 distance, point));
+    QCOMPARE(distance, std::numeric_limits<float>::max());
+}
+
+QTEST_MAIN(tst_hierarchy)
+#include "tst_hierarchy.moc"
@@ -0,0 +1,316 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/surfaceindexbuffer_p.h>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFramebufferObject>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QOpenGLShaderProgram>
+
+#include <algorithm>
+#include <limits>
+
+using namespace QtDataVisualization;
+
+// Index layouts compared by the benchmarks
+enum IndexLayout {
+    LayoutTriangles32, // Triangle lists of unsigned ints, as surfaces were drawn before
+    LayoutTriangles,   // Triangle lists, with unsigned shorts if the grid fits
+    LayoutStrips       // Triangle strips with primitive restarts
+};
+Q_DECLARE_METATYPE(IndexLayout)
+
+class tst_indices: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void stripsMatchTriangles_data();
+    void stripsMatchTriangles();
+    void shortIndices();
+
+    void indexMemory_data();
+    void indexMemory();
+    void drawSurface_data();
+    void drawSurface();
+
+private:
+    bool isLayoutSupported(IndexLayout layout);
+    void uploadIndices(SurfaceIndexBuffer &buffer, IndexLayout layout, int size);
+
+    QOffscreenSurface *m_surface;
+    QOpenGLContext *m_context;
+};
+
+// Returns the triangles of the indices, with the vertices of each triangle sorted and the
+// degenerate triangles left out, so that the layouts can be compared regardless of winding
+static QVector<QVector<GLint> > triangles(const QVector<GLint> &indices, GLenum primitiveMode)
+{
+    QVector<QVector<GLint> > result;
+    if (primitiveMode == GL_TRIANGLES) {
+        for (int i = 0; i + 2 < indices.size(); i += 3)
+            result.append(QVector<GLint>() << indices.at(i) << indices.at(i + 1)
+                          << indices.at(i + 2));
+    } else {
+        int stripStart = 0;
+        for (int i = 0; i < indices.size(); i++) {
+            if (indices.at(i) == SurfaceIndexBuffer::restartIndex) {
+                stripStart = i + 1;
+            } else if (i - stripStart >= 2) {
+                result.append(QVector<GLint>() << indices.at(i - 2) << indices.at(i - 1)
+                              << indices.at(i));
+            }
+        }
+    }
+    for (int i = 0; i < result.size(); i++)
+        std::sort(result[i].begin(), result[i].end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void tst_indices::initTestCase()
+{
+    m_surface = new QOffscreenSurface;
+    m_surface->create();
+    m_context = new QOpenGLContext;
+    if (!m_context->create() || !m_context->makeCurrent(m_surface)) {
+        delete m_context;
+        m_context = 0;
+    }
+}
+
+void tst_indices::cleanupTestCase()
+{
+    if (m_context)
+        m_context->doneCurrent();
+    delete m_context;
+    delete m_surface;
+}
+
+void tst_indices::stripsMatchTriangles_data()
+{
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<bool>("lowerRowFirst");
+
+    QTest::newRow("2x2") << 2 << 2 << true;
+    QTest::newRow("5x3") << 5 << 3 << true;
+    QTest::newRow("5x3 flipped") << 5 << 3 << false;
+    QTest::newRow("3x7 flipped") << 3 << 7 << false;
+}
+
+void tst_indices::stripsMatchTriangles()
+{
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    QFETCH(bool, lowerRowFirst);
+
+    const QVector<GLint> lists =
+            SurfaceIndexBuffer::createSmoothIndices(columns, 0, 0, columns - 1, rows - 1,
+                                                    lowerRowFirst, GL_TRIANGLES);
+    const QVector<GLint> strips =
+            SurfaceIndexBuffer::createSmoothIndices(columns, 0, 0, columns - 1, rows - 1,
+                                                    lowerRowFirst, GL_TRIANGLE_STRIP);
+
+    QCOMPARE(lists.size(), 6 * (columns - 1) * (rows - 1));
+    QCOMPARE(strips.size(), (2 * columns + 1) * (rows - 1) - 1);
+    QCOMPARE(triangles(strips, GL_TRIANGLE_STRIP), triangles(lists, GL_TRIANGLES));
+}
+
+void tst_indices::shortIndices()
+{
+    if (!m_context)
+        QSKIP("No OpenGL context");
+
+    const QVector<GLint> indices =
+            SurfaceIndexBuffer::createSmoothIndices(3, 0, 0, 2, 2, true, GL_TRIANGLE_STRIP);
+    SurfaceIndexBuffer buffer;
+
+    buffer.upload(indices.constData(), indices.size(), 9, GL_TRIANGLE_STRIP);
+    QCOMPARE(buffer.indexType(), GLenum(GL_UNSIGNED_SHORT));
+    QCOMPARE(buffer.primitiveMode(), GLenum(GL_TRIANGLE_STRIP));
+    QCOMPARE(buffer.indexCount(), GLuint(indices.size()));
+
+    // The largest unsigned short is reserved for restarting strips
+    buffer.upload(indices.constData(), indices.size(), 65535, GL_TRIANGLE_STRIP);
+    QCOMPARE(buffer.indexType(), GLenum(GL_UNSIGNED_INT));
+}
+
+bool tst_indices::isLayoutSupported(IndexLayout layout)
+{
+    if (layout != LayoutStrips)
+        return true;
+
+    // Same requirements as for the surfaces of the graphs
+    const QPair<int, int> version = m_context->format().version();
+    if (m_context->isOpenGLES())
+        return version >= qMakePair(3, 0);
+    return version >= qMakePair(4, 3)
+            || m_context->hasExtension(QByteArrayLiteral("GL_ARB_ES3_compatibility"));
+}
+
+// Uploads the indices of a grid of size * size vertices in the given layout
+void tst_indices::uploadIndices(SurfaceIndexBuffer &buffer, IndexLayout layout, int size)
+{
+    const GLenum primitiveMode = layout == LayoutStrips ? GL_TRIANGLE_STRIP : GL_TRIANGLES;
+    const QVector<GLint> indices =
+            SurfaceIndexBuffer::createSmoothIndices(size, 0, 0, size - 1, size - 1, true,
+                                                    primitiveMode);
+
+    // Unsigned ints are used for grids with more vertices than unsigned shorts can index
+    const int vertexCount = layout == LayoutTriangles32 ? std::numeric_limits<int>::max()
+                                                        : size * size;
+    buffer.upload(indices.constData(), indices.size(), vertexCount, primitiveMode);
+}
+
+void tst_indices::indexMemory_data()
+{
+    QTest::addColumn<IndexLayout>("layout");
+    QTest::addColumn<int>("size");
+
+    // Unsigned shorts index grids of at most 255x255 vertices, as the largest one is reserved
+    // for restarting strips, so the compact layouts are compared on grids up to that size
+    QTest::newRow("triangles32 128") << LayoutTriangles32 << 128;
+    QTest::newRow("triangles 128") << LayoutTriangles << 128;
+    QTest::newRow("strips 128") << LayoutStrips << 128;
+    QTest::newRow("triangles32 255") << LayoutTriangles32 << 255;
+    QTest::newRow("triangles 255") << LayoutTriangles << 255;
+    QTest::newRow("strips 255") << LayoutStrips << 255;
+}
+
+void tst_indices::indexMemory()
+{
+    QFETCH(IndexLayout, layout);
+    QFETCH(int, size);
+
+    if (!m_context)
+        QSKIP("No OpenGL context");
+
+    SurfaceIndexBuffer buffer;
+    uploadIndices(buffer, layout, size);
+    QCOMPARE(buffer.indexType(), GLenum(layout == LayoutTriangles32 ? GL_UNSIGNED_INT
+                                                                     : GL_UNSIGNED_SHORT));
+
+    m_context->functions()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.buffer());
+    GLint bytes = 0;
+    m_context->functions()->glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE,
+                                                   &bytes);
+    m_context->functions()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    const int indexSize = buffer.indexType() == GL_UNSIGNED_SHORT ? 2 : 4;
+    QCOMPARE(bytes, GLint(buffer.indexCount() * indexSize));
+    QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+}
+
+void tst_indices::drawSurface_data()
+{
+    indexMemory_data();
+}
+
+void tst_indices::drawSurface()
+{
+    QFETCH(IndexLayout, layout);
+    QFETCH(int, size);
+
+    if (!m_context)
+        QSKIP("No OpenGL context");
+    if (!isLayoutSupported(layout))
+        QSKIP("Primitive restart not supported");
+
+    QOpenGLFramebufferObject fbo(512, 512, QOpenGLFramebufferObject::Depth);
+    fbo.bind();
+
+    QOpenGLShaderProgram program;
+    program.addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                    "attribute highp vec3 vertexPosition_mdl;\n"
+                                    "void main() {\n"
+                                    "    gl_Position = vec4(vertexPosition_mdl, 1.0);\n"
+                                    "}\n");
+    program.addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                    "void main() {\n"
+                                    "    gl_FragColor = vec4(1.0);\n"
+                                    "}\n");
+    QVERIFY(program.link());
+    program.bind();
+
+    // A bumpy grid that covers the view
+    QVector<QVector3D> vertices;
+    vertices.reserve(size * size);
+    const float step = 2.0f / float(size - 1);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            vertices.append(QVector3D(-1.0f + j * step, -1.0f + i * step,
+                                      float((i * 7 + j * 3) % 11) / 11.0f));
+        }
+    }
+
+    QOpenGLFunctions *f = m_context->functions();
+    GLuint vertexBuffer = 0;
+    f->glGenBuffers(1, &vertexBuffer);
+    f->glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    f->glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(QVector3D), vertices.constData(),
+                    GL_STATIC_DRAW);
+    const int posAtt = program.attributeLocation("vertexPosition_mdl");
+    f->glEnableVertexAttribArray(posAtt);
+    f->glVertexAttribPointer(posAtt, 3, GL_FLOAT, GL_FALSE, 0, (void *)0);
+
+    SurfaceIndexBuffer buffer;
+    uploadIndices(buffer, layout, size);
+    f->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.buffer());
+
+    const bool restart = layout == LayoutStrips && !m_context->isOpenGLES();
+    if (restart)
+        f->glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    f->glEnable(GL_DEPTH_TEST);
+
+    QBENCHMARK {
+        f->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        f->glDrawElements(buffer.primitiveMode(), buffer.indexCount(), buffer.indexType(),
+                          (void *)0);
+        f->glFinish();
+    }
+
+    if (restart)
+        f->glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    f->glDisable(GL_DEPTH_TEST);
+    f->glDisableVertexAttribArray(posAtt);
+    f->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    f->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    f->glDeleteBuffers(1, &vertexBuffer);
+    fbo.release();
+}
+
+QTEST_MAIN(tst_indices)
+#include "tst_indices.moc"
@@ -0,0 +1,322 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/surfacelevelofdetail_p.h>
+
+#include <algorithm>
+
+using namespace QtDataVisualization;
+
+// Vertex grid over the view volume of an identity view projection, with the heights stored
+// separately so that they can be shaped by the tests
+class TestGrid : public SurfaceHeightGrid
+{
+public:
+    TestGrid(int columns, int rows, bool sameDirections)
+        : m_columns(columns),
+          m_rows(rows),
+          m_sameDirections(sameDirections),
+          m_heights(columns * rows)
+    {
+    }
+
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+    bool sameDirections() const { return m_sameDirections; }
+    QVector3D gridPosition(int column, int row) const
+    {
+        return QVector3D(float(column) / float(m_columns - 1) * 2.0f - 1.0f,
+                         m_heights.at(row * m_columns + column),
+                         float(row) / float(m_rows - 1) * 2.0f - 1.0f);
+    }
+    void setHeight(int column, int row, float height)
+    {
+        m_heights[row * m_columns + column] = height;
+    }
+
+private:
+    int m_columns;
+    int m_rows;
+    bool m_sameDirections;
+    QVector<float> m_heights;
+};
+
+class tst_levelofdetail: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fullDetail_data();
+    void fullDetail();
+    void tileSelection_data();
+    void tileSelection();
+    void seams_data();
+    void seams();
+};
+
+// Deterministic pseudo random numbers in [0, 1), so that failures can be reproduced
+static float randomFloat(quint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return float(state >> 8) / float(1 << 24);
+}
+
+static SurfaceObject::DataDimensions dataDimension(const TestGrid &grid)
+{
+    return grid.sameDirections() ? SurfaceObject::BothAscending : SurfaceObject::XDescending;
+}
+
+// Returns the triangles of a triangle list rotated to start from their smallest index, so that
+// the lists can be compared regardless of the order of the triangles but with their winding
+static QVector<QVector<GLint> > triangles(const QVector<GLint> &indices)
+{
+    QVector<QVector<GLint> > result;
+    for (int i = 0; i + 2 < indices.size(); i += 3) {
+        QVector<GLint> triangle;
+        triangle << indices.at(i) << indices.at(i + 1) << indices.at(i + 2);
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()),
+                    triangle.end());
+        result.append(triangle);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// Returns the line segments of a line list with the smaller index first
+static QVector<QVector<GLint> > lines(const QVector<GLint> &indices)
+{
+    QVector<QVector<GLint> > result;
+    for (int i = 0; i + 1 < indices.size(); i += 2) {
+        result.append(QVector<GLint>() << qMin(indices.at(i), indices.at(i + 1))
+                      << qMax(indices.at(i), indices.at(i + 1)));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void tst_levelofdetail::fullDetail_data()
+{
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<bool>("sameDirections");
+
+    QTest::newRow("2x2") << 2 << 2 << true;
+    QTest::newRow("33x33") << 33 << 33 << true;
+    QTest::newRow("34x20 flipped") << 34 << 20 << false;
+    QTest::newRow("100x70") << 100 << 70 << true;
+    QTest::newRow("129x129 flipped") << 129 << 129 << false;
+    QTest::newRow("45x200") << 45 << 200 << true;
+}
+
+// Rough surfaces seen at a large pixel scale are drawn with every tile at full detail, which
+// draws the same triangles and grid lines as the undecimated surface
+void tst_levelofdetail::fullDetail()
+{
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    QFETCH(bool, sameDirections);
+
+    TestGrid grid(columns, rows, sameDirections);
+    quint32 state = 1;
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++)
+            grid.setHeight(column, row, randomFloat(state) * 0.5f);
+    }
+
+    SurfaceLevelOfDetail levelOfDetail;
+    levelOfDetail.build(grid);
+    QVERIFY(!levelOfDetail.isDirty());
+    QVERIFY(levelOfDetail.select(QMatrix4x4(), 1.0e6f));
+
+    QVector<GLint> indices;
+    QVector<GLint> gridIndices;
+    levelOfDetail.createIndices(dataDimension(grid), indices, gridIndices);
+
+    const QVector<GLint> fullIndices =
+            SurfaceIndexBuffer::createSmoothIndices(columns, 0, 0, columns - 1, rows - 1,
+                                                    sameDirections, GL_TRIANGLES);
+    QVector<GLint> fullGridIndices;
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            const int index = row * columns + column;
+            if (column < columns - 1)
+                fullGridIndices << index << index + 1;
+            if (row < rows - 1)
+                fullGridIndices << index << index + columns;
+        }
+    }
+
+    QCOMPARE(indices.size(), fullIndices.size());
+    QVERIFY(triangles(indices) == triangles(fullIndices));
+
+    // Adjacent tiles both draw the grid line along their shared edge
+    QVector<QVector<GLint> > drawnLines = lines(gridIndices);
+    drawnLines.erase(std::unique(drawnLines.begin(), drawnLines.end()), drawnLines.end());
+    QVERIFY(drawnLines == lines(fullGridIndices));
+}
+
+void tst_levelofdetail::tileSelection_data()
+{
+    QTest::addColumn<float>("pixelScale");
+    QTest::addColumn<int>("triangleCount");
+
+    // The ridges are 0.01 high, so tiles skipping them are split above a pixel scale of 200
+    QTest::newRow("no error") << 0.0f << 32 * 32 * 2;
+    QTest::newRow("below error") << 190.0f << 32 * 32 * 2;
+    QTest::newRow("above error") << 210.0f << (8 + 2) * 32 * 32 * 2 + 4 * 16;
+    QTest::newRow("far above error") << 1.0e6f << (8 + 2) * 32 * 32 * 2 + 4 * 16;
+}
+
+// The ridges along the odd columns of the leftmost quarter are lost on all but the finest level.
+// Drawn above the error limit, the left half of the surface is drawn at full detail and the
+// right half on the level above it, with a seam fan on every other row of the shared edge.
+void tst_levelofdetail::tileSelection()
+{
+    QFETCH(float, pixelScale);
+    QFETCH(int, triangleCount);
+
+    TestGrid grid(129, 129, true);
+    for (int row = 0; row < grid.rows(); row++) {
+        for (int column = 1; column < 32; column += 2)
+            grid.setHeight(column, row, 0.01f);
+    }
+
+    SurfaceLevelOfDetail levelOfDetail;
+    levelOfDetail.build(grid);
+    QVERIFY(levelOfDetail.select(QMatrix4x4(), pixelScale));
+    QVERIFY(!levelOfDetail.select(QMatrix4x4(), pixelScale));
+
+    QVector<GLint> indices;
+    QVector<GLint> gridIndices;
+    levelOfDetail.createIndices(dataDimension(grid), indices, gridIndices);
+    QCOMPARE(indices.size(), triangleCount * 3);
+
+    // Flattening the ridges lets the whole surface be drawn from the root tile
+    for (int row = 0; row < grid.rows(); row++) {
+        for (int column = 1; column < 32; column += 2)
+            grid.setHeight(column, row, 0.0f);
+        levelOfDetail.updateRows(grid, row, row);
+    }
+    levelOfDetail.select(QMatrix4x4(), pixelScale);
+    levelOfDetail.createIndices(dataDimension(grid), indices, gridIndices);
+    QCOMPARE(indices.size(), 32 * 32 * 2 * 3);
+}
+
+void tst_levelofdetail::seams_data()
+{
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<bool>("sameDirections");
+    QTest::addColumn<float>("pixelScale");
+    QTest::addColumn<int>("spikeColumn");
+
+    QTest::newRow("129x129") << 129 << 129 << true << 210.0f << -1;
+    QTest::newRow("257x257 coarse") << 257 << 257 << true << 50.0f << -1;
+    QTest::newRow("257x257 fine") << 257 << 257 << false << 1000.0f << -1;
+    QTest::newRow("300x170") << 300 << 170 << true << 500.0f << -1;
+    QTest::newRow("257x257 spike") << 257 << 257 << true << 1000.0f << 124;
+    QTest::newRow("300x170 spike") << 300 << 170 << false << 1000.0f << 254;
+}
+
+// Every edge between two triangles must be shared by exactly two triangles, so the seams between
+// tiles of different levels must not leave cracks along the vertices the coarser tile skips
+void tst_levelofdetail::seams()
+{
+    QFETCH(int, columns);
+    QFETCH(int, rows);
+    QFETCH(bool, sameDirections);
+    QFETCH(float, pixelScale);
+    QFETCH(int, spikeColumn);
+
+    // The roughness grows towards the right, so tiles get finer from left to right. Spikes next
+    // to the edge of a large tile make the finest tiles border tiles several levels coarser.
+    TestGrid grid(columns, rows, sameDirections);
+    quint32 state = 1;
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            const float x = float(column) / float(columns - 1);
+            if (spikeColumn < 0)
+                grid.setHeight(column, row, randomFloat(state) * 0.1f * x * x * x);
+            else if (qAbs(column - spikeColumn) < 4)
+                grid.setHeight(column, row, randomFloat(state) * 0.1f);
+        }
+    }
+
+    SurfaceLevelOfDetail levelOfDetail;
+    levelOfDetail.build(grid);
+    levelOfDetail.select(QMatrix4x4(), pixelScale);
+
+    QVector<GLint> indices;
+    QVector<GLint> gridIndices;
+    levelOfDetail.createIndices(dataDimension(grid), indices, gridIndices);
+    QVERIFY(indices.size() < (columns - 1) * (rows - 1) * 6);
+
+    QVector<GLint> edgeIndices;
+    for (int i = 0; i + 2 < indices.size(); i += 3) {
+        edgeIndices << indices.at(i) << indices.at(i + 1)
+                    << indices.at(i + 1) << indices.at(i + 2)
+                    << indices.at(i + 2) << indices.at(i);
+    }
+    const QVector<QVector<GLint> > edges = lines(edgeIndices);
+    int fineEdgeCount = 0;
+    int coarseEdgeCount = 0;
+    for (int i = 0; i < edges.size(); ) {
+        int count = 1;
+        while (i + count < edges.size() && edges.at(i + count) == edges.at(i))
+            count++;
+
+        // Edges along the borders of the surface belong to a single triangle
+        const int column0 = edges.at(i).at(0) % columns;
+        const int row0 = edges.at(i).at(0) / columns;
+        const int column1 = edges.at(i).at(1) % columns;
+        const int row1 = edges.at(i).at(1) / columns;
+        const bool border = (row0 == row1 && (row0 == 0 || row0 == rows - 1))
+                || (column0 == column1 && (column0 == 0 || column0 == columns - 1));
+        if (count != (border ? 1 : 2)) {
+            QFAIL(qPrintable(QStringLiteral("Edge (%1, %2) - (%3, %4) is in %5 triangles")
+                             .arg(column0).arg(row0).arg(column1).arg(row1).arg(count)));
+        }
+        if (row0 == row1) {
+            if (column1 - column0 > 1)
+                coarseEdgeCount++;
+            else
+                fineEdgeCount++;
+        }
+        i += count;
+    }
+
+    // Both full detail and decimated tiles are drawn
+    QVERIFY(fineEdgeCount > 0);
+    QVERIFY(coarseEdgeCount > 0);
+}
+
+QTEST_MAIN(tst_levelofdetail)
+#include "tst_levelofdetail.moc"
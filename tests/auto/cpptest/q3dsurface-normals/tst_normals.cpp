@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt Data Visualization module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 or (at your option) any later version
+** approved by the KDE Free Qt Foundation. The licenses are as published by
+** the Free Software Foundation and appearing in the file LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/private/surfacenormals_p.h>
+#include <QtCore/qmath.h>
+
+using namespace QtDataVisualization;
+
+Q_DECLARE_METATYPE(SurfaceNormals::Kernel)
+
+class tst_normals: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void crossProducts_data();
+    void crossProducts();
+    void bestKernel();
+
+private:
+    QVector<QVector3D> m_vertices;
+};
+
+void tst_normals::initTestCase()
+{
+    // Vertices of a bumpy surface row, with values in a similar range as normalized vertices
+    for (int i = 0; i < 200; i++) {
+        m_vertices.append(QVector3D(float(i) / 100.0f - 1.0f,
+                                    qSin(float(i) * 0.37f) * qCos(float(i) * 0.11f),
+                                    float(i % 17) / 8.0f - 1.0f));
+    }
+}
+
+void tst_normals::crossProducts_data()
+{
+    QTest::addColumn<SurfaceNormals::Kernel>("kernel");
+
+    QTest::newRow("scalar") << SurfaceNormals::KernelScalar;
+    QTest::newRow("sse2") << SurfaceNormals::KernelSse2;
+    QTest::newRow("avx") << SurfaceNormals::KernelAvx;
+}
+
+void tst_normals::crossProducts()
+{
+    QFETCH(SurfaceNormals::Kernel, kernel);
+
+    if (!SurfaceNormals::isKernelSupported(kernel))
+        QSKIP("Kernel not supported on this platform");
+
+    const QVector3D *vertices = m_vertices.constData();
+
+    // Counts that are not multiples of the vector width exercise the scalar tail
+    for (int count = 0; count <= 37; count++) {
+        QVector<QVector3D> normals(count + 1);
+        const QVector3D guard(7.0f, 7.0f, 7.0f);
+        normals[count] = guard;
+
+        SurfaceNormals::crossProducts(kernel, vertices + 1, vertices, vertices + 60,
+                                      normals.data(), count);
+
+        for (int i = 0; i < count; i++) {
+            const QVector3D &a = vertices[i + 1];
+            const QVector3D expected = QVector3D::crossProduct(vertices[i] - a,
+                                                               vertices[i + 60] - a);
+            QVERIFY2((normals.at(i) - expected).length() <= 1e-5f * qMax(1.0f, expected.length()),
+                     qPrintable(QStringLiteral("count %1, index %2").arg(count).arg(i)));
+        }
+        QCOMPARE(normals.at(count), guard);
+    }
+}
+
+void tst_normals::bestKernel()
+{
+    QVERIFY(SurfaceNormals::isKernelSupported(SurfaceNormals::KernelScalar));
+    QVERIFY(SurfaceNormals::isKernelSupported(SurfaceNormals::bestKernel()));
+
+    QVector<QVector3D> normals(10);
+    QVector<QVector3D> scalarNormals(10);
+    const QVector3D *vertices = m_vertices.constData();
+    SurfaceNormals::crossProducts(vertices, vertices + 1, vertices + 20, normals.data(), 10);
+    SurfaceNormals::crossProducts(SurfaceNormals::KernelScalar, vertices, vertices + 1,
+                                  vertices + 20, scalarNormals.data(), 10);
+    for (int i = 0; i < 10; i++)
+        QVERIFY((normals.at(i) - scalarNormals.at(i)).length() <= 1e-5f);
+}
+
+QTEST_MAIN(tst_normals)
+#include "tst_normals.moc"
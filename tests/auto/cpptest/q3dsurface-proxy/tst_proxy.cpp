@@ -47,6 +47,7 @@ private slots:
 
     void initialProperties();
     void initializeProperties();
+    void capacity();
 
 private:
     QSurfaceDataProxy *m_proxy;
@@ -84,6 +85,7 @@ void tst_proxy::initialProperties()
     QCOMPARE(m_proxy->columnCount(), 0);
     QCOMPARE(m_proxy->rowCount(), 0);
     QVERIFY(!m_proxy->series());
+    QCOMPARE(m_proxy->capacity(), 0);
 
     QCOMPARE(m_proxy->type(), QAbstractDataProxy::DataTypeSurface);
 }
@@ -105,5 +107,62 @@ void tst_proxy::initializeProperties()
     QCOMPARE(m_proxy->rowCount(), 2);
 }
 
+void tst_proxy::capacity()
+{
+    QVERIFY(m_proxy);
+
+    QSignalSpy addedSpy(m_proxy, &QSurfaceDataProxy::rowsAdded);
+    QSignalSpy scrolledSpy(m_proxy, &QSurfaceDataProxy::rowsScrolled);
+    QSignalSpy removedSpy(m_proxy, &QSurfaceDataProxy::rowsRemoved);
+
+    m_proxy->setCapacity(3);
+    QCOMPARE(m_proxy->capacity(), 3);
+
+    QSurfaceDataArray data;
+    for (int i = 0; i < 2; i++) {
+        QSurfaceDataRow *dataRow = new QSurfaceDataRow;
+        *dataRow << QVector3D(0.0f, 0.0f, float(i)) << QVector3D(1.0f, 0.0f, float(i));
+        data << dataRow;
+    }
+    QCOMPARE(m_proxy->addRows(data), 0);
+    QCOMPARE(m_proxy->rowCount(), 2);
+    QCOMPARE(addedSpy.count(), 1);
+    QCOMPARE(scrolledSpy.count(), 0);
+
+    // Fills the last row and scrolls the oldest row out
+    data.clear();
+    for (int i = 2; i < 4; i++) {
+        QSurfaceDataRow *dataRow = new QSurfaceDataRow;
+        *dataRow << QVector3D(0.0f, 0.0f, float(i)) << QVector3D(1.0f, 0.0f, float(i));
+        data << dataRow;
+    }
+    QCOMPARE(m_proxy->addRows(data), 1);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(addedSpy.count(), 2);
+    QCOMPARE(scrolledSpy.count(), 1);
+    QCOMPARE(scrolledSpy.at(0).at(0).toInt(), 1);
+    QCOMPARE(m_proxy->itemAt(0, 0)->z(), 1.0f);
+    QCOMPARE(m_proxy->itemAt(2, 0)->z(), 3.0f);
+
+    QSurfaceDataRow *dataRow = new QSurfaceDataRow;
+    *dataRow << QVector3D(0.0f, 0.0f, 4.0f) << QVector3D(1.0f, 0.0f, 4.0f);
+    QCOMPARE(m_proxy->addRow(dataRow), 2);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(scrolledSpy.count(), 2);
+    QCOMPARE(m_proxy->itemAt(0, 0)->z(), 2.0f);
+    QCOMPARE(m_proxy->itemAt(2, 0)->z(), 4.0f);
+
+    // Shrinking keeps the newest rows in chronological order
+    m_proxy->setCapacity(2);
+    QCOMPARE(m_proxy->rowCount(), 2);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(m_proxy->itemAt(0, 0)->z(), 3.0f);
+    QCOMPARE(m_proxy->itemAt(1, 0)->z(), 4.0f);
+
+    QTest::ignoreMessage(QtWarningMsg, "Invalid capacity. Capacity cannot be negative.");
+    m_proxy->setCapacity(-1);
+    QCOMPARE(m_proxy->capacity(), 2);
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
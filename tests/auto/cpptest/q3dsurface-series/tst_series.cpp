@@ -93,6 +93,8 @@ void tst_series::initialProperties()
     QCOMPARE(m_series->drawMode(), QSurface3DSeries::DrawSurfaceAndWireframe);
     QCOMPARE(m_series->isFlatShadingEnabled(), true);
     QCOMPARE(m_series->isFlatShadingSupported(), true);
+    QCOMPARE(m_series->isHeightFieldEnabled(), false);
+    QCOMPARE(m_series->isLevelOfDetailEnabled(), false);
     QCOMPARE(m_series->selectedPoint(), m_series->invalidSelectionPosition());
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
@@ -108,10 +110,14 @@ void tst_series::initializeProperties()
     m_series->setDataProxy(new QSurfaceDataProxy());
     m_series->setDrawMode(QSurface3DSeries::DrawWireframe);
     m_series->setFlatShadingEnabled(false);
+    m_series->setHeightFieldEnabled(true);
+    m_series->setLevelOfDetailEnabled(true);
     m_series->setSelectedPoint(QPoint(0, 0));
 
     QCOMPARE(m_series->drawMode(), QSurface3DSeries::DrawWireframe);
     QCOMPARE(m_series->isFlatShadingEnabled(), false);
+    QCOMPARE(m_series->isHeightFieldEnabled(), true);
+    QCOMPARE(m_series->isLevelOfDetailEnabled(), true);
     QCOMPARE(m_series->selectedPoint(), QPoint(0, 0));
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
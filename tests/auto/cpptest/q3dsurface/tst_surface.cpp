@@ -55,6 +55,9 @@ private slots:
     void removeSeries();
     void removeMultipleSeries();
 
+    void scrollingRange_data();
+    void scrollingRange();
+
 private:
     Q3DSurface *m_graph;
 };
@@ -73,6 +76,35 @@ QSurface3DSeries *newSeries()
     return series;
 }
 
+QSurfaceDataArray newWaterfallRows(int first, int count)
+{
+    QSurfaceDataArray rows;
+    for (int i = first; i < first + count; i++) {
+        QSurfaceDataRow *dataRow = new QSurfaceDataRow;
+        for (int j = 0; j < 16; j++)
+            *dataRow << QVector3D(float(j), float((i * 3 + j * 5) % 7), float(i));
+        rows << dataRow;
+    }
+    return rows;
+}
+
+int differingPixels(const QImage &image, const QImage &reference)
+{
+    int count = 0;
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            QColor color = image.pixelColor(x, y);
+            QColor referenceColor = reference.pixelColor(x, y);
+            if (qAbs(color.red() - referenceColor.red()) > 8
+                    || qAbs(color.green() - referenceColor.green()) > 8
+                    || qAbs(color.blue() - referenceColor.blue()) > 8) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
 void tst_surface::initTestCase()
 {
 }
@@ -131,6 +163,7 @@ void tst_surface::initialProperties()
     QCOMPARE(m_graph->locale(), QLocale("C"));
     QCOMPARE(m_graph->queriedGraphPosition(), QVector3D(0, 0, 0));
     QCOMPARE(m_graph->margin(), -1.0);
+    QCOMPARE(m_graph->isRayCastPicking(), false);
 }
 
 void tst_surface::initializeProperties()
@@ -155,6 +188,7 @@ void tst_surface::initializeProperties()
     m_graph->setReflectivity(0.1);
     m_graph->setLocale(QLocale("FI"));
     m_graph->setMargin(1.0);
+    m_graph->setRayCastPicking(true);
 
     QCOMPARE(m_graph->activeTheme()->type(), Q3DTheme::ThemeDigia);
     QCOMPARE(m_graph->selectionMode(), QAbstract3DGraph::SelectionItem | QAbstract3DGraph::SelectionRow | QAbstract3DGraph::SelectionSlice);
@@ -170,6 +204,7 @@ void tst_surface::initializeProperties()
     QCOMPARE(m_graph->reflectivity(), 0.1);
     QCOMPARE(m_graph->locale(), QLocale("FI"));
     QCOMPARE(m_graph->margin(), 1.0);
+    QCOMPARE(m_graph->isRayCastPicking(), true);
 }
 
 void tst_surface::invalidProperties()
@@ -261,5 +296,54 @@ void tst_surface::removeMultipleSeries()
     delete series3;
 }
 
+void tst_surface::scrollingRange_data()
+{
+    QTest::addColumn<bool>("heightField");
+
+    QTest::newRow("smooth") << false;
+    QTest::newRow("height field") << true;
+}
+
+void tst_surface::scrollingRange()
+{
+    QFETCH(bool, heightField);
+
+    QSurface3DSeries *series = new QSurface3DSeries;
+    series->setHeightFieldEnabled(heightField);
+    series->dataProxy()->setCapacity(16);
+    series->dataProxy()->addRows(newWaterfallRows(0, 16));
+    m_graph->axisX()->setRange(0.0f, 15.0f);
+    m_graph->axisY()->setRange(0.0f, 6.0f);
+    m_graph->axisZ()->setRange(0.0f, 15.0f);
+    m_graph->setShadowQuality(QAbstract3DGraph::ShadowQualityNone);
+    m_graph->addSeries(series);
+
+    const QSize size(200, 200);
+    m_graph->renderToImage(0, size);
+
+    // Rows scrolled in the same update as the z-axis range move
+    series->dataProxy()->addRows(newWaterfallRows(16, 4));
+    m_graph->axisZ()->setRange(4.0f, 19.0f);
+    QImage image = m_graph->renderToImage(0, size);
+
+    // The same rows and ranges set up from scratch
+    Q3DSurface *referenceGraph = new Q3DSurface();
+    QSurface3DSeries *referenceSeries = new QSurface3DSeries;
+    referenceSeries->setHeightFieldEnabled(heightField);
+    referenceSeries->dataProxy()->resetArray(new QSurfaceDataArray(newWaterfallRows(4, 16)));
+    referenceGraph->axisX()->setRange(0.0f, 15.0f);
+    referenceGraph->axisY()->setRange(0.0f, 6.0f);
+    referenceGraph->axisZ()->setRange(4.0f, 19.0f);
+    referenceGraph->setShadowQuality(QAbstract3DGraph::ShadowQualityNone);
+    referenceGraph->addSeries(referenceSeries);
+    QImage reference = referenceGraph->renderToImage(0, size);
+
+    QVERIFY(differingPixels(image, reference) < size.width() * size.height() / 100);
+
+    delete referenceGraph;
+    m_graph->removeSeries(series);
+    delete series;
+}
+
 QTEST_MAIN(tst_surface)
 #include "tst_surface.moc"
@@ -28,7 +28,7 @@
 ****************************************************************************/
 
 import QtQuick 2.0
-import QtDataVisualization 1.2
+import QtDataVisualization 1.4
 import QtTest 1.0
 
 Item {
@@ -82,6 +82,7 @@ Item {
 
             compare(initial.itemCount, 0)
             verify(!initial.series)
+            compare(initial.capacity, 0)
 
             compare(initial.type, AbstractDataProxy.DataTypeScatter)
         }
@@ -126,6 +127,7 @@ Item {
             change.zPosRole = "z"
             change.zPosRolePattern = /-/
             change.zPosRoleReplace = "\\1"
+            change.capacity = 100
 
             compare(change.itemModel.objectName, "model1")
             compare(change.rotationRole, "rot")
@@ -140,6 +142,7 @@ Item {
             compare(change.zPosRole, "z")
             compare(change.zPosRolePattern, /-/)
             compare(change.zPosRoleReplace, "\\1")
+            compare(change.capacity, 100)
         }
     }
 }